@@ -0,0 +1,315 @@
+/**
+ * @file advancement_index.h
+ * @brief Trigger-indexed advancement criteria and per-player progress deltas
+ *
+ * Criteria are indexed when advancements are loaded by trigger type and,
+ * where the criterion names them, by subject (the item, entity type or
+ * block the trigger is about). An event therefore only evaluates the
+ * predicates of criteria listening to that trigger and subject.
+ *
+ * Each player additionally counts the criteria still pending per trigger,
+ * so once every criterion of a trigger is granted (or belongs to a finished
+ * advancement) events of that trigger return immediately.
+ *
+ * Progress is sent as deltas: Update Advancements only carries the
+ * advancements whose progress changed since the last flush, each with just
+ * its obtained criteria (the client treats missing criteria as not
+ * obtained). Definitions are encoded once per registry and only sent in the
+ * initial full sync.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "inventory/item_stack.h"
+#include "network/encoded_packet.h"
+#include "util/identifier.h"
+
+namespace Network {
+class PacketBuffer;
+}  // namespace Network
+
+/**
+ * @namespace Advancement
+ * @brief Advancement definitions, criteria triggers and player progress
+ */
+namespace Advancement {
+
+/**
+ * @enum TriggerType
+ * @brief Criterion triggers the server fires
+ */
+enum class TriggerType : uint8_t {
+  IMPOSSIBLE,             ///< Only granted by command
+  TICK,
+  LOCATION,
+  INVENTORY_CHANGED,      ///< Subject: item id that entered the inventory
+  PLAYER_KILLED_ENTITY,   ///< Subject: entity type id
+  ENTITY_KILLED_PLAYER,   ///< Subject: entity type id
+  CONSUME_ITEM,           ///< Subject: item id
+  ENTER_BLOCK,            ///< Subject: block id
+  PLACED_BLOCK,           ///< Subject: block id
+  CHANGED_DIMENSION,      ///< Subject: dimension id
+  RECIPE_UNLOCKED,        ///< Subject: recipe index
+  BRED_ANIMALS,           ///< Subject: entity type id
+  COUNT,                  ///< Number of trigger types
+};
+
+/** @brief Number of trigger types */
+constexpr size_t TRIGGER_COUNT = static_cast<size_t>(TriggerType::COUNT);
+
+/** @brief Index of an advancement inside a registry */
+using AdvancementId = uint32_t;
+
+/** @brief Global index of a criterion inside a registry */
+using CriterionId = uint32_t;
+
+/**
+ * @struct TriggerEvent
+ * @brief Something that happened to a player and may satisfy criteria
+ */
+struct TriggerEvent {
+  TriggerType type = TriggerType::TICK;
+  int32_t subject = -1;  ///< Item, entity type or block id; -1 when the trigger has none
+  int64_t value = 0;     ///< Trigger specific amount (count, distance, ...)
+  std::span<const Inventory::ItemStack> inventory;  ///< Player inventory, INVENTORY_CHANGED only
+  double x = 0, y = 0, z = 0;  ///< Player position
+};
+
+/** @brief Extra condition of a criterion, evaluated after trigger and subject matched */
+using CriterionPredicate = std::function<bool(const TriggerEvent& event)>;
+
+/**
+ * @struct CriterionDefinition
+ * @brief One named criterion of an advancement
+ */
+struct CriterionDefinition {
+  std::string name;
+  TriggerType trigger = TriggerType::IMPOSSIBLE;
+  std::vector<int32_t> subjects;  ///< Subjects that can satisfy it; empty for any
+  CriterionPredicate predicate;   ///< nullptr when trigger and subject suffice
+};
+
+/**
+ * @struct AdvancementDisplay
+ * @brief How an advancement appears in the advancement screen
+ */
+struct AdvancementDisplay {
+  enum Frame : int32_t { TASK = 0, CHALLENGE = 1, GOAL = 2 };
+
+  std::string title;        ///< Plain text
+  std::string description;  ///< Plain text
+  Inventory::ItemStack icon;
+  Frame frame = TASK;
+  std::optional<std::string> background;  ///< Texture, root advancements only
+  bool show_toast = true;
+  bool hidden = false;
+  float x = 0;
+  float y = 0;
+};
+
+/**
+ * @struct AdvancementDefinition
+ * @brief An advancement as loaded from a datapack
+ */
+struct AdvancementDefinition {
+  std::string id;  ///< e.g. "minecraft:story/mine_stone"
+  std::optional<std::string> parent;
+  std::optional<AdvancementDisplay> display;
+  std::vector<CriterionDefinition> criteria;
+  /** @brief AND of ORs over criterion names; empty means every criterion is required */
+  std::vector<std::vector<std::string>> requirements;
+  bool sends_telemetry = false;
+};
+
+/**
+ * @class AdvancementRegistry
+ * @brief Loaded advancements with trigger and subject indexes
+ *
+ * @note Add() must finish before players use the registry; lookups are
+ *       thread-safe afterwards.
+ */
+class AdvancementRegistry {
+ public:
+  /**
+   * @brief Register an advancement
+   * @param definition Advancement definition
+   * @return Id of the advancement
+   * @throws std::invalid_argument for malformed or duplicate ids, duplicate
+   *         criterion names or requirements naming unknown criteria
+   */
+  AdvancementId Add(AdvancementDefinition definition);
+
+  /** @brief Number of advancements */
+  size_t Size() const { return advancements_.size(); }
+
+  /** @brief Number of criteria across all advancements */
+  size_t CriterionCount() const { return criteria_.size(); }
+
+  /** @brief Definition of an advancement */
+  const AdvancementDefinition& Definition(AdvancementId advancement) const {
+    return advancements_[advancement].definition;
+  }
+
+  /** @brief Find an advancement by id; "story/root" means "minecraft:story/root" */
+  std::optional<AdvancementId> Find(std::string_view id) const;
+
+  /** @brief Find an advancement by interned id, without touching the identifier table */
+  std::optional<AdvancementId> Find(Util::Identifier id) const;
+
+  /**
+   * @brief Find a criterion of an advancement by name
+   * @return Criterion id, or std::nullopt
+   */
+  std::optional<CriterionId> FindCriterion(AdvancementId advancement, std::string_view name) const;
+
+ private:
+  friend class PlayerAdvancements;
+
+  struct Entry {
+    AdvancementDefinition definition;
+    CriterionId first_criterion = 0;
+    /** @brief Requirement groups as local criterion indexes */
+    std::vector<std::vector<uint32_t>> groups;
+  };
+
+  struct Criterion {
+    AdvancementId advancement = 0;
+    uint32_t local = 0;  ///< Index within the advancement's criteria
+  };
+
+  static uint64_t SubjectKey(TriggerType trigger, int32_t subject) {
+    return (static_cast<uint64_t>(trigger) << 32) | static_cast<uint32_t>(subject);
+  }
+
+  /** @brief Criteria listening to any subject of a trigger */
+  const std::vector<CriterionId>& AnySubject(TriggerType trigger) const {
+    return any_subject_[static_cast<size_t>(trigger)];
+  }
+
+  /** @brief Criteria listening to a specific subject, or nullptr */
+  const std::vector<CriterionId>* BySubject(TriggerType trigger, int32_t subject) const;
+
+  std::vector<Entry> advancements_;
+  std::vector<Criterion> criteria_;
+  Util::IdentifierMap<AdvancementId> by_id_;
+  std::array<std::vector<CriterionId>, TRIGGER_COUNT> any_subject_;
+  std::unordered_map<uint64_t, std::vector<CriterionId>> by_subject_;
+  std::vector<uint8_t> encoded_definitions_;  ///< Every mapping entry, encoded once in Add()
+};
+
+/**
+ * @struct AdvancementStats
+ * @brief Counters of a PlayerAdvancements
+ */
+struct AdvancementStats {
+  uint64_t events = 0;
+  uint64_t events_skipped = 0;       ///< Answered from the per-trigger pending count
+  uint64_t predicates_evaluated = 0;
+  uint64_t criteria_granted = 0;
+  uint64_t advancements_completed = 0;
+  uint64_t bytes_encoded = 0;
+};
+
+/**
+ * @class PlayerAdvancements
+ * @brief One player's advancement progress
+ *
+ * @note Not thread-safe; owned by the thread ticking the player.
+ *
+ * @example
+ * @code
+ * Advancement::PlayerAdvancements progress(registry);
+ * connection.SendPacket(progress.FullSyncPacket());
+ * progress.Trigger({.type = Advancement::TriggerType::INVENTORY_CHANGED,
+ *                   .subject = item_id, .inventory = slots}, now_ms);
+ * if (auto packet = progress.FlushUpdate()) connection.SendPacket(packet);
+ * @endcode
+ */
+class PlayerAdvancements {
+ public:
+  /** @brief Called when an advancement becomes complete */
+  using CompletedFunction = std::function<void(AdvancementId advancement)>;
+
+  /**
+   * @brief Create empty progress
+   * @param registry Loaded advancements; must outlive this object
+   */
+  explicit PlayerAdvancements(const AdvancementRegistry& registry);
+
+  /** @brief Install the completion callback (rewards, chat announcement) */
+  void OnCompleted(CompletedFunction handler) { on_completed_ = std::move(handler); }
+
+  /**
+   * @brief Evaluate the criteria listening to an event
+   * @param event What happened
+   * @param now Current time in ms since the Unix epoch, stored on grants
+   * @return Number of criteria granted
+   */
+  size_t Trigger(const TriggerEvent& event, int64_t now);
+
+  /**
+   * @brief Grant a criterion directly (commands, loading saved progress)
+   * @return False if it was already obtained
+   */
+  bool Grant(CriterionId criterion, int64_t now);
+
+  /**
+   * @brief Revoke a criterion
+   * @return False if it was not obtained
+   */
+  bool Revoke(CriterionId criterion);
+
+  /** @brief True when the criterion is obtained */
+  bool IsObtained(CriterionId criterion) const { return obtained_at_[criterion] != 0; }
+
+  /** @brief True when the advancement's requirements are met */
+  bool IsDone(AdvancementId advancement) const { return done_[advancement]; }
+
+  /**
+   * @brief Encode progress changed since the last flush
+   * @return Update Advancements packet, or nullptr when nothing changed
+   */
+  Network::SharedPacket FlushUpdate();
+
+  /**
+   * @brief Encode every definition and all progress, replacing the client's state
+   * @return Update Advancements packet with the reset flag set
+   */
+  Network::SharedPacket FullSyncPacket();
+
+  /** @brief Cumulative counters */
+  const AdvancementStats& GetStats() const { return stats_; }
+
+ private:
+  void Evaluate(const std::vector<CriterionId>& candidates, const TriggerEvent& event,
+                int64_t now, size_t& granted);
+  bool Listening(CriterionId criterion) const;
+  void SetListening(AdvancementId advancement, bool listening);
+  bool RequirementsMet(AdvancementId advancement) const;
+  void MarkChanged(AdvancementId advancement);
+  void WriteProgress(Network::PacketBuffer& buffer, AdvancementId advancement) const;
+  Network::SharedPacket Encode(bool reset, const std::vector<AdvancementId>& advancements);
+
+  const AdvancementRegistry& registry_;
+  std::vector<int64_t> obtained_at_;  ///< Per criterion; 0 = not obtained
+  std::vector<bool> done_;            ///< Per advancement
+  std::vector<bool> changed_flag_;    ///< Per advancement, since the last flush
+  std::vector<AdvancementId> changed_;
+  std::array<uint32_t, TRIGGER_COUNT> pending_{};  ///< Listening criteria per trigger
+  CompletedFunction on_completed_;
+  AdvancementStats stats_;
+};
+
+}  // namespace Advancement
@@ -0,0 +1,237 @@
+/**
+ * @file chat_pipeline.h
+ * @brief Off-tick chat validation and pre-encoded Player Chat broadcasts
+ *
+ * Incoming chat messages are handed to the pipeline straight from the
+ * network thread. Validation and signature verification run on a worker
+ * pool; the Player Chat packet is then encoded once per message and shared
+ * by every recipient. Since 1.21.5 the packet starts with a per-client
+ * global index, so only that head is written per recipient and the shared
+ * tail is passed alongside it (PacketSink::SendPacket(head, tail)).
+ *
+ * Messages are broadcast in submission order even though verification
+ * completes out of order: finished messages wait in a small reorder buffer
+ * until every earlier message has been broadcast or rejected.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "network/encoded_packet.h"
+#include "util/uuid.h"
+#include "util/worker_pool.h"
+
+/**
+ * @namespace Chat
+ * @brief Player chat handling
+ */
+namespace Chat {
+
+/** @brief Maximum message length accepted from a client, in characters */
+constexpr size_t MAX_MESSAGE_LENGTH = 256;
+
+/** @brief Maximum number of last-seen acknowledgements per message */
+constexpr size_t MAX_LAST_SEEN = 20;
+
+/** @brief Size of an RSA message signature in bytes */
+constexpr size_t SIGNATURE_SIZE = 256;
+
+/** @brief Raw message signature */
+using MessageSignature = std::array<uint8_t, SIGNATURE_SIZE>;
+
+/**
+ * @struct ChatMessage
+ * @brief A chat message as received from the sender's Chat Message packet
+ */
+struct ChatMessage {
+  Util::Uuid sender;
+  Util::Uuid session_id;      ///< Sender's chat session (from Player Session)
+  std::string sender_name;
+  std::string text;
+  int64_t timestamp = 0;      ///< Milliseconds since the Unix epoch
+  int64_t salt = 0;
+  int32_t index = 0;          ///< Sender's per-session message index
+  std::optional<MessageSignature> signature;
+  std::vector<MessageSignature> last_seen;  ///< Signatures the sender acknowledged
+};
+
+/**
+ * @enum RejectReason
+ * @brief Why a message was not broadcast
+ */
+enum class RejectReason : uint8_t {
+  TOO_LONG,            ///< More than MAX_MESSAGE_LENGTH characters
+  ILLEGAL_CHARACTERS,  ///< Control characters or the section sign
+  TOO_MANY_LAST_SEEN,  ///< More than MAX_LAST_SEEN acknowledgements
+  UNSIGNED,            ///< Missing signature while secure chat is enforced
+  BAD_SIGNATURE,       ///< Rejected by the signature verifier
+};
+
+/**
+ * @brief Checks a message signature
+ *
+ * Typically verifies SHA256withRSA over SignedPayload() with the sender's
+ * session public key. Invoked on a worker thread; must be thread-safe.
+ */
+using SignatureVerifier = std::function<bool(const ChatMessage& message)>;
+
+/** @brief Called on a worker thread for every rejected message */
+using RejectHandler = std::function<void(const ChatMessage& message, RejectReason reason)>;
+
+/**
+ * @class ChatRecipient
+ * @brief Per-connection chat state: the sink and the Player Chat global index
+ */
+class ChatRecipient {
+ public:
+  explicit ChatRecipient(Network::PacketSink& sink) : sink_(sink) {}
+
+  /** @brief Connection messages are delivered to */
+  Network::PacketSink& Sink() const { return sink_; }
+
+  /**
+   * @brief Take the next global message index for this client
+   * @note Only the pipeline's broadcaster calls this, one message at a time.
+   */
+  int32_t NextGlobalIndex() { return global_index_++; }
+
+ private:
+  Network::PacketSink& sink_;
+  int32_t global_index_ = 0;
+};
+
+/** @brief Immutable snapshot of everyone who receives chat */
+using RecipientList = std::vector<std::shared_ptr<ChatRecipient>>;
+
+/**
+ * @struct ChatPipelineConfig
+ * @brief Server chat settings
+ */
+struct ChatPipelineConfig {
+  bool enforce_secure_chat = true;  ///< Reject unsigned messages
+  int32_t chat_type = 0;            ///< Registry id of minecraft:chat
+};
+
+/**
+ * @struct ChatStats
+ * @brief Counters of a ChatPipeline
+ */
+struct ChatStats {
+  uint64_t submitted = 0;
+  uint64_t rejected = 0;
+  uint64_t broadcast = 0;      ///< Messages encoded and sent
+  uint64_t deliveries = 0;     ///< Packets handed to recipients
+  uint64_t encoded_bytes = 0;  ///< Bytes encoded, once per message
+};
+
+/**
+ * @class ChatPipeline
+ * @brief Verifies, encodes and broadcasts player chat without the tick thread
+ *
+ * @note Submit() and SetRecipients() are thread-safe. Callbacks and sink
+ *       calls happen on worker threads, one message at a time. A callback
+ *       that throws drops its message and a sink that throws misses it;
+ *       neither holds up later messages. The pipeline must outlive the
+ *       tasks it posted to the worker pool.
+ *
+ * @example
+ * @code
+ * Chat::ChatPipeline chat(workers, verifier, {.enforce_secure_chat = true});
+ * chat.SetRecipients(std::make_shared<const Chat::RecipientList>(online));
+ * chat.Submit(std::move(message));  // from the connection's read thread
+ * @endcode
+ */
+class ChatPipeline {
+ public:
+  /**
+   * @brief Create a pipeline
+   * @param workers Pool used for verification, encoding and delivery
+   * @param verifier Signature check; nullptr accepts any signature
+   * @param config Chat settings
+   */
+  ChatPipeline(Util::WorkerPool& workers, SignatureVerifier verifier,
+               ChatPipelineConfig config = {});
+
+  ChatPipeline(const ChatPipeline&) = delete;
+  ChatPipeline& operator=(const ChatPipeline&) = delete;
+
+  /** @brief Install a callback for rejected messages (e.g. to kick the sender) */
+  void OnReject(RejectHandler handler) { on_reject_ = std::move(handler); }
+
+  /**
+   * @brief Publish the set of players receiving chat
+   * @param recipients New snapshot; messages broadcast later use it
+   */
+  void SetRecipients(std::shared_ptr<const RecipientList> recipients);
+
+  /**
+   * @brief Queue a message for verification and broadcast
+   * @param message Message as received; returns immediately
+   */
+  void Submit(ChatMessage message);
+
+  /** @brief Snapshot of the counters */
+  ChatStats GetStats() const;
+
+  /**
+   * @brief Bytes covered by the sender's signature
+   *
+   * Layout: int 1, sender UUID, session UUID, int index, long salt,
+   * long timestamp in seconds, int length + UTF-8 text, int last-seen count
+   * followed by each acknowledged signature.
+   *
+   * @param message Message to serialize
+   * @return Payload to verify against ChatMessage::signature
+   */
+  static std::vector<uint8_t> SignedPayload(const ChatMessage& message);
+
+  /**
+   * @brief Check length and characters of a message
+   * @param message Message to check
+   * @return Reason the message is invalid, or std::nullopt
+   */
+  static std::optional<RejectReason> Validate(const ChatMessage& message);
+
+ private:
+  void Process(uint64_t sequence, const ChatMessage& message);
+  Network::SharedPacket Encode(const ChatMessage& message) const;
+  void Complete(uint64_t sequence, Network::SharedPacket packet);
+  void Broadcast(const Network::SharedPacket& packet);
+  void Deliver(ChatRecipient& recipient, const Network::SharedPacket& packet);
+
+  Util::WorkerPool& workers_;
+  SignatureVerifier verifier_;
+  ChatPipelineConfig config_;
+  RejectHandler on_reject_;
+
+  mutable std::mutex recipients_mutex_;
+  std::shared_ptr<const RecipientList> recipients_;
+
+  std::atomic<uint64_t> next_sequence_{0};
+
+  std::mutex order_mutex_;
+  std::map<uint64_t, Network::SharedPacket> finished_;  ///< Nullptr for rejected messages
+  uint64_t next_broadcast_ = 0;
+  bool draining_ = false;
+
+  std::atomic<uint64_t> submitted_{0};
+  std::atomic<uint64_t> rejected_{0};
+  std::atomic<uint64_t> broadcast_{0};
+  std::atomic<uint64_t> deliveries_{0};
+  std::atomic<uint64_t> encoded_bytes_{0};
+};
+
+}  // namespace Chat
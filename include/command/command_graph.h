@@ -0,0 +1,343 @@
+/**
+ * @file command_graph.h
+ * @brief Brigadier-compatible command graph, parser and tab completion
+ *
+ * The graph is built once through CommandGraphBuilder and then frozen into
+ * flat arrays: nodes, a child index list in which each node's literal
+ * children come first sorted by name, and one pool holding every interned
+ * literal and argument name. Parsing walks these arrays over string_views
+ * of the input and records arguments into a fixed-capacity ParseResult,
+ * so a parse performs no heap allocation.
+ *
+ * The Commands packet is serialized once per permission level (0-4) when
+ * the graph is built, and literal completions are kept as sorted per-node
+ * lists so tab completion is a binary search.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "network/encoded_packet.h"
+
+/**
+ * @namespace Command
+ * @brief Command graph, parsing and dispatch
+ */
+namespace Command {
+
+/** @brief Highest vanilla operator permission level */
+constexpr uint8_t MAX_PERMISSION_LEVEL = 4;
+
+/** @brief Maximum number of arguments captured by one parse */
+constexpr size_t MAX_ARGUMENTS = 16;
+
+/** @brief Index of a node inside a command graph */
+using NodeId = uint32_t;
+
+/** @brief Id of the root node in every graph */
+constexpr NodeId ROOT_NODE = 0;
+
+/** @brief Marker for "no node" */
+constexpr NodeId NO_NODE = UINT32_MAX;
+
+/**
+ * @enum ArgumentType
+ * @brief Argument parsers understood by the server
+ *
+ * Values map onto entries of the client's command argument type registry.
+ */
+enum class ArgumentType : uint8_t {
+  BOOL,             ///< brigadier:bool
+  FLOAT,            ///< brigadier:float
+  DOUBLE,           ///< brigadier:double
+  INTEGER,          ///< brigadier:integer
+  LONG,             ///< brigadier:long
+  WORD,             ///< brigadier:string, single word
+  QUOTABLE_STRING,  ///< brigadier:string, word or "quoted phrase"
+  GREEDY_STRING,    ///< brigadier:string, rest of the input
+  ENTITY,           ///< minecraft:entity (parsed server-side as a word)
+  GAME_PROFILE,     ///< minecraft:game_profile (parsed server-side as a word)
+  BLOCK_POS,        ///< minecraft:block_pos (three integers)
+};
+
+/**
+ * @struct ArgumentSpec
+ * @brief Parser and constraints of an argument node
+ */
+struct ArgumentSpec {
+  ArgumentType type = ArgumentType::WORD;
+  bool has_min = false;
+  bool has_max = false;
+  double min = 0;  ///< Inclusive lower bound for numeric types
+  double max = 0;  ///< Inclusive upper bound for numeric types
+  uint8_t entity_flags = 0;  ///< minecraft:entity flags (0x01 single, 0x02 players only)
+  std::vector<std::string> suggestions;  ///< Static completions offered by the server
+};
+
+/**
+ * @enum ParseStatus
+ * @brief Outcome of parsing a command line
+ */
+enum class ParseStatus : uint8_t {
+  OK,                 ///< Parsed up to an executable node
+  UNKNOWN_COMMAND,    ///< First token is not a visible command
+  INCOMPLETE,         ///< Input ended on a node that is not executable
+  INVALID_ARGUMENT,   ///< A token matched no child of the current node
+  TOO_MANY_ARGUMENTS, ///< More than MAX_ARGUMENTS arguments
+};
+
+/**
+ * @struct ParsedArgument
+ * @brief One argument captured by the parser
+ */
+struct ParsedArgument {
+  NodeId node = NO_NODE;  ///< Argument node that consumed the text
+  std::string_view text;  ///< Raw text, without surrounding quotes
+  int64_t integer = 0;    ///< INTEGER / LONG / BOOL value
+  double number = 0;      ///< FLOAT / DOUBLE value
+  std::array<int32_t, 3> position{};  ///< BLOCK_POS value
+};
+
+class CommandGraph;
+
+/**
+ * @struct ParseResult
+ * @brief Fixed-capacity result of CommandGraph::Parse()
+ *
+ * String views point into the parsed input, which must outlive the result.
+ */
+struct ParseResult {
+  ParseStatus status = ParseStatus::UNKNOWN_COMMAND;
+  NodeId node = NO_NODE;     ///< Executable node reached (status OK)
+  size_t error_offset = 0;   ///< Input offset where parsing failed
+  size_t argument_count = 0;
+  std::array<ParsedArgument, MAX_ARGUMENTS> arguments;
+
+  /**
+   * @brief Look up an argument by node name
+   * @param graph Graph the result was produced by
+   * @param name Argument node name
+   * @return Pointer to the argument, nullptr when absent
+   */
+  const ParsedArgument* Find(const CommandGraph& graph, std::string_view name) const;
+};
+
+/**
+ * @struct CommandSource
+ * @brief Who is executing a command
+ */
+struct CommandSource {
+  uint8_t permission_level = 0;
+  Network::PacketSink* sink = nullptr;  ///< Connection to reply to, nullptr for the console
+  void* user = nullptr;                 ///< Caller-defined context (player, console, ...)
+};
+
+/** @brief Handler of an executable node; returns a command result value */
+using CommandHandler = std::function<int32_t(const CommandSource& source, const ParseResult& result)>;
+
+/**
+ * @class CommandGraph
+ * @brief Frozen command graph with cached Commands packets
+ *
+ * @note Immutable after construction and therefore safe to use from any
+ *       number of threads.
+ *
+ * @example
+ * @code
+ * Command::CommandGraphBuilder builder;
+ * auto tp = builder.Literal(Command::ROOT_NODE, "tp", 2);
+ * auto target = builder.Argument(tp, "target", {.type = Command::ArgumentType::ENTITY});
+ * builder.Executes(target, [](const Command::CommandSource&, const Command::ParseResult&) {
+ *   return 1;
+ * });
+ * Command::CommandGraph graph = builder.Build();
+ * connection.SendPacket(graph.CommandsPacket(player_permission));
+ * @endcode
+ */
+class CommandGraph {
+ public:
+  CommandGraph(CommandGraph&&) noexcept = default;
+  CommandGraph& operator=(CommandGraph&&) noexcept = default;
+  CommandGraph(const CommandGraph&) = delete;
+  CommandGraph& operator=(const CommandGraph&) = delete;
+
+  /**
+   * @brief Parse a command line without executing it
+   * @param input Command text without the leading slash
+   * @param permission_level Permission level of the source
+   * @return Parse result; views into @p input
+   */
+  ParseResult Parse(std::string_view input, uint8_t permission_level) const;
+
+  /**
+   * @brief Parse and run a command
+   * @param source Executing source
+   * @param input Command text without the leading slash
+   * @param result Receives the parse result
+   * @return Handler return value, or 0 when parsing failed
+   */
+  int32_t Execute(const CommandSource& source, std::string_view input, ParseResult& result) const;
+
+  /**
+   * @brief Pre-encoded Commands packet for a permission level
+   * @param permission_level Level 0-4; higher values are clamped
+   * @return Shared packet containing only nodes visible at that level
+   */
+  const Network::SharedPacket& CommandsPacket(uint8_t permission_level) const {
+    return commands_packets_[std::min<uint8_t>(permission_level, MAX_PERMISSION_LEVEL)];
+  }
+
+  /**
+   * @brief Answer a Command Suggestions Request
+   * @param transaction_id Id echoed back to the client
+   * @param input Text typed so far, without the leading slash
+   * @param permission_level Permission level of the requester
+   * @return Encoded Command Suggestions Response
+   */
+  Network::SharedPacket Suggest(int32_t transaction_id, std::string_view input,
+                                uint8_t permission_level) const;
+
+  /**
+   * @brief Collect completions for the node still being typed at the end of @p input
+   *
+   * Complete nodes are consumed with the parser's own argument rules, so a
+   * quoted string or a block position that spans several words is
+   * completed from its first character rather than from the last space.
+   * @param input Text typed so far, without the leading slash
+   * @param permission_level Permission level of the requester
+   * @param start Receives the offset where the node being completed begins
+   * @param out Receives views of the matching completions
+   */
+  void Complete(std::string_view input, uint8_t permission_level, size_t& start,
+                std::vector<std::string_view>& out) const;
+
+  /** @brief Name of a literal or argument node */
+  std::string_view NodeName(NodeId node) const;
+
+  /** @brief Number of nodes, including the root */
+  size_t NodeCount() const { return nodes_.size(); }
+
+ private:
+  friend class CommandGraphBuilder;
+
+  CommandGraph() = default;
+
+  enum NodeType : uint8_t { ROOT = 0, LITERAL = 1, ARGUMENT = 2 };
+
+  struct Node {
+    NodeType type = ROOT;
+    uint8_t permission = 0;
+    uint32_t name_offset = 0;
+    uint32_t name_length = 0;
+    uint32_t first_child = 0;      ///< Into children_
+    uint16_t literal_children = 0; ///< Literal children, sorted by name, come first
+    uint16_t child_count = 0;
+    NodeId redirect = NO_NODE;
+    int32_t argument = -1;         ///< Into arguments_
+    int32_t handler = -1;          ///< Into handlers_
+  };
+
+  struct Completions {
+    /** @brief Sorted names per permission level */
+    std::array<std::vector<std::string_view>, MAX_PERMISSION_LEVEL + 1> by_level;
+  };
+
+  std::string_view NameOf(const Node& node) const {
+    return {name_pool_.data() + node.name_offset, node.name_length};
+  }
+  bool Visible(NodeId node, uint8_t permission_level) const {
+    return nodes_[node].permission <= permission_level;
+  }
+  NodeId ChildrenOwner(NodeId node) const;
+  NodeId WalkToCompletion(std::string_view input, uint8_t permission_level, size_t& start) const;
+  bool ParseFrom(NodeId node, std::string_view input, size_t offset, uint8_t permission_level,
+                 ParseResult& result) const;
+  bool ParseArgument(const ArgumentSpec& spec, std::string_view input, size_t offset,
+                     size_t& end, ParsedArgument& argument) const;
+  NodeId FindLiteral(NodeId owner, std::string_view token, uint8_t permission_level) const;
+  void EncodeCommandsPackets();
+  void BuildCompletions();
+
+  std::vector<Node> nodes_;
+  std::vector<NodeId> children_;
+  std::vector<char> name_pool_;  ///< Interned names; a vector so views survive moves
+  std::vector<ArgumentSpec> arguments_;
+  std::vector<CommandHandler> handlers_;
+  std::vector<Completions> completions_;  ///< Per node
+  std::array<Network::SharedPacket, MAX_PERMISSION_LEVEL + 1> commands_packets_;
+};
+
+/**
+ * @class CommandGraphBuilder
+ * @brief Mutable construction front end producing a CommandGraph
+ */
+class CommandGraphBuilder {
+ public:
+  CommandGraphBuilder();
+
+  /**
+   * @brief Add (or reuse) a literal child
+   * @param parent Parent node
+   * @param name Literal text, e.g. "gamemode"
+   * @param permission Minimum permission level to see and use the node
+   * @return Node id of the literal
+   */
+  NodeId Literal(NodeId parent, std::string_view name, uint8_t permission = 0);
+
+  /**
+   * @brief Add an argument child
+   * @param parent Parent node
+   * @param name Argument name shown to the client
+   * @param spec Parser and constraints
+   * @param permission Minimum permission level to see and use the node
+   * @return Node id of the argument
+   */
+  NodeId Argument(NodeId parent, std::string_view name, ArgumentSpec spec,
+                  uint8_t permission = 0);
+
+  /**
+   * @brief Make a node executable
+   * @param node Node that completes a command
+   * @param handler Handler invoked by CommandGraph::Execute()
+   */
+  void Executes(NodeId node, CommandHandler handler);
+
+  /**
+   * @brief Continue parsing at another node's children (e.g. "execute ... run")
+   * @param node Node that redirects
+   * @param target Node whose children follow
+   */
+  void Redirect(NodeId node, NodeId target);
+
+  /**
+   * @brief Freeze the graph and pre-encode its packets
+   * @return Immutable graph
+   */
+  CommandGraph Build() const;
+
+ private:
+  struct PendingNode {
+    uint8_t type = 0;
+    uint8_t permission = 0;
+    std::string name;
+    std::vector<NodeId> children;
+    NodeId redirect = NO_NODE;
+    int32_t argument = -1;
+    int32_t handler = -1;
+  };
+
+  std::vector<PendingNode> nodes_;
+  std::vector<ArgumentSpec> arguments_;
+  std::vector<CommandHandler> handlers_;
+};
+
+}  // namespace Command
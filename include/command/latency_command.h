@@ -0,0 +1,32 @@
+/**
+ * @file latency_command.h
+ * @brief The /latency command: recent latency percentiles in game
+ *
+ * /latency [tick|packets|join|chunks] prints p50, p99, p99.9 and the maximum
+ * of the recent window for every histogram of a Util::LatencyMetrics family
+ * (tick phases when no category is given); packet ids are listed worst p99
+ * first, at most ten. Players receive the lines as system chat messages,
+ * the console as log lines.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "command/command_graph.h"
+#include "util/latency_metrics.h"
+
+namespace Command {
+
+/**
+ * @brief Add /latency to a graph under construction
+ * @param builder Builder of the server's command graph
+ * @param latency Histograms to report; must outlive the built graph
+ * @param permission Permission level required, operators by default
+ */
+void RegisterLatencyCommand(CommandGraphBuilder& builder, const Util::LatencyMetrics& latency,
+                            uint8_t permission = 2);
+
+}  // namespace Command
@@ -0,0 +1,153 @@
+/**
+ * @file container.h
+ * @brief Container slots with revision tracking and per-viewer delta sync
+ *
+ * Every slot write bumps the container's revision and stamps the slot with
+ * it. Each viewer remembers the revision it last synchronized, so a flush
+ * only looks at slots stamped after that point and sends either individual
+ * Set Container Slot packets or, when that would be larger, one Set
+ * Container Content packet.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "inventory/item_stack.h"
+#include "network/encoded_packet.h"
+
+namespace Network {
+class PacketBuffer;
+}
+
+namespace Inventory {
+
+class ItemStackCache;
+
+/**
+ * @class Container
+ * @brief Ordered item slots shared by every viewer of an inventory
+ *
+ * @note Not thread-safe; owned by the thread ticking the container.
+ */
+class Container {
+ public:
+  /**
+   * @brief Create a container of empty slots
+   * @param slot_count Number of slots
+   */
+  explicit Container(size_t slot_count)
+      : slots_(slot_count), slot_revisions_(slot_count, 0) {}
+
+  /** @brief Number of slots */
+  size_t Size() const { return slots_.size(); }
+
+  /** @brief Current contents of a slot */
+  const ItemStack& Slot(size_t index) const { return slots_[index]; }
+
+  /**
+   * @brief Replace a slot's contents
+   * @param index Slot index
+   * @param stack New contents
+   * @return true if the slot changed
+   *
+   * Writing a stack equal to the current one does not bump the revision.
+   */
+  bool SetSlot(size_t index, ItemStack stack);
+
+  /** @brief Revision of the most recent change */
+  uint64_t Revision() const { return revision_; }
+
+  /** @brief Revision at which @p index last changed */
+  uint64_t SlotRevision(size_t index) const { return slot_revisions_[index]; }
+
+ private:
+  std::vector<ItemStack> slots_;
+  std::vector<uint64_t> slot_revisions_;
+  uint64_t revision_ = 0;
+};
+
+/**
+ * @struct ContainerSyncStats
+ * @brief Packet counters of a ContainerView
+ */
+struct ContainerSyncStats {
+  uint64_t slot_packets = 0;     ///< Set Container Slot packets sent
+  uint64_t content_packets = 0;  ///< Set Container Content packets sent
+  uint64_t cursor_packets = 0;   ///< Cursor item updates sent
+  uint64_t bytes_sent = 0;       ///< Encoded bytes of all three packet types
+};
+
+/**
+ * @class ContainerView
+ * @brief One player's open window onto a Container
+ *
+ * The first Flush() after construction or Resync() always sends the full
+ * contents. Afterwards only slots changed since the last flush are sent.
+ * A changed cursor item is sent on its own: Set Cursor Item from 1.21.2,
+ * Set Container Slot with window -1 and slot -1 before that.
+ *
+ * @example
+ * @code
+ * Inventory::ContainerView view(chest, window_id);
+ * // ... slot changes during the tick
+ * view.Flush(item_cache, player_connection);
+ * @endcode
+ */
+class ContainerView {
+ public:
+  /**
+   * @brief Open a window onto a container
+   * @param container Container being viewed; must outlive the view
+   * @param window_id Protocol window id (0 for the player inventory)
+   */
+  ContainerView(const Container& container, int32_t window_id)
+      : container_(container), window_id_(window_id) {}
+
+  /** @brief Protocol window id */
+  int32_t WindowId() const { return window_id_; }
+
+  /** @brief State id of the last packet sent; clicks must echo it */
+  int32_t StateId() const { return state_id_; }
+
+  /**
+   * @brief Set the item held on this viewer's cursor
+   * @param stack Cursor contents
+   */
+  void SetCarried(ItemStack stack);
+
+  /** @brief Force the next flush to send the full contents */
+  void Resync() { full_sync_ = true; }
+
+  /**
+   * @brief Send whatever changed since the last flush
+   * @param cache Encoded stack cache shared by the flushing thread
+   * @param sink Viewer's connection
+   * @return Number of packets sent
+   */
+  size_t Flush(ItemStackCache& cache, Network::PacketSink& sink);
+
+  /** @brief Packet counters */
+  const ContainerSyncStats& GetStats() const { return stats_; }
+
+ private:
+  void SendContent(ItemStackCache& cache, Network::PacketSink& sink);
+  void SendSlot(ItemStackCache& cache, Network::PacketSink& sink, size_t index);
+  void SendCarried(ItemStackCache& cache, Network::PacketSink& sink);
+  void WriteHeader(Network::PacketBuffer& buffer, int32_t window_id);
+
+  const Container& container_;
+  int32_t window_id_;
+  int32_t state_id_ = 0;
+  uint64_t synced_revision_ = 0;
+  bool full_sync_ = true;
+  bool carried_dirty_ = false;  ///< Cursor changed since the last flush
+  ItemStack carried_;
+  std::vector<size_t> changed_;  ///< Scratch list reused across flushes
+  ContainerSyncStats stats_;
+};
+
+}  // namespace Inventory
@@ -0,0 +1,105 @@
+/**
+ * @file item_stack.h
+ * @brief Item stacks with pre-encoded data component patches
+ *
+ * Item data components are kept in their wire encoding. The server rarely
+ * needs to interpret them, and keeping the bytes lets identical stacks be
+ * recognised by hash and encoded once.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "util/hash.h"
+
+/**
+ * @namespace Inventory
+ * @brief Items, containers and crafting
+ */
+namespace Inventory {
+
+/**
+ * @class ItemComponentPatch
+ * @brief Immutable, pre-encoded data component patch of an item stack
+ *
+ * For 1.20.5+ @ref Encoded() holds the added components followed by the
+ * removed component type ids, exactly as written after the two counts in
+ * a Slot. For older versions it holds the stack's NBT tag.
+ */
+class ItemComponentPatch {
+ public:
+  /**
+   * @brief Wrap an encoded component patch
+   * @param added_count Number of added components in @p encoded
+   * @param removed_count Number of removed component types in @p encoded
+   * @param encoded Wire encoding of the components
+   */
+  ItemComponentPatch(int32_t added_count, int32_t removed_count, std::vector<uint8_t> encoded)
+      : added_count_(added_count),
+        removed_count_(removed_count),
+        encoded_(std::move(encoded)),
+        hash_(Util::HashCombine(Util::HashCombine(Util::Fnv1a(encoded_), added_count_),
+                                removed_count_)) {}
+
+  int32_t AddedCount() const { return added_count_; }
+  int32_t RemovedCount() const { return removed_count_; }
+  const std::vector<uint8_t>& Encoded() const { return encoded_; }
+
+  /** @brief Content hash, computed once at construction */
+  uint64_t Hash() const { return hash_; }
+
+  bool operator==(const ItemComponentPatch& other) const {
+    return hash_ == other.hash_ && added_count_ == other.added_count_ &&
+           removed_count_ == other.removed_count_ && encoded_ == other.encoded_;
+  }
+
+ private:
+  int32_t added_count_;
+  int32_t removed_count_;
+  std::vector<uint8_t> encoded_;
+  uint64_t hash_;
+};
+
+/**
+ * @struct ItemStack
+ * @brief An item id, a count and an optional component patch
+ *
+ * A count of 0 is the empty stack regardless of the other fields.
+ */
+struct ItemStack {
+  int32_t item_id = 0;
+  int32_t count = 0;
+  std::shared_ptr<const ItemComponentPatch> components;  ///< nullptr for default components
+
+  /** @brief True for the empty stack */
+  bool IsEmpty() const { return count <= 0; }
+
+  /** @brief Hash of id, count and components; all empty stacks hash equal */
+  uint64_t Hash() const {
+    if (IsEmpty()) {
+      return 0;
+    }
+    uint64_t hash = Util::HashCombine(static_cast<uint64_t>(item_id), static_cast<uint64_t>(count));
+    return components ? Util::HashCombine(hash, components->Hash()) : hash;
+  }
+
+  bool operator==(const ItemStack& other) const {
+    if (IsEmpty() || other.IsEmpty()) {
+      return IsEmpty() == other.IsEmpty();
+    }
+    if (item_id != other.item_id || count != other.count) {
+      return false;
+    }
+    if (components == other.components) {
+      return true;
+    }
+    return components && other.components && *components == *other.components;
+  }
+};
+
+}  // namespace Inventory
@@ -0,0 +1,105 @@
+/**
+ * @file item_stack_cache.h
+ * @brief Cache of wire-encoded Slot data keyed by item stack content
+ *
+ * Inventories are full of identical stacks (64 cobblestone, one of each
+ * tool). Encoding each distinct stack once and copying its bytes into
+ * container packets keeps slot serialization out of the profile.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "inventory/item_stack.h"
+
+namespace Network {
+class PacketBuffer;
+}
+
+namespace Inventory {
+
+/**
+ * @struct ItemStackCacheStats
+ * @brief Lookup counters of an ItemStackCache
+ */
+struct ItemStackCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t clears = 0;  ///< Times the cache was dropped for exceeding its capacity or budget
+};
+
+/**
+ * @class ItemStackCache
+ * @brief Maps item stacks to their encoded Slot bytes
+ *
+ * When the number of entries exceeds the capacity, or the caches memory
+ * budget is exceeded (see Util::MemorySubsystem::CACHES), the cache is
+ * cleared; the working set of a server is small and rebuilds quickly,
+ * which keeps lookups free of LRU bookkeeping.
+ *
+ * @note Not thread-safe. Use one cache per thread that encodes containers.
+ */
+class ItemStackCache {
+ public:
+  /**
+   * @brief Create an empty cache
+   * @param capacity Maximum number of distinct stacks kept
+   */
+  explicit ItemStackCache(size_t capacity = 4096) : capacity_(capacity) {}
+  ~ItemStackCache() { Clear(); }
+
+  ItemStackCache(const ItemStackCache&) = delete;
+  ItemStackCache& operator=(const ItemStackCache&) = delete;
+
+  /**
+   * @brief Append the Slot encoding of @p stack to @p buffer
+   * @param buffer Destination packet buffer
+   * @param stack Stack to encode (may be empty)
+   */
+  void Write(Network::PacketBuffer& buffer, const ItemStack& stack);
+
+  /**
+   * @brief Size in bytes of the Slot encoding of @p stack
+   * @param stack Stack to measure
+   * @return Encoded size; populates the cache as a side effect
+   */
+  size_t EncodedSize(const ItemStack& stack);
+
+  /** @brief Drop all cached encodings, e.g. under memory pressure */
+  void Clear();
+
+  /** @brief Number of cached stacks */
+  size_t Size() const { return entries_.size(); }
+
+  /** @brief Approximate memory held by the entries, as accounted to the caches budget */
+  size_t Bytes() const { return bytes_; }
+
+  /** @brief Lookup counters */
+  const ItemStackCacheStats& GetStats() const { return stats_; }
+
+  /**
+   * @brief Encode a stack without the cache
+   * @param buffer Destination packet buffer
+   * @param stack Stack to encode (may be empty)
+   */
+  static void Encode(Network::PacketBuffer& buffer, const ItemStack& stack);
+
+ private:
+  struct KeyHash {
+    size_t operator()(const ItemStack& stack) const { return stack.Hash(); }
+  };
+
+  const std::vector<uint8_t>& Lookup(const ItemStack& stack);
+
+  size_t capacity_;
+  std::unordered_map<ItemStack, std::vector<uint8_t>, KeyHash> entries_;
+  size_t bytes_ = 0;
+  ItemStackCacheStats stats_;
+};
+
+}  // namespace Inventory
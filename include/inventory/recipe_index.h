@@ -0,0 +1,173 @@
+/**
+ * @file recipe_index.h
+ * @brief Hash-indexed crafting recipe lookup
+ *
+ * Instead of testing a crafting grid against every recipe, recipes are
+ * bucketed by a key derived from the normalized grid:
+ * - shaped recipes by trimmed size, occupancy mask and the item in the
+ *   first occupied cell (registered once per accepted item, and again for
+ *   the horizontally mirrored pattern);
+ * - shapeless recipes by ingredient count and the smallest item id.
+ * A lookup hashes the grid once and verifies only the few recipes in the
+ * matching buckets.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "inventory/item_stack.h"
+
+namespace Inventory {
+
+/** @brief Item id of minecraft:air, used for empty grid cells */
+constexpr int32_t EMPTY_ITEM = 0;
+
+/**
+ * @struct Ingredient
+ * @brief Set of item ids accepted by one recipe cell
+ *
+ * An ingredient with no items matches only an empty cell.
+ */
+struct Ingredient {
+  std::vector<int32_t> items;  ///< Sorted, unique item ids
+
+  /** @brief True when the ingredient stands for an empty cell */
+  bool IsEmpty() const { return items.empty(); }
+
+  /** @brief True when @p item_id satisfies the ingredient */
+  bool Accepts(int32_t item_id) const;
+};
+
+/**
+ * @struct CraftingRecipe
+ * @brief A shaped or shapeless crafting table recipe
+ */
+struct CraftingRecipe {
+  enum Kind { SHAPED, SHAPELESS };
+
+  std::string id;     ///< Namespaced recipe id, e.g. "minecraft:crafting_table"
+  Kind kind = SHAPED;
+  int32_t width = 0;  ///< Pattern width (shaped only)
+  int32_t height = 0; ///< Pattern height (shaped only)
+  std::vector<Ingredient> ingredients;  ///< Row-major pattern, or the shapeless list
+  ItemStack result;
+};
+
+/**
+ * @struct CraftingGrid
+ * @brief Item ids currently in a 2x2 or 3x3 crafting grid
+ */
+struct CraftingGrid {
+  int32_t width = 3;
+  int32_t height = 3;
+  std::array<int32_t, 9> items{};  ///< Row-major, EMPTY_ITEM for empty cells
+
+  bool operator==(const CraftingGrid&) const = default;
+};
+
+/**
+ * @class RecipeIndex
+ * @brief Immutable-after-load crafting recipe index
+ *
+ * When several recipes match, the one added first wins, mirroring the
+ * datapack order vanilla uses.
+ *
+ * @note Add() must finish before concurrent Match() calls; Match() itself
+ *       is thread-safe.
+ */
+class RecipeIndex {
+ public:
+  /**
+   * @brief Register a recipe
+   * @param recipe Recipe definition; shaped patterns are trimmed on insert
+   * @return Index of the recipe inside this index
+   * @throws std::invalid_argument if the recipe does not fit a 3x3 grid
+   */
+  size_t Add(CraftingRecipe recipe);
+
+  /**
+   * @brief Find the recipe crafted by a grid
+   * @param grid Current grid contents
+   * @return Matching recipe, or nullptr
+   */
+  const CraftingRecipe* Match(const CraftingGrid& grid) const;
+
+  /** @brief Number of registered recipes */
+  size_t Size() const { return recipes_.size(); }
+
+ private:
+  struct Candidate {
+    uint32_t recipe;
+    bool mirrored;
+  };
+
+  static uint64_t ShapedKey(int32_t width, int32_t height, uint16_t mask, int32_t first_item);
+  static uint64_t ShapelessKey(int32_t count, int32_t smallest_item);
+  bool MatchesShaped(const CraftingRecipe& recipe, bool mirrored, int32_t width,
+                     const std::array<int32_t, 9>& cells) const;
+  static bool MatchesShapeless(const CraftingRecipe& recipe, const std::array<int32_t, 9>& items,
+                               int32_t count);
+
+  std::vector<CraftingRecipe> recipes_;
+  std::unordered_map<uint64_t, std::vector<Candidate>> shaped_;
+  std::unordered_map<uint64_t, std::vector<uint32_t>> shapeless_;
+};
+
+/**
+ * @struct CraftingMatcherStats
+ * @brief Cache counters of a CraftingMatcher
+ */
+struct CraftingMatcherStats {
+  uint64_t lookups = 0;
+  uint64_t cache_hits = 0;  ///< Lookups answered from the last match
+};
+
+/**
+ * @class CraftingMatcher
+ * @brief Per-window front end that remembers the last grid and its result
+ *
+ * Slot updates that do not change the item layout (count changes, the
+ * client re-sending the same grid) are answered without touching the
+ * index.
+ *
+ * @example
+ * @code
+ * Inventory::CraftingMatcher matcher(recipes);
+ * const Inventory::CraftingRecipe* recipe = matcher.Match(grid);
+ * result_slot = recipe ? recipe->result : Inventory::ItemStack{};
+ * @endcode
+ */
+class CraftingMatcher {
+ public:
+  /**
+   * @brief Create a matcher for one crafting window
+   * @param index Shared recipe index; must outlive the matcher
+   */
+  explicit CraftingMatcher(const RecipeIndex& index) : index_(index) {}
+
+  /**
+   * @brief Find the recipe crafted by a grid
+   * @param grid Current grid contents
+   * @return Matching recipe, or nullptr
+   */
+  const CraftingRecipe* Match(const CraftingGrid& grid);
+
+  /** @brief Cache counters */
+  const CraftingMatcherStats& GetStats() const { return stats_; }
+
+ private:
+  const RecipeIndex& index_;
+  CraftingGrid last_grid_;
+  const CraftingRecipe* last_match_ = nullptr;
+  bool has_last_ = false;
+  CraftingMatcherStats stats_;
+};
+
+}  // namespace Inventory
@@ -0,0 +1,76 @@
+/**
+ * @file encoded_packet.h
+ * @brief Immutable pre-encoded packets and the sink interface that delivers them
+ *
+ * Packets that go to more than one client are serialized exactly once into
+ * an EncodedPacket and shared between recipients by reference counting.
+ * Connections only add the length prefix, compression and encryption.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Network {
+
+/**
+ * @struct EncodedPacket
+ * @brief A fully serialized packet body (packet id VarInt followed by payload)
+ *
+ * The length prefix is not part of @ref bytes because it depends on the
+ * per-connection compression threshold.
+ */
+struct EncodedPacket {
+  int32_t packet_id = -1;      ///< Protocol packet id, for logging and metrics
+  std::vector<uint8_t> bytes;  ///< Packet id VarInt followed by the payload
+};
+
+/** @brief Reference-counted immutable packet shared between recipients */
+using SharedPacket = std::shared_ptr<const EncodedPacket>;
+
+/**
+ * @class PacketSink
+ * @brief Destination for pre-encoded packets (typically a client connection)
+ *
+ * Implementations must be safe to call from the thread that owns the sink;
+ * connections that are fed from several threads are responsible for their
+ * own queueing.
+ */
+class PacketSink {
+ public:
+  virtual ~PacketSink() = default;
+
+  /**
+   * @brief Queue a pre-encoded packet for delivery
+   * @param packet Shared packet; the sink may keep the reference until sent
+   */
+  virtual void SendPacket(const SharedPacket& packet) = 0;
+
+  /**
+   * @brief Queue a packet made of a per-recipient head and a shared tail
+   *
+   * Used when a broadcast differs between recipients only in its first
+   * fields (e.g. the Player Chat global index). @p head holds the packet id
+   * VarInt and those fields; @p tail->bytes holds the rest of the packet.
+   * The default implementation concatenates both into a new packet;
+   * connections that can write gathered buffers should override it.
+   *
+   * @param head Packet id and per-recipient fields; only valid during the call
+   * @param tail Shared remainder of the packet
+   */
+  virtual void SendPacket(std::span<const uint8_t> head, const SharedPacket& tail) {
+    auto packet = std::make_shared<EncodedPacket>();
+    packet->packet_id = tail->packet_id;
+    packet->bytes.reserve(head.size() + tail->bytes.size());
+    packet->bytes.insert(packet->bytes.end(), head.begin(), head.end());
+    packet->bytes.insert(packet->bytes.end(), tail->bytes.begin(), tail->bytes.end());
+    SendPacket(SharedPacket(std::move(packet)));
+  }
+};
+
+}  // namespace Network
@@ -0,0 +1,154 @@
+/**
+ * @file http_server.h
+ * @brief Minimal HTTP/1.1 server for operational endpoints
+ *
+ * Serves the few plain GET routes operators point tools at: /metrics for
+ * Prometheus, health checks for orchestrators. It runs on its own thread,
+ * so it answers while the tick loop is busy or stuck, which is exactly when
+ * those endpoints matter. One thread multiplexes all connections with
+ * poll(); handlers are expected to return quickly and never block on the
+ * tick thread.
+ *
+ * Not a general web server: requests are GET or HEAD without a body,
+ * headers are limited in size, responses are built in memory. Keep-alive
+ * is supported because Prometheus reuses its connection between scrapes.
+ * Bind to loopback or an internal interface; there is no authentication.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace Network {
+
+/**
+ * @struct HttpServerConfig
+ * @brief Listening address and limits of an HttpServer
+ */
+struct HttpServerConfig {
+  std::string address = "127.0.0.1";  ///< IPv4 or IPv6 literal; "0.0.0.0" for every interface
+  uint16_t port = 9225;               ///< 0 picks a free port, see HttpServer::Port()
+  size_t max_connections = 64;        ///< Further connections are accepted and closed
+  size_t max_request_bytes = 8192;    ///< Request line and headers
+  std::chrono::milliseconds idle_timeout{10000};  ///< Closes connections with no request
+};
+
+/**
+ * @struct HttpRequest
+ * @brief Parsed request passed to a handler
+ */
+struct HttpRequest {
+  std::string method;  ///< "GET" or "HEAD"
+  std::string path;    ///< Without the query string
+  std::string query;   ///< After '?', undecoded; empty when absent
+  std::string accept;  ///< Accept header; empty when absent
+};
+
+/**
+ * @struct HttpResponse
+ * @brief What a handler answers
+ */
+struct HttpResponse {
+  int status = 200;
+  std::string content_type = "text/plain; charset=utf-8";
+  std::string body;
+};
+
+/** @brief Route handler; runs on the server thread and must not throw for normal errors */
+using HttpHandler = std::function<HttpResponse(const HttpRequest& request)>;
+
+/**
+ * @struct HttpServerStats
+ * @brief Counters of an HttpServer
+ */
+struct HttpServerStats {
+  uint64_t connections = 0;  ///< Accepted connections
+  uint64_t requests = 0;     ///< Requests answered, errors included
+  uint64_t rejected = 0;     ///< Connections closed at max_connections or malformed requests
+};
+
+/**
+ * @class HttpServer
+ * @brief Single-threaded HTTP/1.1 server for GET routes
+ *
+ * @note Thread-safe. Routes may be added before or after Start(); handlers
+ *       run one at a time on the server thread. A handler that throws
+ *       answers 500.
+ *
+ * @example
+ * @code
+ * Network::HttpServerConfig config;
+ * config.address = "0.0.0.0";
+ * Network::HttpServer http(config);
+ * http.Handle("/metrics", [&](const Network::HttpRequest& request) {
+ *   const Util::MetricsFormat format = Util::NegotiateMetricsFormat(request.accept);
+ *   return Network::HttpResponse{200, std::string(Util::MetricsContentType(format)),
+ *                                registry.Render(format)};
+ * });
+ * http.Start();
+ * @endcode
+ */
+class HttpServer {
+ public:
+  explicit HttpServer(HttpServerConfig config = {});
+  ~HttpServer();
+
+  HttpServer(const HttpServer&) = delete;
+  HttpServer& operator=(const HttpServer&) = delete;
+
+  /**
+   * @brief Serve @p path with @p handler, replacing an earlier handler
+   * @param path Exact path, e.g. "/metrics"
+   * @param handler Called for GET and HEAD requests on @p path
+   */
+  void Handle(std::string path, HttpHandler handler);
+
+  /**
+   * @brief Bind, listen and start the server thread
+   * @throws std::runtime_error If the address is invalid or cannot be bound
+   */
+  void Start();
+
+  /** @brief Close every connection and join the server thread */
+  void Stop();
+
+  /** @brief Port listened on; the chosen one when the config asked for 0 */
+  uint16_t Port() const { return port_.load(std::memory_order_relaxed); }
+
+  /** @brief Snapshot of the counters */
+  HttpServerStats GetStats() const;
+
+ private:
+  struct Connection;
+
+  void Loop();
+
+  /** @brief Answer every complete request buffered on @p connection; false to close it */
+  bool Serve(Connection& connection);
+
+  HttpResponse Dispatch(const HttpRequest& request);
+
+  HttpServerConfig config_;
+  mutable std::mutex mutex_;
+  std::map<std::string, HttpHandler, std::less<>> routes_;
+  intptr_t listener_ = -1;  ///< Socket handle; SOCKET on Windows
+  std::atomic<uint16_t> port_{0};
+  std::atomic<bool> stopping_{false};
+  std::atomic<uint64_t> connections_{0};
+  std::atomic<uint64_t> requests_{0};
+  std::atomic<uint64_t> rejected_{0};
+  std::thread thread_;
+};
+
+}  // namespace Network
@@ -0,0 +1,216 @@
+/**
+ * @file packet_buffer.h
+ * @brief Growable big-endian write buffer for Minecraft protocol packets
+ *
+ * PacketBuffer serializes the primitive data types of the Java Edition
+ * protocol (VarInt, VarLong, String, Long, ...) into a contiguous byte
+ * vector. A buffer constructed with a packet id writes that id first, so
+ * Finish() yields an EncodedPacket ready to be framed by a connection.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "network/encoded_packet.h"
+#include "util/uuid.h"
+
+namespace Network {
+
+/**
+ * @class PacketBuffer
+ * @brief Serializes protocol data types into a byte vector
+ *
+ * All multi-byte fixed-width values are written in network (big-endian)
+ * byte order regardless of the host platform.
+ *
+ * @note Not thread-safe. A buffer is expected to be filled by one thread
+ *       and then handed off through Finish().
+ *
+ * @example
+ * @code
+ * Network::PacketBuffer buffer(Protocol::Play::Clientbound::BLOCK_UPDATE);
+ * buffer.WriteLong(position.Encode());
+ * buffer.WriteVarInt(state_id);
+ * Network::SharedPacket packet = buffer.Finish();
+ * @endcode
+ */
+class PacketBuffer {
+ public:
+  PacketBuffer() = default;
+
+  /**
+   * @brief Create a buffer that starts with the given packet id
+   * @param packet_id Protocol packet id written as a VarInt prefix
+   * @param reserve Number of bytes to reserve up front
+   */
+  explicit PacketBuffer(int32_t packet_id, size_t reserve = 64)
+      : packet_id_(packet_id) {
+    data_.reserve(reserve);
+    WriteVarInt(packet_id);
+  }
+
+  /**
+   * @brief Create a buffer that writes into recycled storage
+   * @param packet_id Protocol packet id written as a VarInt prefix
+   * @param storage Vector whose capacity is reused; its contents are discarded
+   * @see PacketPool::Acquire()
+   */
+  PacketBuffer(int32_t packet_id, std::vector<uint8_t>&& storage)
+      : packet_id_(packet_id), data_(std::move(storage)) {
+    data_.clear();
+    WriteVarInt(packet_id);
+  }
+
+  /** @brief Append a single unsigned byte */
+  void WriteByte(uint8_t value) { data_.push_back(value); }
+
+  /** @brief Append a boolean as 0x00 / 0x01 */
+  void WriteBool(bool value) { data_.push_back(value ? 1 : 0); }
+
+  /** @brief Append a big-endian 16-bit integer */
+  void WriteShort(int16_t value) { WriteBigEndian(static_cast<uint16_t>(value)); }
+
+  /** @brief Append a big-endian 32-bit integer */
+  void WriteInt(int32_t value) { WriteBigEndian(static_cast<uint32_t>(value)); }
+
+  /** @brief Append a big-endian 64-bit integer */
+  void WriteLong(int64_t value) { WriteBigEndian(static_cast<uint64_t>(value)); }
+
+  /** @brief Append an IEEE 754 single precision float */
+  void WriteFloat(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    WriteBigEndian(bits);
+  }
+
+  /** @brief Append an IEEE 754 double precision float */
+  void WriteDouble(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    WriteBigEndian(bits);
+  }
+
+  /**
+   * @brief Append a variable-length 32-bit integer
+   * @param value Value to encode; negative values always take 5 bytes
+   */
+  void WriteVarInt(int32_t value) {
+    uint32_t remaining = static_cast<uint32_t>(value);
+    while (remaining >= 0x80) {
+      data_.push_back(static_cast<uint8_t>(remaining | 0x80));
+      remaining >>= 7;
+    }
+    data_.push_back(static_cast<uint8_t>(remaining));
+  }
+
+  /**
+   * @brief Append a variable-length 64-bit integer
+   * @param value Value to encode; negative values always take 10 bytes
+   */
+  void WriteVarLong(int64_t value) {
+    uint64_t remaining = static_cast<uint64_t>(value);
+    while (remaining >= 0x80) {
+      data_.push_back(static_cast<uint8_t>(remaining | 0x80));
+      remaining >>= 7;
+    }
+    data_.push_back(static_cast<uint8_t>(remaining));
+  }
+
+  /**
+   * @brief Append a VarInt length-prefixed UTF-8 string
+   * @param value UTF-8 encoded string contents
+   */
+  void WriteString(std::string_view value) {
+    WriteVarInt(static_cast<int32_t>(value.size()));
+    data_.insert(data_.end(), value.begin(), value.end());
+  }
+
+  /** @brief Append a UUID as two big-endian 64-bit halves */
+  void WriteUuid(const Util::Uuid& uuid) {
+    WriteBigEndian(uuid.most);
+    WriteBigEndian(uuid.least);
+  }
+
+  /** @brief Append raw bytes without any length prefix */
+  void WriteBytes(std::span<const uint8_t> bytes) {
+    data_.insert(data_.end(), bytes.begin(), bytes.end());
+  }
+
+  /**
+   * @brief Hand the written bytes off without the packet id prefix
+   *
+   * Produces the shared tail of a packet whose head is written per
+   * recipient (see PacketSink::SendPacket(head, tail)). Only meaningful for
+   * buffers created without a packet id.
+   *
+   * @param packet_id Packet id recorded on the tail for logging and metrics
+   * @return SharedPacket owning the buffer contents
+   */
+  SharedPacket FinishTail(int32_t packet_id) {
+    return std::make_shared<const EncodedPacket>(EncodedPacket{packet_id, std::move(data_)});
+  }
+
+  /** @brief Reserve capacity for at least @p bytes additional bytes */
+  void Reserve(size_t bytes) { data_.reserve(data_.size() + bytes); }
+
+  /** @brief Number of bytes written so far, including the packet id */
+  size_t Size() const { return data_.size(); }
+
+  /** @brief Read-only view of the bytes written so far */
+  std::span<const uint8_t> Data() const { return data_; }
+
+  /**
+   * @brief Hand the written bytes off as an immutable shared packet
+   * @return SharedPacket owning the buffer contents
+   * @note The buffer is left empty afterwards.
+   */
+  SharedPacket Finish() {
+    return std::make_shared<const EncodedPacket>(
+        EncodedPacket{packet_id_, std::move(data_)});
+  }
+
+  /**
+   * @brief Hand the raw storage off, e.g. to a PacketPool
+   * @return Written bytes; the buffer is left empty afterwards
+   */
+  std::vector<uint8_t> TakeBytes() { return std::move(data_); }
+
+  /** @brief Packet id given at construction, or -1 */
+  int32_t PacketId() const { return packet_id_; }
+
+  /**
+   * @brief Number of bytes a VarInt encoding of @p value occupies
+   * @param value Value to measure
+   * @return Encoded size in bytes (1-5)
+   */
+  static constexpr size_t VarIntSize(int32_t value) {
+    uint32_t remaining = static_cast<uint32_t>(value);
+    size_t size = 1;
+    while (remaining >= 0x80) {
+      remaining >>= 7;
+      ++size;
+    }
+    return size;
+  }
+
+ private:
+  template <typename T>
+  void WriteBigEndian(T value) {
+    for (int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8) {
+      data_.push_back(static_cast<uint8_t>(value >> shift));
+    }
+  }
+
+  int32_t packet_id_ = -1;
+  std::vector<uint8_t> data_;
+};
+
+}  // namespace Network
@@ -0,0 +1,237 @@
+/**
+ * @file packet_log.h
+ * @brief Sampled binary packet log for protocol debugging in production
+ *
+ * Formatting every packet as a text log line costs more than handling the
+ * packet. PacketLog instead appends a fixed 24-byte binary record per
+ * sampled packet (timestamp, connection, direction, state, packet id,
+ * length) plus, if the packet's rule asks for it, the first bytes of the
+ * payload. Records go straight into memory-mapped files, so logging is a
+ * reservation and a memcpy, the page cache does the I/O, and records
+ * written before a crash survive it.
+ *
+ * The files form a ring: packets-0.pslog ... packets-(N-1).pslog. A
+ * background thread truncates and pre-faults the next file while the
+ * current one fills, and unmaps files once they are full, so neither the
+ * page faults nor the file I/O land on the threads that log. Disk use is
+ * bounded by file_bytes * file_count; the ring holds the file being
+ * written, the prepared next one and file_count - 2 full files of the
+ * most recent traffic. tools/packet_log_decode turns the files back into
+ * text.
+ *
+ * Sampling is decided per direction and packet id: log one in N packets of
+ * that type (1 = all, 0 = none) and capture up to a number of payload
+ * bytes (0 = header only).
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace Network {
+
+/** @brief Which way a packet travelled */
+enum class PacketDirection : uint8_t {
+  SERVERBOUND = 0,  ///< Received from the client
+  CLIENTBOUND = 1,  ///< Sent to the client
+};
+
+/** @brief Protocol state a packet was sent in; packet ids are only unique per state */
+enum class ConnectionState : uint8_t {
+  HANDSHAKING = 0,
+  STATUS = 1,
+  LOGIN = 2,
+  CONFIGURATION = 3,
+  PLAY = 4,
+};
+
+/** @brief "PSPKTLOG" */
+constexpr std::array<char, 8> PACKET_LOG_MAGIC = {'P', 'S', 'P', 'K', 'T', 'L', 'O', 'G'};
+
+/** @brief Version of the file layout below */
+constexpr uint32_t PACKET_LOG_VERSION = 1;
+
+/** @brief Records and their payloads start on multiples of this */
+constexpr size_t PACKET_LOG_ALIGNMENT = 8;
+
+/** @brief Packet ids below this get their own rule; higher ids use the default */
+constexpr int32_t PACKET_LOG_RULE_IDS = 256;
+
+/**
+ * @struct PacketLogFileHeader
+ * @brief First bytes of every log file, in host byte order
+ */
+struct PacketLogFileHeader {
+  std::array<char, 8> magic;   ///< PACKET_LOG_MAGIC
+  uint32_t version;            ///< PACKET_LOG_VERSION
+  uint32_t header_bytes;       ///< sizeof(PacketLogFileHeader); records start here
+  uint64_t sequence;           ///< Increases with every file started; orders the ring
+  uint64_t created_ns;         ///< Unix time the file was started, in nanoseconds
+  uint64_t file_bytes;         ///< Size of the mapping
+  uint32_t minecraft_version;  ///< MINECRAFT_VERSION the server was built for
+  uint32_t reserved = 0;
+  std::array<uint8_t, 16> padding{};
+};
+static_assert(sizeof(PacketLogFileHeader) == 64);
+
+/**
+ * @struct PacketLogRecord
+ * @brief One sampled packet, followed by @ref payload_bytes of its payload
+ *
+ * The payload is padded to PACKET_LOG_ALIGNMENT. A record with a zero
+ * timestamp marks the end of the data in a file.
+ */
+struct PacketLogRecord {
+  uint64_t timestamp_ns;   ///< Unix time in nanoseconds
+  uint32_t connection;     ///< Caller-assigned connection id
+  int32_t packet_id;       ///< Protocol packet id
+  uint32_t length;         ///< Full packet length, which may exceed the captured payload
+  uint16_t payload_bytes;  ///< Payload bytes stored after the record
+  uint8_t direction;       ///< PacketDirection
+  uint8_t state;           ///< ConnectionState
+};
+static_assert(sizeof(PacketLogRecord) == 24);
+
+/**
+ * @struct PacketLogRule
+ * @brief How packets of one type are sampled
+ */
+struct PacketLogRule {
+  uint16_t sample_one_in = 1;  ///< Log one in this many packets; 0 disables the type
+  uint16_t payload_bytes = 0;  ///< Payload bytes to capture; 0 logs headers only
+};
+
+/**
+ * @struct PacketLogConfig
+ * @brief Location and size of the file ring
+ */
+struct PacketLogConfig {
+  std::filesystem::path directory = "packet-log";
+  uint64_t file_bytes = 64ull << 20;  ///< Size of each file; 1 MiB to 256 GiB
+  size_t file_count = 4;              ///< Files in the ring; at least 3
+  PacketLogRule default_rule;         ///< Rule for every type without its own
+};
+
+/**
+ * @struct PacketLogStats
+ * @brief Counters of a PacketLog
+ */
+struct PacketLogStats {
+  uint64_t bytes = 0;      ///< Record bytes written since the log was opened
+  uint64_t rotations = 0;  ///< Files started after the first
+  bool failed = false;     ///< A file could not be created; logging stopped
+};
+
+/**
+ * @class PacketLog
+ * @brief Writer of the binary packet log ring
+ *
+ * @note Thread-safe; Record() is lock-free except for the one call per file
+ *       that switches to the next file, which waits only if the background
+ *       thread has not finished preparing it.
+ *
+ * @example
+ * @code
+ * Network::PacketLogConfig config;
+ * config.directory = "logs/packets";
+ * Network::PacketLog log(config);
+ * log.SetRule(Network::PacketDirection::SERVERBOUND, 0x1D, {.sample_one_in = 100});
+ * log.Record(connection_id, Network::PacketDirection::CLIENTBOUND,
+ *            Network::ConnectionState::PLAY, packet->packet_id, packet->bytes);
+ * @endcode
+ */
+class PacketLog {
+ public:
+  /**
+   * @brief Create the directory, start the first file and the preparing thread
+   * @throws std::invalid_argument If the ring is smaller than allowed
+   * @throws std::runtime_error If the first file cannot be created
+   */
+  explicit PacketLog(PacketLogConfig config);
+  ~PacketLog();
+
+  PacketLog(const PacketLog&) = delete;
+  PacketLog& operator=(const PacketLog&) = delete;
+
+  /** @brief Sampling of one packet type */
+  void SetRule(PacketDirection direction, int32_t packet_id, PacketLogRule rule);
+
+  /** @brief Sampling of every type that has no rule of its own */
+  void SetDefaultRule(PacketLogRule rule);
+
+  /**
+   * @brief Log a packet if its rule samples it
+   * @param connection Connection id
+   * @param direction Which way the packet travelled
+   * @param state Protocol state the packet belongs to
+   * @param packet_id Protocol packet id
+   * @param packet The packet body; its size is recorded as the length and
+   *               the rule decides how much of it is kept
+   * @return True if a record was written
+   */
+  bool Record(uint32_t connection, PacketDirection direction, ConnectionState state,
+              int32_t packet_id, std::span<const uint8_t> packet);
+
+  /** @brief Ask the OS to start writing the current file back to disk */
+  void Flush();
+
+  /** @brief Snapshot of the counters */
+  PacketLogStats GetStats() const;
+
+ private:
+  struct Segment;
+
+  static uint32_t PackRule(PacketLogRule rule);
+
+  /** @brief Truncate, map and pre-fault a file of the ring; false on failure */
+  bool Open(Segment& segment, uint64_t sequence);
+
+  /** @brief Re-measure the cycle counter rate and anchor @p segment's timestamps */
+  void Calibrate(Segment& segment);
+
+  /** @brief Wait for the writers still inside @p segment, then unmap it */
+  void Close(Segment& segment);
+
+  /** @brief Replace @p full with the prepared file, once */
+  void Rotate(Segment* full);
+
+  /** @brief Background thread: retire full files and prepare the next one */
+  void PrepareLoop();
+
+  PacketLogConfig config_;
+  std::vector<std::unique_ptr<Segment>> segments_;
+  std::atomic<Segment*> current_{nullptr};
+
+  // Rules packed as sample_one_in << 16 | payload_bytes, read with one relaxed load
+  std::array<std::array<std::atomic<uint32_t>, PACKET_LOG_RULE_IDS>, 2> rules_;
+  std::atomic<uint32_t> default_rule_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable prepare_wake_;  ///< Wakes the preparing thread
+  std::condition_variable spare_ready_;   ///< Wakes Rotate() waiting for the next file
+  size_t next_index_ = 1;                 ///< Ring index of the next file to prepare
+  uint64_t calibration_ns_ = 0;           ///< Unix time at construction
+  uint64_t calibration_ticks_ = 0;        ///< Cycle counter at construction
+  uint64_t sequence_ = 1;
+  Segment* spare_ = nullptr;
+  std::vector<Segment*> retiring_;
+  bool stopping_ = false;
+  std::atomic<uint64_t> closed_bytes_{0};
+  std::atomic<uint64_t> rotations_{0};
+  std::atomic<bool> failed_{false};
+  std::thread preparer_;
+};
+
+}  // namespace Network
@@ -0,0 +1,112 @@
+/**
+ * @file packet_pool.h
+ * @brief Recycling of packet byte buffers, packet objects and their control blocks
+ *
+ * Every packet the server sends used to cost three heap allocations: the
+ * byte vector, the EncodedPacket and the shared_ptr control block. A
+ * PacketPool keeps all three. Buffers are segregated into capacity classes
+ * so a 10-byte Block Update never pins a 60 KiB chunk buffer and a chunk
+ * packet never starts from a buffer it must regrow. When the last
+ * reference to a pooled SharedPacket is dropped (usually on a network
+ * thread, after the write completed), the packet returns to its pool
+ * instead of being freed.
+ *
+ * In steady state a tick that sends the same mix of packets as the
+ * previous one does not touch the heap for packets.
+ *
+ * Finished packets and idle buffers are accounted to
+ * Util::MemorySubsystem::NETWORK. While that subsystem is over its budget
+ * returned buffers are freed instead of kept, and producers of optional
+ * traffic should hold back until Util::OverMemoryBudget() clears.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "network/encoded_packet.h"
+#include "network/packet_buffer.h"
+
+namespace Network {
+
+/** @brief Capacities of the buffer classes; larger buffers are never pooled */
+constexpr std::array<size_t, 6> PACKET_POOL_CLASSES = {64, 256, 1024, 4096, 16384, 65536};
+
+/**
+ * @struct PacketPoolConfig
+ * @brief Retention limits of a PacketPool
+ */
+struct PacketPoolConfig {
+  size_t max_buffers_per_class = 4096;  ///< Idle buffers kept per capacity class
+  size_t max_packets = 4096;            ///< Idle packet objects and control blocks kept
+};
+
+/**
+ * @struct PacketPoolStats
+ * @brief Counters of a PacketPool
+ */
+struct PacketPoolStats {
+  uint64_t acquired = 0;           ///< Acquire() calls
+  uint64_t buffers_reused = 0;     ///< Served from a capacity class
+  uint64_t buffers_allocated = 0;  ///< Served by a new vector
+  uint64_t packets_reused = 0;     ///< Finish() calls served without allocating
+  uint64_t recycled = 0;           ///< Packets returned after their last reference
+  uint64_t discarded = 0;          ///< Buffers freed: oversized, class full or over the network budget
+};
+
+/**
+ * @class PacketPool
+ * @brief Type- and size-segregated pool behind PacketBuffer and SharedPacket
+ *
+ * @note Thread-safe. Acquire() and Finish() are normally called by the tick
+ *       thread, while packets return from whichever thread drops the last
+ *       reference. Pooled packets may outlive the pool object.
+ *
+ * @example
+ * @code
+ * Network::PacketBuffer buffer = pool.Acquire(Protocol::Play::Clientbound::BLOCK_UPDATE, 16);
+ * buffer.WriteLong(position.Encode());
+ * buffer.WriteVarInt(state_id);
+ * Network::SharedPacket packet = pool.Finish(buffer);
+ * @endcode
+ */
+class PacketPool {
+ public:
+  explicit PacketPool(PacketPoolConfig config = {});
+
+  PacketPool(const PacketPool&) = delete;
+  PacketPool& operator=(const PacketPool&) = delete;
+
+  /**
+   * @brief Start a packet in recycled storage
+   * @param packet_id Protocol packet id
+   * @param size_hint Expected encoded size; selects the capacity class
+   * @return Buffer with the packet id already written
+   */
+  PacketBuffer Acquire(int32_t packet_id, size_t size_hint = 64);
+
+  /**
+   * @brief Seal a buffer into a pooled shared packet
+   * @param buffer Buffer from Acquire(); left empty
+   * @return Packet that returns to this pool when its last reference drops
+   */
+  SharedPacket Finish(PacketBuffer& buffer);
+
+  /** @brief Snapshot of the counters */
+  PacketPoolStats GetStats() const;
+
+ private:
+  struct State;
+  struct Recycler;
+  template <typename T>
+  struct BlockAllocator;
+
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace Network
@@ -0,0 +1,201 @@
+/**
+ * @file player_data_store.h
+ * @brief Asynchronous player data persistence with login prefetch
+ *
+ * Loading starts as soon as the login handshake reveals the player's UUID
+ * (Prefetch()), so disk reads overlap encryption, authentication and the
+ * configuration phase. By the time the player spawns the result is usually
+ * ready and the tick thread only polls a future.
+ *
+ * Saves take a value snapshot on the tick thread and write it on the I/O
+ * pool: serialize, write and fsync "<uuid>.dat.tmp", rename it over
+ * "<uuid>.dat" and fsync the directory, so neither a crash nor a power loss
+ * leaves a torn file. At most one write per player is in
+ * flight; snapshots queued behind it are coalesced so only the newest is
+ * written. A prefetch for a player whose save has not reached disk yet is
+ * answered from that snapshot.
+ *
+ * File format (big-endian): magic "PSPD", u16 version, the PlayerData
+ * fields, then an FNV-1a 64 checksum of everything before it.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "inventory/item_stack.h"
+#include "util/uuid.h"
+#include "util/worker_pool.h"
+
+namespace Player {
+
+/**
+ * @struct InventoryEntry
+ * @brief A non-empty slot of the player inventory
+ */
+struct InventoryEntry {
+  int32_t slot = 0;
+  Inventory::ItemStack stack;
+};
+
+/**
+ * @struct PlayerData
+ * @brief Persistent state of a player
+ */
+struct PlayerData {
+  Util::Uuid uuid;
+  std::string dimension = "minecraft:overworld";
+  double x = 0, y = 0, z = 0;
+  float yaw = 0, pitch = 0;
+  float health = 20;
+  int32_t food = 20;
+  float saturation = 5;
+  int32_t experience_level = 0;
+  int32_t experience_total = 0;
+  int32_t game_mode = 0;
+  int32_t selected_slot = 0;
+  std::vector<InventoryEntry> inventory;
+  std::vector<std::pair<int32_t, int32_t>> statistics;  ///< (statistic id, value)
+};
+
+/**
+ * @enum LoadStatus
+ * @brief Outcome of loading a player
+ */
+enum class LoadStatus : uint8_t {
+  LOADED,      ///< Read from disk or from a pending save
+  NEW_PLAYER,  ///< No file; defaults returned
+  CORRUPT,     ///< Bad magic, version or checksum
+  IO_ERROR,    ///< File exists but could not be read
+};
+
+/**
+ * @struct LoadResult
+ * @brief Loaded data and how it was obtained
+ */
+struct LoadResult {
+  LoadStatus status = LoadStatus::NEW_PLAYER;
+  PlayerData data;
+  uint64_t load_micros = 0;  ///< Time from Prefetch() to completion
+};
+
+/**
+ * @struct PlayerDataStats
+ * @brief Counters of a PlayerDataStore
+ */
+struct PlayerDataStats {
+  uint64_t loads = 0;
+  uint64_t loads_from_pending_save = 0;
+  uint64_t load_failures = 0;     ///< CORRUPT or IO_ERROR
+  uint64_t saves_requested = 0;
+  uint64_t saves_written = 0;
+  uint64_t saves_coalesced = 0;   ///< Snapshots replaced before being written
+  uint64_t save_failures = 0;
+  uint64_t bytes_written = 0;
+};
+
+/**
+ * @class PlayerDataStore
+ * @brief Loads and saves player data on a worker pool
+ *
+ * @note All methods are thread-safe. The store must outlive the tasks it
+ *       posted; call Flush() before destroying it.
+ *
+ * @example
+ * @code
+ * // Login Start handler (network thread):
+ * auto pending = store.Prefetch(uuid);
+ * // ... encryption, configuration ...
+ * // Tick thread, once configuration finished:
+ * if (pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+ *   SpawnPlayer(pending.get().data);
+ * }
+ * // Autosave and disconnect:
+ * store.Save(SnapshotOf(player));
+ * @endcode
+ */
+class PlayerDataStore {
+ public:
+  /**
+   * @brief Create a store
+   * @param directory Directory holding "<uuid>.dat" files; created if missing
+   * @param io Pool used for disk access
+   */
+  PlayerDataStore(std::filesystem::path directory, Util::WorkerPool& io);
+
+  PlayerDataStore(const PlayerDataStore&) = delete;
+  PlayerDataStore& operator=(const PlayerDataStore&) = delete;
+
+  /**
+   * @brief Start loading a player, or return the load already in progress
+   * @param uuid Player UUID from Login Start
+   * @return Future completed on the I/O pool
+   */
+  std::shared_future<LoadResult> Prefetch(const Util::Uuid& uuid);
+
+  /**
+   * @brief Forget a prefetched result (disconnect before spawn, or after spawn)
+   * @param uuid Player UUID
+   */
+  void Release(const Util::Uuid& uuid);
+
+  /**
+   * @brief Queue a snapshot for writing
+   * @param snapshot Copy of the player's state taken on the tick thread
+   */
+  void Save(PlayerData snapshot);
+
+  /** @brief Block until every queued save has been written */
+  void Flush();
+
+  /** @brief Snapshot of the counters */
+  PlayerDataStats GetStats() const;
+
+  /**
+   * @brief Serialize player data in the store's file format
+   * @param data Data to encode
+   * @return File contents including the checksum
+   */
+  static std::vector<uint8_t> Serialize(const PlayerData& data);
+
+  /**
+   * @brief Parse the store's file format
+   * @param bytes File contents
+   * @return Parsed data, or std::nullopt when the file is corrupt
+   */
+  static std::optional<PlayerData> Deserialize(std::span<const uint8_t> bytes);
+
+ private:
+  struct PendingSave {
+    std::optional<PlayerData> queued;  ///< Next snapshot to write
+    std::optional<PlayerData> writing; ///< Snapshot currently being written
+  };
+
+  std::filesystem::path PathOf(const Util::Uuid& uuid) const;
+  LoadResult LoadFromDisk(const Util::Uuid& uuid) const;
+  void WriteLoop(Util::Uuid uuid);
+  size_t WriteFile(const PlayerData& data) const;
+
+  std::filesystem::path directory_;
+  Util::WorkerPool& io_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable saves_done_;
+  std::unordered_map<Util::Uuid, std::shared_future<LoadResult>, Util::UuidHash> loads_;
+  std::unordered_map<Util::Uuid, PendingSave, Util::UuidHash> saves_;
+  PlayerDataStats stats_;
+};
+
+}  // namespace Player
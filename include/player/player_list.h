@@ -0,0 +1,204 @@
+/**
+ * @file player_list.h
+ * @brief Tab list state with per-tick batched Player Info packets
+ *
+ * Joins, leaves and per-player changes (latency, game mode, display name,
+ * ...) are recorded as pending action bits on the affected entry instead of
+ * being sent immediately. At tick end all removals become one Player Info
+ * Remove packet, and all pending entries are grouped by their action set
+ * into as few Player Info Update packets as possible (one per distinct set,
+ * typically "joined" and "latency changed"). Every packet is encoded once
+ * and shared by all recipients.
+ *
+ * A player that joins and leaves within the same tick never reaches the
+ * wire. The encoded profile (name and properties) of each entry is kept, so
+ * snapshots for joining players do not re-serialize skins.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "network/encoded_packet.h"
+#include "protocol/version.h"
+#include "util/uuid.h"
+
+/**
+ * @namespace Player
+ * @brief Player sessions and the state shared between them
+ */
+namespace Player {
+
+/**
+ * @enum PlayerInfoAction
+ * @brief Action bits of the Player Info Update packet
+ */
+enum PlayerInfoAction : uint8_t {
+  ADD_PLAYER = 0x01,
+  INITIALIZE_CHAT = 0x02,
+  UPDATE_GAME_MODE = 0x04,
+  UPDATE_LISTED = 0x08,
+  UPDATE_LATENCY = 0x10,
+  UPDATE_DISPLAY_NAME = 0x20,
+  UPDATE_LIST_PRIORITY = 0x40,  ///< 1.21.2+
+  UPDATE_HAT = 0x80,            ///< 1.21.4+
+};
+
+/** @brief Every action understood by the target version */
+#if MINECRAFT_VERSION >= 121400
+constexpr uint8_t ALL_PLAYER_INFO_ACTIONS = 0xFF;
+#elif MINECRAFT_VERSION >= 121200
+constexpr uint8_t ALL_PLAYER_INFO_ACTIONS = 0x7F;
+#else
+constexpr uint8_t ALL_PLAYER_INFO_ACTIONS = 0x3F;
+#endif
+
+/**
+ * @struct ProfileProperty
+ * @brief Game profile property, e.g. "textures"
+ */
+struct ProfileProperty {
+  std::string name;
+  std::string value;
+  std::optional<std::string> signature;
+};
+
+/**
+ * @struct ChatSessionData
+ * @brief Player's chat signing session (from the Player Session packet)
+ */
+struct ChatSessionData {
+  Util::Uuid session_id;
+  int64_t expires_at = 0;            ///< Public key expiry, ms since the Unix epoch
+  std::vector<uint8_t> public_key;   ///< X.509 encoded key
+  std::vector<uint8_t> key_signature;
+};
+
+/**
+ * @struct PlayerListEntry
+ * @brief Everything the tab list shows about one player
+ */
+struct PlayerListEntry {
+  Util::Uuid uuid;
+  std::string name;
+  std::vector<ProfileProperty> properties;
+  std::optional<ChatSessionData> chat_session;
+  int32_t game_mode = 0;
+  bool listed = true;
+  int32_t latency = 0;                      ///< Milliseconds
+  std::optional<std::string> display_name;  ///< Plain text, nullopt shows the name
+  int32_t list_priority = 0;
+  bool show_hat = true;
+};
+
+/**
+ * @struct PlayerListStats
+ * @brief Traffic counters of a PlayerList
+ */
+struct PlayerListStats {
+  uint64_t update_packets = 0;
+  uint64_t remove_packets = 0;
+  uint64_t entries_sent = 0;        ///< Entries across all update packets
+  uint64_t cancelled_joins = 0;     ///< Players that joined and left within one tick
+  uint64_t bytes_encoded = 0;       ///< Before fan-out
+};
+
+/**
+ * @class PlayerList
+ * @brief Server-wide tab list coalescing Player Info packets per tick
+ *
+ * @note Not thread-safe; owned by the tick thread.
+ *
+ * @example
+ * @code
+ * players.Add(std::move(entry));
+ * players.SetLatency(uuid, 42);
+ * // ... end of tick
+ * players.Flush([&](const Network::SharedPacket& packet) {
+ *   for (Network::PacketSink* sink : connections) sink->SendPacket(packet);
+ * });
+ * joining_connection.SendPacket(players.SnapshotPacket());
+ * @endcode
+ */
+class PlayerList {
+ public:
+  /** @brief Receives every packet produced by Flush() */
+  using BroadcastFunction = std::function<void(const Network::SharedPacket& packet)>;
+
+  /**
+   * @brief Add a player; announced with every action at the next flush
+   * @param entry Initial tab list state; replaces an entry with the same UUID
+   */
+  void Add(PlayerListEntry entry);
+
+  /**
+   * @brief Remove a player
+   * @param uuid Player to remove
+   * @return False when the player is not listed
+   */
+  bool Remove(const Util::Uuid& uuid);
+
+  /** @name Field updates; a no-op when the value is unchanged or the player unknown */
+  ///@{
+  void SetChatSession(const Util::Uuid& uuid, std::optional<ChatSessionData> session);
+  void SetGameMode(const Util::Uuid& uuid, int32_t game_mode);
+  void SetListed(const Util::Uuid& uuid, bool listed);
+  void SetLatency(const Util::Uuid& uuid, int32_t latency);
+  void SetDisplayName(const Util::Uuid& uuid, std::optional<std::string> display_name);
+  void SetListPriority(const Util::Uuid& uuid, int32_t list_priority);
+  void SetShowHat(const Util::Uuid& uuid, bool show_hat);
+  ///@}
+
+  /** @brief Current state of a player, or nullptr */
+  const PlayerListEntry* Find(const Util::Uuid& uuid) const;
+
+  /** @brief Number of listed players */
+  size_t Size() const { return records_.size(); }
+
+  /**
+   * @brief Encode the pending removals and updates of this tick
+   * @param broadcast Invoked with the remove packet first, then each update packet
+   * @return Number of packets produced
+   *
+   * Recipients that join this tick should receive SnapshotPacket() after
+   * the flush instead of the broadcast.
+   */
+  size_t Flush(const BroadcastFunction& broadcast);
+
+  /**
+   * @brief Full tab list for a joining player
+   * @return Player Info Update with every action for every entry, or nullptr when empty
+   * @note Reflects the state as of the last Flush() plus any pending changes.
+   */
+  Network::SharedPacket SnapshotPacket();
+
+  /** @brief Cumulative traffic counters */
+  const PlayerListStats& GetStats() const { return stats_; }
+
+ private:
+  struct Record {
+    PlayerListEntry entry;
+    std::vector<uint8_t> profile;  ///< Encoded name and properties (ADD_PLAYER data)
+    uint8_t pending = 0;
+  };
+
+  template <typename Field, typename Value>
+  void Update(const Util::Uuid& uuid, Field PlayerListEntry::*field, Value&& value,
+              PlayerInfoAction action);
+  void MarkPending(Record& record, uint8_t actions);
+  Network::SharedPacket EncodeUpdate(uint8_t actions, const std::vector<const Record*>& records);
+
+  std::unordered_map<Util::Uuid, Record, Util::UuidHash> records_;
+  std::vector<Util::Uuid> dirty_;     ///< Entries with pending actions
+  std::vector<Util::Uuid> removed_;   ///< Removals not yet sent
+  PlayerListStats stats_;
+};
+
+}  // namespace Player
@@ -0,0 +1,145 @@
+/**
+ * @file event_bus.h
+ * @brief Event dispatch to native plugin and server handlers
+ *
+ * Handlers are kept in one contiguous array per event type, sorted by
+ * priority when they are registered. Dispatch is a template on the event
+ * type, so the array is selected at compile time and a dispatch is a plain
+ * loop of indirect calls: no lookup, no virtual call, no allocation.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "plugin/plugin_abi.h"
+
+/**
+ * @namespace Plugin
+ * @brief Native plugin loading and the event bus
+ */
+namespace Plugin {
+
+/**
+ * @enum EventType
+ * @brief C++ view of ps_event_type
+ */
+enum class EventType : uint32_t {
+  BLOCK_PLACE = PS_EVENT_BLOCK_PLACE,
+  BLOCK_BREAK = PS_EVENT_BLOCK_BREAK,
+  PLAYER_JOIN = PS_EVENT_PLAYER_JOIN,
+  PLAYER_QUIT = PS_EVENT_PLAYER_QUIT,
+  PLAYER_CHAT = PS_EVENT_PLAYER_CHAT,
+};
+
+/** @brief Number of event types */
+constexpr size_t EVENT_TYPE_COUNT = PS_EVENT_COUNT;
+
+/** @brief Maps an event type to its ABI struct */
+template <EventType Type>
+struct EventTraits;
+
+template <>
+struct EventTraits<EventType::BLOCK_PLACE> {
+  using Data = ps_block_event;
+};
+template <>
+struct EventTraits<EventType::BLOCK_BREAK> {
+  using Data = ps_block_event;
+};
+template <>
+struct EventTraits<EventType::PLAYER_JOIN> {
+  using Data = ps_player_event;
+};
+template <>
+struct EventTraits<EventType::PLAYER_QUIT> {
+  using Data = ps_player_event;
+};
+template <>
+struct EventTraits<EventType::PLAYER_CHAT> {
+  using Data = ps_chat_event;
+};
+
+/** @brief Identifies who registered a handler, so it can be removed on unload */
+using PluginId = uint32_t;
+
+/** @brief Owner id of handlers registered by the server itself */
+constexpr PluginId SERVER_PLUGIN = 0;
+
+/**
+ * @class EventBus
+ * @brief Priority-ordered handler arrays per event type
+ *
+ * @note Not thread-safe. Handlers are registered and removed on the tick
+ *       thread, never from inside a handler, and events are dispatched on
+ *       the tick thread.
+ *
+ * @example
+ * @code
+ * Plugin::EventBus bus;
+ * bus.Subscribe(Plugin::EventType::BLOCK_PLACE, PS_PRIORITY_NORMAL, &DenySpawnEdits, &spawn);
+ * ps_block_event event{};
+ * event.x = x; event.y = y; event.z = z; event.state_id = state;
+ * if (!bus.Dispatch<Plugin::EventType::BLOCK_PLACE>(event)) {
+ *   RevertPlacement();
+ * }
+ * @endcode
+ */
+class EventBus {
+ public:
+  /**
+   * @brief Register a handler
+   * @param type Event to handle
+   * @param priority Lower runs first; equal priorities run in registration order
+   * @param handler Handler function
+   * @param user_data Passed to every call
+   * @param owner Plugin that owns the handler
+   */
+  void Subscribe(EventType type, int32_t priority, ps_event_handler handler, void* user_data,
+                 PluginId owner = SERVER_PLUGIN);
+
+  /**
+   * @brief Remove every handler of a plugin
+   * @param owner Plugin whose handlers are removed
+   * @return Number of handlers removed
+   */
+  size_t UnsubscribeAll(PluginId owner);
+
+  /**
+   * @brief Run the handlers of an event
+   * @param event Event data; header.type is filled in and header.cancelled updated
+   * @return True when no handler cancelled the event
+   */
+  template <EventType Type>
+  bool Dispatch(typename EventTraits<Type>::Data& event) const {
+    event.header.type = static_cast<uint32_t>(Type);
+    for (const Handler& handler : handlers_[static_cast<size_t>(Type)]) {
+      if (handler.function(handler.user_data, &event) == PS_EVENT_CANCEL) {
+        event.header.cancelled = 1;
+      }
+    }
+    return event.header.cancelled == 0;
+  }
+
+  /** @brief True when at least one handler listens to @p type */
+  bool HasHandlers(EventType type) const { return !handlers_[static_cast<size_t>(type)].empty(); }
+
+  /** @brief Number of handlers registered for @p type */
+  size_t HandlerCount(EventType type) const { return handlers_[static_cast<size_t>(type)].size(); }
+
+ private:
+  struct Handler {
+    ps_event_handler function;
+    void* user_data;
+    int32_t priority;
+    PluginId owner;
+  };
+
+  std::array<std::vector<Handler>, EVENT_TYPE_COUNT> handlers_;
+};
+
+}  // namespace Plugin
@@ -0,0 +1,145 @@
+/**
+ * @file plugin_abi.h
+ * @brief Stable C ABI between the server and native plugins
+ *
+ * Native plugins are shared libraries exporting one function,
+ * ps_plugin_entry(), that returns a static ps_plugin_info. Everything that
+ * crosses the library boundary is a plain C type, so plugins can be built
+ * with any compiler (or language) that produces C-compatible symbols and do
+ * not depend on the server's C++ standard library or class layouts.
+ *
+ * Compatibility rules: new fields are only appended to structs, every
+ * struct that may grow carries its size, and PS_PLUGIN_ABI_VERSION is bumped
+ * for any incompatible change. The server refuses plugins built against a
+ * different ABI version.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief ABI version implemented by this header */
+#define PS_PLUGIN_ABI_VERSION 1u
+
+/** @brief Name of the symbol every plugin exports */
+#define PS_PLUGIN_ENTRY_SYMBOL "ps_plugin_entry"
+
+#if defined(_WIN32)
+#define PS_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define PS_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+/** @brief Events plugins can subscribe to */
+typedef enum ps_event_type {
+  PS_EVENT_BLOCK_PLACE = 0,
+  PS_EVENT_BLOCK_BREAK = 1,
+  PS_EVENT_PLAYER_JOIN = 2,
+  PS_EVENT_PLAYER_QUIT = 3,
+  PS_EVENT_PLAYER_CHAT = 4,
+  PS_EVENT_COUNT
+} ps_event_type;
+
+/** @brief Handler return values */
+typedef enum ps_event_result {
+  PS_EVENT_CONTINUE = 0,  /**< Leave the event as it is */
+  PS_EVENT_CANCEL = 1,    /**< Cancel the event; later handlers still run */
+} ps_event_result;
+
+/** @brief Handler priorities; lower runs first */
+typedef enum ps_event_priority {
+  PS_PRIORITY_LOWEST = -200,
+  PS_PRIORITY_LOW = -100,
+  PS_PRIORITY_NORMAL = 0,
+  PS_PRIORITY_HIGH = 100,
+  PS_PRIORITY_HIGHEST = 200,
+  PS_PRIORITY_MONITOR = 300,  /**< Observe the outcome; must not modify the event */
+} ps_event_priority;
+
+/** @brief Log levels accepted by ps_host_api::log */
+typedef enum ps_log_level {
+  PS_LOG_DEBUG = 0,
+  PS_LOG_INFO = 1,
+  PS_LOG_WARN = 2,
+  PS_LOG_ERROR = 3,
+} ps_log_level;
+
+/** @brief UUID as two big-endian halves */
+typedef struct ps_uuid {
+  uint64_t most;
+  uint64_t least;
+} ps_uuid;
+
+/** @brief Common first member of every event */
+typedef struct ps_event_header {
+  uint32_t type;       /**< ps_event_type */
+  uint32_t cancelled;  /**< Non-zero once a handler returned PS_EVENT_CANCEL */
+} ps_event_header;
+
+/** @brief PS_EVENT_BLOCK_PLACE and PS_EVENT_BLOCK_BREAK */
+typedef struct ps_block_event {
+  ps_event_header header;
+  ps_uuid player;
+  int32_t x, y, z;
+  int32_t state_id;  /**< Placed state, or the state being broken */
+} ps_block_event;
+
+/** @brief PS_EVENT_PLAYER_JOIN and PS_EVENT_PLAYER_QUIT */
+typedef struct ps_player_event {
+  ps_event_header header;
+  ps_uuid player;
+  const char* name;  /**< UTF-8, valid for the duration of the call */
+} ps_player_event;
+
+/** @brief PS_EVENT_PLAYER_CHAT */
+typedef struct ps_chat_event {
+  ps_event_header header;
+  ps_uuid player;
+  const char* message;  /**< UTF-8, not NUL-terminated, valid for the duration of the call */
+  size_t length;
+} ps_chat_event;
+
+/**
+ * @brief Event handler
+ * @param user_data Pointer given at registration
+ * @param event Event struct matching the registered type, starting with ps_event_header
+ * @return ps_event_result
+ */
+typedef int32_t (*ps_event_handler)(void* user_data, void* event);
+
+/** @brief Services the server offers to a plugin */
+typedef struct ps_host_api {
+  uint32_t abi_version;  /**< PS_PLUGIN_ABI_VERSION of the server */
+  uint32_t size;         /**< sizeof(ps_host_api) of the server */
+  void* host;            /**< Opaque, pass back to every call */
+
+  /** @return 0 on success, -1 for an unknown event type */
+  int32_t (*register_handler)(void* host, uint32_t event_type, int32_t priority,
+                              ps_event_handler handler, void* user_data);
+  void (*log)(void* host, int32_t level, const char* message);
+} ps_host_api;
+
+/** @brief Plugin description returned by ps_plugin_entry() */
+typedef struct ps_plugin_info {
+  uint32_t abi_version;  /**< Must be PS_PLUGIN_ABI_VERSION */
+  const char* name;
+  const char* version;
+  /** @return 0 on success; non-zero aborts loading */
+  int32_t (*on_enable)(const ps_host_api* host);
+  /** @brief Called before unloading; may be NULL */
+  void (*on_disable)(void);
+} ps_plugin_info;
+
+/** @brief Signature of the exported entry point */
+typedef const ps_plugin_info* (*ps_plugin_entry_fn)(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
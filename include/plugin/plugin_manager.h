@@ -0,0 +1,111 @@
+/**
+ * @file plugin_manager.h
+ * @brief Loading and unloading of native plugins
+ *
+ * A plugin is a shared library exporting ps_plugin_entry() (see
+ * plugin_abi.h). Loading resolves that symbol, checks the ABI version and
+ * calls on_enable() with a ps_host_api bound to the plugin, so every handler
+ * it registers is owned by it and removed when it is unloaded.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "plugin/event_bus.h"
+#include "plugin/plugin_abi.h"
+
+namespace Plugin {
+
+/**
+ * @struct PluginDescription
+ * @brief Public information about a loaded plugin
+ */
+struct PluginDescription {
+  PluginId id = SERVER_PLUGIN;
+  std::string name;
+  std::string version;
+  std::filesystem::path path;
+};
+
+/**
+ * @class PluginManager
+ * @brief Owns loaded plugin libraries
+ *
+ * @note Not thread-safe; used from the tick thread like the EventBus.
+ *
+ * @example
+ * @code
+ * Plugin::EventBus bus;
+ * Plugin::PluginManager plugins(bus);
+ * plugins.LoadDirectory("plugins");
+ * @endcode
+ */
+class PluginManager {
+ public:
+  /**
+   * @brief Create a manager registering plugin handlers on @p bus
+   * @param bus Event bus; must outlive the manager
+   */
+  explicit PluginManager(EventBus& bus);
+
+  /** @brief Unloads every plugin */
+  ~PluginManager();
+
+  PluginManager(const PluginManager&) = delete;
+  PluginManager& operator=(const PluginManager&) = delete;
+
+  /**
+   * @brief Load and enable a plugin
+   * @param path Shared library
+   * @return Id of the plugin
+   * @throws std::runtime_error When the library cannot be opened, has no
+   *         entry point, was built for another ABI version or fails to enable
+   */
+  PluginId Load(const std::filesystem::path& path);
+
+  /**
+   * @brief Load every shared library in a directory
+   * @param directory Plugin directory; missing directories load nothing
+   * @return Number of plugins loaded; failures are logged and skipped
+   */
+  size_t LoadDirectory(const std::filesystem::path& directory);
+
+  /**
+   * @brief Disable and unload a plugin
+   * @param id Plugin id returned by Load()
+   * @return False when no such plugin is loaded
+   */
+  bool Unload(PluginId id);
+
+  /** @brief Unload every plugin, most recently loaded first */
+  void UnloadAll();
+
+  /** @brief Loaded plugins in load order */
+  std::vector<PluginDescription> Plugins() const;
+
+ private:
+  struct LoadedPlugin {
+    PluginDescription description;
+    void* library = nullptr;
+    const ps_plugin_info* info = nullptr;
+    ps_host_api api{};
+    EventBus* bus = nullptr;
+  };
+
+  static int32_t RegisterHandler(void* host, uint32_t event_type, int32_t priority,
+                                 ps_event_handler handler, void* user_data);
+  static void Log(void* host, int32_t level, const char* message);
+  void Close(LoadedPlugin& plugin);
+
+  EventBus& bus_;
+  std::vector<std::unique_ptr<LoadedPlugin>> plugins_;  ///< Stable addresses for api.host
+  PluginId next_id_ = SERVER_PLUGIN + 1;
+};
+
+}  // namespace Plugin
@@ -0,0 +1,167 @@
+/**
+ * @file wasm_plugin_host.h
+ * @brief Sandboxed WebAssembly plugins on the event bus
+ *
+ * Third-party plugins that should not run native code in the server process
+ * are shipped as WebAssembly modules and executed by WAMR (WebAssembly Micro
+ * Runtime). A module is either bytecode (.wasm, interpreted) or compiled ahead
+ * of time with wamrc (.aot, native speed); both load through Load().
+ *
+ * Modules see a deliberately narrow host API, imported from module "ps":
+ *   - subscribe(i32 event_type, i32 priority) -> i32: 0 on success
+ *   - log(i32 level, i32 text, i32 length)
+ * and export:
+ *   - ps_plugin_init() -> i32: called once, subscribes; non-zero aborts loading
+ *   - ps_on_event(i32 type, i32 event, i32 length) -> i32: PS_EVENT_CANCEL to cancel
+ *
+ * Events are copied into a buffer in the module's linear memory, laid out
+ * little-endian: u32 type, u32 cancelled, u64 uuid most, u64 uuid least,
+ * then for block events i32 x, y, z, state_id, and for player and chat events
+ * u32 length followed by the UTF-8 name or message (truncated to the buffer).
+ *
+ * Every call is timed. A plugin whose handlers used more than its per-tick
+ * budget skips events until the next BeginTick(); a call running longer than
+ * the call timeout is terminated by a watchdog thread and counts as a trap;
+ * a plugin reaching the trap limit is disabled.
+ *
+ * The runtime is only compiled with -DPARELLELSTONE_WASM_PLUGINS=ON (vcpkg
+ * feature "wasm-plugins"). Otherwise Available() returns false and Load()
+ * throws.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "plugin/event_bus.h"
+
+namespace Plugin {
+
+/** @brief First PluginId handed to WebAssembly plugins; native plugins count up from 1 */
+constexpr PluginId WASM_PLUGIN_ID_BASE = 0x80000000u;
+
+/**
+ * @struct WasmLimits
+ * @brief Resource limits applied to every WebAssembly plugin
+ */
+struct WasmLimits {
+  uint32_t stack_size = 64 * 1024;               ///< Operand and native stack, bytes
+  uint32_t heap_size = 1024 * 1024;              ///< Module heap, bytes
+  uint32_t event_buffer_size = 4096;             ///< Event copy buffer in linear memory
+  std::chrono::microseconds call_timeout{5000};  ///< Single call before termination
+  std::chrono::microseconds tick_budget{2000};   ///< CPU time per tick across calls
+  uint32_t max_traps = 3;                        ///< Traps and timeouts before disabling
+};
+
+/**
+ * @struct WasmPluginStats
+ * @brief CPU accounting of one WebAssembly plugin
+ */
+struct WasmPluginStats {
+  uint64_t events = 0;             ///< Calls into ps_on_event
+  uint64_t cancelled = 0;          ///< Calls that returned PS_EVENT_CANCEL
+  uint64_t cpu_nanos = 0;          ///< Total wall time inside the module
+  uint64_t max_call_nanos = 0;
+  uint64_t over_budget_skips = 0;  ///< Events skipped because the tick budget was spent
+  uint64_t timeouts = 0;           ///< Calls terminated by the watchdog
+  uint64_t traps = 0;              ///< Calls that trapped, including timeouts
+  bool disabled = false;
+};
+
+/**
+ * @class WasmPluginHost
+ * @brief Loads WebAssembly plugins and bridges them to an EventBus
+ *
+ * @note Only one host may exist per process (the runtime is global). Load,
+ *       Unload, BeginTick and event dispatch happen on the tick thread.
+ *
+ * @example
+ * @code
+ * Plugin::WasmPluginHost wasm(bus);
+ * wasm.Load("plugins/protect-spawn.aot");
+ * // every tick:
+ * wasm.BeginTick();
+ * @endcode
+ */
+class WasmPluginHost {
+ public:
+  /**
+   * @brief Initialize the runtime and start the watchdog
+   * @param bus Event bus; must outlive the host
+   * @param limits Limits applied to every plugin
+   * @throws std::runtime_error When the runtime cannot be initialized
+   */
+  explicit WasmPluginHost(EventBus& bus, WasmLimits limits = {});
+
+  /** @brief Unloads every plugin and shuts the runtime down */
+  ~WasmPluginHost();
+
+  WasmPluginHost(const WasmPluginHost&) = delete;
+  WasmPluginHost& operator=(const WasmPluginHost&) = delete;
+
+  /** @brief True when the server was built with the WebAssembly runtime */
+  static bool Available();
+
+  /**
+   * @brief Load, instantiate and initialize a module
+   * @param path .wasm bytecode or .aot module
+   * @return Id owning the plugin's handlers
+   * @throws std::runtime_error When the module is invalid, lacks the required
+   *         exports, traps or fails in ps_plugin_init
+   */
+  PluginId Load(const std::filesystem::path& path);
+
+  /**
+   * @brief Remove a plugin and its handlers
+   * @param id Id returned by Load()
+   * @return False when no such plugin is loaded
+   */
+  bool Unload(PluginId id);
+
+  /** @brief Start a new tick: refills every plugin's CPU budget */
+  void BeginTick();
+
+  /**
+   * @brief CPU accounting of a plugin
+   * @param id Id returned by Load()
+   * @return Counters, or zeroes for an unknown id
+   */
+  WasmPluginStats GetStats(PluginId id) const;
+
+ private:
+  struct Module;
+
+  /** @name Native imports of module "ps"; @p exec_env is a wasm_exec_env_t */
+  ///@{
+  static int32_t Subscribe(void* exec_env, int32_t event_type, int32_t priority);
+  static void Log(void* exec_env, int32_t level, const char* text, uint32_t length);
+  ///@}
+
+  static int32_t HandleEvent(void* user_data, void* event);
+  bool Call(Module& module, void* function, uint32_t argc, uint32_t* argv);
+  void WatchdogLoop();
+
+  EventBus& bus_;
+  WasmLimits limits_;
+  std::vector<std::unique_ptr<Module>> modules_;
+  PluginId next_id_ = WASM_PLUGIN_ID_BASE;
+  std::thread::id runtime_thread_;
+
+  std::atomic<Module*> running_{nullptr};      ///< Module inside a call, for the watchdog
+  std::atomic<int64_t> running_since_{0};      ///< steady_clock nanoseconds
+  std::atomic<bool> stop_{false};
+  std::mutex watchdog_mutex_;                  ///< Held while the watchdog terminates a call
+  std::thread watchdog_;
+};
+
+}  // namespace Plugin
@@ -0,0 +1,133 @@
+/**
+ * @file packet_ids.h
+ * @brief Play state packet ids for the Minecraft version selected at build time
+ *
+ * The table is chosen with the MINECRAFT_VERSION definition set by CMake;
+ * every version CMake accepts has its own table, since ids shift whenever
+ * a release inserts or removes a packet. Only packets the server currently
+ * emits are listed; add entries here rather than hard-coding ids at call
+ * sites.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "protocol/version.h"
+
+/**
+ * @namespace Protocol
+ * @brief Minecraft Java Edition protocol constants
+ */
+namespace Protocol {
+
+namespace Play {
+
+/**
+ * @namespace Protocol::Play::Clientbound
+ * @brief Packet ids sent from the server to the client in the play state
+ */
+namespace Clientbound {
+
+#if MINECRAFT_VERSION == 121700
+// 1.21.7 / 1.21.8 (protocol 772)
+constexpr int32_t BLOCK_UPDATE = 0x08;           ///< Single block change
+constexpr int32_t COMMAND_SUGGESTIONS = 0x0F;    ///< Tab completion response
+constexpr int32_t COMMANDS = 0x10;               ///< Command graph
+constexpr int32_t DISPLAY_OBJECTIVE = 0x5B;      ///< Scoreboard display slot
+constexpr int32_t PLAYER_CHAT = 0x3A;            ///< Signed player chat message
+constexpr int32_t PLAYER_INFO_REMOVE = 0x3E;     ///< Tab list removals
+constexpr int32_t PLAYER_INFO_UPDATE = 0x3F;     ///< Tab list additions and changes
+constexpr int32_t RESET_SCORE = 0x48;            ///< Remove a scoreboard score
+constexpr int32_t SET_CONTAINER_CONTENT = 0x12;  ///< Full window contents
+constexpr int32_t SET_CONTAINER_SLOT = 0x14;     ///< One window slot
+constexpr int32_t SET_CURSOR_ITEM = 0x59;        ///< Item carried on the cursor
+constexpr int32_t SYSTEM_CHAT = 0x72;            ///< Unsigned server message
+constexpr int32_t UPDATE_ADVANCEMENTS = 0x7B;    ///< Advancement definitions and progress
+constexpr int32_t UPDATE_OBJECTIVES = 0x63;      ///< Scoreboard objective create/remove/update
+constexpr int32_t UPDATE_SCORE = 0x67;           ///< Scoreboard score value
+constexpr int32_t UPDATE_SECTION_BLOCKS = 0x4D;  ///< Multi block change within a section
+constexpr int32_t UPDATE_TEAMS = 0x66;           ///< Scoreboard teams
+#elif MINECRAFT_VERSION == 121300
+// 1.21.2 / 1.21.3 (protocol 768)
+constexpr int32_t BLOCK_UPDATE = 0x09;           ///< Single block change
+constexpr int32_t COMMAND_SUGGESTIONS = 0x10;    ///< Tab completion response
+constexpr int32_t COMMANDS = 0x11;               ///< Command graph
+constexpr int32_t DISPLAY_OBJECTIVE = 0x5C;      ///< Scoreboard display slot
+constexpr int32_t PLAYER_CHAT = 0x3B;            ///< Signed player chat message
+constexpr int32_t PLAYER_INFO_REMOVE = 0x3F;     ///< Tab list removals
+constexpr int32_t PLAYER_INFO_UPDATE = 0x40;     ///< Tab list additions and changes
+constexpr int32_t RESET_SCORE = 0x49;            ///< Remove a scoreboard score
+constexpr int32_t SET_CONTAINER_CONTENT = 0x13;  ///< Full window contents
+constexpr int32_t SET_CONTAINER_SLOT = 0x15;     ///< One window slot
+constexpr int32_t SET_CURSOR_ITEM = 0x5A;        ///< Item carried on the cursor
+constexpr int32_t SYSTEM_CHAT = 0x73;            ///< Unsigned server message
+constexpr int32_t UPDATE_ADVANCEMENTS = 0x7B;    ///< Advancement definitions and progress
+constexpr int32_t UPDATE_OBJECTIVES = 0x64;      ///< Scoreboard objective create/remove/update
+constexpr int32_t UPDATE_SCORE = 0x68;           ///< Scoreboard score value
+constexpr int32_t UPDATE_SECTION_BLOCKS = 0x4E;  ///< Multi block change within a section
+constexpr int32_t UPDATE_TEAMS = 0x67;           ///< Scoreboard teams
+#elif MINECRAFT_VERSION == 121100
+// 1.21 / 1.21.1 (protocol 767)
+constexpr int32_t BLOCK_UPDATE = 0x09;           ///< Single block change
+constexpr int32_t COMMAND_SUGGESTIONS = 0x10;    ///< Tab completion response
+constexpr int32_t COMMANDS = 0x11;               ///< Command graph
+constexpr int32_t DISPLAY_OBJECTIVE = 0x57;      ///< Scoreboard display slot
+constexpr int32_t PLAYER_CHAT = 0x39;            ///< Signed player chat message
+constexpr int32_t PLAYER_INFO_REMOVE = 0x3D;     ///< Tab list removals
+constexpr int32_t PLAYER_INFO_UPDATE = 0x3E;     ///< Tab list additions and changes
+constexpr int32_t RESET_SCORE = 0x44;            ///< Remove a scoreboard score
+constexpr int32_t SET_CONTAINER_CONTENT = 0x13;  ///< Full window contents
+constexpr int32_t SET_CONTAINER_SLOT = 0x15;     ///< One window slot
+constexpr int32_t SYSTEM_CHAT = 0x6C;            ///< Unsigned server message
+constexpr int32_t UPDATE_ADVANCEMENTS = 0x74;    ///< Advancement definitions and progress
+constexpr int32_t UPDATE_OBJECTIVES = 0x5E;      ///< Scoreboard objective create/remove/update
+constexpr int32_t UPDATE_SCORE = 0x61;           ///< Scoreboard score value
+constexpr int32_t UPDATE_SECTION_BLOCKS = 0x49;  ///< Multi block change within a section
+constexpr int32_t UPDATE_TEAMS = 0x60;           ///< Scoreboard teams
+#elif MINECRAFT_VERSION == 120400
+// 1.20.3 / 1.20.4 (protocol 765)
+constexpr int32_t BLOCK_UPDATE = 0x09;           ///< Single block change
+constexpr int32_t COMMAND_SUGGESTIONS = 0x10;    ///< Tab completion response
+constexpr int32_t COMMANDS = 0x11;               ///< Command graph
+constexpr int32_t DISPLAY_OBJECTIVE = 0x55;      ///< Scoreboard display slot
+constexpr int32_t PLAYER_CHAT = 0x37;            ///< Signed player chat message
+constexpr int32_t PLAYER_INFO_REMOVE = 0x3B;     ///< Tab list removals
+constexpr int32_t PLAYER_INFO_UPDATE = 0x3C;     ///< Tab list additions and changes
+constexpr int32_t RESET_SCORE = 0x42;            ///< Remove a scoreboard score
+constexpr int32_t SET_CONTAINER_CONTENT = 0x13;  ///< Full window contents
+constexpr int32_t SET_CONTAINER_SLOT = 0x15;     ///< One window slot
+constexpr int32_t SYSTEM_CHAT = 0x69;            ///< Unsigned server message
+constexpr int32_t UPDATE_ADVANCEMENTS = 0x70;    ///< Advancement definitions and progress
+constexpr int32_t UPDATE_OBJECTIVES = 0x5C;      ///< Scoreboard objective create/remove/update
+constexpr int32_t UPDATE_SCORE = 0x5F;           ///< Scoreboard score value
+constexpr int32_t UPDATE_SECTION_BLOCKS = 0x47;  ///< Multi block change within a section
+constexpr int32_t UPDATE_TEAMS = 0x5E;           ///< Scoreboard teams
+#elif MINECRAFT_VERSION == 120100
+// 1.20 / 1.20.1 (protocol 763); scores are reset through Update Score
+constexpr int32_t BLOCK_UPDATE = 0x0A;           ///< Single block change
+constexpr int32_t COMMAND_SUGGESTIONS = 0x0F;    ///< Tab completion response
+constexpr int32_t COMMANDS = 0x10;               ///< Command graph
+constexpr int32_t DISPLAY_OBJECTIVE = 0x51;      ///< Scoreboard display slot
+constexpr int32_t PLAYER_CHAT = 0x35;            ///< Signed player chat message
+constexpr int32_t PLAYER_INFO_REMOVE = 0x39;     ///< Tab list removals
+constexpr int32_t PLAYER_INFO_UPDATE = 0x3A;     ///< Tab list additions and changes
+constexpr int32_t SET_CONTAINER_CONTENT = 0x12;  ///< Full window contents
+constexpr int32_t SET_CONTAINER_SLOT = 0x14;     ///< One window slot
+constexpr int32_t SYSTEM_CHAT = 0x64;            ///< Unsigned server message
+constexpr int32_t UPDATE_ADVANCEMENTS = 0x69;    ///< Advancement definitions and progress
+constexpr int32_t UPDATE_OBJECTIVES = 0x58;      ///< Scoreboard objective create/remove/update
+constexpr int32_t UPDATE_SCORE = 0x5B;           ///< Scoreboard score value
+constexpr int32_t UPDATE_SECTION_BLOCKS = 0x43;  ///< Multi block change within a section
+constexpr int32_t UPDATE_TEAMS = 0x5A;           ///< Scoreboard teams
+#else
+#error "No packet id table for this MINECRAFT_VERSION; add one above"
+#endif
+
+}  // namespace Clientbound
+
+}  // namespace Play
+
+}  // namespace Protocol
@@ -0,0 +1,30 @@
+/**
+ * @file text_component.h
+ * @brief Encoding of plain-text chat components
+ *
+ * Since 1.20.3 text components travel as network NBT; before that they are
+ * JSON strings. A plain, unstyled component can be written directly in
+ * either form without building a component tree: a root string tag, or a
+ * JSON string literal.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "network/packet_buffer.h"
+#include "protocol/version.h"
+
+namespace Protocol {
+
+/**
+ * @brief Append an unstyled text component
+ * @param buffer Destination buffer
+ * @param text UTF-8 text; NBT strings longer than 65535 encoded bytes are truncated
+ */
+void WritePlainText(Network::PacketBuffer& buffer, std::string_view text);
+
+}  // namespace Protocol
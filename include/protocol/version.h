@@ -0,0 +1,17 @@
+/**
+ * @file version.h
+ * @brief Minecraft version selection shared by protocol-dependent code
+ *
+ * CMake defines MINECRAFT_VERSION (format XXYYZZ, e.g. 121700 for 1.21.7).
+ * The fallback keeps tooling that compiles single files (clangd with
+ * compile_flags.txt) on the default version.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#ifndef MINECRAFT_VERSION
+/** @brief Minecraft version the server is compiled for */
+#define MINECRAFT_VERSION 121700
+#endif
@@ -0,0 +1,241 @@
+/**
+ * @file scoreboard.h
+ * @brief Objectives, scores and teams with per-tick batched updates
+ *
+ * A Scoreboard is the state one set of viewers sees: the server-wide
+ * scoreboard, or a per-player one for minigame sidebars. Changes are not
+ * sent when they are made:
+ * - structural changes (objective and team creation/removal, display slots,
+ *   team membership) are rare and are encoded in call order;
+ * - value changes (scores, objective titles, team prefix/suffix and
+ *   options) happen many times per second and are coalesced: only the last
+ *   value set during a tick is sent, and setting the value the viewers
+ *   already have sends nothing.
+ * Flush() at tick end encodes everything once and hands the packets to the
+ * caller for every viewer.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "network/encoded_packet.h"
+
+/**
+ * @namespace Scoreboard
+ * @brief Scoreboard objectives, scores and teams
+ */
+namespace Scoreboard {
+
+/**
+ * @enum DisplaySlot
+ * @brief Where an objective is shown
+ */
+enum class DisplaySlot : int32_t {
+  LIST = 0,
+  SIDEBAR = 1,
+  BELOW_NAME = 2,
+};
+
+/** @brief Number of non-team display slots handled */
+constexpr size_t DISPLAY_SLOT_COUNT = 3;
+
+/**
+ * @enum RenderType
+ * @brief How scores of an objective are drawn in the tab list
+ */
+enum class RenderType : int32_t {
+  INTEGER = 0,
+  HEARTS = 1,
+};
+
+/**
+ * @struct TeamOptions
+ * @brief Mutable properties of a team
+ */
+struct TeamOptions {
+  enum Visibility : int32_t {
+    ALWAYS = 0,
+    NEVER = 1,
+    HIDE_FOR_OTHER_TEAMS = 2,
+    HIDE_FOR_OWN_TEAM = 3,
+  };
+  enum Collision : int32_t {
+    PUSH_ALWAYS = 0,
+    PUSH_NEVER = 1,
+    PUSH_OTHER_TEAMS = 2,
+    PUSH_OWN_TEAM = 3,
+  };
+
+  std::string display_name;  ///< Plain text
+  std::string prefix;        ///< Plain text shown before member names
+  std::string suffix;        ///< Plain text shown after member names
+  bool allow_friendly_fire = true;
+  bool see_friendly_invisibles = true;
+  Visibility name_tag_visibility = ALWAYS;
+  Collision collision_rule = PUSH_ALWAYS;
+  int32_t color = 21;  ///< Formatting code index; 21 = reset
+
+  bool operator==(const TeamOptions&) const = default;
+};
+
+/**
+ * @struct ScoreboardStats
+ * @brief Traffic counters of a Scoreboard
+ */
+struct ScoreboardStats {
+  uint64_t score_sets = 0;
+  uint64_t unchanged_sets = 0;   ///< Sets dropped because viewers already had the value
+  uint64_t coalesced_sets = 0;   ///< Sets replaced by a later set in the same tick
+  uint64_t packets = 0;
+  uint64_t bytes_encoded = 0;    ///< Before fan-out
+};
+
+/**
+ * @class Scoreboard
+ * @brief Scoreboard state with dirty tracking
+ *
+ * @note Not thread-safe; owned by the tick thread.
+ *
+ * @example
+ * @code
+ * Scoreboard::Scoreboard board;
+ * board.AddObjective("sidebar", "My Game");
+ * board.SetDisplaySlot(Scoreboard::DisplaySlot::SIDEBAR, "sidebar");
+ * board.SetScore("line-1", "sidebar", 15, "Kills: 3");
+ * // ... end of tick
+ * board.Flush([&](const Network::SharedPacket& packet) { sink.SendPacket(packet); });
+ * @endcode
+ */
+class Scoreboard {
+ public:
+  /** @brief Receives every packet produced by Flush(), in order */
+  using BroadcastFunction = std::function<void(const Network::SharedPacket& packet)>;
+
+  /** @name Objectives */
+  ///@{
+  /** @return False when the objective already exists */
+  bool AddObjective(std::string_view name, std::string_view display_name,
+                    RenderType render_type = RenderType::INTEGER);
+  /** @return False when the objective does not exist */
+  bool RemoveObjective(std::string_view name);
+  void SetObjectiveDisplayName(std::string_view name, std::string_view display_name);
+  /** @brief Show an objective in a slot; an empty name clears the slot */
+  void SetDisplaySlot(DisplaySlot slot, std::string_view objective);
+  ///@}
+
+  /** @name Scores */
+  ///@{
+  /**
+   * @brief Set a score
+   * @param entry Player name or score holder
+   * @param objective Existing objective
+   * @param value New value
+   * @param display_name Text replacing @p entry in the sidebar (1.20.3+)
+   */
+  void SetScore(std::string_view entry, std::string_view objective, int32_t value,
+                std::optional<std::string_view> display_name = std::nullopt);
+  /** @brief Remove a score */
+  void ResetScore(std::string_view entry, std::string_view objective);
+  /** @brief Current value of a score */
+  std::optional<int32_t> GetScore(std::string_view entry, std::string_view objective) const;
+  ///@}
+
+  /** @name Teams */
+  ///@{
+  /** @return False when the team already exists */
+  bool AddTeam(std::string_view name, TeamOptions options = {});
+  /** @return False when the team does not exist */
+  bool RemoveTeam(std::string_view name);
+  void UpdateTeam(std::string_view name, const TeamOptions& options);
+  /** @brief Set only the prefix and suffix, the usual way sidebar lines change */
+  void SetTeamAffixes(std::string_view name, std::string_view prefix, std::string_view suffix);
+  void AddTeamMember(std::string_view name, std::string_view member);
+  void RemoveTeamMember(std::string_view name, std::string_view member);
+  ///@}
+
+  /**
+   * @brief Encode this tick's changes
+   * @param broadcast Invoked with each packet, in the order the client must apply them
+   * @return Number of packets
+   *
+   * Viewers added this tick should receive SnapshotPackets() after the flush.
+   */
+  size_t Flush(const BroadcastFunction& broadcast);
+
+  /**
+   * @brief Packets recreating the whole scoreboard for a new viewer
+   * @return Objectives, display slots, teams and scores
+   */
+  std::vector<Network::SharedPacket> SnapshotPackets() const;
+
+  /** @brief Cumulative traffic counters */
+  const ScoreboardStats& GetStats() const { return stats_; }
+
+ private:
+  /** @brief Transparent hash so lookups by string_view do not allocate */
+  struct NameHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+  };
+
+  template <typename Value>
+  using NameMap = std::unordered_map<std::string, Value, NameHash, std::equal_to<>>;
+
+  struct Score {
+    int32_t value = 0;
+    std::optional<std::string> display_name;
+    bool dirty = false;
+  };
+
+  struct Objective {
+    std::string display_name;
+    RenderType render_type = RenderType::INTEGER;
+    bool dirty = false;   ///< Display name changed
+    bool queued = false;  ///< Listed in dirty_objectives_
+    NameMap<Score> scores;
+    std::vector<std::string> dirty_scores;
+    std::vector<std::string> reset_scores;
+  };
+
+  struct Team {
+    TeamOptions options;
+    std::vector<std::string> members;
+    bool dirty = false;  ///< Options changed, listed in dirty_teams_
+  };
+
+  Objective* FindObjective(std::string_view name);
+  Team* FindTeam(std::string_view name);
+  void Emit(Network::SharedPacket packet);
+  void Queue(std::string_view name, Objective& objective);
+
+  Network::SharedPacket EncodeObjective(std::string_view name, const Objective& objective,
+                                        uint8_t mode) const;
+  Network::SharedPacket EncodeObjectiveRemoval(std::string_view name) const;
+  Network::SharedPacket EncodeDisplaySlot(DisplaySlot slot, std::string_view objective) const;
+  Network::SharedPacket EncodeTeam(std::string_view name, const Team& team, uint8_t mode) const;
+  Network::SharedPacket EncodeTeamMembers(std::string_view name, uint8_t mode,
+                                          std::string_view member) const;
+  Network::SharedPacket EncodeScore(std::string_view entry, std::string_view objective,
+                                    const Score& score) const;
+  Network::SharedPacket EncodeReset(std::string_view entry, std::string_view objective) const;
+
+  NameMap<Objective> objectives_;
+  NameMap<Team> teams_;
+  std::array<std::string, DISPLAY_SLOT_COUNT> display_slots_;
+  std::vector<std::string> dirty_objectives_;
+  std::vector<std::string> dirty_teams_;
+  std::vector<Network::SharedPacket> structural_;  ///< Encoded in call order
+  ScoreboardStats stats_;
+};
+
+}  // namespace Scoreboard
@@ -0,0 +1,187 @@
+/**
+ * @file async_log.h
+ * @brief Asynchronous spdlog pipeline for the tick and network threads
+ *
+ * A synchronous spdlog sink writes and sometimes flushes on the thread that
+ * logged, so a slow disk or a stalled terminal stalls the tick. AsyncLogSink
+ * moves all I/O to one writer thread. The calling thread formats the line
+ * with its own clone of the pattern formatter (spdlog's pattern formatter
+ * caches the timestamp and is not shareable), copies it into a slot of a
+ * bounded lock-free ring and returns; the writer hands the preformatted
+ * lines to the downstream sinks.
+ *
+ * When the ring is full the overflow policy decides: DROP_OLDEST discards
+ * the oldest queued line so logging never blocks, BLOCK waits for the
+ * writer. Discarded lines are counted and reported in the log itself once
+ * the writer catches up.
+ *
+ * spdlog's own async_logger is not used: its queue takes a mutex per
+ * message and formats on the worker thread, after the line was copied.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <spdlog/logger.h>
+#include <spdlog/sinks/sink.h>
+
+namespace Util {
+
+/** @brief What a producer does when the log queue is full */
+enum class LogOverflowPolicy {
+  DROP_OLDEST,  ///< Discard the oldest queued line; logging never waits
+  BLOCK,        ///< Wait for the writer thread to make room
+};
+
+/**
+ * @struct AsyncLogConfig
+ * @brief Queue size, overflow policy and line format of an AsyncLogSink
+ */
+struct AsyncLogConfig {
+  size_t queue_capacity = 8192;  ///< Lines; rounded up to a power of two
+  LogOverflowPolicy overflow = LogOverflowPolicy::DROP_OLDEST;
+  std::string pattern = "[%Y-%m-%d %H:%M:%S.%e] [%l] [%t] %v";  ///< Applied on the logging thread
+  std::chrono::milliseconds flush_interval{1000};  ///< Downstream flush period while idle
+};
+
+/**
+ * @struct AsyncLogStats
+ * @brief Counters of an AsyncLogSink
+ */
+struct AsyncLogStats {
+  uint64_t enqueued = 0;  ///< Lines accepted into the queue
+  uint64_t written = 0;   ///< Lines handed to the downstream sinks
+  uint64_t dropped = 0;   ///< Queued lines discarded under DROP_OLDEST
+  uint64_t blocked = 0;   ///< Times a producer waited for room under BLOCK
+  size_t depth = 0;       ///< Lines currently queued
+};
+
+/**
+ * @class AsyncLogSink
+ * @brief spdlog sink that formats on the caller and writes on its own thread
+ *
+ * Downstream sinks receive the finished line as the message text, so they
+ * should use a "%v" style pattern (InstallAsyncLogging() sets "%^%v%$",
+ * which keeps level colours on console sinks).
+ *
+ * @note log() and flush() are lock-free for the caller except when BLOCK
+ *       waits for room. flush() only asks the writer to flush; Drain()
+ *       waits until everything logged so far is written and flushed.
+ */
+class AsyncLogSink final : public spdlog::sinks::sink {
+ public:
+  /**
+   * @brief Start the writer thread
+   * @param sinks Destinations of the formatted lines
+   * @param config Queue and format settings
+   */
+  explicit AsyncLogSink(std::vector<spdlog::sink_ptr> sinks, AsyncLogConfig config = {});
+
+  /** @brief Write out everything queued and stop the writer thread */
+  ~AsyncLogSink() override;
+
+  AsyncLogSink(const AsyncLogSink&) = delete;
+  AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+  void log(const spdlog::details::log_msg& msg) override;
+  void flush() override;
+  void set_pattern(const std::string& pattern) override;
+  void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+  /** @brief Block until every line logged before the call is written and flushed */
+  void Drain();
+
+  /** @brief Snapshot of the counters */
+  AsyncLogStats GetStats() const;
+
+ private:
+  struct Slot;
+
+  /** @brief Claim a free slot and fill it; false when the ring is full */
+  bool TryPush(const spdlog::details::log_msg& msg, const spdlog::memory_buf_t& line);
+
+  /**
+   * @brief Release the oldest published slot
+   *
+   * Unless @p discard, the line is swapped into popped_ first, so the slot
+   * is free again before the writer starts its (possibly slow) I/O.
+   */
+  bool TryPop(bool discard);
+
+  /** @brief Forward one formatted line to the downstream sinks */
+  void Write(spdlog::level::level_enum level, spdlog::log_clock::time_point time,
+             std::string_view text);
+
+  void WakeWriter();
+  void WriterLoop();
+  void FlushSinks();
+
+  std::vector<spdlog::sink_ptr> sinks_;
+  AsyncLogConfig config_;
+  std::unique_ptr<Slot[]> slots_;
+  size_t mask_;
+  std::unique_ptr<Slot> popped_;  ///< Line being written; writer thread only
+
+  alignas(64) std::atomic<uint64_t> enqueue_position_{0};
+  alignas(64) std::atomic<uint64_t> dequeue_position_{0};
+  alignas(64) std::atomic<uint64_t> written_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> blocked_{0};
+  std::atomic<uint32_t> waiting_producers_{0};
+
+  // Formatter shared by the per-thread clones; a new version makes threads re-clone
+  std::mutex formatter_mutex_;
+  std::unique_ptr<spdlog::formatter> formatter_;
+  std::atomic<uint64_t> formatter_version_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable drained_;
+  std::atomic<bool> writer_sleeping_{false};
+  std::atomic<bool> flush_requested_{false};
+  uint64_t drain_target_ = 0;  ///< Highest enqueue position a Drain() waits for
+  uint64_t flushed_position_ = 0;  ///< Lines before this position are written and flushed
+  bool stopping_ = false;
+  std::thread writer_;
+};
+
+/**
+ * @brief Make an AsyncLogSink in front of @p sinks spdlog's default logger
+ *
+ * Sets the downstream patterns to "%^%v%$", flushes on warnings and above
+ * (without blocking the caller) and registers the logger as the default,
+ * so plain spdlog::info() calls go through the queue.
+ *
+ * @param name Logger name
+ * @param sinks Destinations, e.g. a stdout colour sink and a rotating file sink
+ * @param config Queue and format settings
+ * @param level Minimum level logged
+ * @return The sink, for GetStats() and Drain() at shutdown
+ *
+ * @example
+ * @code
+ * auto console = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+ * auto file = std::make_shared<spdlog::sinks::rotating_file_sink_mt>("logs/server.log", 64 << 20, 5);
+ * auto logging = Util::InstallAsyncLogging("server", {console, file});
+ * ...
+ * logging->Drain();
+ * @endcode
+ */
+std::shared_ptr<AsyncLogSink> InstallAsyncLogging(
+    const std::string& name, std::vector<spdlog::sink_ptr> sinks, AsyncLogConfig config = {},
+    spdlog::level::level_enum level = spdlog::level::info);
+
+}  // namespace Util
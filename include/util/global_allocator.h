@@ -0,0 +1,31 @@
+/**
+ * @file global_allocator.h
+ * @brief The malloc/operator new implementation the server was built with
+ *
+ * The PARELLELSTONE_ALLOCATOR CMake option replaces the C runtime allocator
+ * with mimalloc or jemalloc for the whole process. Server code does not
+ * call them directly; these helpers report which one is active and ask it
+ * to hand unused memory back to the system.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <string_view>
+
+namespace Util {
+
+/** @brief "mimalloc", "jemalloc" or "system" */
+std::string_view GlobalAllocatorName();
+
+/**
+ * @brief Return free allocator memory to the operating system
+ *
+ * Purges retained pages (mi_collect, jemalloc arena purge, malloc_trim or
+ * _heapmin). Takes milliseconds on a large heap, so call it when memory is
+ * scarce, not every tick.
+ */
+void TrimGlobalAllocator();
+
+}  // namespace Util
@@ -0,0 +1,65 @@
+/**
+ * @file hash.h
+ * @brief Small, allocation-free hashing helpers
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace Util {
+
+/** @brief FNV-1a 64-bit offset basis */
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+
+/** @brief FNV-1a 64-bit prime */
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+/**
+ * @brief FNV-1a hash of a byte range
+ * @param bytes Data to hash
+ * @param seed Running hash to continue from
+ * @return 64-bit hash
+ */
+constexpr uint64_t Fnv1a(std::span<const uint8_t> bytes, uint64_t seed = FNV_OFFSET_BASIS) {
+  uint64_t hash = seed;
+  for (uint8_t byte : bytes) {
+    hash = (hash ^ byte) * FNV_PRIME;
+  }
+  return hash;
+}
+
+/**
+ * @brief FNV-1a hash of a string
+ * @param text Data to hash
+ * @param seed Running hash to continue from
+ * @return 64-bit hash
+ */
+constexpr uint64_t Fnv1a(std::string_view text, uint64_t seed = FNV_OFFSET_BASIS) {
+  uint64_t hash = seed;
+  for (char c : text) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * FNV_PRIME;
+  }
+  return hash;
+}
+
+/**
+ * @brief Mix a 64-bit value into a running hash
+ * @param seed Running hash
+ * @param value Value to mix in
+ * @return Combined hash
+ */
+constexpr uint64_t HashCombine(uint64_t seed, uint64_t value) {
+  // splitmix64 finalizer on the combined value.
+  uint64_t x = seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+}  // namespace Util
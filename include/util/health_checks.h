@@ -0,0 +1,105 @@
+/**
+ * @file health_checks.h
+ * @brief Liveness and readiness probes for orchestrators
+ *
+ * /healthz answers whether the process should be restarted: it fails when
+ * the tick loop has not finished a tick for longer than the stall limit
+ * (a deadlock or an endless tick). /readyz answers whether the instance
+ * should receive players: worlds are loaded, logins are accepted and the
+ * mean MSPT is under the overload threshold. An overloaded or shutting
+ * down instance turns unready, so the orchestrator stops routing new
+ * players to it without killing it.
+ *
+ * Both are served by Network::HttpServer's own thread and read only
+ * atomics the tick loop publishes, so they keep answering while the tick
+ * thread is stuck. Responses list every check as "[+]name detail" or
+ * "[-]name detail" and use status 200 or 503.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include "network/http_server.h"
+#include "util/server_metrics.h"
+
+namespace Util {
+
+/**
+ * @struct HealthConfig
+ * @brief Thresholds of the probes
+ */
+struct HealthConfig {
+  std::chrono::milliseconds tick_stall{10000};      ///< Longest gap between ticks while alive
+  std::chrono::milliseconds startup_grace{300000};  ///< Time allowed before the first tick
+  double max_mspt = 45.0;  ///< Readiness fails above this mean MSPT; 50 is the 20 TPS budget
+};
+
+/**
+ * @struct HealthReport
+ * @brief Outcome of one probe
+ */
+struct HealthReport {
+  bool ok = true;
+  std::string detail;  ///< One line per check
+};
+
+/**
+ * @class HealthChecks
+ * @brief Liveness and readiness derived from the tick loop and server state
+ *
+ * @note Thread-safe. The Set*() calls are relaxed atomic stores.
+ *
+ * @example
+ * @code
+ * Util::HealthChecks health(metrics);
+ * health.Serve(http);
+ * LoadWorlds();
+ * health.SetWorldsLoaded(true);
+ * health.SetAcceptingLogins(true);
+ * // on shutdown: stop new players first, then drain
+ * health.SetAcceptingLogins(false);
+ * @endcode
+ */
+class HealthChecks {
+ public:
+  /**
+   * @param metrics Source of tick times and MSPT; must outlive this object
+   * @param config Thresholds
+   */
+  explicit HealthChecks(const ServerMetrics& metrics, HealthConfig config = {});
+
+  HealthChecks(const HealthChecks&) = delete;
+  HealthChecks& operator=(const HealthChecks&) = delete;
+
+  /** @brief Worlds finished loading (or started unloading when false) */
+  void SetWorldsLoaded(bool loaded) noexcept;
+
+  /** @brief The login handler admits new players */
+  void SetAcceptingLogins(bool accepting) noexcept;
+
+  /** @brief /healthz: the tick loop is advancing */
+  HealthReport Liveness() const;
+
+  /** @brief /readyz: alive, worlds loaded, logins accepted and MSPT under the threshold */
+  HealthReport Readiness() const;
+
+  /**
+   * @brief Serve /healthz and /readyz on @p server
+   * @param server Server to add the routes to; this object must outlive them
+   */
+  void Serve(Network::HttpServer& server) const;
+
+ private:
+  const ServerMetrics& metrics_;
+  HealthConfig config_;
+  std::chrono::steady_clock::time_point created_;
+  std::atomic<bool> worlds_loaded_{false};
+  std::atomic<bool> accepting_logins_{false};
+};
+
+}  // namespace Util
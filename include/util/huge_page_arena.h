@@ -0,0 +1,79 @@
+/**
+ * @file huge_page_arena.h
+ * @brief Bump arena over huge-page regions for long-lived world memory
+ *
+ * The arena reserves large regions through Platform::AllocateHugePages()
+ * and hands out aligned pieces of them. Pieces are never returned
+ * individually; the owner (e.g. the slab allocator's segment source)
+ * recycles them itself, and all regions are released with the arena.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "platform.h"
+
+namespace Util {
+
+/**
+ * @struct HugePageArenaStats
+ * @brief Counters of a HugePageArena
+ */
+struct HugePageArenaStats {
+  uint64_t regions = 0;         ///< Regions obtained from the system
+  uint64_t huge_regions = 0;    ///< Regions backed by huge pages
+  uint64_t bytes_reserved = 0;  ///< Total size of all regions
+  uint64_t bytes_used = 0;      ///< Handed out, including alignment padding
+};
+
+/**
+ * @class HugePageArena
+ * @brief Thread-safe bump allocator over 2 MiB-page regions
+ *
+ * @example
+ * @code
+ * Util::HugePageArena arena(64 * 1024 * 1024);
+ * void* segment = arena.Allocate(4 * 1024 * 1024, 64 * 1024);
+ * @endcode
+ */
+class HugePageArena {
+ public:
+  /**
+   * @brief Create an arena; no memory is reserved until the first allocation
+   * @param region_size Bytes reserved from the system at a time
+   */
+  explicit HugePageArena(size_t region_size = 64 * 1024 * 1024);
+
+  /** @brief Releases every region */
+  ~HugePageArena();
+
+  HugePageArena(const HugePageArena&) = delete;
+  HugePageArena& operator=(const HugePageArena&) = delete;
+
+  /**
+   * @brief Carve memory from the current region, reserving a new one when full
+   * @param size Bytes
+   * @param alignment Power of two, at most Platform::HUGE_PAGE_SIZE
+   * @return Zeroed memory valid until the arena is destroyed
+   * @throws std::bad_alloc When the system is out of memory
+   */
+  void* Allocate(size_t size, size_t alignment);
+
+  /** @brief Snapshot of the counters */
+  HugePageArenaStats GetStats() const;
+
+ private:
+  size_t region_size_;
+  mutable std::mutex mutex_;
+  std::vector<Platform::PageAllocation> regions_;
+  size_t offset_ = 0;  ///< Next free byte in regions_.back()
+  HugePageArenaStats stats_;
+};
+
+}  // namespace Util
@@ -0,0 +1,169 @@
+/**
+ * @file identifier.h
+ * @brief Interned namespaced identifiers with dense 32-bit handles
+ *
+ * Identifiers such as "minecraft:stone" are interned once, when registries
+ * and datapacks are loaded, into a process-wide table that hands out
+ * consecutive handles. At runtime an Identifier is a plain integer:
+ * comparing two is one instruction, hashing is free, and maps keyed by
+ * identifiers become arrays indexed by the handle (see IdentifierMap).
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Util {
+
+/** @brief Namespace assumed for identifiers written without one */
+constexpr std::string_view DEFAULT_NAMESPACE = "minecraft";
+
+/**
+ * @class Identifier
+ * @brief Handle of an interned namespaced identifier
+ *
+ * A default-constructed Identifier is invalid. Handles are stable for the
+ * lifetime of the process and the same text always yields the same handle.
+ *
+ * @note Intern() and Find() are thread-safe; intern at load time, the table
+ *       takes an exclusive lock for new entries.
+ *
+ * @example
+ * @code
+ * const Util::Identifier stone = Util::Identifier::Intern("minecraft:stone");
+ * if (block_id == stone) { ... }
+ * @endcode
+ */
+class Identifier {
+ public:
+  constexpr Identifier() = default;
+
+  /**
+   * @brief Intern an identifier, adding it to the table when new
+   * @param name "namespace:path", or "path" for the minecraft namespace
+   * @return Handle of the identifier
+   * @throws std::invalid_argument when @p name is not a valid identifier
+   */
+  static Identifier Intern(std::string_view name);
+
+  /**
+   * @brief Look up an identifier without adding it
+   * @param name "namespace:path", or "path" for the minecraft namespace
+   * @return Handle, or std::nullopt when the identifier was never interned
+   */
+  static std::optional<Identifier> Find(std::string_view name);
+
+  /** @brief Number of interned identifiers; every handle is below this */
+  static size_t TableSize();
+
+  /** @brief Dense index of the handle, usable as an array index */
+  constexpr uint32_t Index() const { return index_; }
+
+  /** @brief False for a default-constructed handle */
+  constexpr bool IsValid() const { return index_ != INVALID_INDEX; }
+
+  /** @brief Full text, e.g. "minecraft:stone"; empty for an invalid handle */
+  std::string_view Name() const;
+
+  /** @brief Namespace part, e.g. "minecraft" */
+  std::string_view Namespace() const;
+
+  /** @brief Path part, e.g. "stone" */
+  std::string_view Path() const;
+
+  constexpr bool operator==(const Identifier&) const = default;
+  constexpr auto operator<=>(const Identifier&) const = default;
+
+ private:
+  static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+  explicit constexpr Identifier(uint32_t index) : index_(index) {}
+
+  uint32_t index_ = INVALID_INDEX;
+};
+
+/**
+ * @class IdentifierMap
+ * @brief Map from identifiers to values, stored as an array indexed by handle
+ *
+ * Lookups are a bounds check and an array access. The array grows to the
+ * largest inserted handle, which is bounded by the interned identifier
+ * count, so the map suits registry-style data that is keyed by a large
+ * share of the identifiers of one kind.
+ *
+ * @note Not thread-safe for writes; concurrent lookups are fine.
+ */
+template <typename T>
+class IdentifierMap {
+ public:
+  /**
+   * @brief Insert a value when the key is absent
+   * @param key Valid identifier
+   * @param value Value to store
+   * @return True when inserted, false when the key already had a value
+   */
+  bool Insert(Identifier key, T value) {
+    std::optional<T>& slot = Slot(key);
+    if (slot) {
+      return false;
+    }
+    slot.emplace(std::move(value));
+    ++size_;
+    return true;
+  }
+
+  /** @brief Value of a valid @p key, default-constructed when absent */
+  T& operator[](Identifier key) {
+    std::optional<T>& slot = Slot(key);
+    if (!slot) {
+      slot.emplace();
+      ++size_;
+    }
+    return *slot;
+  }
+
+  /** @brief Value of @p key, or nullptr */
+  const T* Find(Identifier key) const {
+    if (key.Index() >= slots_.size() || !slots_[key.Index()]) {
+      return nullptr;
+    }
+    return &*slots_[key.Index()];
+  }
+
+  T* Find(Identifier key) {
+    return const_cast<T*>(std::as_const(*this).Find(key));
+  }
+
+  /** @brief True when @p key has a value */
+  bool Contains(Identifier key) const { return Find(key) != nullptr; }
+
+  /** @brief Number of keys with a value */
+  size_t Size() const { return size_; }
+
+ private:
+  std::optional<T>& Slot(Identifier key) {
+    if (key.Index() >= slots_.size()) {
+      slots_.resize(static_cast<size_t>(key.Index()) + 1);
+    }
+    return slots_[key.Index()];
+  }
+
+  std::vector<std::optional<T>> slots_;
+  size_t size_ = 0;
+};
+
+}  // namespace Util
+
+template <>
+struct std::hash<Util::Identifier> {
+  size_t operator()(Util::Identifier id) const noexcept { return id.Index(); }
+};
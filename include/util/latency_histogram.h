@@ -0,0 +1,129 @@
+/**
+ * @file latency_histogram.h
+ * @brief HDR-style latency histogram recorded per thread, merged on read
+ *
+ * Averages hide lag spikes; percentiles need the whole distribution. The
+ * histogram uses HDR Histogram's log-linear buckets: values below 64 ns are
+ * counted exactly, and every power-of-two range above is split into 64
+ * buckets, so any recorded value is reproduced within 1/64 (1.6%) over the
+ * whole range from nanoseconds to a minute, in a fixed 1984 buckets.
+ *
+ * Every thread that records gets its own bucket array, so recording is a
+ * few relaxed loads and stores with no shared cache line; readers merge all
+ * arrays. Percentiles are reported both since creation and over a recent
+ * window, because a lifetime p99 stops moving after the first hour.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Util {
+
+/** @brief Bits of precision: each power-of-two range has 2^this buckets */
+constexpr uint32_t LATENCY_SUB_BUCKET_BITS = 6;
+
+/** @brief Values at or above 2^this nanoseconds (~68.7 s) share the last bucket */
+constexpr uint32_t LATENCY_RANGE_BITS = 36;
+
+/** @brief Buckets per histogram */
+constexpr size_t LATENCY_BUCKETS =
+    size_t{LATENCY_RANGE_BITS - LATENCY_SUB_BUCKET_BITS + 1} << LATENCY_SUB_BUCKET_BITS;
+
+/**
+ * @struct LatencySnapshot
+ * @brief Merged counts of a LatencyHistogram, or the difference of two
+ */
+struct LatencySnapshot {
+  uint64_t count = 0;
+  uint64_t sum_ns = 0;
+  uint64_t max_ns = 0;  ///< Exact for totals; bucket precision for windows
+  std::vector<uint64_t> buckets = std::vector<uint64_t>(LATENCY_BUCKETS, 0);
+
+  /**
+   * @brief Value at or below which @p percentile percent of samples fall
+   * @param percentile 0-100, e.g. 99.9
+   * @return Nanoseconds, within bucket precision; 0 when empty
+   */
+  uint64_t Percentile(double percentile) const;
+
+  /** @brief Mean in nanoseconds; 0 when empty */
+  double Mean() const { return count == 0 ? 0.0 : static_cast<double>(sum_ns) / count; }
+};
+
+/**
+ * @struct LatencyReading
+ * @brief What LatencyHistogram::Read() returns
+ */
+struct LatencyReading {
+  LatencySnapshot total;   ///< Everything since the histogram was created
+  LatencySnapshot recent;  ///< Samples of the last one to two windows
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief Log-linear latency histogram with a bucket array per recording thread
+ *
+ * @note Thread-safe. Record() takes no lock after a thread's first call.
+ *       A thread's buckets stay with the histogram after the thread exits,
+ *       so its samples keep counting.
+ *
+ * @example
+ * @code
+ * Util::LatencyHistogram chunk_delivery;
+ * const auto requested = std::chrono::steady_clock::now();
+ * // ... generate, encode and send the chunk
+ * chunk_delivery.Record(std::chrono::steady_clock::now() - requested);
+ * const Util::LatencyReading reading = chunk_delivery.Read();
+ * spdlog::info("chunk p99 {} ns", reading.recent.Percentile(99.0));
+ * @endcode
+ */
+class LatencyHistogram {
+ public:
+  /**
+   * @param window Length of the recent window; Read().recent covers between
+   *               one and two windows of samples
+   */
+  explicit LatencyHistogram(std::chrono::steady_clock::duration window = std::chrono::minutes(1));
+  ~LatencyHistogram();
+
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  /** @brief Record one latency; negative values count as zero */
+  void Record(std::chrono::nanoseconds latency) noexcept;
+
+  /** @brief Merge every thread's buckets; also advances the recent window */
+  LatencyReading Read() const;
+
+  /** @brief Bucket that counts @p nanoseconds */
+  static size_t BucketIndex(uint64_t nanoseconds);
+
+  /** @brief Largest value counted by @p bucket */
+  static uint64_t BucketUpperBound(size_t bucket);
+
+ private:
+  struct Shard;
+
+  Shard& LocalShard();
+  LatencySnapshot Merge() const;
+
+  const uint32_t id_;  ///< Index into the per-thread shard cache
+  const std::chrono::steady_clock::duration window_;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  mutable LatencySnapshot window_start_;  ///< Totals at the start of the recent window
+  mutable LatencySnapshot window_next_;   ///< Totals at the start of the window being filled
+  mutable std::chrono::steady_clock::time_point window_rotated_;
+};
+
+}  // namespace Util
@@ -0,0 +1,142 @@
+/**
+ * @file latency_metrics.h
+ * @brief The server's latency histograms and their exposition
+ *
+ * Four families of LatencyHistogram, each exported as a Prometheus summary
+ * whose quantiles (0.5, 0.99, 0.999 and 1 for the maximum) cover the recent
+ * window and whose _sum and _count are lifetime totals:
+ * - parellelstone_tick_phase_seconds{phase}: duration of each tick phase
+ * - parellelstone_packet_handling_seconds{packet_id}: serverbound play
+ *   packet handlers, per packet id
+ * - parellelstone_join_seconds: login start to the player being in the world
+ * - parellelstone_chunk_delivery_seconds: chunk requested (entered view) to
+ *   its packet being sent
+ *
+ * The same readings feed the /latency command (command/latency_command.h).
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/latency_histogram.h"
+#include "util/metrics.h"
+
+namespace Util {
+
+/** @brief Packet ids with their own handling histogram; higher ids are not recorded */
+constexpr int32_t LATENCY_PACKET_IDS = 256;
+
+/**
+ * @enum LatencyCategory
+ * @brief Histogram families of LatencyMetrics
+ */
+enum class LatencyCategory : uint8_t {
+  TICK_PHASES,
+  PACKETS,
+  JOIN,
+  CHUNK_DELIVERY,
+};
+
+/**
+ * @struct LatencyLine
+ * @brief Recent-window summary of one histogram, for reports
+ */
+struct LatencyLine {
+  std::string name;  ///< Phase name, "0x1D" style packet id, "join" or "chunk delivery"
+  uint64_t samples = 0;
+  uint64_t p50_ns = 0;
+  uint64_t p99_ns = 0;
+  uint64_t p999_ns = 0;
+  uint64_t max_ns = 0;
+};
+
+/**
+ * @class LatencyMetrics
+ * @brief Tick phase, packet, join and chunk delivery latency histograms
+ *
+ * @note Thread-safe. Recording is lock-free once a thread has recorded to a
+ *       histogram; the first sample of a new packet id registers its series.
+ *       Must outlive every scrape of the registry it was given.
+ *
+ * @example
+ * @code
+ * Util::LatencyMetrics latency(registry);
+ * Util::LatencyHistogram& entities = latency.TickPhase("entities");
+ * // tick loop
+ * const auto start = std::chrono::steady_clock::now();
+ * TickEntities();
+ * entities.Record(std::chrono::steady_clock::now() - start);
+ * // network thread
+ * latency.RecordPacket(packet_id, handled - received);
+ * @endcode
+ */
+class LatencyMetrics {
+ public:
+  /**
+   * @param registry Registry the summaries are added to
+   * @param window Recent window of the quantiles
+   * @throws std::invalid_argument If @p registry already holds these metrics
+   */
+  explicit LatencyMetrics(MetricsRegistry& registry,
+                          std::chrono::steady_clock::duration window = std::chrono::minutes(1));
+  ~LatencyMetrics();
+
+  LatencyMetrics(const LatencyMetrics&) = delete;
+  LatencyMetrics& operator=(const LatencyMetrics&) = delete;
+
+  /**
+   * @brief Histogram of a tick phase, created on first use
+   * @param phase Phase name, e.g. "entities"; becomes the phase label
+   * @return Histogram valid for this object's lifetime; keep it rather than
+   *         looking it up every tick
+   */
+  LatencyHistogram& TickPhase(std::string_view phase);
+
+  /**
+   * @brief Record how long a serverbound packet's handler took
+   * @param packet_id Play state packet id; ids outside [0, LATENCY_PACKET_IDS) are ignored
+   * @param latency Handling time
+   */
+  void RecordPacket(int32_t packet_id, std::chrono::nanoseconds latency);
+
+  /** @brief Record a login start to in-world time */
+  void RecordJoin(std::chrono::nanoseconds latency) noexcept { join_.Record(latency); }
+
+  /** @brief Record a chunk request to send time */
+  void RecordChunkDelivery(std::chrono::nanoseconds latency) noexcept {
+    chunk_delivery_.Record(latency);
+  }
+
+  /** @brief Recent-window summaries of one family; empty histograms are left out */
+  std::vector<LatencyLine> Report(LatencyCategory category) const;
+
+ private:
+  struct Named {
+    std::string name;
+    std::unique_ptr<LatencyHistogram> histogram;
+  };
+
+  LatencyHistogram& AddPacket(int32_t packet_id);
+
+  MetricsRegistry& registry_;
+  const std::chrono::steady_clock::duration window_;
+  LatencyHistogram join_;
+  LatencyHistogram chunk_delivery_;
+  std::array<std::atomic<LatencyHistogram*>, LATENCY_PACKET_IDS> packets_{};
+  mutable std::mutex mutex_;
+  std::vector<Named> phases_;
+  std::vector<Named> packet_histograms_;  ///< Owners of packets_ entries
+};
+
+}  // namespace Util
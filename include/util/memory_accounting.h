@@ -0,0 +1,130 @@
+/**
+ * @file memory_accounting.h
+ * @brief Live bytes per subsystem and operator-set memory budgets
+ *
+ * The custom allocators tag what they hand out with the subsystem that owns
+ * it: chunk sections through SlabAllocator, packets through PacketPool,
+ * encoded caches and plugin sandboxes where they allocate. The counters
+ * answer "who owns the memory" at runtime without a heap profiler.
+ *
+ * A subsystem can be given a budget. Exceeding it never fails an
+ * allocation; instead the owner reacts: caches stop growing and drop
+ * entries, the packet pool stops keeping idle buffers so producers should
+ * back off (OverMemoryBudget()), and EnforceMemoryBudgets(), run once per
+ * tick, calls the subsystem's pressure handler, e.g. to evict chunks.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace Util {
+
+/**
+ * @enum MemorySubsystem
+ * @brief Owners memory is accounted to
+ */
+enum class MemorySubsystem : uint8_t {
+  CHUNKS,    ///< Chunk section palettes and block data
+  ENTITIES,  ///< Entity and player state
+  NETWORK,   ///< Encoded packets and pooled packet buffers
+  CACHES,    ///< Pre-encoded data kept for reuse
+  PLUGINS,   ///< Plugin sandboxes
+  OTHER,
+};
+
+/** @brief Number of MemorySubsystem values */
+constexpr size_t MEMORY_SUBSYSTEM_COUNT = 6;
+
+/**
+ * @struct MemoryUsage
+ * @brief Counters of one subsystem
+ */
+struct MemoryUsage {
+  MemorySubsystem subsystem = MemorySubsystem::OTHER;
+  int64_t live_bytes = 0;          ///< Currently allocated
+  int64_t peak_bytes = 0;          ///< Highest live_bytes seen
+  uint64_t allocations = 0;        ///< Tracked allocations since start
+  uint64_t budget_bytes = 0;       ///< 0 when unlimited
+  uint64_t pressure_events = 0;    ///< Pressure handler invocations
+};
+
+/** @brief Lower-case name, e.g. "chunks" */
+std::string_view MemorySubsystemName(MemorySubsystem subsystem);
+
+/**
+ * @brief Account an allocation to a subsystem
+ * @param subsystem Owner
+ * @param bytes Size of the allocation
+ * @note Thread-safe. Counts are batched per thread and published in 64 KiB
+ *       steps, so the hot path touches no shared cache line; live bytes
+ *       lag by at most that much per thread and subsystem.
+ */
+void TrackAllocation(MemorySubsystem subsystem, size_t bytes) noexcept;
+
+/**
+ * @brief Account a release, with the size that was tracked for it
+ * @param subsystem Owner
+ * @param bytes Size of the allocation
+ */
+void TrackRelease(MemorySubsystem subsystem, size_t bytes) noexcept;
+
+/**
+ * @brief Set the budget of a subsystem
+ * @param subsystem Owner
+ * @param bytes Budget; 0 removes it
+ */
+void SetMemoryBudget(MemorySubsystem subsystem, uint64_t bytes);
+
+/** @brief True when a budget is set and live bytes exceed it */
+bool OverMemoryBudget(MemorySubsystem subsystem) noexcept;
+
+/** @brief Counters of one subsystem */
+MemoryUsage GetMemoryUsage(MemorySubsystem subsystem);
+
+/** @brief Counters of every subsystem, indexed by MemorySubsystem */
+std::array<MemoryUsage, MEMORY_SUBSYSTEM_COUNT> GetAllMemoryUsage();
+
+/**
+ * @brief Reaction to a subsystem exceeding its budget
+ * @param excess_bytes Live bytes above the budget
+ */
+using MemoryPressureHandler = std::function<void(uint64_t excess_bytes)>;
+
+/**
+ * @brief Install the pressure handler of a subsystem
+ * @param subsystem Owner
+ * @param handler Called by EnforceMemoryBudgets(); nullptr removes it
+ *
+ * @example
+ * @code
+ * Util::SetMemoryPressureHandler(Util::MemorySubsystem::CHUNKS, [&](uint64_t excess) {
+ *   chunks.Evict(excess, [&](World::ChunkPosition position) { return players.Views(position); });
+ * });
+ * @endcode
+ */
+void SetMemoryPressureHandler(MemorySubsystem subsystem, MemoryPressureHandler handler);
+
+/**
+ * @brief Call the pressure handler of every subsystem over its budget
+ * @return Number of handlers called
+ * @note Call from the tick thread between ticks, where handlers may unload
+ *       data safely. Handlers are called without internal locks held.
+ */
+size_t EnforceMemoryBudgets();
+
+/**
+ * @brief Parse a byte size such as "512M", "2G", "64k" or "1048576"
+ * @param text Number with an optional K, M or G suffix (powers of 1024)
+ * @return Bytes
+ * @throws std::invalid_argument when @p text is not a size
+ */
+uint64_t ParseByteSize(std::string_view text);
+
+}  // namespace Util
@@ -0,0 +1,159 @@
+/**
+ * @file memory_pressure.h
+ * @brief Container memory pressure monitor
+ *
+ * In a container the OOM killer acts on the cgroup's memory limit, not on
+ * the machine's free memory, and it does not warn. The monitor samples the
+ * cgroup's working set (memory.current minus reclaimable inactive file
+ * pages, cgroup v2 or v1) against its limit, together with the kernel's
+ * memory pressure stall information (PSI), and turns them into a pressure
+ * level with hysteresis.
+ *
+ * The levels feed the controls that can give memory back before the limit
+ * is reached: by default the monitor tightens the memory budgets of caches,
+ * network buffers and chunks (see memory_accounting.h), so caches drop their
+ * entries, the packet pool stops keeping idle buffers and
+ * EnforceMemoryBudgets() evicts unused chunks. Listeners get the level too,
+ * e.g. World::ViewDistancePolicy shortens the view distance of new chunk
+ * loads.
+ *
+ * Outside a memory cgroup the process RSS is compared with physical memory.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "util/memory_accounting.h"
+
+namespace Util {
+
+/**
+ * @enum MemoryPressureLevel
+ * @brief How close the process is to its memory limit
+ */
+enum class MemoryPressureLevel : uint8_t {
+  NONE,
+  MODERATE,  ///< Shed optional memory: shrink caches, shorten view distance
+  CRITICAL,  ///< Free everything that can be rebuilt, evict unused chunks
+};
+
+/** @brief Lower-case name, e.g. "moderate" */
+std::string_view MemoryPressureLevelName(MemoryPressureLevel level);
+
+/**
+ * @struct MemoryPressureConfig
+ * @brief Thresholds and reactions of a MemoryPressureMonitor
+ */
+struct MemoryPressureConfig {
+  std::filesystem::path cgroup_dir;  ///< Memory cgroup directory; empty to detect it
+  uint64_t limit_bytes = 0;          ///< Overrides the cgroup limit when non-zero
+  double moderate_ratio = 0.80;      ///< Working set / limit entering MODERATE
+  double critical_ratio = 0.90;      ///< Working set / limit entering CRITICAL
+  double moderate_psi = 10.0;        ///< "some" avg10 stall percentage entering MODERATE
+  double critical_psi = 5.0;         ///< "full" avg10 stall percentage entering CRITICAL
+  double recovery_margin = 0.05;     ///< Ratio below a threshold before leaving its level
+  std::chrono::milliseconds interval{1000};
+  bool adjust_budgets = true;        ///< Tighten subsystem budgets under pressure
+};
+
+/**
+ * @struct MemoryPressureSample
+ * @brief One reading of the monitor
+ */
+struct MemoryPressureSample {
+  uint64_t working_set_bytes = 0;  ///< Usage minus inactive file cache, or RSS
+  uint64_t limit_bytes = 0;        ///< 0 when unknown
+  double psi_some_avg10 = 0;       ///< Share of time some task stalled on memory, percent
+  double psi_full_avg10 = 0;       ///< Share of time all tasks stalled on memory, percent
+  bool cgroup = false;             ///< Read from a memory cgroup rather than the process
+  MemoryPressureLevel level = MemoryPressureLevel::NONE;
+};
+
+/**
+ * @class MemoryPressureMonitor
+ * @brief Background sampler turning cgroup usage and PSI into pressure levels
+ *
+ * @note Listeners run on the monitor thread and must be thread-safe. Level()
+ *       is a relaxed atomic load, cheap enough for every chunk load.
+ *
+ * @example
+ * @code
+ * Util::MemoryPressureMonitor monitor;
+ * monitor.AddListener([&](Util::MemoryPressureLevel level) { view_distance.OnPressure(level); });
+ * monitor.Start();
+ * @endcode
+ */
+class MemoryPressureMonitor {
+ public:
+  using Listener = std::function<void(MemoryPressureLevel level)>;
+
+  explicit MemoryPressureMonitor(MemoryPressureConfig config = {});
+  ~MemoryPressureMonitor();
+
+  MemoryPressureMonitor(const MemoryPressureMonitor&) = delete;
+  MemoryPressureMonitor& operator=(const MemoryPressureMonitor&) = delete;
+
+  /** @brief Start sampling every config interval on a background thread */
+  void Start();
+
+  /** @brief Stop the background thread; restores budgets changed by the monitor */
+  void Stop();
+
+  /**
+   * @brief Take a sample now and react to a level change
+   *
+   * Entering CRITICAL also trims the global allocator once the listeners
+   * have released what they can, so freed pages leave the working set.
+   *
+   * @return The sample, including the resulting level
+   */
+  MemoryPressureSample Update();
+
+  /** @brief Current level */
+  MemoryPressureLevel Level() const { return level_.load(std::memory_order_relaxed); }
+
+  /** @brief Latest sample */
+  MemoryPressureSample LastSample() const;
+
+  /**
+   * @brief Be told about level changes
+   * @param listener Called with the new level, on the thread that took the sample
+   */
+  void AddListener(Listener listener);
+
+ private:
+  MemoryPressureSample Read() const;
+  MemoryPressureLevel Classify(const MemoryPressureSample& sample) const;
+  void ApplyBudgets(MemoryPressureLevel level);
+  void Loop();
+
+  MemoryPressureConfig config_;
+  std::filesystem::path cgroup_dir_;
+  bool cgroup_v2_ = false;
+  std::atomic<MemoryPressureLevel> level_{MemoryPressureLevel::NONE};
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+  MemoryPressureSample last_;
+  std::vector<Listener> listeners_;
+  /** @brief Operator budgets saved while the monitor overrides them */
+  std::array<uint64_t, MEMORY_SUBSYSTEM_COUNT> saved_budgets_{};
+  bool budgets_overridden_ = false;
+  std::thread thread_;
+};
+
+}  // namespace Util
@@ -0,0 +1,239 @@
+/**
+ * @file metrics.h
+ * @brief Prometheus/OpenMetrics metrics registry with per-thread counter shards
+ *
+ * Counters and histograms are written on hot paths (every packet, every
+ * tick) by many threads at once. A shared atomic would bounce its cache
+ * line between cores on every increment, so each thread owns a shard of
+ * counter slots instead: an increment is a relaxed load and store to a slot
+ * only that thread writes. A scrape sums the slot over every live shard plus
+ * what exited threads left behind, so totals are exact.
+ *
+ * Gauges are plain atomics, or callbacks evaluated at scrape time for values
+ * another component already keeps (player count, queue depth); summaries
+ * come from callbacks too, for latency histograms that compute their own
+ * quantiles (see util/latency_histogram.h). Render() produces the
+ * Prometheus text format (0.0.4) or OpenMetrics 1.0; serve it over
+ * Network::HttpServer (see util/server_metrics.h).
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Util {
+
+/** @brief Label name/value pairs of one series, e.g. {{"direction", "in"}} */
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/** @brief Counter slots across every registry, histogram buckets included */
+constexpr size_t METRIC_SLOTS = 16384;
+
+/**
+ * @enum MetricsFormat
+ * @brief Exposition format of MetricsRegistry::Render()
+ */
+enum class MetricsFormat : uint8_t {
+  PROMETHEUS,   ///< text/plain; version=0.0.4
+  OPENMETRICS,  ///< application/openmetrics-text; version=1.0.0
+};
+
+/** @brief Content-Type header value of @p format */
+std::string_view MetricsContentType(MetricsFormat format);
+
+/**
+ * @brief Format a scraper asked for
+ * @param accept Value of the request's Accept header
+ * @return OPENMETRICS when accepted, PROMETHEUS otherwise
+ */
+MetricsFormat NegotiateMetricsFormat(std::string_view accept);
+
+/**
+ * @struct MetricSummary
+ * @brief Value of a summary series at scrape time
+ */
+struct MetricSummary {
+  std::vector<std::pair<double, double>> quantiles;  ///< Quantile in [0, 1] and its value
+  double sum = 0;                                    ///< Sum of all observations
+  uint64_t count = 0;                                ///< Number of observations
+};
+
+/**
+ * @class Counter
+ * @brief Monotonic count sharded per thread
+ *
+ * @note Thread-safe. Add() writes only the calling thread's shard.
+ */
+class Counter {
+ public:
+  /** @brief Add @p amount; one relaxed load and store on the thread's own slot */
+  void Add(uint64_t amount = 1) noexcept;
+
+  /** @brief Sum over all threads; as expensive as a scrape of this counter */
+  uint64_t Value() const;
+
+ private:
+  friend class MetricsRegistry;
+  explicit Counter(uint32_t slot) : slot_(slot) {}
+
+  uint32_t slot_;
+};
+
+/**
+ * @class Gauge
+ * @brief Value that goes up and down, set by its owner
+ *
+ * @note Thread-safe; a single shared atomic, meant for values that change
+ *       per tick rather than per packet.
+ */
+class Gauge {
+ public:
+  void Set(double value) noexcept { value_.store(value, std::memory_order_relaxed); }
+  void Add(double amount) noexcept { value_.fetch_add(amount, std::memory_order_relaxed); }
+  double Value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  friend class MetricsRegistry;
+  Gauge() = default;
+
+  std::atomic<double> value_{0.0};
+};
+
+/**
+ * @class Histogram
+ * @brief Bucketed distribution of integer observations, sharded per thread
+ *
+ * Observations are integers in a fixed unit (microseconds, bytes) so that
+ * every bucket and the sum are counter slots; @p scale converts them to the
+ * exposed base unit, e.g. 1e-6 to expose microseconds as seconds.
+ *
+ * @note Thread-safe. Observe() writes two slots of the thread's own shard.
+ */
+class Histogram {
+ public:
+  /** @brief Record one observation */
+  void Observe(uint64_t value) noexcept;
+
+ private:
+  friend class MetricsRegistry;
+  Histogram(uint32_t first_slot, std::vector<uint64_t> bounds, double scale)
+      : first_slot_(first_slot), bounds_(std::move(bounds)), scale_(scale) {}
+
+  uint32_t first_slot_;          ///< One slot per bucket, +Inf included, then the sum
+  std::vector<uint64_t> bounds_;  ///< Inclusive upper bounds, ascending
+  double scale_;
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief Named metric families and their exposition
+ *
+ * Names follow Prometheus conventions: base units (seconds, bytes) and
+ * counter names without the _total suffix, which the exposition adds.
+ * Registered metrics live as long as the registry; their counter slots are
+ * not reused after it is destroyed.
+ *
+ * @note Thread-safe. Registration and Render() lock the registry; recording
+ *       never does.
+ *
+ * @example
+ * @code
+ * Util::MetricsRegistry registry;
+ * Util::Counter& bytes = registry.AddCounter("parellelstone_network_bytes",
+ *                                            "Bytes sent to clients", {{"direction", "out"}});
+ * bytes.Add(packet.size());
+ * registry.AddGaugeCallback("parellelstone_players", "Players online", {},
+ *                           [&] { return static_cast<double>(players.Size()); });
+ * std::string body = registry.Render(Util::MetricsFormat::PROMETHEUS);
+ * @endcode
+ */
+class MetricsRegistry {
+ public:
+  MetricsRegistry();
+  ~MetricsRegistry();
+
+  MetricsRegistry(const MetricsRegistry&) = delete;
+  MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+  /**
+   * @brief Register a counter series
+   * @param name Family name without _total
+   * @param help One-line description of the family
+   * @param labels Labels of this series
+   * @return The counter, valid for the registry's lifetime
+   * @throws std::invalid_argument If a name is malformed, the series exists
+   *         or the family was registered with another type
+   * @throws std::length_error If METRIC_SLOTS are used up
+   */
+  Counter& AddCounter(std::string name, std::string help, MetricLabels labels = {});
+
+  /**
+   * @brief Register a gauge series the owner sets
+   * @throws std::invalid_argument As for AddCounter()
+   */
+  Gauge& AddGauge(std::string name, std::string help, MetricLabels labels = {});
+
+  /**
+   * @brief Register a gauge series read from @p read at scrape time
+   * @param read Called on the scraping thread with the registry locked; must
+   *             be thread-safe and must not register metrics
+   * @throws std::invalid_argument As for AddCounter()
+   */
+  void AddGaugeCallback(std::string name, std::string help, MetricLabels labels,
+                        std::function<double()> read);
+
+  /**
+   * @brief Register a counter series whose total another component keeps
+   * @param read Returns the monotonic total; called like AddGaugeCallback()'s
+   * @throws std::invalid_argument As for AddCounter()
+   */
+  void AddCounterCallback(std::string name, std::string help, MetricLabels labels,
+                          std::function<uint64_t()> read);
+
+  /**
+   * @brief Register a summary series read from @p read at scrape time
+   * @param read Called like AddGaugeCallback()'s
+   * @throws std::invalid_argument As for AddCounter()
+   */
+  void AddSummaryCallback(std::string name, std::string help, MetricLabels labels,
+                          std::function<MetricSummary()> read);
+
+  /**
+   * @brief Register a histogram series
+   * @param bounds Inclusive bucket upper bounds in observation units, ascending
+   * @param scale Factor from observation units to the exposed unit
+   * @throws std::invalid_argument As for AddCounter(), or if @p bounds is
+   *         empty or not ascending
+   * @throws std::length_error If METRIC_SLOTS are used up
+   */
+  Histogram& AddHistogram(std::string name, std::string help, std::vector<uint64_t> bounds,
+                          double scale = 1.0, MetricLabels labels = {});
+
+  /** @brief Every family in @p format, in registration order */
+  std::string Render(MetricsFormat format = MetricsFormat::PROMETHEUS) const;
+
+ private:
+  enum class Type : uint8_t { COUNTER, GAUGE, HISTOGRAM, SUMMARY };
+  struct Series;
+  struct Family;
+
+  Series& AddSeries(std::string name, std::string help, Type type, MetricLabels labels);
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Family>> families_;
+  std::map<std::string, Family*, std::less<>> by_name_;
+};
+
+}  // namespace Util
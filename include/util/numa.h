@@ -0,0 +1,91 @@
+/**
+ * @file numa.h
+ * @brief NUMA topology, thread pinning and memory placement
+ *
+ * On multi-socket hosts a thread that ticks a region on one node while the
+ * region's chunks live in the other node's memory pays the interconnect
+ * latency on every block access. The helpers here let the server keep
+ * both on the same node: worker pools pin their threads to a node (see
+ * WorkerPool), the slab allocator reserves each thread heap's memory on
+ * that thread's node, and ChunkColumn::Relocate() moves a column's storage
+ * after its region was handed to another node.
+ *
+ * Linux uses sysfs for the topology and the mbind system call for placement
+ * (no libnuma dependency). Windows supports topology and pinning; memory
+ * follows the first-touch policy there. Other platforms report one node.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Util {
+
+/** @brief Highest number of nodes tracked by per-node counters */
+constexpr size_t MAX_NUMA_NODES = 8;
+
+/**
+ * @struct NumaTopology
+ * @brief Online nodes and their CPUs
+ */
+struct NumaTopology {
+  std::vector<std::vector<int>> node_cpus;  ///< CPUs of each node, indexed by node id
+  std::vector<int> cpu_node;                ///< Node of each CPU, -1 when unknown
+
+  /** @brief Number of nodes; 1 on non-NUMA machines */
+  size_t NodeCount() const { return node_cpus.size(); }
+};
+
+/**
+ * @struct NumaNodeCounters
+ * @brief Kernel page allocation counters of one node (Linux numastat)
+ *
+ * numa_miss and other_node count pages that ended up on a node other than
+ * the one the allocating thread preferred or ran on; rising values mean
+ * memory is being placed remotely.
+ */
+struct NumaNodeCounters {
+  uint64_t numa_hit = 0;
+  uint64_t numa_miss = 0;
+  uint64_t numa_foreign = 0;
+  uint64_t local_node = 0;
+  uint64_t other_node = 0;
+};
+
+/** @brief Topology of this machine, discovered on first use */
+const NumaTopology& GetNumaTopology();
+
+/**
+ * @brief Node the calling thread is currently running on
+ * @return Node id, 0 when unknown or on non-NUMA machines
+ */
+int CurrentNumaNode();
+
+/**
+ * @brief Restrict the calling thread to the CPUs of a node
+ * @param node Node id
+ * @return False when the node does not exist or pinning is unsupported
+ */
+bool PinCurrentThreadToNode(int node);
+
+/**
+ * @brief Prefer a node for the pages of a memory range
+ * @param address Page-aligned start of the range
+ * @param size Bytes
+ * @param node Node id
+ * @param migrate Also move pages that are already resident
+ * @return False when placement is unsupported or the call failed
+ */
+bool BindMemoryToNode(void* address, size_t size, int node, bool migrate);
+
+/**
+ * @brief Read the kernel allocation counters of every node
+ * @return One entry per node; empty when unsupported
+ */
+std::vector<NumaNodeCounters> ReadNumaCounters();
+
+}  // namespace Util
@@ -0,0 +1,129 @@
+/**
+ * @file server_metrics.h
+ * @brief The server's standard metric set and its /metrics endpoint
+ *
+ * Registers what every instance exports: TPS and the tick duration (MSPT)
+ * histogram, players, loaded chunks and entities, network bytes and
+ * packets per direction, queue depths, and allocator state (live and peak
+ * bytes per memory subsystem, budgets, slab counters, the global
+ * allocator in use).
+ *
+ * Values other components already keep are read through callbacks at
+ * scrape time; traffic and ticks are counted here. The network threads
+ * call CountReceived()/CountSent() per packet and the tick loop calls
+ * RecordTick() once per tick.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "network/http_server.h"
+#include "util/metrics.h"
+
+namespace Util {
+
+/** @brief Ticks TPS and the mean MSPT are computed over (5 s at 20 TPS) */
+constexpr size_t TICK_WINDOW = 100;
+
+/**
+ * @struct ServerMetricSources
+ * @brief Where scrape-time values come from; unset callbacks are not exported
+ */
+struct ServerMetricSources {
+  std::function<size_t()> players;        ///< Players online
+  std::function<size_t()> loaded_chunks;  ///< Chunk columns in memory
+  std::function<size_t()> entities;       ///< Entities across all worlds
+  /** @brief Queue name and depth, exported as parellelstone_queue_depth{queue="name"} */
+  std::vector<std::pair<std::string, std::function<size_t()>>> queues;
+};
+
+/**
+ * @class ServerMetrics
+ * @brief Standard server metrics registered in a MetricsRegistry
+ *
+ * @note Thread-safe. RecordTick() is meant for the single tick thread;
+ *       CountReceived() and CountSent() may be called from any thread. The
+ *       registry's callbacks refer to this object, so it must outlive every
+ *       scrape of the registry.
+ *
+ * @example
+ * @code
+ * Util::MetricsRegistry registry;
+ * Util::ServerMetricSources sources;
+ * sources.players = [&] { return players.Size(); };
+ * sources.queues.emplace_back("workers", [&] { return workers.QueueDepth(); });
+ * Util::ServerMetrics metrics(registry, std::move(sources));
+ * Util::ServeMetrics(http, registry);
+ * // tick loop
+ * metrics.RecordTick(std::chrono::steady_clock::now() - tick_start);
+ * @endcode
+ */
+class ServerMetrics {
+ public:
+  /**
+   * @brief Register the standard metrics
+   * @throws std::invalid_argument If @p registry already holds them
+   */
+  ServerMetrics(MetricsRegistry& registry, ServerMetricSources sources);
+
+  ServerMetrics(const ServerMetrics&) = delete;
+  ServerMetrics& operator=(const ServerMetrics&) = delete;
+
+  /**
+   * @brief Record a finished tick
+   * @param duration Time the tick's work took, excluding the sleep until the next tick
+   */
+  void RecordTick(std::chrono::nanoseconds duration) noexcept;
+
+  /** @brief Count one packet of @p bytes read from a client */
+  void CountReceived(size_t bytes) noexcept;
+
+  /** @brief Count one packet of @p bytes written to a client */
+  void CountSent(size_t bytes) noexcept;
+
+  /** @brief Ticks per second over the last TICK_WINDOW ticks; falls while the loop stalls */
+  double TicksPerSecond() const;
+
+  /** @brief Mean tick duration over the last TICK_WINDOW ticks, in milliseconds */
+  double MillisecondsPerTick() const;
+
+  /** @brief When the latest tick finished; nullopt before the first one */
+  std::optional<std::chrono::steady_clock::time_point> LastTickTime() const;
+
+ private:
+  ServerMetricSources sources_;
+  Counter& ticks_;
+  Histogram& tick_duration_;
+  Counter& bytes_received_;
+  Counter& bytes_sent_;
+  Counter& packets_received_;
+  Counter& packets_sent_;
+
+  // Written by the tick thread only; readers tolerate a torn window
+  std::array<std::atomic<int64_t>, TICK_WINDOW> tick_ends_ns_{};
+  std::array<std::atomic<int64_t>, TICK_WINDOW> tick_durations_ns_{};
+  std::atomic<uint64_t> tick_count_{0};
+};
+
+/**
+ * @brief Serve @p registry on @p server, negotiating Prometheus or OpenMetrics text
+ * @param server Server to add the route to
+ * @param registry Registry to render; must outlive the route
+ * @param path Route, "/metrics" by convention
+ */
+void ServeMetrics(Network::HttpServer& server, const MetricsRegistry& registry,
+                  std::string path = "/metrics");
+
+}  // namespace Util
@@ -0,0 +1,146 @@
+/**
+ * @file slab_allocator.h
+ * @brief Size-class slab allocator with thread-local heaps
+ *
+ * Chunk sections allocate and free their palette and packed data as players
+ * explore, thousands of times per second, in a handful of sizes. The slab
+ * allocator serves those sizes from 64 KiB slabs, each holding blocks of a
+ * single size class, so churn reuses the same slabs instead of fragmenting
+ * the general heap, and a slab whose blocks are all free goes back to the
+ * system.
+ *
+ * Every thread allocates from its own heap without locking. A block freed
+ * by a thread other than its slab's owner (a section generated on a worker
+ * and unloaded by the tick thread) is pushed onto the owner's lock-free
+ * remote list; the owner takes the whole list back the next time it runs
+ * out of blocks. A heap whose thread exits is adopted by the next thread
+ * that needs one, so its slabs are never stranded.
+ *
+ * Each heap takes its slabs from segments placed on the NUMA node its thread
+ * runs on, so a worker pinned to a node (see WorkerPool) allocates local
+ * memory. Sizes above the largest class go to ::operator new. Segments can
+ * be backed by huge pages, see SetSlabHugePages().
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "util/memory_accounting.h"
+#include "util/numa.h"
+
+namespace Util {
+
+/** @brief Size and alignment of a slab */
+constexpr size_t SLAB_SIZE = 64 * 1024;
+
+/**
+ * @brief Block sizes served from slabs
+ *
+ * Besides powers of two, the packed data sizes of 5, 6 and 7 bit chunk
+ * sections (rounded to 64 bytes) get their own class so they do not waste
+ * up to a third of a 4 KiB block.
+ */
+constexpr std::array<size_t, 12> SLAB_CLASSES = {32,   64,   128,  256,  512,  1024,
+                                                 2048, 2752, 3328, 3712, 4096, 8192};
+
+/** @brief Largest alignment a slab block guarantees */
+constexpr size_t SLAB_ALIGNMENT = 64;
+
+/**
+ * @struct SlabStats
+ * @brief Process-wide slab counters
+ */
+struct SlabStats {
+  uint64_t slabs_live = 0;        ///< Slabs currently held
+  uint64_t slabs_allocated = 0;   ///< Slabs obtained from the system
+  uint64_t slabs_released = 0;    ///< Empty slabs given back
+  uint64_t remote_frees = 0;      ///< Blocks freed by a thread other than the owner
+  uint64_t large_allocations = 0; ///< Requests above the largest class
+  uint64_t heaps = 0;             ///< Thread heaps created
+  uint64_t segments = 0;          ///< Address-space segments reserved for slabs
+  bool huge_pages = false;        ///< Segments come from huge pages
+  std::array<uint64_t, MAX_NUMA_NODES> slabs_per_node{};  ///< Live slabs placed on each node
+};
+
+/**
+ * @brief Allocate from the calling thread's slab heap
+ * @param size Bytes; alignment is min(size class, SLAB_ALIGNMENT)
+ * @return Block of at least @p size bytes
+ * @throws std::bad_alloc When the system is out of memory
+ */
+void* SlabAllocate(size_t size);
+
+/**
+ * @brief Return a block from SlabAllocate(), from any thread
+ * @param block Block to free; nullptr is ignored
+ * @param size The size passed to SlabAllocate()
+ */
+void SlabFree(void* block, size_t size) noexcept;
+
+/** @brief Snapshot of the process-wide counters */
+SlabStats GetSlabStats();
+
+/**
+ * @brief Back new slab segments with 2 MiB pages (see Platform::AllocateHugePages())
+ * @param enable True to use huge pages
+ *
+ * Fewer TLB misses on random block access, at a memory cost: empty slabs
+ * stay committed instead of being decommitted, because returning 64 KiB
+ * of a huge page would split it back into small pages.
+ *
+ * @note Call once at startup, before chunk data is allocated.
+ */
+void SetSlabHugePages(bool enable);
+
+/**
+ * @class SlabAllocator
+ * @brief Standard allocator backed by SlabAllocate()
+ *
+ * Stateless: every instance is interchangeable, so containers can be moved
+ * and swapped across threads. The requested bytes are accounted to
+ * @p SUBSYSTEM (see TrackAllocation()).
+ *
+ * @example
+ * @code
+ * std::vector<uint64_t, Util::SlabAllocator<uint64_t, Util::MemorySubsystem::CHUNKS>> packed;
+ * @endcode
+ */
+template <typename T, MemorySubsystem SUBSYSTEM = MemorySubsystem::OTHER>
+class SlabAllocator {
+ public:
+  static_assert(alignof(T) <= SLAB_ALIGNMENT, "type is over-aligned for slab blocks");
+
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = SlabAllocator<U, SUBSYSTEM>;
+  };
+
+  SlabAllocator() noexcept = default;
+  template <typename U>
+  SlabAllocator(const SlabAllocator<U, SUBSYSTEM>&) noexcept {}
+
+  T* allocate(size_t count) {
+    T* block = static_cast<T*>(SlabAllocate(count * sizeof(T)));
+    TrackAllocation(SUBSYSTEM, count * sizeof(T));
+    return block;
+  }
+  void deallocate(T* block, size_t count) noexcept {
+    TrackRelease(SUBSYSTEM, count * sizeof(T));
+    SlabFree(block, count * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const SlabAllocator<U, SUBSYSTEM>&) const noexcept {
+    return true;
+  }
+};
+
+}  // namespace Util
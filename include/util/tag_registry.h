@@ -0,0 +1,98 @@
+/**
+ * @file tag_registry.h
+ * @brief Datapack tags of one registry, resolved to membership bitsets
+ *
+ * A tag such as "#minecraft:logs" names a set of registry entries and may
+ * include other tags. Tags are defined while datapacks load, then Resolve()
+ * flattens nested tags once. Afterwards a membership test ("is this block
+ * in minecraft:mineable/axe?") is a bit test on the entry's registry id, and
+ * the tag itself is addressed by its interned Identifier instead of a
+ * string.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "util/identifier.h"
+
+namespace Util {
+
+/**
+ * @class TagRegistry
+ * @brief Tags over the numeric ids of one registry (blocks, items, ...)
+ *
+ * @note Define() and Resolve() must finish before concurrent lookups;
+ *       lookups are thread-safe afterwards.
+ *
+ * @example
+ * @code
+ * Util::TagRegistry block_tags;
+ * block_tags.Define(Util::Identifier::Intern("minecraft:logs"), {}, {oak_logs, birch_logs});
+ * block_tags.Resolve();
+ * if (block_tags.Contains(logs, state_block_id)) { ... }
+ * @endcode
+ */
+class TagRegistry {
+ public:
+  /**
+   * @brief Define a tag, or extend it when already defined (datapack merging)
+   * @param tag Tag identifier, without the leading '#'
+   * @param entries Registry ids of direct members
+   * @param included_tags Tags whose members are included
+   */
+  void Define(Identifier tag, std::span<const int32_t> entries,
+              std::span<const Identifier> included_tags = {});
+
+  /**
+   * @brief Flatten included tags into every tag's member set
+   * @throws std::invalid_argument when a tag includes an undefined tag or
+   *         includes itself through a cycle
+   */
+  void Resolve();
+
+  /**
+   * @brief Membership test
+   * @param tag Tag identifier
+   * @param entry Registry id
+   * @return False for unknown tags and for entries outside the tag
+   */
+  bool Contains(Identifier tag, int32_t entry) const {
+    const Tag* found = tags_.Find(tag);
+    if (found == nullptr || entry < 0) {
+      return false;
+    }
+    const auto bit = static_cast<size_t>(entry);
+    return bit / 64 < found->bits.size() && (found->bits[bit / 64] >> (bit % 64)) & 1;
+  }
+
+  /** @brief Sorted members of a resolved tag; empty for unknown tags */
+  std::span<const int32_t> Entries(Identifier tag) const;
+
+  /** @brief True when @p tag is defined */
+  bool Has(Identifier tag) const { return tags_.Contains(tag); }
+
+  /** @brief Number of defined tags */
+  size_t Size() const { return tags_.Size(); }
+
+ private:
+  enum class State : uint8_t { UNRESOLVED, RESOLVING, RESOLVED };
+
+  struct Tag {
+    std::vector<int32_t> entries;  ///< Sorted, unique once resolved
+    std::vector<Identifier> included;
+    std::vector<uint64_t> bits;  ///< Membership bitset indexed by registry id
+    State state = State::UNRESOLVED;
+  };
+
+  void ResolveTag(Identifier id, Tag& tag);
+
+  IdentifierMap<Tag> tags_;
+  std::vector<Identifier> order_;  ///< Tags in definition order
+};
+
+}  // namespace Util
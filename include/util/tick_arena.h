@@ -0,0 +1,114 @@
+/**
+ * @file tick_arena.h
+ * @brief Monotonic per-tick memory resource for transient data
+ *
+ * Scratch data that lives for at most one tick (decoded packet fields,
+ * intermediate encode buffers, per-tick work lists) is allocated from a
+ * TickArena through std::pmr containers. Allocation is a pointer bump;
+ * deallocation is a no-op; Reset() at tick end releases everything at once.
+ * Memory is kept between ticks: if a tick needed more than one block, Reset()
+ * replaces the blocks with a single block of the combined size, so after a
+ * few ticks the arena serves every tick from one block with no upstream
+ * allocation.
+ *
+ * With poisoning enabled (the default in debug builds) new allocations are
+ * filled with 0xCD and released memory with 0xDD, so reads of uninitialized
+ * scratch data and uses after Reset() show up as obviously wrong values.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace Util {
+
+/** @brief Byte written over fresh allocations when poisoning */
+constexpr uint8_t ARENA_ALLOCATED_POISON = 0xCD;
+/** @brief Byte written over memory released by Reset() when poisoning */
+constexpr uint8_t ARENA_RELEASED_POISON = 0xDD;
+
+/**
+ * @struct TickArenaStats
+ * @brief Counters of a TickArena
+ */
+struct TickArenaStats {
+  uint64_t ticks = 0;                 ///< Reset() calls
+  uint64_t allocations = 0;
+  uint64_t upstream_allocations = 0;  ///< Blocks obtained from the heap
+  size_t peak_bytes = 0;              ///< Largest single-tick usage
+  size_t capacity = 0;                ///< Bytes currently held
+};
+
+/**
+ * @class TickArena
+ * @brief Bump allocator reset once per tick
+ *
+ * @note Not thread-safe. Each tick thread owns its arena; memory from it
+ *       must not be kept past Reset().
+ *
+ * @example
+ * @code
+ * Util::TickArena arena;
+ * // during the tick:
+ * std::pmr::vector<World::BlockPosition> changed(&arena);
+ * changed.reserve(256);
+ * // tick end:
+ * arena.Reset();
+ * @endcode
+ */
+class TickArena : public std::pmr::memory_resource {
+ public:
+#ifdef NDEBUG
+  static constexpr bool DEFAULT_POISON = false;
+#else
+  static constexpr bool DEFAULT_POISON = true;
+#endif
+
+  /**
+   * @brief Create an arena
+   * @param initial_size Size of the first block, allocated up front
+   * @param poison Fill allocated and released memory with marker bytes
+   */
+  explicit TickArena(size_t initial_size = 256 * 1024, bool poison = DEFAULT_POISON);
+
+  TickArena(const TickArena&) = delete;
+  TickArena& operator=(const TickArena&) = delete;
+
+  /** @brief Release every allocation; call at tick end */
+  void Reset();
+
+  /** @brief Bytes handed out since the last Reset(), including alignment padding */
+  size_t BytesUsed() const { return used_before_current_ + offset_; }
+
+  /** @brief Cumulative counters */
+  const TickArenaStats& GetStats() const { return stats_; }
+
+ private:
+  struct Block {
+    std::unique_ptr<std::byte[]> memory;
+    size_t size = 0;
+  };
+
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void*, size_t, size_t) override {}
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  void AddBlock(size_t size);
+
+  std::vector<Block> blocks_;
+  size_t current_ = 0;              ///< Block being bumped
+  size_t offset_ = 0;               ///< Next free byte in blocks_[current_]
+  size_t used_before_current_ = 0;  ///< Bytes used in blocks before current_
+  bool poison_;
+  TickArenaStats stats_;
+};
+
+}  // namespace Util
@@ -0,0 +1,56 @@
+/**
+ * @file uuid.h
+ * @brief 128-bit UUID as used for player and entity identities
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "util/hash.h"
+
+namespace Util {
+
+/**
+ * @struct Uuid
+ * @brief UUID stored as the two big-endian halves the protocol sends
+ */
+struct Uuid {
+  uint64_t most = 0;   ///< Most significant 64 bits
+  uint64_t least = 0;  ///< Least significant 64 bits
+
+  /** @brief True for the nil UUID */
+  constexpr bool IsNil() const { return most == 0 && least == 0; }
+
+  /** @brief Canonical lowercase 8-4-4-4-12 hex form */
+  std::string ToString() const {
+    static constexpr char HEX[] = "0123456789abcdef";
+    std::string text;
+    text.reserve(36);
+    for (int i = 0; i < 32; ++i) {
+      if (i == 8 || i == 12 || i == 16 || i == 20) {
+        text += '-';
+      }
+      const uint64_t half = i < 16 ? most : least;
+      text += HEX[(half >> ((15 - i % 16) * 4)) & 0xF];
+    }
+    return text;
+  }
+
+  constexpr bool operator==(const Uuid&) const = default;
+  constexpr auto operator<=>(const Uuid&) const = default;
+};
+
+/** @brief Hash functor for Uuid keyed containers */
+struct UuidHash {
+  size_t operator()(const Uuid& uuid) const {
+    return static_cast<size_t>(HashCombine(uuid.most, uuid.least));
+  }
+};
+
+}  // namespace Util
@@ -0,0 +1,103 @@
+/**
+ * @file worker_pool.h
+ * @brief Fixed-size thread pool for work that must stay off the tick thread
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @namespace Util
+ * @brief General purpose building blocks shared by the server subsystems
+ */
+namespace Util {
+
+/**
+ * @class WorkerPool
+ * @brief A fixed number of worker threads draining a shared FIFO task queue
+ *
+ * Tasks must not block waiting for other tasks of the same pool, otherwise
+ * a small pool can deadlock. Fan-out/fan-in work should count completions
+ * instead (see World::BulkEditor).
+ *
+ * A pool can be confined to one NUMA node: its workers then run on that
+ * node's CPUs and their slab allocations come from its memory. Give each
+ * node its own pool and post a region's work to the pool of its node.
+ *
+ * @note Submit() is thread-safe. The destructor drains queued tasks and
+ *       joins all workers.
+ *
+ * @example
+ * @code
+ * Util::WorkerPool pool(4);
+ * std::future<int> answer = pool.Submit([] { return 42; });
+ * @endcode
+ */
+class WorkerPool {
+ public:
+  /**
+   * @brief Start the worker threads
+   * @param thread_count Number of workers; 0 selects hardware concurrency, or
+   *                     the CPU count of @p numa_node
+   * @param numa_node Node to pin the workers to; -1 leaves them unpinned
+   */
+  explicit WorkerPool(size_t thread_count = 0, int numa_node = -1);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * @brief Queue a callable and obtain a future for its result
+   * @param task Callable invoked with no arguments on a worker thread
+   * @return std::future receiving the result or the thrown exception
+   */
+  template <typename Function>
+  auto Submit(Function&& task) -> std::future<std::invoke_result_t<Function>> {
+    using Result = std::invoke_result_t<Function>;
+    auto packaged =
+        std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(task));
+    std::future<Result> future = packaged->get_future();
+    Post([packaged] { (*packaged)(); });
+    return future;
+  }
+
+  /**
+   * @brief Queue a fire-and-forget task
+   * @param task Callable invoked on a worker thread; exceptions are logged and dropped
+   */
+  void Post(std::function<void()> task);
+
+  /** @brief Number of worker threads */
+  size_t ThreadCount() const { return threads_.size(); }
+
+  /** @brief Node the workers are pinned to, -1 when unpinned */
+  int NumaNode() const { return numa_node_; }
+
+  /** @brief Number of tasks waiting for a worker */
+  size_t QueueDepth() const;
+
+ private:
+  void WorkerLoop();
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::deque<std::function<void()>> queue_;
+  std::vector<std::thread> threads_;
+  bool stopping_ = false;
+  int numa_node_;
+};
+
+}  // namespace Util
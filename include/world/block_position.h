@@ -0,0 +1,112 @@
+/**
+ * @file block_position.h
+ * @brief Block, section and chunk coordinates with their protocol encodings
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+/**
+ * @namespace World
+ * @brief World data model: coordinates, chunk storage and block edits
+ */
+namespace World {
+
+/** @brief Width of a chunk section along each axis, in blocks */
+constexpr int32_t SECTION_SIZE = 16;
+
+/** @brief Number of blocks in a chunk section */
+constexpr int32_t SECTION_VOLUME = SECTION_SIZE * SECTION_SIZE * SECTION_SIZE;
+
+/**
+ * @struct SectionPosition
+ * @brief Coordinates of a 16x16x16 chunk section
+ */
+struct SectionPosition {
+  int32_t x = 0;
+  int32_t y = 0;
+  int32_t z = 0;
+
+  /**
+   * @brief Encode as the protocol's packed section position
+   * @return 64-bit value with x (22 bits), z (22 bits), y (20 bits)
+   */
+  constexpr int64_t Encode() const {
+    return static_cast<int64_t>(
+        ((static_cast<uint64_t>(x) & 0x3FFFFF) << 42) |
+        ((static_cast<uint64_t>(z) & 0x3FFFFF) << 20) |
+        (static_cast<uint64_t>(y) & 0xFFFFF));
+  }
+
+  constexpr bool operator==(const SectionPosition&) const = default;
+};
+
+/**
+ * @struct ChunkPosition
+ * @brief Coordinates of a full-height chunk column
+ */
+struct ChunkPosition {
+  int32_t x = 0;
+  int32_t z = 0;
+
+  constexpr bool operator==(const ChunkPosition&) const = default;
+};
+
+/**
+ * @struct BlockPosition
+ * @brief Absolute block coordinates
+ */
+struct BlockPosition {
+  int32_t x = 0;
+  int32_t y = 0;
+  int32_t z = 0;
+
+  /**
+   * @brief Encode as the protocol's packed Position type
+   * @return 64-bit value with x (26 bits), z (26 bits), y (12 bits)
+   */
+  constexpr int64_t Encode() const {
+    return static_cast<int64_t>(
+        ((static_cast<uint64_t>(x) & 0x3FFFFFF) << 38) |
+        ((static_cast<uint64_t>(z) & 0x3FFFFFF) << 12) |
+        (static_cast<uint64_t>(y) & 0xFFF));
+  }
+
+  /** @brief Section containing this block */
+  constexpr SectionPosition Section() const { return {x >> 4, y >> 4, z >> 4}; }
+
+  /** @brief Chunk column containing this block */
+  constexpr ChunkPosition Chunk() const { return {x >> 4, z >> 4}; }
+
+  /**
+   * @brief Index of this block inside its section
+   * @return Value in [0, 4096) laid out as (y << 8) | (z << 4) | x
+   */
+  constexpr uint16_t SectionIndex() const {
+    return static_cast<uint16_t>(((y & 15) << 8) | ((z & 15) << 4) | (x & 15));
+  }
+
+  constexpr bool operator==(const BlockPosition&) const = default;
+};
+
+/** @brief Hash functor for SectionPosition keyed containers */
+struct SectionPositionHash {
+  size_t operator()(const SectionPosition& position) const {
+    return std::hash<int64_t>{}(position.Encode());
+  }
+};
+
+/** @brief Hash functor for ChunkPosition keyed containers */
+struct ChunkPositionHash {
+  size_t operator()(const ChunkPosition& position) const {
+    return std::hash<uint64_t>{}((static_cast<uint64_t>(static_cast<uint32_t>(position.x)) << 32) |
+                                 static_cast<uint32_t>(position.z));
+  }
+};
+
+}  // namespace World
@@ -0,0 +1,240 @@
+/**
+ * @file bulk_editor.h
+ * @brief Asynchronous fill / clone / paste of large block regions
+ *
+ * Bulk edits bypass per-block change tracking. Work is split per chunk
+ * column and run on a worker pool; inside a column every touched section
+ * is unpacked once, edited in a flat array and re-packed once (or switched
+ * to a single-value palette when a fill covers it completely). Heightmaps
+ * are recomputed once per column and the listener hooks fire once per
+ * rewritten section (lighting) and once per column (chunk resend).
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "world/block_position.h"
+#include "world/chunk_column.h"
+
+namespace Util {
+class WorkerPool;
+}
+
+namespace World {
+
+/**
+ * @struct BlockBox
+ * @brief Axis-aligned box of blocks with inclusive corners
+ */
+struct BlockBox {
+  BlockPosition min;
+  BlockPosition max;
+
+  /**
+   * @brief Build a box from two arbitrary opposite corners
+   * @param a First corner
+   * @param b Opposite corner
+   */
+  static constexpr BlockBox FromCorners(const BlockPosition& a, const BlockPosition& b) {
+    return {{std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)},
+            {std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)}};
+  }
+
+  /**
+   * @brief True when @p max lies below @p min on some axis
+   *
+   * Such a box holds no blocks. FromCorners() never builds one; a box
+   * assembled field by field can.
+   */
+  constexpr bool Inverted() const { return max.x < min.x || max.y < min.y || max.z < min.z; }
+
+  constexpr int32_t SizeX() const { return max.x - min.x + 1; }
+  constexpr int32_t SizeY() const { return max.y - min.y + 1; }
+  constexpr int32_t SizeZ() const { return max.z - min.z + 1; }
+
+  /** @brief Number of blocks inside the box, 0 when inverted */
+  constexpr int64_t Volume() const {
+    return Inverted() ? 0 : static_cast<int64_t>(SizeX()) * SizeY() * SizeZ();
+  }
+};
+
+/**
+ * @class Schematic
+ * @brief Dense block state snapshot of a box, indexed (y, z, x)
+ */
+class Schematic {
+ public:
+  /**
+   * @brief Create an all-air schematic
+   * @param size_x Width along x
+   * @param size_y Height along y
+   * @param size_z Length along z
+   */
+  Schematic(int32_t size_x, int32_t size_y, int32_t size_z)
+      : size_x_(size_x),
+        size_y_(size_y),
+        size_z_(size_z),
+        states_(static_cast<size_t>(size_x) * size_y * size_z, AIR_STATE) {}
+
+  int32_t SizeX() const { return size_x_; }
+  int32_t SizeY() const { return size_y_; }
+  int32_t SizeZ() const { return size_z_; }
+
+  /** @brief Block state at schematic-local coordinates */
+  int32_t Get(int32_t x, int32_t y, int32_t z) const { return states_[IndexOf(x, y, z)]; }
+
+  /** @brief Set the block state at schematic-local coordinates */
+  void Set(int32_t x, int32_t y, int32_t z, int32_t state_id) {
+    states_[IndexOf(x, y, z)] = state_id;
+  }
+
+  /** @brief Raw states in (y, z, x) order, e.g. for loading from a file */
+  std::span<int32_t> States() { return states_; }
+
+ private:
+  size_t IndexOf(int32_t x, int32_t y, int32_t z) const {
+    return (static_cast<size_t>(y) * size_z_ + z) * size_x_ + x;
+  }
+
+  int32_t size_x_;
+  int32_t size_y_;
+  int32_t size_z_;
+  std::vector<int32_t> states_;
+};
+
+/**
+ * @struct BulkEditResult
+ * @brief Summary of a completed bulk edit
+ */
+struct BulkEditResult {
+  uint64_t blocks_written = 0;      ///< Blocks inside loaded columns that were written
+  uint64_t sections_filled = 0;     ///< Sections collapsed to a single-value palette
+  uint64_t sections_rewritten = 0;  ///< Sections unpacked, edited and re-packed
+  uint64_t columns_updated = 0;     ///< Columns whose heightmap was recomputed
+  uint64_t columns_skipped = 0;     ///< Columns in the box that were not loaded
+  std::chrono::nanoseconds elapsed{0};
+};
+
+/**
+ * @struct BulkEditListener
+ * @brief Hooks invoked while an edit is applied
+ *
+ * Both hooks run on worker threads with the column's Mutex() held, so
+ * they see consistent block data but must not lock other columns.
+ */
+struct BulkEditListener {
+  /** @brief Once per modified section, e.g. to relight it */
+  std::function<void(ChunkColumn& column, int32_t section_y)> on_section_changed;
+  /** @brief Once per modified column after its heightmap is rebuilt, e.g. to resend it */
+  std::function<void(ChunkColumn& column)> on_column_changed;
+};
+
+/**
+ * @class BulkEditor
+ * @brief Applies fill, clone and paste operations section-at-a-time on workers
+ *
+ * Columns outside the loaded set are skipped and counted in the result.
+ *
+ * @note The returned futures complete on a worker thread. The tick thread
+ *       must lock ChunkColumn::Mutex() for columns it edits concurrently.
+ *
+ * @example
+ * @code
+ * World::BulkEditor editor(chunk_map, workers);
+ * auto done = editor.Fill(World::BlockBox::FromCorners(a, b), stone_state,
+ *                         {.on_column_changed = [&](World::ChunkColumn& c) {
+ *                            chunk_sender.Resend(c.Position());
+ *                          }});
+ * @endcode
+ */
+class BulkEditor {
+ public:
+  /**
+   * @brief Bind the editor to a world's chunks and a worker pool
+   * @param chunks Loaded columns of the target world
+   * @param workers Pool running the per-column tasks
+   */
+  BulkEditor(ChunkMap& chunks, Util::WorkerPool& workers) : chunks_(chunks), workers_(workers) {}
+
+  /**
+   * @brief Set every block of a box to one state
+   * @param box Target box
+   * @param state_id Block state id to write
+   * @param listener Optional per-section / per-column hooks
+   * @return Future completed when every column has been written
+   * @throws std::invalid_argument When @p box is inverted
+   */
+  std::future<BulkEditResult> Fill(const BlockBox& box, int32_t state_id,
+                                   BulkEditListener listener = {});
+
+  /**
+   * @brief Write a schematic with its minimum corner at @p origin
+   * @param schematic Source blocks
+   * @param origin World position of schematic-local (0, 0, 0)
+   * @param ignore_air Leave existing blocks where the schematic holds air
+   * @param listener Optional per-section / per-column hooks
+   * @return Future completed when every column has been written; at once
+   *         for an empty schematic
+   */
+  std::future<BulkEditResult> Paste(std::shared_ptr<const Schematic> schematic,
+                                    const BlockPosition& origin, bool ignore_air = false,
+                                    BulkEditListener listener = {});
+
+  /**
+   * @brief Copy a box so its minimum corner lands at @p destination
+   * @param source Box to copy from
+   * @param destination World position of the copy's minimum corner
+   * @param listener Optional per-section / per-column hooks
+   * @return Future completed when the copy has been written
+   * @throws std::invalid_argument When @p source is inverted
+   *
+   * The source is captured completely before anything is written, so
+   * overlapping source and destination boxes behave like a copy.
+   */
+  std::future<BulkEditResult> Clone(const BlockBox& source, const BlockPosition& destination,
+                                    BulkEditListener listener = {});
+
+  /**
+   * @brief Snapshot a box into a schematic on the worker pool
+   * @param box Box to read
+   * @return Future receiving the schematic; unloaded columns read as air
+   * @throws std::invalid_argument When @p box is inverted
+   */
+  std::future<std::shared_ptr<Schematic>> Capture(const BlockBox& box);
+
+ private:
+  /** @brief Writes one section's clipped part of an edit into unpacked states */
+  struct SectionOperation {
+    int32_t fill_state = -1;       ///< Uniform fill when >= 0
+    bool overwrites_clip = false;  ///< Writer sets every block of the clip
+    std::function<void(const BlockBox& clip, std::span<int32_t, SECTION_VOLUME> states)> write;
+  };
+
+  using ColumnTask = std::function<void(ChunkColumn& column, BulkEditResult& result)>;
+  using DoneFunction = std::function<void(const BulkEditResult& result, std::exception_ptr error)>;
+
+  void ForEachColumn(const BlockBox& box, ColumnTask task, DoneFunction on_done);
+  void Apply(const BlockBox& box, std::shared_ptr<const SectionOperation> operation,
+             BulkEditListener listener, DoneFunction on_done);
+  void CaptureThen(const BlockBox& box,
+                   std::function<void(std::shared_ptr<Schematic>, std::exception_ptr)> on_done);
+  static void ApplyToColumn(ChunkColumn& column, const BlockBox& box,
+                            const SectionOperation& operation, const BulkEditListener& listener,
+                            BulkEditResult& result);
+
+  ChunkMap& chunks_;
+  Util::WorkerPool& workers_;
+};
+
+}  // namespace World
@@ -0,0 +1,242 @@
+/**
+ * @file chunk_column.h
+ * @brief Full-height chunk column and the map of loaded columns
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "world/block_position.h"
+#include "world/chunk_section.h"
+
+namespace World {
+
+/** @brief Lowest block y of the overworld */
+constexpr int32_t OVERWORLD_MIN_Y = -64;
+
+/** @brief Number of sections in an overworld column (384 blocks) */
+constexpr int32_t OVERWORLD_SECTION_COUNT = 24;
+
+/**
+ * @class ChunkColumn
+ * @brief The vertical stack of sections that make up one chunk
+ *
+ * Holds a WORLD_SURFACE style heightmap: for each (x, z) the height above
+ * the world bottom of the first air block above the highest non-air block
+ * (0 for an all-air column), the same encoding vanilla sends to clients.
+ *
+ * @note Callers modifying blocks from more than one thread must hold
+ *       Mutex() for the duration of the edit.
+ */
+class ChunkColumn {
+ public:
+  /**
+   * @brief Create an all-air column
+   * @param position Chunk coordinates
+   * @param min_y Lowest block y, a multiple of 16
+   * @param section_count Number of sections stacked above @p min_y
+   */
+  ChunkColumn(ChunkPosition position, int32_t min_y = OVERWORLD_MIN_Y,
+              int32_t section_count = OVERWORLD_SECTION_COUNT);
+
+  /** @brief Chunk coordinates of this column */
+  ChunkPosition Position() const { return position_; }
+
+  /** @brief Lowest block y */
+  int32_t MinY() const { return min_y_; }
+
+  /** @brief One past the highest block y */
+  int32_t MaxY() const { return min_y_ + SectionCount() * SECTION_SIZE; }
+
+  /** @brief Number of sections in the column */
+  int32_t SectionCount() const { return static_cast<int32_t>(sections_.size()); }
+
+  /**
+   * @brief Section by absolute section y
+   * @param section_y Section y coordinate (block y >> 4)
+   * @return Pointer to the section, or nullptr when outside the column
+   */
+  ChunkSection* SectionAt(int32_t section_y);
+  const ChunkSection* SectionAt(int32_t section_y) const;
+
+  /**
+   * @brief Read a block state
+   * @param position Absolute block position inside this column
+   * @return Block state id, AIR_STATE when outside the build height
+   */
+  int32_t GetBlock(const BlockPosition& position) const;
+
+  /**
+   * @brief Write a block state and update the heightmap incrementally
+   * @param position Absolute block position inside this column
+   * @param state_id Block state id
+   * @return Previous state id, or AIR_STATE when outside the build height
+   */
+  int32_t SetBlock(const BlockPosition& position, int32_t state_id);
+
+  /**
+   * @brief Recompute the whole heightmap from section data
+   *
+   * Used after bulk edits instead of maintaining it per block.
+   * All-air sections are skipped without unpacking.
+   */
+  void RecomputeHeightmap();
+
+  /**
+   * @brief Heightmap value for a column of blocks
+   * @param local_x Block x within the chunk [0, 16)
+   * @param local_z Block z within the chunk [0, 16)
+   */
+  int32_t HeightAt(int32_t local_x, int32_t local_z) const {
+    return heightmap_[(local_z << 4) | local_x];
+  }
+
+  /**
+   * @brief Move the block data into memory owned by the calling thread
+   *
+   * Section storage comes from the slab heap of the thread that allocated
+   * it, which is placed on that thread's NUMA node. When a region is handed
+   * to a pool on another node, run this on a worker of that pool so the
+   * region's hot data follows it; copying on the destination thread faults
+   * the new pages in locally.
+   *
+   * @note Takes Mutex().
+   */
+  void Relocate();
+
+  /** @brief Mutex guarding block data against concurrent edits */
+  std::mutex& Mutex() const { return mutex_; }
+
+  /** @brief Bytes of section storage held by the column */
+  size_t StorageBytes() const;
+
+  /** @brief True while a ColumnPin holds the column loaded */
+  bool Pinned() const { return pins_.load(std::memory_order_acquire) != 0; }
+
+ private:
+  friend class ChunkMap;
+  friend class ColumnPin;
+
+  ChunkPosition position_;
+  int32_t min_y_;
+  std::vector<ChunkSection> sections_;
+  std::array<int16_t, SECTION_SIZE * SECTION_SIZE> heightmap_{};
+  mutable std::mutex mutex_;
+  std::atomic<uint32_t> pins_{0};  ///< Outstanding ColumnPins; taken under the map's lock
+};
+
+/**
+ * @class ColumnPin
+ * @brief Keeps a column loaded while held
+ *
+ * Obtained from ChunkMap::Pin(). Unload() and Evict() skip pinned columns,
+ * so work that outlives a tick (bulk edits on workers) can keep using the
+ * column after the map lock is gone.
+ */
+class ColumnPin {
+ public:
+  ColumnPin() = default;
+  ~ColumnPin() { Reset(); }
+
+  ColumnPin(ColumnPin&& other) noexcept : column_(std::exchange(other.column_, nullptr)) {}
+  ColumnPin& operator=(ColumnPin&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      column_ = std::exchange(other.column_, nullptr);
+    }
+    return *this;
+  }
+  ColumnPin(const ColumnPin&) = delete;
+  ColumnPin& operator=(const ColumnPin&) = delete;
+
+  /** @brief Pinned column, nullptr when the column was not loaded */
+  ChunkColumn* Get() const { return column_; }
+  ChunkColumn* operator->() const { return column_; }
+  ChunkColumn& operator*() const { return *column_; }
+  explicit operator bool() const { return column_ != nullptr; }
+
+  /** @brief Release the pin; the column may be unloaded afterwards */
+  void Reset() {
+    if (column_ != nullptr) {
+      column_->pins_.fetch_sub(1, std::memory_order_release);
+      column_ = nullptr;
+    }
+  }
+
+ private:
+  friend class ChunkMap;
+  explicit ColumnPin(ChunkColumn* column) : column_(column) {}
+
+  ChunkColumn* column_ = nullptr;
+};
+
+/**
+ * @class ChunkMap
+ * @brief Loaded chunk columns of one world, keyed by chunk position
+ *
+ * Column pointers stay valid until the column is unloaded. Work that
+ * keeps a column past the current tick pins it instead (Pin()).
+ *
+ * @note Thread-safe. Lookups take a shared lock, loads/unloads an
+ *       exclusive one.
+ */
+class ChunkMap {
+ public:
+  /**
+   * @brief Find a loaded column
+   * @param position Chunk coordinates
+   * @return Pointer to the column, or nullptr when not loaded
+   */
+  ChunkColumn* Find(ChunkPosition position) const;
+
+  /**
+   * @brief Find a loaded column and keep it loaded until the pin is released
+   * @param position Chunk coordinates
+   * @return Pin of the column; empty when not loaded
+   */
+  ColumnPin Pin(ChunkPosition position) const;
+
+  /**
+   * @brief Find a column, creating an empty one when not loaded
+   * @param position Chunk coordinates
+   * @return Reference to the column
+   */
+  ChunkColumn& GetOrCreate(ChunkPosition position);
+
+  /**
+   * @brief Unload a column
+   * @param position Chunk coordinates
+   * @return true if a column was removed; false when not loaded or pinned
+   */
+  bool Unload(ChunkPosition position);
+
+  /**
+   * @brief Unload columns until chunk memory dropped by at least @p bytes
+   * @param bytes Chunk section bytes to free (see Util::MemorySubsystem::CHUNKS)
+   * @param in_use Returns true for columns that must stay, e.g. in view of a player;
+   *               pinned columns always stay
+   * @return Number of columns unloaded
+   */
+  size_t Evict(uint64_t bytes, const std::function<bool(ChunkPosition)>& in_use);
+
+  /** @brief Number of loaded columns */
+  size_t Size() const;
+
+ private:
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<ChunkPosition, std::unique_ptr<ChunkColumn>, ChunkPositionHash> columns_;
+};
+
+}  // namespace World
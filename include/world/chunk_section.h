@@ -0,0 +1,123 @@
+/**
+ * @file chunk_section.h
+ * @brief Paletted block state storage for one 16x16x16 chunk section
+ *
+ * The layout mirrors the protocol's paletted container so a section can be
+ * written to a chunk packet without conversion: a single-value palette for
+ * uniform sections, an indirect palette of 4-8 bits per entry, or direct
+ * global state ids. Entries never span two longs.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "util/slab_allocator.h"
+#include "world/block_position.h"
+
+namespace Network {
+class PacketBuffer;
+}
+
+namespace World {
+
+/** @brief Global block state id of minecraft:air */
+constexpr int32_t AIR_STATE = 0;
+
+/** @brief Vector for section storage, served from slabs to keep load/unload churn off the heap */
+template <typename T>
+using SectionVector = std::vector<T, Util::SlabAllocator<T, Util::MemorySubsystem::CHUNKS>>;
+
+/**
+ * @class ChunkSection
+ * @brief Block states of a chunk section in paletted form
+ *
+ * Indices are in the protocol order (y << 8) | (z << 4) | x, see
+ * BlockPosition::SectionIndex().
+ *
+ * @note Not thread-safe; guarded by the owning ChunkColumn.
+ */
+class ChunkSection {
+ public:
+  /** @brief Bits per entry used once the palette outgrows 8 bits */
+  static constexpr uint8_t DIRECT_BITS = 15;
+
+  /** @brief Create a section filled with air */
+  ChunkSection() = default;
+
+  /**
+   * @brief Read a block state
+   * @param index Section index in [0, 4096)
+   * @return Global block state id
+   */
+  int32_t GetBlock(uint16_t index) const;
+
+  /**
+   * @brief Write a block state, growing the palette when required
+   * @param index Section index in [0, 4096)
+   * @param state_id Global block state id
+   * @return The previous block state id at @p index
+   */
+  int32_t SetBlock(uint16_t index, int32_t state_id);
+
+  /**
+   * @brief Replace every block with one state (single-value palette)
+   * @param state_id Global block state id
+   */
+  void Fill(int32_t state_id);
+
+  /**
+   * @brief Replace the whole section in one pass
+   * @param states All 4096 block states in section index order
+   *
+   * Builds the smallest palette for the data and packs it once, which is
+   * much cheaper than 4096 SetBlock() calls that resize incrementally.
+   */
+  void Assign(std::span<const int32_t, SECTION_VOLUME> states);
+
+  /**
+   * @brief Unpack all block states
+   * @param states Receives 4096 block states in section index order
+   */
+  void Export(std::span<int32_t, SECTION_VOLUME> states) const;
+
+  /** @brief Number of blocks that are not air */
+  int16_t NonAirCount() const { return non_air_count_; }
+
+  /** @brief True when every block is air */
+  bool IsEmpty() const { return non_air_count_ == 0; }
+
+  /** @brief Current bits per entry (0 for a single-value section) */
+  uint8_t BitsPerEntry() const { return bits_; }
+
+  /** @brief Bytes of palette and data storage, as accounted to MemorySubsystem::CHUNKS */
+  size_t StorageBytes() const {
+    return palette_.capacity() * sizeof(int32_t) + data_.capacity() * sizeof(uint64_t);
+  }
+
+  /**
+   * @brief Write the block count and block state container as sent in
+   *        Chunk Data and Update Light
+   * @param buffer Destination buffer
+   */
+  void Serialize(Network::PacketBuffer& buffer) const;
+
+ private:
+  static uint8_t BitsForPaletteSize(size_t palette_size);
+
+  uint32_t ReadRaw(uint16_t index) const;
+  void WriteRaw(uint16_t index, uint32_t value);
+  void Repack(uint8_t new_bits);
+  int32_t PaletteIndexOf(int32_t state_id);
+
+  uint8_t bits_ = 0;
+  SectionVector<int32_t> palette_{AIR_STATE};  ///< Empty in direct mode
+  SectionVector<uint64_t> data_;
+  int16_t non_air_count_ = 0;
+};
+
+}  // namespace World
@@ -0,0 +1,125 @@
+/**
+ * @file section_change_tracker.h
+ * @brief Per-section block change accumulator flushed once per tick
+ *
+ * Block changes made during a tick are grouped by chunk section instead of
+ * being sent immediately. At the end of the tick every touched section is
+ * encoded exactly once: a single change becomes a Block Update packet, two
+ * or more become one Update Section Blocks packet with packed VarLong
+ * entries. The resulting packet is shared by every viewer of the section.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "network/encoded_packet.h"
+#include "network/packet_pool.h"
+#include "world/block_position.h"
+
+namespace World {
+
+/**
+ * @struct SectionChangeStats
+ * @brief Cumulative counters describing the traffic produced by a tracker
+ */
+struct SectionChangeStats {
+  uint64_t changes_recorded = 0;       ///< RecordChange() calls
+  uint64_t changes_overwritten = 0;    ///< Changes replaced by a later change to the same block
+  uint64_t block_update_packets = 0;   ///< Block Update packets encoded
+  uint64_t section_update_packets = 0; ///< Update Section Blocks packets encoded
+  uint64_t bytes_encoded = 0;          ///< Total encoded packet bytes, before fan-out
+};
+
+/**
+ * @class SectionChangeTracker
+ * @brief Coalesces block changes into one packet per section per tick
+ *
+ * Repeated changes to the same block within a tick collapse to the last
+ * state written. Section bookkeeping (map nodes and entry buffers) is
+ * recycled between ticks, and with a PacketPool the packets are too, so a tracker in steady state
+ * does not allocate.
+ *
+ * @note Not thread-safe. Each tracker belongs to the thread that ticks the
+ *       blocks it records.
+ *
+ * @example
+ * @code
+ * World::SectionChangeTracker tracker;
+ * tracker.RecordChange({10, 64, -3}, stone_state);
+ * // ... end of tick
+ * tracker.Flush([&](const World::SectionPosition& section,
+ *                   const Network::SharedPacket& packet) {
+ *   for (Network::PacketSink* viewer : ViewersOf(section)) {
+ *     viewer->SendPacket(packet);
+ *   }
+ * });
+ * @endcode
+ */
+class SectionChangeTracker {
+ public:
+  /**
+   * @brief Callback receiving the encoded packet for one section
+   * @param section Section the packet describes
+   * @param packet Packet to deliver to every viewer of @p section
+   */
+  using BroadcastFunction =
+      std::function<void(const SectionPosition& section, const Network::SharedPacket& packet)>;
+
+  /**
+   * @brief Create a tracker
+   * @param pool Pool packets are encoded into; nullptr allocates each packet
+   */
+  explicit SectionChangeTracker(Network::PacketPool* pool = nullptr) : pool_(pool) {}
+
+  /**
+   * @brief Record that a block changed to a new state during this tick
+   * @param position Absolute block position
+   * @param state_id Global block state id the block now has
+   */
+  void RecordChange(const BlockPosition& position, int32_t state_id);
+
+  /**
+   * @brief Encode all pending changes and hand each section's packet out
+   * @param broadcast Invoked once per touched section
+   *
+   * Called at tick end. Pending state is cleared afterwards.
+   */
+  void Flush(const BroadcastFunction& broadcast);
+
+  /** @brief True when no changes are pending */
+  bool Empty() const { return pending_.empty(); }
+
+  /** @brief Number of sections with pending changes */
+  size_t PendingSections() const { return pending_.size(); }
+
+  /** @brief Cumulative traffic counters */
+  const SectionChangeStats& GetStats() const { return stats_; }
+
+ private:
+  struct PendingSection {
+    std::bitset<SECTION_VOLUME> touched;
+    std::vector<uint64_t> entries;  ///< (state_id << 12) | (x << 8) | (z << 4) | y
+  };
+
+  static uint16_t PackedLocal(const BlockPosition& position);
+
+  Network::SharedPacket EncodeSingle(const SectionPosition& section, uint64_t entry);
+  Network::SharedPacket EncodeMultiple(const SectionPosition& section,
+                                       const std::vector<uint64_t>& entries);
+
+  using PendingMap = std::unordered_map<SectionPosition, PendingSection, SectionPositionHash>;
+
+  PendingMap pending_;
+  std::vector<PendingMap::node_type> spare_;  ///< Map nodes, with their buffers, kept between ticks
+  Network::PacketPool* pool_;
+  SectionChangeStats stats_;
+};
+
+}  // namespace World
@@ -0,0 +1,69 @@
+/**
+ * @file view_distance.h
+ * @brief View and simulation distance adapted to memory pressure
+ *
+ * Loaded chunks are the bulk of a server's memory and grow with the square
+ * of the view distance. Under memory pressure the policy hands out shorter
+ * distances for new chunk loads, so players that join or move keep loading
+ * fewer columns while already loaded ones are left alone; once pressure
+ * clears the configured distances return.
+ *
+ * @date 2026/10/18
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "util/memory_pressure.h"
+
+namespace World {
+
+/**
+ * @class ViewDistancePolicy
+ * @brief Effective view and simulation distances for new chunk loads
+ *
+ * MODERATE pressure takes three quarters of the configured distances,
+ * CRITICAL half, never below the minimum.
+ *
+ * @note Thread-safe; OnPressure() is meant to be a MemoryPressureMonitor
+ *       listener and the getters are read by chunk loading.
+ */
+class ViewDistancePolicy {
+ public:
+  /**
+   * @param view_distance Configured view distance, in chunks
+   * @param simulation_distance Configured simulation distance, in chunks
+   * @param minimum Lowest distance pressure may reduce either to
+   */
+  ViewDistancePolicy(int32_t view_distance, int32_t simulation_distance, int32_t minimum = 2);
+
+  /** @brief Adapt the effective distances to a pressure level */
+  void OnPressure(Util::MemoryPressureLevel level);
+
+  /** @brief View distance to use for new chunk loads */
+  int32_t ViewDistance() const { return view_distance_.load(std::memory_order_relaxed); }
+
+  /** @brief Simulation distance to use for new chunk loads */
+  int32_t SimulationDistance() const {
+    return simulation_distance_.load(std::memory_order_relaxed);
+  }
+
+  /** @brief View distance without pressure */
+  int32_t ConfiguredViewDistance() const { return configured_view_; }
+
+  /** @brief Simulation distance without pressure */
+  int32_t ConfiguredSimulationDistance() const { return configured_simulation_; }
+
+ private:
+  int32_t Reduce(int32_t distance, Util::MemoryPressureLevel level) const;
+
+  int32_t configured_view_;
+  int32_t configured_simulation_;
+  int32_t minimum_;
+  std::atomic<int32_t> view_distance_;
+  std::atomic<int32_t> simulation_distance_;
+};
+
+}  // namespace World
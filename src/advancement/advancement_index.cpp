@@ -0,0 +1,359 @@
+#include "advancement/advancement_index.h"
+
+#include <stdexcept>
+
+#include "inventory/item_stack_cache.h"
+#include "network/packet_buffer.h"
+#include "protocol/packet_ids.h"
+#include "protocol/text_component.h"
+
+namespace Advancement {
+
+namespace {
+
+constexpr int32_t FLAG_BACKGROUND = 0x01;
+constexpr int32_t FLAG_SHOW_TOAST = 0x02;
+constexpr int32_t FLAG_HIDDEN = 0x04;
+
+void WriteDisplay(Network::PacketBuffer& buffer, const AdvancementDisplay& display) {
+  Protocol::WritePlainText(buffer, display.title);
+  Protocol::WritePlainText(buffer, display.description);
+  Inventory::ItemStackCache::Encode(buffer, display.icon);
+  buffer.WriteVarInt(display.frame);
+  int32_t flags = 0;
+  flags |= display.background ? FLAG_BACKGROUND : 0;
+  flags |= display.show_toast ? FLAG_SHOW_TOAST : 0;
+  flags |= display.hidden ? FLAG_HIDDEN : 0;
+  buffer.WriteInt(flags);
+  if (display.background) {
+    buffer.WriteString(*display.background);
+  }
+  buffer.WriteFloat(display.x);
+  buffer.WriteFloat(display.y);
+}
+
+}  // namespace
+
+AdvancementId AdvancementRegistry::Add(AdvancementDefinition definition) {
+  const Util::Identifier key = Util::Identifier::Intern(definition.id);
+  if (by_id_.Contains(key)) {
+    throw std::invalid_argument("duplicate advancement: " + definition.id);
+  }
+
+  std::unordered_map<std::string_view, uint32_t> local;
+  for (uint32_t i = 0; i < definition.criteria.size(); ++i) {
+    if (!local.emplace(definition.criteria[i].name, i).second) {
+      throw std::invalid_argument("duplicate criterion " + definition.criteria[i].name +
+                                  " in " + definition.id);
+    }
+  }
+
+  Entry entry;
+  if (definition.requirements.empty()) {
+    for (uint32_t i = 0; i < definition.criteria.size(); ++i) {
+      entry.groups.push_back({i});
+    }
+  } else {
+    for (const auto& names : definition.requirements) {
+      std::vector<uint32_t>& group = entry.groups.emplace_back();
+      for (const std::string& name : names) {
+        auto it = local.find(name);
+        if (it == local.end()) {
+          throw std::invalid_argument("unknown criterion " + name + " in " + definition.id);
+        }
+        group.push_back(it->second);
+      }
+    }
+  }
+
+  const auto id = static_cast<AdvancementId>(advancements_.size());
+  entry.first_criterion = static_cast<CriterionId>(criteria_.size());
+  for (uint32_t i = 0; i < definition.criteria.size(); ++i) {
+    const CriterionDefinition& criterion = definition.criteria[i];
+    const auto criterion_id = static_cast<CriterionId>(criteria_.size());
+    criteria_.push_back({id, i});
+    if (criterion.subjects.empty()) {
+      any_subject_[static_cast<size_t>(criterion.trigger)].push_back(criterion_id);
+    } else {
+      for (int32_t subject : criterion.subjects) {
+        by_subject_[SubjectKey(criterion.trigger, subject)].push_back(criterion_id);
+      }
+    }
+  }
+
+  // Mapping entry of the Update Advancements packet, sent on every full sync.
+  Network::PacketBuffer buffer;
+  buffer.WriteString(definition.id);
+  buffer.WriteBool(definition.parent.has_value());
+  if (definition.parent) {
+    buffer.WriteString(*definition.parent);
+  }
+  buffer.WriteBool(definition.display.has_value());
+  if (definition.display) {
+    WriteDisplay(buffer, *definition.display);
+  }
+#if MINECRAFT_VERSION < 120200
+  buffer.WriteVarInt(static_cast<int32_t>(definition.criteria.size()));
+  for (const CriterionDefinition& criterion : definition.criteria) {
+    buffer.WriteString(criterion.name);
+  }
+#endif
+  buffer.WriteVarInt(static_cast<int32_t>(entry.groups.size()));
+  for (const auto& group : entry.groups) {
+    buffer.WriteVarInt(static_cast<int32_t>(group.size()));
+    for (uint32_t index : group) {
+      buffer.WriteString(definition.criteria[index].name);
+    }
+  }
+  buffer.WriteBool(definition.sends_telemetry);
+  encoded_definitions_.insert(encoded_definitions_.end(), buffer.Data().begin(),
+                              buffer.Data().end());
+
+  by_id_.Insert(key, id);
+  entry.definition = std::move(definition);
+  advancements_.push_back(std::move(entry));
+  return id;
+}
+
+std::optional<AdvancementId> AdvancementRegistry::Find(std::string_view id) const {
+  const std::optional<Util::Identifier> key = Util::Identifier::Find(id);
+  if (!key) {
+    return std::nullopt;
+  }
+  return Find(*key);
+}
+
+std::optional<AdvancementId> AdvancementRegistry::Find(Util::Identifier id) const {
+  const AdvancementId* found = by_id_.Find(id);
+  if (found == nullptr) {
+    return std::nullopt;
+  }
+  return *found;
+}
+
+std::optional<CriterionId> AdvancementRegistry::FindCriterion(AdvancementId advancement,
+                                                              std::string_view name) const {
+  const Entry& entry = advancements_[advancement];
+  for (uint32_t i = 0; i < entry.definition.criteria.size(); ++i) {
+    if (entry.definition.criteria[i].name == name) {
+      return entry.first_criterion + i;
+    }
+  }
+  return std::nullopt;
+}
+
+const std::vector<CriterionId>* AdvancementRegistry::BySubject(TriggerType trigger,
+                                                               int32_t subject) const {
+  auto it = by_subject_.find(SubjectKey(trigger, subject));
+  return it == by_subject_.end() ? nullptr : &it->second;
+}
+
+PlayerAdvancements::PlayerAdvancements(const AdvancementRegistry& registry)
+    : registry_(registry),
+      obtained_at_(registry.CriterionCount(), 0),
+      done_(registry.Size(), false),
+      changed_flag_(registry.Size(), false) {
+  for (AdvancementId advancement = 0; advancement < registry_.Size(); ++advancement) {
+    // Advancements without criteria are done from the start.
+    if (registry_.advancements_[advancement].groups.empty()) {
+      done_[advancement] = true;
+    } else {
+      SetListening(advancement, true);
+    }
+  }
+}
+
+bool PlayerAdvancements::Listening(CriterionId criterion) const {
+  return obtained_at_[criterion] == 0 && !done_[registry_.criteria_[criterion].advancement];
+}
+
+void PlayerAdvancements::SetListening(AdvancementId advancement, bool listening) {
+  const auto& entry = registry_.advancements_[advancement];
+  for (uint32_t i = 0; i < entry.definition.criteria.size(); ++i) {
+    if (obtained_at_[entry.first_criterion + i] == 0) {
+      uint32_t& count = pending_[static_cast<size_t>(entry.definition.criteria[i].trigger)];
+      count = listening ? count + 1 : count - 1;
+    }
+  }
+}
+
+bool PlayerAdvancements::RequirementsMet(AdvancementId advancement) const {
+  const auto& entry = registry_.advancements_[advancement];
+  for (const auto& group : entry.groups) {
+    bool any = false;
+    for (uint32_t index : group) {
+      if (obtained_at_[entry.first_criterion + index] != 0) {
+        any = true;
+        break;
+      }
+    }
+    if (!any) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PlayerAdvancements::MarkChanged(AdvancementId advancement) {
+  if (!changed_flag_[advancement]) {
+    changed_flag_[advancement] = true;
+    changed_.push_back(advancement);
+  }
+}
+
+size_t PlayerAdvancements::Trigger(const TriggerEvent& event, int64_t now) {
+  ++stats_.events;
+  if (pending_[static_cast<size_t>(event.type)] == 0) {
+    ++stats_.events_skipped;
+    return 0;
+  }
+
+  size_t granted = 0;
+  Evaluate(registry_.AnySubject(event.type), event, now, granted);
+  if (event.subject >= 0) {
+    if (const auto* candidates = registry_.BySubject(event.type, event.subject)) {
+      Evaluate(*candidates, event, now, granted);
+    }
+  }
+  return granted;
+}
+
+void PlayerAdvancements::Evaluate(const std::vector<CriterionId>& candidates,
+                                  const TriggerEvent& event, int64_t now, size_t& granted) {
+  for (CriterionId criterion : candidates) {
+    if (!Listening(criterion)) {
+      continue;
+    }
+    const auto& location = registry_.criteria_[criterion];
+    const CriterionDefinition& definition =
+        registry_.advancements_[location.advancement].definition.criteria[location.local];
+    if (definition.predicate) {
+      ++stats_.predicates_evaluated;
+      if (!definition.predicate(event)) {
+        continue;
+      }
+    }
+    granted += Grant(criterion, now);
+  }
+}
+
+bool PlayerAdvancements::Grant(CriterionId criterion, int64_t now) {
+  if (obtained_at_[criterion] != 0) {
+    return false;
+  }
+  const AdvancementId advancement = registry_.criteria_[criterion].advancement;
+  const auto& entry = registry_.advancements_[advancement];
+  if (!done_[advancement]) {
+    --pending_[static_cast<size_t>(
+        entry.definition.criteria[registry_.criteria_[criterion].local].trigger)];
+  }
+  obtained_at_[criterion] = now != 0 ? now : 1;
+  ++stats_.criteria_granted;
+  MarkChanged(advancement);
+
+  if (!done_[advancement] && RequirementsMet(advancement)) {
+    // Remaining alternatives of a finished advancement stop listening.
+    SetListening(advancement, false);
+    done_[advancement] = true;
+    ++stats_.advancements_completed;
+    if (on_completed_) {
+      on_completed_(advancement);
+    }
+  }
+  return true;
+}
+
+bool PlayerAdvancements::Revoke(CriterionId criterion) {
+  if (obtained_at_[criterion] == 0) {
+    return false;
+  }
+  const AdvancementId advancement = registry_.criteria_[criterion].advancement;
+  const auto& entry = registry_.advancements_[advancement];
+  obtained_at_[criterion] = 0;
+  MarkChanged(advancement);
+
+  if (done_[advancement]) {
+    if (!RequirementsMet(advancement)) {
+      done_[advancement] = false;
+      SetListening(advancement, true);
+    }
+  } else {
+    ++pending_[static_cast<size_t>(
+        entry.definition.criteria[registry_.criteria_[criterion].local].trigger)];
+  }
+  return true;
+}
+
+void PlayerAdvancements::WriteProgress(Network::PacketBuffer& buffer,
+                                       AdvancementId advancement) const {
+  const auto& entry = registry_.advancements_[advancement];
+  const auto& criteria = entry.definition.criteria;
+  int32_t obtained = 0;
+  for (uint32_t i = 0; i < criteria.size(); ++i) {
+    obtained += obtained_at_[entry.first_criterion + i] != 0;
+  }
+  buffer.WriteString(entry.definition.id);
+  buffer.WriteVarInt(obtained);
+  for (uint32_t i = 0; i < criteria.size(); ++i) {
+    const int64_t at = obtained_at_[entry.first_criterion + i];
+    if (at != 0) {
+      buffer.WriteString(criteria[i].name);
+      buffer.WriteBool(true);
+      buffer.WriteLong(at);
+    }
+  }
+}
+
+Network::SharedPacket PlayerAdvancements::Encode(bool reset,
+                                                 const std::vector<AdvancementId>& advancements) {
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::UPDATE_ADVANCEMENTS,
+                               16 + advancements.size() * 48 +
+                                   (reset ? registry_.encoded_definitions_.size() : 0));
+  buffer.WriteBool(reset);
+  if (reset) {
+    buffer.WriteVarInt(static_cast<int32_t>(registry_.Size()));
+    buffer.WriteBytes(registry_.encoded_definitions_);
+  } else {
+    buffer.WriteVarInt(0);
+  }
+  buffer.WriteVarInt(0);  // Removed advancements
+  buffer.WriteVarInt(static_cast<int32_t>(advancements.size()));
+  for (AdvancementId advancement : advancements) {
+    WriteProgress(buffer, advancement);
+  }
+#if MINECRAFT_VERSION >= 121500
+  buffer.WriteBool(true);  // Show advancements screen contents
+#endif
+  stats_.bytes_encoded += buffer.Size();
+  return buffer.Finish();
+}
+
+Network::SharedPacket PlayerAdvancements::FlushUpdate() {
+  if (changed_.empty()) {
+    return nullptr;
+  }
+  Network::SharedPacket packet = Encode(false, changed_);
+  for (AdvancementId advancement : changed_) {
+    changed_flag_[advancement] = false;
+  }
+  changed_.clear();
+  return packet;
+}
+
+Network::SharedPacket PlayerAdvancements::FullSyncPacket() {
+  std::vector<AdvancementId> with_progress;
+  for (AdvancementId advancement = 0; advancement < registry_.Size(); ++advancement) {
+    changed_flag_[advancement] = false;
+    const auto& entry = registry_.advancements_[advancement];
+    for (uint32_t i = 0; i < entry.definition.criteria.size(); ++i) {
+      if (obtained_at_[entry.first_criterion + i] != 0) {
+        with_progress.push_back(advancement);
+        break;
+      }
+    }
+  }
+  changed_.clear();
+  return Encode(true, with_progress);
+}
+
+}  // namespace Advancement
@@ -0,0 +1,259 @@
+#include "chat/chat_pipeline.h"
+
+#include <exception>
+
+#include <spdlog/spdlog.h>
+
+#include "network/packet_buffer.h"
+#include "protocol/packet_ids.h"
+#include "protocol/text_component.h"
+
+namespace Chat {
+
+namespace {
+
+/** @brief Filter type PASS_THROUGH */
+constexpr int32_t FILTER_PASS_THROUGH = 0;
+
+/** @brief Number of UTF-8 code points in @p text */
+size_t CodePointCount(std::string_view text) {
+  size_t count = 0;
+  for (char c : text) {
+    count += (static_cast<uint8_t>(c) & 0xC0) != 0x80;
+  }
+  return count;
+}
+
+void AppendInt(std::vector<uint8_t>& out, uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+void AppendLong(std::vector<uint8_t>& out, uint64_t value) {
+  AppendInt(out, static_cast<uint32_t>(value >> 32));
+  AppendInt(out, static_cast<uint32_t>(value));
+}
+
+}  // namespace
+
+ChatPipeline::ChatPipeline(Util::WorkerPool& workers, SignatureVerifier verifier,
+                           ChatPipelineConfig config)
+    : workers_(workers),
+      verifier_(std::move(verifier)),
+      config_(config),
+      recipients_(std::make_shared<const RecipientList>()) {}
+
+void ChatPipeline::SetRecipients(std::shared_ptr<const RecipientList> recipients) {
+  std::lock_guard lock(recipients_mutex_);
+  recipients_ = std::move(recipients);
+}
+
+void ChatPipeline::Submit(ChatMessage message) {
+  submitted_.fetch_add(1, std::memory_order_relaxed);
+  const uint64_t sequence = next_sequence_.fetch_add(1, std::memory_order_relaxed);
+  auto shared = std::make_shared<const ChatMessage>(std::move(message));
+  workers_.Post([this, sequence, shared] { Process(sequence, *shared); });
+}
+
+ChatStats ChatPipeline::GetStats() const {
+  return {submitted_.load(std::memory_order_relaxed), rejected_.load(std::memory_order_relaxed),
+          broadcast_.load(std::memory_order_relaxed), deliveries_.load(std::memory_order_relaxed),
+          encoded_bytes_.load(std::memory_order_relaxed)};
+}
+
+std::optional<RejectReason> ChatPipeline::Validate(const ChatMessage& message) {
+  if (CodePointCount(message.text) > MAX_MESSAGE_LENGTH) {
+    return RejectReason::TOO_LONG;
+  }
+  for (size_t i = 0; i < message.text.size(); ++i) {
+    const auto byte = static_cast<uint8_t>(message.text[i]);
+    // Control characters, DEL and the section sign (U+00A7, formatting codes).
+    if (byte < 0x20 || byte == 0x7F ||
+        (byte == 0xC2 && i + 1 < message.text.size() &&
+         static_cast<uint8_t>(message.text[i + 1]) == 0xA7)) {
+      return RejectReason::ILLEGAL_CHARACTERS;
+    }
+  }
+  if (message.last_seen.size() > MAX_LAST_SEEN) {
+    return RejectReason::TOO_MANY_LAST_SEEN;
+  }
+  return std::nullopt;
+}
+
+std::vector<uint8_t> ChatPipeline::SignedPayload(const ChatMessage& message) {
+  std::vector<uint8_t> out;
+  out.reserve(64 + message.text.size() + message.last_seen.size() * SIGNATURE_SIZE);
+  AppendInt(out, 1);
+  AppendLong(out, message.sender.most);
+  AppendLong(out, message.sender.least);
+  AppendLong(out, message.session_id.most);
+  AppendLong(out, message.session_id.least);
+  AppendInt(out, static_cast<uint32_t>(message.index));
+  AppendLong(out, static_cast<uint64_t>(message.salt));
+  AppendLong(out, static_cast<uint64_t>(message.timestamp / 1000));
+  AppendInt(out, static_cast<uint32_t>(message.text.size()));
+  out.insert(out.end(), message.text.begin(), message.text.end());
+  AppendInt(out, static_cast<uint32_t>(message.last_seen.size()));
+  for (const MessageSignature& signature : message.last_seen) {
+    out.insert(out.end(), signature.begin(), signature.end());
+  }
+  return out;
+}
+
+void ChatPipeline::Process(uint64_t sequence, const ChatMessage& message) {
+  // Every sequence number must reach Complete(), or all later messages wait
+  // for it in the reorder buffer forever; a failure drops just this message.
+  Network::SharedPacket packet;
+  try {
+    std::optional<RejectReason> reason = Validate(message);
+    if (!reason) {
+      if (!message.signature) {
+        if (config_.enforce_secure_chat) {
+          reason = RejectReason::UNSIGNED;
+        }
+      } else if (verifier_ && !verifier_(message)) {
+        reason = RejectReason::BAD_SIGNATURE;
+      }
+    }
+
+    if (reason) {
+      rejected_.fetch_add(1, std::memory_order_relaxed);
+      if (on_reject_) {
+        on_reject_(message, *reason);
+      }
+    } else {
+      packet = Encode(message);
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("Chat message from {} dropped: {}", message.sender_name, e.what());
+    packet = nullptr;
+  } catch (...) {
+    spdlog::error("Chat message from {} dropped", message.sender_name);
+    packet = nullptr;
+  }
+  Complete(sequence, std::move(packet));
+}
+
+Network::SharedPacket ChatPipeline::Encode(const ChatMessage& message) const {
+  // Everything after the global index (1.21.5+) is identical for every
+  // recipient. Last-seen entries are always sent as full signatures rather
+  // than as per-client cache ids so that the tail can be shared.
+#if MINECRAFT_VERSION >= 121500
+  Network::PacketBuffer buffer;
+  buffer.Reserve(128 + message.text.size() + message.last_seen.size() * (SIGNATURE_SIZE + 1));
+#else
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::PLAYER_CHAT,
+                               128 + message.text.size() +
+                                   message.last_seen.size() * (SIGNATURE_SIZE + 1));
+#endif
+  buffer.WriteUuid(message.sender);
+  buffer.WriteVarInt(message.index);
+  buffer.WriteBool(message.signature.has_value());
+  if (message.signature) {
+    buffer.WriteBytes(*message.signature);
+  }
+  buffer.WriteString(message.text);
+  buffer.WriteLong(message.timestamp);
+  buffer.WriteLong(message.salt);
+  buffer.WriteVarInt(static_cast<int32_t>(message.last_seen.size()));
+  for (const MessageSignature& signature : message.last_seen) {
+    buffer.WriteVarInt(0);  // 0 = full signature follows
+    buffer.WriteBytes(signature);
+  }
+  buffer.WriteBool(false);  // No unsigned content
+  buffer.WriteVarInt(FILTER_PASS_THROUGH);
+#if MINECRAFT_VERSION >= 121100
+  buffer.WriteVarInt(config_.chat_type + 1);  // Registry reference (id + 1)
+#else
+  buffer.WriteVarInt(config_.chat_type);
+#endif
+  Protocol::WritePlainText(buffer, message.sender_name);
+  buffer.WriteBool(false);  // No target name
+
+#if MINECRAFT_VERSION >= 121500
+  return buffer.FinishTail(Protocol::Play::Clientbound::PLAYER_CHAT);
+#else
+  return buffer.Finish();
+#endif
+}
+
+void ChatPipeline::Complete(uint64_t sequence, Network::SharedPacket packet) {
+  {
+    std::lock_guard lock(order_mutex_);
+    finished_.emplace(sequence, std::move(packet));
+    if (draining_) {
+      return;
+    }
+    draining_ = true;
+  }
+
+  // Whoever completes the next message in order drains everything that is
+  // ready; other workers just park their result in finished_.
+  try {
+    for (;;) {
+      Network::SharedPacket next;
+      {
+        std::lock_guard lock(order_mutex_);
+        auto it = finished_.find(next_broadcast_);
+        if (it == finished_.end()) {
+          draining_ = false;
+          return;
+        }
+        next = std::move(it->second);
+        finished_.erase(it);
+        ++next_broadcast_;
+      }
+      if (next) {
+        Broadcast(next);
+      }
+    }
+  } catch (...) {
+    // Hand the drain to the next completion rather than leaving it claimed
+    std::lock_guard lock(order_mutex_);
+    draining_ = false;
+    throw;
+  }
+}
+
+void ChatPipeline::Deliver(ChatRecipient& recipient, const Network::SharedPacket& packet) {
+  // One broken connection must not keep the message from everyone after it
+  try {
+#if MINECRAFT_VERSION >= 121500
+    // Head: packet id VarInt + global index VarInt, at most 10 bytes.
+    std::array<uint8_t, 10> head;
+    size_t size = 0;
+    for (uint32_t value : {static_cast<uint32_t>(Protocol::Play::Clientbound::PLAYER_CHAT),
+                           static_cast<uint32_t>(recipient.NextGlobalIndex())}) {
+      while (value >= 0x80) {
+        head[size++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+      }
+      head[size++] = static_cast<uint8_t>(value);
+    }
+    recipient.Sink().SendPacket(std::span<const uint8_t>(head.data(), size), packet);
+#else
+    recipient.Sink().SendPacket(packet);
+#endif
+  } catch (const std::exception& e) {
+    spdlog::error("Chat delivery failed: {}", e.what());
+  }
+}
+
+void ChatPipeline::Broadcast(const Network::SharedPacket& packet) {
+  std::shared_ptr<const RecipientList> recipients;
+  {
+    std::lock_guard lock(recipients_mutex_);
+    recipients = recipients_;
+  }
+
+  broadcast_.fetch_add(1, std::memory_order_relaxed);
+  encoded_bytes_.fetch_add(packet->bytes.size(), std::memory_order_relaxed);
+  deliveries_.fetch_add(recipients->size(), std::memory_order_relaxed);
+
+  for (const std::shared_ptr<ChatRecipient>& recipient : *recipients) {
+    Deliver(*recipient, packet);
+  }
+}
+
+}  // namespace Chat
@@ -0,0 +1,562 @@
+#include "command/command_graph.h"
+
+#include <charconv>
+#include <unordered_map>
+
+#include "network/packet_buffer.h"
+#include "protocol/packet_ids.h"
+
+namespace Command {
+
+namespace {
+
+/** @brief Ids in the client's command argument type registry */
+enum ParserId : int32_t {
+  PARSER_BOOL = 0,
+  PARSER_FLOAT = 1,
+  PARSER_DOUBLE = 2,
+  PARSER_INTEGER = 3,
+  PARSER_LONG = 4,
+  PARSER_STRING = 5,
+  PARSER_ENTITY = 6,
+  PARSER_GAME_PROFILE = 7,
+  PARSER_BLOCK_POS = 8,
+};
+
+constexpr uint8_t FLAG_EXECUTABLE = 0x04;
+constexpr uint8_t FLAG_REDIRECT = 0x08;
+constexpr uint8_t FLAG_SUGGESTIONS = 0x10;
+
+size_t TokenEnd(std::string_view input, size_t offset) {
+  const size_t end = input.find(' ', offset);
+  return end == std::string_view::npos ? input.size() : end;
+}
+
+template <typename T>
+bool ParseNumber(std::string_view token, T& value) {
+  if (token.empty()) {
+    return false;
+  }
+  const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+  return error == std::errc() && end == token.data() + token.size();
+}
+
+/** @brief One block_pos component: integer, "~", "~n", "^" or "^n" */
+bool ParseCoordinate(std::string_view token, int32_t& value) {
+  if (!token.empty() && (token.front() == '~' || token.front() == '^')) {
+    token.remove_prefix(1);
+    value = 0;
+    return token.empty() || ParseNumber(token, value);
+  }
+  return ParseNumber(token, value);
+}
+
+bool InRange(const ArgumentSpec& spec, double value) {
+  return (!spec.has_min || value >= spec.min) && (!spec.has_max || value <= spec.max);
+}
+
+void Fail(ParseResult& result, ParseStatus status, size_t offset) {
+  if (offset >= result.error_offset) {
+    result.status = status;
+    result.error_offset = offset;
+  }
+}
+
+void WriteNumericProperties(Network::PacketBuffer& buffer, const ArgumentSpec& spec) {
+  buffer.WriteByte(static_cast<uint8_t>((spec.has_min ? 0x01 : 0) | (spec.has_max ? 0x02 : 0)));
+  auto write = [&](double value) {
+    switch (spec.type) {
+      case ArgumentType::FLOAT: buffer.WriteFloat(static_cast<float>(value)); break;
+      case ArgumentType::DOUBLE: buffer.WriteDouble(value); break;
+      case ArgumentType::INTEGER: buffer.WriteInt(static_cast<int32_t>(value)); break;
+      default: buffer.WriteLong(static_cast<int64_t>(value)); break;
+    }
+  };
+  if (spec.has_min) {
+    write(spec.min);
+  }
+  if (spec.has_max) {
+    write(spec.max);
+  }
+}
+
+void WriteParser(Network::PacketBuffer& buffer, const ArgumentSpec& spec) {
+  switch (spec.type) {
+    case ArgumentType::BOOL: buffer.WriteVarInt(PARSER_BOOL); break;
+    case ArgumentType::FLOAT:
+      buffer.WriteVarInt(PARSER_FLOAT);
+      WriteNumericProperties(buffer, spec);
+      break;
+    case ArgumentType::DOUBLE:
+      buffer.WriteVarInt(PARSER_DOUBLE);
+      WriteNumericProperties(buffer, spec);
+      break;
+    case ArgumentType::INTEGER:
+      buffer.WriteVarInt(PARSER_INTEGER);
+      WriteNumericProperties(buffer, spec);
+      break;
+    case ArgumentType::LONG:
+      buffer.WriteVarInt(PARSER_LONG);
+      WriteNumericProperties(buffer, spec);
+      break;
+    case ArgumentType::WORD:
+      buffer.WriteVarInt(PARSER_STRING);
+      buffer.WriteVarInt(0);
+      break;
+    case ArgumentType::QUOTABLE_STRING:
+      buffer.WriteVarInt(PARSER_STRING);
+      buffer.WriteVarInt(1);
+      break;
+    case ArgumentType::GREEDY_STRING:
+      buffer.WriteVarInt(PARSER_STRING);
+      buffer.WriteVarInt(2);
+      break;
+    case ArgumentType::ENTITY:
+      buffer.WriteVarInt(PARSER_ENTITY);
+      buffer.WriteByte(spec.entity_flags);
+      break;
+    case ArgumentType::GAME_PROFILE: buffer.WriteVarInt(PARSER_GAME_PROFILE); break;
+    case ArgumentType::BLOCK_POS: buffer.WriteVarInt(PARSER_BLOCK_POS); break;
+  }
+}
+
+}  // namespace
+
+const ParsedArgument* ParseResult::Find(const CommandGraph& graph, std::string_view name) const {
+  for (size_t i = 0; i < argument_count; ++i) {
+    if (graph.NodeName(arguments[i].node) == name) {
+      return &arguments[i];
+    }
+  }
+  return nullptr;
+}
+
+std::string_view CommandGraph::NodeName(NodeId node) const { return NameOf(nodes_[node]); }
+
+NodeId CommandGraph::ChildrenOwner(NodeId node) const {
+  const NodeId redirect = nodes_[node].redirect;
+  return redirect == NO_NODE ? node : redirect;
+}
+
+NodeId CommandGraph::FindLiteral(NodeId owner, std::string_view token,
+                                 uint8_t permission_level) const {
+  const Node& node = nodes_[owner];
+  const NodeId* first = children_.data() + node.first_child;
+  const NodeId* last = first + node.literal_children;
+  const NodeId* found = std::lower_bound(
+      first, last, token, [this](NodeId child, std::string_view value) {
+        return NameOf(nodes_[child]) < value;
+      });
+  if (found == last || NameOf(nodes_[*found]) != token || !Visible(*found, permission_level)) {
+    return NO_NODE;
+  }
+  return *found;
+}
+
+bool CommandGraph::ParseArgument(const ArgumentSpec& spec, std::string_view input, size_t offset,
+                                 size_t& end, ParsedArgument& argument) const {
+  end = TokenEnd(input, offset);
+  std::string_view token = input.substr(offset, end - offset);
+
+  switch (spec.type) {
+    case ArgumentType::BOOL:
+      if (token != "true" && token != "false") {
+        return false;
+      }
+      argument.integer = token == "true";
+      break;
+    case ArgumentType::INTEGER:
+    case ArgumentType::LONG:
+      if (!ParseNumber(token, argument.integer) ||
+          (spec.type == ArgumentType::INTEGER &&
+           (argument.integer < INT32_MIN || argument.integer > INT32_MAX)) ||
+          !InRange(spec, static_cast<double>(argument.integer))) {
+        return false;
+      }
+      break;
+    case ArgumentType::FLOAT:
+    case ArgumentType::DOUBLE:
+      if (!ParseNumber(token, argument.number) || !InRange(spec, argument.number)) {
+        return false;
+      }
+      break;
+    case ArgumentType::QUOTABLE_STRING:
+      if (!token.empty() && (token.front() == '"' || token.front() == '\'')) {
+        const char quote = token.front();
+        size_t close = offset + 1;
+        while (close < input.size() && input[close] != quote) {
+          close += input[close] == '\\' ? 2 : 1;
+        }
+        if (close >= input.size()) {
+          return false;
+        }
+        argument.text = input.substr(offset + 1, close - offset - 1);
+        end = close + 1;
+        return end == input.size() || input[end] == ' ';
+      }
+      [[fallthrough]];
+    case ArgumentType::WORD:
+    case ArgumentType::ENTITY:
+    case ArgumentType::GAME_PROFILE:
+      if (token.empty()) {
+        return false;
+      }
+      break;
+    case ArgumentType::GREEDY_STRING:
+      end = input.size();
+      token = input.substr(offset);
+      if (token.empty()) {
+        return false;
+      }
+      break;
+    case ArgumentType::BLOCK_POS: {
+      size_t cursor = offset;
+      for (size_t axis = 0; axis < 3; ++axis) {
+        if (axis > 0) {
+          if (cursor >= input.size() || input[cursor] != ' ') {
+            return false;
+          }
+          ++cursor;
+        }
+        const size_t axis_end = TokenEnd(input, cursor);
+        if (!ParseCoordinate(input.substr(cursor, axis_end - cursor), argument.position[axis])) {
+          return false;
+        }
+        cursor = axis_end;
+      }
+      end = cursor;
+      token = input.substr(offset, end - offset);
+      break;
+    }
+  }
+  argument.text = token;
+  return true;
+}
+
+bool CommandGraph::ParseFrom(NodeId node, std::string_view input, size_t offset,
+                             uint8_t permission_level, ParseResult& result) const {
+  if (offset >= input.size()) {
+    if (nodes_[node].handler >= 0) {
+      result.status = ParseStatus::OK;
+      result.node = node;
+      return true;
+    }
+    Fail(result, ParseStatus::INCOMPLETE, offset);
+    return false;
+  }
+
+  if (node != ROOT_NODE) {
+    if (input[offset] != ' ') {
+      Fail(result, ParseStatus::INVALID_ARGUMENT, offset);
+      return false;
+    }
+    ++offset;
+  }
+
+  const NodeId owner = ChildrenOwner(node);
+  const Node& owner_node = nodes_[owner];
+  const size_t token_end = TokenEnd(input, offset);
+  const NodeId literal =
+      FindLiteral(owner, input.substr(offset, token_end - offset), permission_level);
+  if (literal != NO_NODE && ParseFrom(literal, input, token_end, permission_level, result)) {
+    return true;
+  }
+
+  for (uint16_t i = owner_node.literal_children; i < owner_node.child_count; ++i) {
+    const NodeId child = children_[owner_node.first_child + i];
+    if (!Visible(child, permission_level)) {
+      continue;
+    }
+    if (result.argument_count >= MAX_ARGUMENTS) {
+      Fail(result, ParseStatus::TOO_MANY_ARGUMENTS, offset);
+      return false;
+    }
+    ParsedArgument& argument = result.arguments[result.argument_count];
+    argument = ParsedArgument{};
+    size_t end = 0;
+    if (!ParseArgument(arguments_[nodes_[child].argument], input, offset, end, argument)) {
+      continue;
+    }
+    argument.node = child;
+    ++result.argument_count;
+    if (ParseFrom(child, input, end, permission_level, result)) {
+      return true;
+    }
+    --result.argument_count;
+  }
+
+  Fail(result, node == ROOT_NODE ? ParseStatus::UNKNOWN_COMMAND : ParseStatus::INVALID_ARGUMENT,
+       offset);
+  return false;
+}
+
+ParseResult CommandGraph::Parse(std::string_view input, uint8_t permission_level) const {
+  ParseResult result;
+  if (!input.empty()) {
+    ParseFrom(ROOT_NODE, input, 0, permission_level, result);
+  }
+  return result;
+}
+
+int32_t CommandGraph::Execute(const CommandSource& source, std::string_view input,
+                              ParseResult& result) const {
+  result = Parse(input, source.permission_level);
+  if (result.status != ParseStatus::OK) {
+    return 0;
+  }
+  return handlers_[nodes_[result.node].handler](source, result);
+}
+
+NodeId CommandGraph::WalkToCompletion(std::string_view input, uint8_t permission_level,
+                                      size_t& start) const {
+  // Consume every child whose text is complete, i.e. followed by a separator. What is left
+  // starts at the node being typed, which may span several words (quoted string, block_pos).
+  NodeId node = ROOT_NODE;
+  size_t offset = 0;
+  for (;;) {
+    const NodeId owner = ChildrenOwner(node);
+    const size_t token_end = TokenEnd(input, offset);
+    NodeId next = token_end < input.size()
+                      ? FindLiteral(owner, input.substr(offset, token_end - offset),
+                                    permission_level)
+                      : NO_NODE;
+    size_t next_end = token_end;
+
+    const Node& owner_node = nodes_[owner];
+    for (uint16_t i = owner_node.literal_children; next == NO_NODE && i < owner_node.child_count;
+         ++i) {
+      const NodeId child = children_[owner_node.first_child + i];
+      ParsedArgument argument;
+      size_t end = 0;
+      if (Visible(child, permission_level) &&
+          ParseArgument(arguments_[nodes_[child].argument], input, offset, end, argument) &&
+          end < input.size() && input[end] == ' ') {
+        next = child;
+        next_end = end;
+      }
+    }
+    if (next == NO_NODE) {
+      start = offset;
+      return node;
+    }
+    node = next;
+    offset = next_end + 1;
+  }
+}
+
+void CommandGraph::Complete(std::string_view input, uint8_t permission_level, size_t& start,
+                            std::vector<std::string_view>& out) const {
+  out.clear();
+  const NodeId node = WalkToCompletion(input, permission_level, start);
+  const std::string_view prefix = input.substr(start);
+  const std::vector<std::string_view>& names =
+      completions_[ChildrenOwner(node)].by_level[std::min<uint8_t>(permission_level,
+                                                                   MAX_PERMISSION_LEVEL)];
+  for (auto it = std::lower_bound(names.begin(), names.end(), prefix);
+       it != names.end() && it->starts_with(prefix); ++it) {
+    out.push_back(*it);
+  }
+}
+
+Network::SharedPacket CommandGraph::Suggest(int32_t transaction_id, std::string_view input,
+                                            uint8_t permission_level) const {
+  thread_local std::vector<std::string_view> matches;
+  size_t start = 0;
+  Complete(input, permission_level, start, matches);
+
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::COMMAND_SUGGESTIONS,
+                               16 + matches.size() * 12);
+  buffer.WriteVarInt(transaction_id);
+  // Offsets are relative to the client's text, which includes the slash.
+  buffer.WriteVarInt(static_cast<int32_t>(start + 1));
+  buffer.WriteVarInt(static_cast<int32_t>(input.size() - start));
+  buffer.WriteVarInt(static_cast<int32_t>(matches.size()));
+  for (std::string_view match : matches) {
+    buffer.WriteString(match);
+    buffer.WriteBool(false);  // no tooltip
+  }
+  return buffer.Finish();
+}
+
+void CommandGraph::BuildCompletions() {
+  completions_.assign(nodes_.size(), {});
+  for (NodeId id = 0; id < nodes_.size(); ++id) {
+    const Node& node = nodes_[id];
+    for (uint8_t level = 0; level <= MAX_PERMISSION_LEVEL; ++level) {
+      std::vector<std::string_view>& names = completions_[id].by_level[level];
+      for (uint16_t i = 0; i < node.child_count; ++i) {
+        const NodeId child = children_[node.first_child + i];
+        if (!Visible(child, level)) {
+          continue;
+        }
+        if (nodes_[child].type == LITERAL) {
+          names.push_back(NameOf(nodes_[child]));
+        } else {
+          for (const std::string& suggestion : arguments_[nodes_[child].argument].suggestions) {
+            names.push_back(suggestion);
+          }
+        }
+      }
+      std::sort(names.begin(), names.end());
+      names.erase(std::unique(names.begin(), names.end()), names.end());
+    }
+  }
+}
+
+void CommandGraph::EncodeCommandsPackets() {
+  std::vector<int32_t> packet_index(nodes_.size());
+  std::vector<NodeId> order;
+
+  for (uint8_t level = 0; level <= MAX_PERMISSION_LEVEL; ++level) {
+    // Breadth-first numbering of the nodes visible at this level.
+    std::fill(packet_index.begin(), packet_index.end(), -1);
+    order.assign(1, ROOT_NODE);
+    packet_index[ROOT_NODE] = 0;
+    for (size_t cursor = 0; cursor < order.size(); ++cursor) {
+      const Node& node = nodes_[order[cursor]];
+      auto visit = [&](NodeId next) {
+        if (packet_index[next] < 0 && Visible(next, level)) {
+          packet_index[next] = static_cast<int32_t>(order.size());
+          order.push_back(next);
+        }
+      };
+      for (uint16_t i = 0; i < node.child_count; ++i) {
+        visit(children_[node.first_child + i]);
+      }
+      if (node.redirect != NO_NODE) {
+        visit(node.redirect);
+      }
+    }
+
+    Network::PacketBuffer buffer(Protocol::Play::Clientbound::COMMANDS, order.size() * 16);
+    buffer.WriteVarInt(static_cast<int32_t>(order.size()));
+    for (NodeId id : order) {
+      const Node& node = nodes_[id];
+      const bool redirect = node.redirect != NO_NODE && packet_index[node.redirect] >= 0;
+      const bool suggestions =
+          node.type == ARGUMENT && !arguments_[node.argument].suggestions.empty();
+
+      uint8_t flags = node.type;
+      flags |= node.handler >= 0 ? FLAG_EXECUTABLE : 0;
+      flags |= redirect ? FLAG_REDIRECT : 0;
+      flags |= suggestions ? FLAG_SUGGESTIONS : 0;
+      buffer.WriteByte(flags);
+
+      int32_t visible_children = 0;
+      for (uint16_t i = 0; i < node.child_count; ++i) {
+        visible_children += packet_index[children_[node.first_child + i]] >= 0;
+      }
+      buffer.WriteVarInt(visible_children);
+      for (uint16_t i = 0; i < node.child_count; ++i) {
+        const int32_t child = packet_index[children_[node.first_child + i]];
+        if (child >= 0) {
+          buffer.WriteVarInt(child);
+        }
+      }
+      if (redirect) {
+        buffer.WriteVarInt(packet_index[node.redirect]);
+      }
+      if (node.type != ROOT) {
+        buffer.WriteString(NameOf(node));
+      }
+      if (node.type == ARGUMENT) {
+        WriteParser(buffer, arguments_[node.argument]);
+      }
+      if (suggestions) {
+        buffer.WriteString("minecraft:ask_server");
+      }
+    }
+    buffer.WriteVarInt(0);  // root index
+    commands_packets_[level] = buffer.Finish();
+  }
+}
+
+CommandGraphBuilder::CommandGraphBuilder() { nodes_.emplace_back(); }
+
+NodeId CommandGraphBuilder::Literal(NodeId parent, std::string_view name, uint8_t permission) {
+  for (NodeId child : nodes_[parent].children) {
+    if (nodes_[child].type == 1 && nodes_[child].name == name) {
+      return child;
+    }
+  }
+  const auto id = static_cast<NodeId>(nodes_.size());
+  PendingNode& node = nodes_.emplace_back();
+  node.type = 1;
+  node.permission = permission;
+  node.name = name;
+  nodes_[parent].children.push_back(id);
+  return id;
+}
+
+NodeId CommandGraphBuilder::Argument(NodeId parent, std::string_view name, ArgumentSpec spec,
+                                     uint8_t permission) {
+  const auto id = static_cast<NodeId>(nodes_.size());
+  PendingNode& node = nodes_.emplace_back();
+  node.type = 2;
+  node.permission = permission;
+  node.name = name;
+  node.argument = static_cast<int32_t>(arguments_.size());
+  arguments_.push_back(std::move(spec));
+  nodes_[parent].children.push_back(id);
+  return id;
+}
+
+void CommandGraphBuilder::Executes(NodeId node, CommandHandler handler) {
+  nodes_[node].handler = static_cast<int32_t>(handlers_.size());
+  handlers_.push_back(std::move(handler));
+}
+
+void CommandGraphBuilder::Redirect(NodeId node, NodeId target) { nodes_[node].redirect = target; }
+
+CommandGraph CommandGraphBuilder::Build() const {
+  CommandGraph graph;
+  graph.arguments_ = arguments_;
+  graph.handlers_ = handlers_;
+  graph.nodes_.resize(nodes_.size());
+
+  std::unordered_map<std::string_view, uint32_t> interned;
+  for (const PendingNode& pending : nodes_) {
+    if (pending.name.empty()) {
+      continue;
+    }
+    const auto offset = static_cast<uint32_t>(graph.name_pool_.size());
+    if (interned.try_emplace(pending.name, offset).second) {
+      graph.name_pool_.insert(graph.name_pool_.end(), pending.name.begin(), pending.name.end());
+    }
+  }
+
+  for (NodeId id = 0; id < nodes_.size(); ++id) {
+    const PendingNode& pending = nodes_[id];
+    CommandGraph::Node& node = graph.nodes_[id];
+    node.type = static_cast<CommandGraph::NodeType>(pending.type);
+    node.permission = pending.permission;
+    node.name_offset = pending.name.empty() ? 0 : interned[pending.name];
+    node.name_length = static_cast<uint32_t>(pending.name.size());
+    node.redirect = pending.redirect;
+    node.argument = pending.argument;
+    node.handler = pending.handler;
+  }
+
+  for (NodeId id = 0; id < nodes_.size(); ++id) {
+    std::vector<NodeId> literals;
+    std::vector<NodeId> arguments;
+    for (NodeId child : nodes_[id].children) {
+      (nodes_[child].type == 1 ? literals : arguments).push_back(child);
+    }
+    std::sort(literals.begin(), literals.end(),
+              [this](NodeId a, NodeId b) { return nodes_[a].name < nodes_[b].name; });
+
+    CommandGraph::Node& node = graph.nodes_[id];
+    node.first_child = static_cast<uint32_t>(graph.children_.size());
+    node.literal_children = static_cast<uint16_t>(literals.size());
+    node.child_count = static_cast<uint16_t>(literals.size() + arguments.size());
+    graph.children_.insert(graph.children_.end(), literals.begin(), literals.end());
+    graph.children_.insert(graph.children_.end(), arguments.begin(), arguments.end());
+  }
+
+  graph.BuildCompletions();
+  graph.EncodeCommandsPackets();
+  return graph;
+}
+
+}  // namespace Command
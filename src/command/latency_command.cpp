@@ -0,0 +1,117 @@
+#include "command/latency_command.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include "network/packet_buffer.h"
+#include "protocol/packet_ids.h"
+#include "protocol/text_component.h"
+
+namespace Command {
+
+namespace {
+
+/** @brief Packet ids listed by /latency packets */
+constexpr size_t MAX_PACKET_LINES = 10;
+
+std::optional<Util::LatencyCategory> ParseCategory(std::string_view name) {
+  if (name == "tick") {
+    return Util::LatencyCategory::TICK_PHASES;
+  }
+  if (name == "packets") {
+    return Util::LatencyCategory::PACKETS;
+  }
+  if (name == "join") {
+    return Util::LatencyCategory::JOIN;
+  }
+  if (name == "chunks") {
+    return Util::LatencyCategory::CHUNK_DELIVERY;
+  }
+  return std::nullopt;
+}
+
+/** @brief Nanoseconds with a unit that keeps three significant digits */
+std::string FormatDuration(uint64_t nanoseconds) {
+  const auto value = static_cast<double>(nanoseconds);
+  if (nanoseconds < 1000) {
+    return fmt::format("{}ns", nanoseconds);
+  }
+  if (nanoseconds < 1'000'000) {
+    return fmt::format("{:.3g}µs", value / 1e3);
+  }
+  if (nanoseconds < 1'000'000'000) {
+    return fmt::format("{:.3g}ms", value / 1e6);
+  }
+  return fmt::format("{:.3g}s", value / 1e9);
+}
+
+std::string FormatLine(const Util::LatencyLine& line) {
+  return fmt::format("{}: p50 {} p99 {} p99.9 {} max {} ({} samples)", line.name,
+                     FormatDuration(line.p50_ns), FormatDuration(line.p99_ns),
+                     FormatDuration(line.p999_ns), FormatDuration(line.max_ns), line.samples);
+}
+
+void Reply(const CommandSource& source, std::string_view text) {
+  if (source.sink == nullptr) {
+    spdlog::info("{}", text);
+    return;
+  }
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::SYSTEM_CHAT, 16 + text.size());
+  Protocol::WritePlainText(buffer, text);
+  buffer.WriteBool(false);  // Chat box, not the action bar
+  source.sink->SendPacket(buffer.Finish());
+}
+
+int32_t ReportCategory(const CommandSource& source, const Util::LatencyMetrics& latency,
+                       std::string_view name) {
+  const std::optional<Util::LatencyCategory> category = ParseCategory(name);
+  if (!category) {
+    Reply(source, "Usage: /latency [tick|packets|join|chunks]");
+    return 0;
+  }
+  std::vector<Util::LatencyLine> lines = latency.Report(*category);
+  if (*category == Util::LatencyCategory::PACKETS && lines.size() > MAX_PACKET_LINES) {
+    lines.resize(MAX_PACKET_LINES);
+  }
+  if (lines.empty()) {
+    Reply(source, fmt::format("No {} latency recorded yet", name));
+    return 0;
+  }
+  for (const Util::LatencyLine& line : lines) {
+    Reply(source, FormatLine(line));
+  }
+  return static_cast<int32_t>(lines.size());
+}
+
+}  // namespace
+
+void RegisterLatencyCommand(CommandGraphBuilder& builder, const Util::LatencyMetrics& latency,
+                            uint8_t permission) {
+  const NodeId root = builder.Literal(ROOT_NODE, "latency", permission);
+  builder.Executes(root, [&latency](const CommandSource& source, const ParseResult&) {
+    return ReportCategory(source, latency, "tick");
+  });
+
+  ArgumentSpec spec;
+  spec.type = ArgumentType::WORD;
+  spec.suggestions = {"tick", "packets", "join", "chunks"};
+  const NodeId category = builder.Argument(root, "category", std::move(spec), permission);
+  // The built graph is not known yet, so the argument is matched by node rather than Find()
+  builder.Executes(category, [&latency, category](const CommandSource& source,
+                                                  const ParseResult& result) {
+    for (size_t i = 0; i < result.argument_count; ++i) {
+      if (result.arguments[i].node == category) {
+        return ReportCategory(source, latency, result.arguments[i].text);
+      }
+    }
+    return 0;
+  });
+}
+
+}  // namespace Command
@@ -0,0 +1,132 @@
+#include "inventory/container.h"
+
+#include "inventory/item_stack_cache.h"
+#include "network/packet_buffer.h"
+#include "protocol/packet_ids.h"
+
+namespace Inventory {
+
+bool Container::SetSlot(size_t index, ItemStack stack) {
+  if (slots_[index] == stack) {
+    return false;
+  }
+  slots_[index] = std::move(stack);
+  slot_revisions_[index] = ++revision_;
+  return true;
+}
+
+void ContainerView::SetCarried(ItemStack stack) {
+  if (carried_ == stack) {
+    return;
+  }
+  carried_ = std::move(stack);
+  carried_dirty_ = true;
+}
+
+void ContainerView::WriteHeader(Network::PacketBuffer& buffer, int32_t window_id) {
+  state_id_ = (state_id_ + 1) & 0x7FFF;
+#if MINECRAFT_VERSION >= 121300
+  buffer.WriteVarInt(window_id);
+#else
+  buffer.WriteByte(static_cast<uint8_t>(window_id));
+#endif
+  buffer.WriteVarInt(state_id_);
+}
+
+size_t ContainerView::Flush(ItemStackCache& cache, Network::PacketSink& sink) {
+  if (!full_sync_ && !carried_dirty_ && container_.Revision() == synced_revision_) {
+    return 0;
+  }
+
+  if (!full_sync_ && container_.Revision() == synced_revision_) {
+    SendCarried(cache, sink);
+    return 1;
+  }
+
+  if (!full_sync_) {
+    changed_.clear();
+    for (size_t i = 0; i < container_.Size(); ++i) {
+      if (container_.SlotRevision(i) > synced_revision_) {
+        changed_.push_back(i);
+      }
+    }
+
+    // Compare the bytes of per-slot updates with one full content packet;
+    // both sizes come from the encoded stack cache. Headers are estimated
+    // at 5 bytes (packet id, window id, state id).
+    constexpr size_t HEADER_BYTES = 5;
+    size_t slot_bytes = 0;
+    for (size_t index : changed_) {
+      slot_bytes += HEADER_BYTES + 2 + cache.EncodedSize(container_.Slot(index));
+    }
+    size_t content_bytes = HEADER_BYTES + 2 + cache.EncodedSize(carried_);
+    for (size_t i = 0; i < container_.Size() && content_bytes < slot_bytes; ++i) {
+      content_bytes += cache.EncodedSize(container_.Slot(i));
+    }
+
+    if (slot_bytes <= content_bytes) {
+      size_t sent = changed_.size();
+      for (size_t index : changed_) {
+        SendSlot(cache, sink, index);
+      }
+      if (carried_dirty_) {
+        SendCarried(cache, sink);
+        ++sent;
+      }
+      synced_revision_ = container_.Revision();
+      return sent;
+    }
+  }
+
+  // Set Container Content carries the cursor item as well
+  SendContent(cache, sink);
+  full_sync_ = false;
+  carried_dirty_ = false;
+  synced_revision_ = container_.Revision();
+  return 1;
+}
+
+void ContainerView::SendContent(ItemStackCache& cache, Network::PacketSink& sink) {
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::SET_CONTAINER_CONTENT,
+                               16 + container_.Size() * 4);
+  WriteHeader(buffer, window_id_);
+  buffer.WriteVarInt(static_cast<int32_t>(container_.Size()));
+  for (size_t i = 0; i < container_.Size(); ++i) {
+    cache.Write(buffer, container_.Slot(i));
+  }
+  cache.Write(buffer, carried_);
+
+  ++stats_.content_packets;
+  stats_.bytes_sent += buffer.Size();
+  sink.SendPacket(buffer.Finish());
+}
+
+void ContainerView::SendSlot(ItemStackCache& cache, Network::PacketSink& sink, size_t index) {
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::SET_CONTAINER_SLOT, 16);
+  WriteHeader(buffer, window_id_);
+  buffer.WriteShort(static_cast<int16_t>(index));
+  cache.Write(buffer, container_.Slot(index));
+
+  ++stats_.slot_packets;
+  stats_.bytes_sent += buffer.Size();
+  sink.SendPacket(buffer.Finish());
+}
+
+void ContainerView::SendCarried(ItemStackCache& cache, Network::PacketSink& sink) {
+#if MINECRAFT_VERSION >= 121300
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::SET_CURSOR_ITEM, 16);
+#else
+  // Window -1, slot -1 addresses the cursor
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::SET_CONTAINER_SLOT, 16);
+  WriteHeader(buffer, -1);
+  buffer.WriteShort(-1);
+#endif
+  cache.Write(buffer, carried_);
+  carried_dirty_ = false;
+
+  ++stats_.cursor_packets;
+  stats_.bytes_sent += buffer.Size();
+  sink.SendPacket(buffer.Finish());
+}
+
+}  // namespace Inventory
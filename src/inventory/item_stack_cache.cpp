@@ -0,0 +1,77 @@
+#include "inventory/item_stack_cache.h"
+
+#include "network/packet_buffer.h"
+#include "protocol/version.h"
+#include "util/memory_accounting.h"
+
+namespace Inventory {
+
+void ItemStackCache::Encode(Network::PacketBuffer& buffer, const ItemStack& stack) {
+#if MINECRAFT_VERSION >= 121100
+  // 1.20.5+: VarInt count, then id and the component patch when non-empty.
+  if (stack.IsEmpty()) {
+    buffer.WriteVarInt(0);
+    return;
+  }
+  buffer.WriteVarInt(stack.count);
+  buffer.WriteVarInt(stack.item_id);
+  if (stack.components) {
+    buffer.WriteVarInt(stack.components->AddedCount());
+    buffer.WriteVarInt(stack.components->RemovedCount());
+    buffer.WriteBytes(stack.components->Encoded());
+  } else {
+    buffer.WriteVarInt(0);
+    buffer.WriteVarInt(0);
+  }
+#else
+  // Before 1.20.5: present flag, id, byte count and an NBT tag (TAG_End if none).
+  if (stack.IsEmpty()) {
+    buffer.WriteBool(false);
+    return;
+  }
+  buffer.WriteBool(true);
+  buffer.WriteVarInt(stack.item_id);
+  buffer.WriteByte(static_cast<uint8_t>(stack.count));
+  if (stack.components) {
+    buffer.WriteBytes(stack.components->Encoded());
+  } else {
+    buffer.WriteByte(0);
+  }
+#endif
+}
+
+const std::vector<uint8_t>& ItemStackCache::Lookup(const ItemStack& stack) {
+  if (auto it = entries_.find(stack); it != entries_.end()) {
+    ++stats_.hits;
+    return it->second;
+  }
+
+  ++stats_.misses;
+  if (entries_.size() >= capacity_ || Util::OverMemoryBudget(Util::MemorySubsystem::CACHES)) {
+    Clear();
+    ++stats_.clears;
+  }
+  Network::PacketBuffer encoded;
+  Encode(encoded, stack);
+  const auto bytes = encoded.Data();
+  // Node, key and value estimate; components are shared with the inventories
+  const size_t entry_bytes = sizeof(ItemStack) + sizeof(std::vector<uint8_t>) + 2 * sizeof(void*) +
+                             bytes.size();
+  bytes_ += entry_bytes;
+  Util::TrackAllocation(Util::MemorySubsystem::CACHES, entry_bytes);
+  return entries_.emplace(stack, std::vector<uint8_t>(bytes.begin(), bytes.end())).first->second;
+}
+
+void ItemStackCache::Clear() {
+  entries_.clear();
+  Util::TrackRelease(Util::MemorySubsystem::CACHES, bytes_);
+  bytes_ = 0;
+}
+
+void ItemStackCache::Write(Network::PacketBuffer& buffer, const ItemStack& stack) {
+  buffer.WriteBytes(Lookup(stack));
+}
+
+size_t ItemStackCache::EncodedSize(const ItemStack& stack) { return Lookup(stack).size(); }
+
+}  // namespace Inventory
@@ -0,0 +1,250 @@
+#include "inventory/recipe_index.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "util/hash.h"
+
+namespace Inventory {
+
+namespace {
+
+/** @brief A grid or pattern reduced to the bounding box of its occupied cells */
+template <typename Cell>
+struct Trimmed {
+  int32_t width = 0;
+  int32_t height = 0;
+  uint16_t mask = 0;  ///< Bit (row * width + column) set for occupied cells
+  int32_t occupied = 0;
+  std::array<Cell, 9> cells{};
+};
+
+template <typename Cell, typename IsEmpty>
+Trimmed<Cell> Trim(int32_t width, int32_t height, const Cell* cells, IsEmpty is_empty) {
+  int32_t min_row = height, max_row = -1, min_col = width, max_col = -1;
+  for (int32_t row = 0; row < height; ++row) {
+    for (int32_t col = 0; col < width; ++col) {
+      if (!is_empty(cells[row * width + col])) {
+        min_row = std::min(min_row, row);
+        max_row = std::max(max_row, row);
+        min_col = std::min(min_col, col);
+        max_col = std::max(max_col, col);
+      }
+    }
+  }
+
+  Trimmed<Cell> trimmed;
+  if (max_row < 0) {
+    return trimmed;
+  }
+  trimmed.width = max_col - min_col + 1;
+  trimmed.height = max_row - min_row + 1;
+  for (int32_t row = 0; row < trimmed.height; ++row) {
+    for (int32_t col = 0; col < trimmed.width; ++col) {
+      const int32_t index = row * trimmed.width + col;
+      const Cell& cell = cells[(row + min_row) * width + col + min_col];
+      trimmed.cells[index] = cell;
+      if (!is_empty(cell)) {
+        trimmed.mask |= static_cast<uint16_t>(1u << index);
+        ++trimmed.occupied;
+      }
+    }
+  }
+  return trimmed;
+}
+
+int32_t FirstOccupied(uint16_t mask) {
+  int32_t index = 0;
+  while (!(mask & (1u << index))) {
+    ++index;
+  }
+  return index;
+}
+
+bool AssignShapeless(const CraftingRecipe& recipe, const std::array<int32_t, 9>& items,
+                     int32_t count, int32_t item, uint16_t used) {
+  if (item == count) {
+    return true;
+  }
+  for (size_t i = 0; i < recipe.ingredients.size(); ++i) {
+    if (!(used & (1u << i)) && recipe.ingredients[i].Accepts(items[item]) &&
+        AssignShapeless(recipe, items, count, item + 1, static_cast<uint16_t>(used | (1u << i)))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+bool Ingredient::Accepts(int32_t item_id) const {
+  return std::binary_search(items.begin(), items.end(), item_id);
+}
+
+uint64_t RecipeIndex::ShapedKey(int32_t width, int32_t height, uint16_t mask, int32_t first_item) {
+  return Util::HashCombine(
+      Util::HashCombine(static_cast<uint64_t>((width << 4) | height), mask),
+      static_cast<uint64_t>(first_item));
+}
+
+uint64_t RecipeIndex::ShapelessKey(int32_t count, int32_t smallest_item) {
+  return Util::HashCombine(static_cast<uint64_t>(count), static_cast<uint64_t>(smallest_item));
+}
+
+size_t RecipeIndex::Add(CraftingRecipe recipe) {
+  for (Ingredient& ingredient : recipe.ingredients) {
+    std::sort(ingredient.items.begin(), ingredient.items.end());
+    ingredient.items.erase(std::unique(ingredient.items.begin(), ingredient.items.end()),
+                           ingredient.items.end());
+  }
+
+  const auto index = static_cast<uint32_t>(recipes_.size());
+
+  if (recipe.kind == CraftingRecipe::SHAPELESS) {
+    const auto count = static_cast<int32_t>(recipe.ingredients.size());
+    if (count == 0 || count > 9) {
+      throw std::invalid_argument("shapeless recipe needs 1-9 ingredients: " + recipe.id);
+    }
+    std::vector<int32_t> accepted;
+    for (const Ingredient& ingredient : recipe.ingredients) {
+      accepted.insert(accepted.end(), ingredient.items.begin(), ingredient.items.end());
+    }
+    std::sort(accepted.begin(), accepted.end());
+    accepted.erase(std::unique(accepted.begin(), accepted.end()), accepted.end());
+    for (int32_t item : accepted) {
+      shapeless_[ShapelessKey(count, item)].push_back(index);
+    }
+    recipes_.push_back(std::move(recipe));
+    return index;
+  }
+
+  if (recipe.width < 1 || recipe.width > 3 || recipe.height < 1 || recipe.height > 3 ||
+      recipe.ingredients.size() != static_cast<size_t>(recipe.width * recipe.height)) {
+    throw std::invalid_argument("shaped recipe pattern must fit a 3x3 grid: " + recipe.id);
+  }
+  const auto trimmed = Trim(recipe.width, recipe.height, recipe.ingredients.data(),
+                            [](const Ingredient& ingredient) { return ingredient.IsEmpty(); });
+  if (trimmed.occupied == 0) {
+    throw std::invalid_argument("shaped recipe has an empty pattern: " + recipe.id);
+  }
+  recipe.width = trimmed.width;
+  recipe.height = trimmed.height;
+  recipe.ingredients.assign(trimmed.cells.begin(), trimmed.cells.begin() + trimmed.width * trimmed.height);
+
+  auto register_pattern = [&](bool mirrored) {
+    uint16_t mask = 0;
+    for (int32_t row = 0; row < recipe.height; ++row) {
+      for (int32_t col = 0; col < recipe.width; ++col) {
+        const int32_t source = row * recipe.width + (mirrored ? recipe.width - 1 - col : col);
+        if (!recipe.ingredients[source].IsEmpty()) {
+          mask |= static_cast<uint16_t>(1u << (row * recipe.width + col));
+        }
+      }
+    }
+    const int32_t first = FirstOccupied(mask);
+    const int32_t first_source =
+        (first / recipe.width) * recipe.width +
+        (mirrored ? recipe.width - 1 - first % recipe.width : first % recipe.width);
+    for (int32_t item : recipe.ingredients[first_source].items) {
+      shaped_[ShapedKey(recipe.width, recipe.height, mask, item)].push_back({index, mirrored});
+    }
+  };
+
+  register_pattern(false);
+  bool symmetric = true;
+  for (int32_t row = 0; row < recipe.height && symmetric; ++row) {
+    for (int32_t col = 0; col < recipe.width / 2; ++col) {
+      if (recipe.ingredients[row * recipe.width + col].items !=
+          recipe.ingredients[row * recipe.width + recipe.width - 1 - col].items) {
+        symmetric = false;
+        break;
+      }
+    }
+  }
+  if (!symmetric) {
+    register_pattern(true);
+  }
+
+  recipes_.push_back(std::move(recipe));
+  return index;
+}
+
+bool RecipeIndex::MatchesShaped(const CraftingRecipe& recipe, bool mirrored, int32_t width,
+                                const std::array<int32_t, 9>& cells) const {
+  for (int32_t i = 0; i < recipe.width * recipe.height; ++i) {
+    const int32_t row = i / width;
+    const int32_t col = i % width;
+    const Ingredient& ingredient =
+        recipe.ingredients[row * width + (mirrored ? width - 1 - col : col)];
+    if (ingredient.IsEmpty() ? cells[i] != EMPTY_ITEM : !ingredient.Accepts(cells[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RecipeIndex::MatchesShapeless(const CraftingRecipe& recipe,
+                                   const std::array<int32_t, 9>& items, int32_t count) {
+  return static_cast<int32_t>(recipe.ingredients.size()) == count &&
+         AssignShapeless(recipe, items, count, 0, 0);
+}
+
+const CraftingRecipe* RecipeIndex::Match(const CraftingGrid& grid) const {
+  const auto trimmed = Trim(grid.width, grid.height, grid.items.data(),
+                            [](int32_t item) { return item == EMPTY_ITEM; });
+  if (trimmed.occupied == 0) {
+    return nullptr;
+  }
+
+  uint32_t best = UINT32_MAX;
+
+  const int32_t first_item = trimmed.cells[FirstOccupied(trimmed.mask)];
+  if (auto it = shaped_.find(ShapedKey(trimmed.width, trimmed.height, trimmed.mask, first_item));
+      it != shaped_.end()) {
+    for (const Candidate& candidate : it->second) {
+      const CraftingRecipe& recipe = recipes_[candidate.recipe];
+      if (recipe.width == trimmed.width && recipe.height == trimmed.height &&
+          MatchesShaped(recipe, candidate.mirrored, trimmed.width, trimmed.cells)) {
+        best = candidate.recipe;
+        break;
+      }
+    }
+  }
+
+  std::array<int32_t, 9> items{};
+  int32_t count = 0;
+  for (int32_t item : grid.items) {
+    if (item != EMPTY_ITEM) {
+      items[count++] = item;
+    }
+  }
+  std::sort(items.begin(), items.begin() + count);
+  if (auto it = shapeless_.find(ShapelessKey(count, items[0])); it != shapeless_.end()) {
+    for (uint32_t candidate : it->second) {
+      if (candidate >= best) {
+        break;
+      }
+      const CraftingRecipe& recipe = recipes_[candidate];
+      if (recipe.kind == CraftingRecipe::SHAPELESS && MatchesShapeless(recipe, items, count)) {
+        best = candidate;
+        break;
+      }
+    }
+  }
+
+  return best == UINT32_MAX ? nullptr : &recipes_[best];
+}
+
+const CraftingRecipe* CraftingMatcher::Match(const CraftingGrid& grid) {
+  ++stats_.lookups;
+  if (has_last_ && grid == last_grid_) {
+    ++stats_.cache_hits;
+    return last_match_;
+  }
+  last_grid_ = grid;
+  last_match_ = index_.Match(grid);
+  has_last_ = true;
+  return last_match_;
+}
+
+}  // namespace Inventory
@@ -0,0 +1,431 @@
+#include "network/http_server.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "platform.h"
+
+#ifndef PLATFORM_WINDOWS
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#endif
+
+namespace Network {
+
+namespace {
+
+#ifdef PLATFORM_WINDOWS
+using SocketHandle = SOCKET;
+const SocketHandle NO_SOCKET = INVALID_SOCKET;
+using PollDescriptor = WSAPOLLFD;
+#else
+using SocketHandle = int;
+constexpr SocketHandle NO_SOCKET = -1;
+using PollDescriptor = pollfd;
+#endif
+
+/** @brief How long the server thread sleeps in poll() before checking for Stop() */
+constexpr int POLL_INTERVAL_MS = 200;
+
+SocketHandle ToSocket(intptr_t handle) { return static_cast<SocketHandle>(handle); }
+
+void CloseSocket(SocketHandle socket) {
+#ifdef PLATFORM_WINDOWS
+  ::closesocket(socket);
+#else
+  ::close(socket);
+#endif
+}
+
+bool SetNonBlocking(SocketHandle socket) {
+#ifdef PLATFORM_WINDOWS
+  u_long enable = 1;
+  return ::ioctlsocket(socket, FIONBIO, &enable) == 0;
+#else
+  const int flags = ::fcntl(socket, F_GETFL, 0);
+  return flags >= 0 && ::fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+bool WouldBlock() {
+#ifdef PLATFORM_WINDOWS
+  return ::WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+int PollSockets(std::vector<PollDescriptor>& descriptors, int timeout_ms) {
+#ifdef PLATFORM_WINDOWS
+  return ::WSAPoll(descriptors.data(), static_cast<ULONG>(descriptors.size()), timeout_ms);
+#else
+  return ::poll(descriptors.data(), descriptors.size(), timeout_ms);
+#endif
+}
+
+std::string_view ReasonPhrase(int status) {
+  switch (status) {
+    case 200:
+      return "OK";
+    case 400:
+      return "Bad Request";
+    case 404:
+      return "Not Found";
+    case 405:
+      return "Method Not Allowed";
+    case 431:
+      return "Request Header Fields Too Large";
+    case 500:
+      return "Internal Server Error";
+    case 503:
+      return "Service Unavailable";
+    default:
+      return "Unknown";
+  }
+}
+
+bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+  return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return std::tolower(static_cast<unsigned char>(x)) ==
+                  std::tolower(static_cast<unsigned char>(y));
+         });
+}
+
+std::string_view Trim(std::string_view text) {
+  while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+void AppendResponse(std::string& out, const HttpResponse& response, bool head, bool close) {
+  out += "HTTP/1.1 ";
+  out += std::to_string(response.status);
+  out += ' ';
+  out += ReasonPhrase(response.status);
+  out += "\r\nContent-Type: ";
+  out += response.content_type;
+  out += "\r\nContent-Length: ";
+  out += std::to_string(response.body.size());
+  out += "\r\nCache-Control: no-store\r\n";
+  if (response.status == 405) {
+    out += "Allow: GET, HEAD\r\n";
+  }
+  if (close) {
+    out += "Connection: close\r\n";
+  }
+  out += "\r\n";
+  if (!head) {
+    out += response.body;
+  }
+}
+
+}  // namespace
+
+struct HttpServer::Connection {
+  SocketHandle socket = NO_SOCKET;
+  std::string input;
+  std::string output;
+  size_t output_sent = 0;
+  bool close_after_output = false;
+  std::chrono::steady_clock::time_point last_activity;
+};
+
+HttpServer::HttpServer(HttpServerConfig config) : config_(std::move(config)) {
+#ifdef PLATFORM_WINDOWS
+  WSADATA data;
+  ::WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+}
+
+HttpServer::~HttpServer() {
+  Stop();
+#ifdef PLATFORM_WINDOWS
+  ::WSACleanup();
+#endif
+}
+
+void HttpServer::Handle(std::string path, HttpHandler handler) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  routes_[std::move(path)] = std::move(handler);
+}
+
+void HttpServer::Start() {
+  if (thread_.joinable()) {
+    return;
+  }
+  sockaddr_storage address{};
+  socklen_t address_length = 0;
+  auto* ipv4 = reinterpret_cast<sockaddr_in*>(&address);
+  auto* ipv6 = reinterpret_cast<sockaddr_in6*>(&address);
+  if (::inet_pton(AF_INET, config_.address.c_str(), &ipv4->sin_addr) == 1) {
+    ipv4->sin_family = AF_INET;
+    ipv4->sin_port = htons(config_.port);
+    address_length = sizeof(sockaddr_in);
+  } else if (::inet_pton(AF_INET6, config_.address.c_str(), &ipv6->sin6_addr) == 1) {
+    ipv6->sin6_family = AF_INET6;
+    ipv6->sin6_port = htons(config_.port);
+    address_length = sizeof(sockaddr_in6);
+  } else {
+    throw std::runtime_error("Invalid HTTP listen address: " + config_.address);
+  }
+
+  const SocketHandle listener = ::socket(address.ss_family, SOCK_STREAM, IPPROTO_TCP);
+  if (listener == NO_SOCKET) {
+    throw std::runtime_error("Cannot create HTTP listen socket");
+  }
+  const int reuse = 1;
+  ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse),
+               sizeof(reuse));
+  if (::bind(listener, reinterpret_cast<const sockaddr*>(&address), address_length) != 0 ||
+      ::listen(listener, SOMAXCONN) != 0 || !SetNonBlocking(listener)) {
+    CloseSocket(listener);
+    throw std::runtime_error("Cannot listen for HTTP on " + config_.address + ":" +
+                             std::to_string(config_.port));
+  }
+  sockaddr_storage bound{};
+  socklen_t bound_length = sizeof(bound);
+  if (::getsockname(listener, reinterpret_cast<sockaddr*>(&bound), &bound_length) == 0) {
+    port_.store(ntohs(bound.ss_family == AF_INET6
+                          ? reinterpret_cast<const sockaddr_in6*>(&bound)->sin6_port
+                          : reinterpret_cast<const sockaddr_in*>(&bound)->sin_port),
+                std::memory_order_relaxed);
+  }
+
+  listener_ = static_cast<intptr_t>(listener);
+  stopping_.store(false, std::memory_order_relaxed);
+  thread_ = std::thread([this] { Loop(); });
+  spdlog::info("HTTP endpoint listening on {}:{}", config_.address, Port());
+}
+
+void HttpServer::Stop() {
+  stopping_.store(true, std::memory_order_relaxed);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+HttpServerStats HttpServer::GetStats() const {
+  HttpServerStats stats;
+  stats.connections = connections_.load(std::memory_order_relaxed);
+  stats.requests = requests_.load(std::memory_order_relaxed);
+  stats.rejected = rejected_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+HttpResponse HttpServer::Dispatch(const HttpRequest& request) {
+  HttpHandler handler;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto route = routes_.find(request.path);
+    if (route == routes_.end()) {
+      return {404, "text/plain; charset=utf-8", "Not Found\n"};
+    }
+    handler = route->second;
+  }
+  try {
+    return handler(request);
+  } catch (const std::exception& e) {
+    spdlog::error("HTTP handler for {} failed: {}", request.path, e.what());
+    return {500, "text/plain; charset=utf-8", "Internal Server Error\n"};
+  }
+}
+
+bool HttpServer::Serve(Connection& connection) {
+  for (;;) {
+    const size_t header_end = connection.input.find("\r\n\r\n");
+    if (header_end == std::string::npos) {
+      if (connection.input.size() > config_.max_request_bytes) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        AppendResponse(connection.output, {431, "text/plain; charset=utf-8", "Too Large\n"}, false,
+                       true);
+        connection.close_after_output = true;
+      }
+      return true;
+    }
+    const std::string_view head(connection.input.data(), header_end);
+    const size_t line_end = head.find("\r\n");
+    const std::string_view request_line = head.substr(0, line_end);
+    const size_t method_end = request_line.find(' ');
+    const size_t target_end = request_line.find(' ', method_end + 1);
+    if (method_end == std::string_view::npos || target_end == std::string_view::npos) {
+      rejected_.fetch_add(1, std::memory_order_relaxed);
+      AppendResponse(connection.output, {400, "text/plain; charset=utf-8", "Bad Request\n"},
+                     false, true);
+      connection.close_after_output = true;
+      return true;
+    }
+
+    HttpRequest request;
+    request.method = request_line.substr(0, method_end);
+    const std::string_view target =
+        request_line.substr(method_end + 1, target_end - method_end - 1);
+    const std::string_view version = request_line.substr(target_end + 1);
+    const size_t query_start = target.find('?');
+    request.path = target.substr(0, query_start);
+    if (query_start != std::string_view::npos) {
+      request.query = target.substr(query_start + 1);
+    }
+
+    bool close = version != "HTTP/1.1";
+    bool has_body = false;
+    std::string_view headers =
+        line_end == std::string_view::npos ? std::string_view() : head.substr(line_end + 2);
+    while (!headers.empty()) {
+      const size_t next = headers.find("\r\n");
+      const std::string_view line = headers.substr(0, next);
+      headers = next == std::string_view::npos ? std::string_view() : headers.substr(next + 2);
+      const size_t colon = line.find(':');
+      if (colon == std::string_view::npos) {
+        continue;
+      }
+      const std::string_view name = Trim(line.substr(0, colon));
+      const std::string_view value = Trim(line.substr(colon + 1));
+      if (EqualsIgnoreCase(name, "Accept")) {
+        request.accept = value;
+      } else if (EqualsIgnoreCase(name, "Connection")) {
+        close = EqualsIgnoreCase(value, "close") ||
+                (version != "HTTP/1.1" && !EqualsIgnoreCase(value, "keep-alive"));
+      } else if ((EqualsIgnoreCase(name, "Content-Length") && value != "0") ||
+                 EqualsIgnoreCase(name, "Transfer-Encoding")) {
+        has_body = true;
+      }
+    }
+    connection.input.erase(0, header_end + 4);
+    requests_.fetch_add(1, std::memory_order_relaxed);
+
+    const bool head_only = request.method == "HEAD";
+    if (has_body) {
+      // No route takes a body; the connection cannot be resynchronised without reading it
+      AppendResponse(connection.output, {400, "text/plain; charset=utf-8", "Bad Request\n"},
+                     false, true);
+      connection.close_after_output = true;
+      return true;
+    }
+    if (request.method != "GET" && !head_only) {
+      AppendResponse(connection.output,
+                     {405, "text/plain; charset=utf-8", "Method Not Allowed\n"}, false, close);
+    } else {
+      AppendResponse(connection.output, Dispatch(request), head_only, close);
+    }
+    if (close) {
+      connection.close_after_output = true;
+      return true;
+    }
+  }
+}
+
+void HttpServer::Loop() {
+  const SocketHandle listener = ToSocket(listener_);
+  std::vector<std::unique_ptr<Connection>> connections;
+  std::vector<PollDescriptor> descriptors;
+  char buffer[4096];
+
+  while (!stopping_.load(std::memory_order_relaxed)) {
+    descriptors.clear();
+    descriptors.push_back({listener, POLLIN, 0});
+    for (const std::unique_ptr<Connection>& connection : connections) {
+      const bool writing = connection->output_sent < connection->output.size();
+      descriptors.push_back(
+          {connection->socket, static_cast<short>(writing ? POLLOUT : POLLIN), 0});
+    }
+    if (PollSockets(descriptors, POLL_INTERVAL_MS) < 0 && !WouldBlock()) {
+      spdlog::error("HTTP endpoint poll failed; stopping");
+      break;
+    }
+    const auto now = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < connections.size(); ++i) {
+      Connection& connection = *connections[i];
+      const short events = descriptors[i + 1].revents;
+      bool open = true;
+      if ((events & (POLLERR | POLLHUP | POLLNVAL)) != 0 && (events & POLLIN) == 0) {
+        open = false;
+      } else if ((events & POLLIN) != 0) {
+        const auto received = ::recv(connection.socket, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+          connection.input.append(buffer, static_cast<size_t>(received));
+          connection.last_activity = now;
+          if (!connection.close_after_output) {
+            open = Serve(connection);
+          }
+        } else if (received == 0 || !WouldBlock()) {
+          open = false;
+        }
+      }
+      if (open && connection.output_sent < connection.output.size()) {
+#ifdef MSG_NOSIGNAL
+        constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+        constexpr int SEND_FLAGS = 0;
+#endif
+        const auto sent =
+            ::send(connection.socket, connection.output.data() + connection.output_sent,
+                   static_cast<int>(connection.output.size() - connection.output_sent),
+                   SEND_FLAGS);
+        if (sent > 0) {
+          connection.output_sent += static_cast<size_t>(sent);
+          connection.last_activity = now;
+          if (connection.output_sent == connection.output.size()) {
+            connection.output.clear();
+            connection.output_sent = 0;
+          }
+        } else if (!WouldBlock()) {
+          open = false;
+        }
+      }
+      const bool drained = connection.output.empty();
+      if (!open || (drained && connection.close_after_output) ||
+          now - connection.last_activity > config_.idle_timeout) {
+        CloseSocket(connection.socket);
+        connection.socket = NO_SOCKET;
+      }
+    }
+    std::erase_if(connections, [](const std::unique_ptr<Connection>& connection) {
+      return connection->socket == NO_SOCKET;
+    });
+
+    if ((descriptors[0].revents & POLLIN) == 0) {
+      continue;
+    }
+    for (;;) {
+      const SocketHandle accepted = ::accept(listener, nullptr, nullptr);
+      if (accepted == NO_SOCKET) {
+        break;
+      }
+      connections_.fetch_add(1, std::memory_order_relaxed);
+      if (connections.size() >= config_.max_connections || !SetNonBlocking(accepted)) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        CloseSocket(accepted);
+        continue;
+      }
+#ifdef SO_NOSIGPIPE
+      const int no_sigpipe = 1;
+      ::setsockopt(accepted, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+      auto connection = std::make_unique<Connection>();
+      connection->socket = accepted;
+      connection->last_activity = now;
+      connections.push_back(std::move(connection));
+    }
+  }
+
+  for (const std::unique_ptr<Connection>& connection : connections) {
+    CloseSocket(connection->socket);
+  }
+  CloseSocket(listener);
+  listener_ = -1;
+}
+
+}  // namespace Network
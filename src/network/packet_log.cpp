@@ -0,0 +1,434 @@
+#include "network/packet_log.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#include "platform.h"
+
+#ifndef PLATFORM_WINDOWS
+#include <fcntl.h>
+#endif
+
+#if defined(_M_X64)
+#include <intrin.h>
+#elif defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#ifndef MINECRAFT_VERSION
+#define MINECRAFT_VERSION 0
+#endif
+
+namespace Network {
+
+namespace {
+
+// Segment::state packs the next free offset with the number of writers inside the
+// mapping, so a single fetch_add both reserves space and pins the mapping
+constexpr uint64_t WRITER_BITS = 24;
+constexpr uint64_t WRITER_MASK = (uint64_t{1} << WRITER_BITS) - 1;
+constexpr uint64_t CLOSED_BIT = uint64_t{1} << 63;
+constexpr uint64_t MAX_FILE_BYTES = uint64_t{1} << 38;
+constexpr uint64_t MIN_FILE_BYTES = uint64_t{1} << 20;
+
+/** @brief Initial measurement of the cycle counter rate; refined with every file */
+constexpr std::chrono::milliseconds CALIBRATION_TIME{20};
+
+/** @brief Distance between the bytes touched to pre-fault a file; the smallest page size */
+constexpr uint64_t PREFAULT_STRIDE = 4096;
+
+uint64_t NowNanoseconds() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count());
+}
+
+/**
+ * @brief The CPU's invariant cycle counter, or steady_clock where there is none
+ *
+ * A clock_gettime() per packet would be over half the cost of a record.
+ * Records convert ticks to Unix time with their file's anchor and rate.
+ */
+uint64_t ReadTicks() {
+#if defined(_M_X64) || defined(__x86_64__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t ticks;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+#endif
+}
+
+/** @brief Unix time and the cycle counter read as close together as possible */
+std::pair<uint64_t, uint64_t> ReadClockPair() {
+  const uint64_t before = ReadTicks();
+  const uint64_t nanoseconds = NowNanoseconds();
+  const uint64_t after = ReadTicks();
+  return {nanoseconds, before + (after - before) / 2};
+}
+
+/** @brief Per-thread xorshift64* draw for 1-in-N sampling */
+uint64_t NextRandom() {
+  thread_local uint64_t state = reinterpret_cast<uintptr_t>(&state) | 1;
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  return state * 0x2545F4914F6CDD1Dull;
+}
+
+}  // namespace
+
+struct PacketLog::Segment {
+  std::filesystem::path path;
+  uint8_t* base = nullptr;
+  uint64_t size = 0;  ///< Fixed at construction, so writers may read it without a mapping
+  uint64_t anchor_ns = 0;     ///< Unix time at anchor_ticks
+  uint64_t anchor_ticks = 0;  ///< Cycle counter when the file was prepared
+  double ns_per_tick = 1.0;
+#ifdef PLATFORM_WINDOWS
+  HANDLE file = INVALID_HANDLE_VALUE;
+  HANDLE mapping = nullptr;
+#else
+  int fd = -1;
+#endif
+  alignas(64) std::atomic<uint64_t> state{CLOSED_BIT};
+};
+
+PacketLog::PacketLog(PacketLogConfig config)
+    : config_(std::move(config)), default_rule_(PackRule(config_.default_rule)) {
+  if (config_.file_count < 3) {
+    throw std::invalid_argument("packet log needs at least three files");
+  }
+  if (config_.file_bytes < MIN_FILE_BYTES || config_.file_bytes > MAX_FILE_BYTES) {
+    throw std::invalid_argument("packet log file size must be between 1 MiB and 256 GiB");
+  }
+  for (auto& direction : rules_) {
+    for (std::atomic<uint32_t>& rule : direction) {
+      rule.store(PackRule(config_.default_rule), std::memory_order_relaxed);
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::create_directories(config_.directory, error);
+  if (error) {
+    throw std::runtime_error("cannot create packet log directory " + config_.directory.string() +
+                             ": " + error.message());
+  }
+  for (size_t i = 0; i < config_.file_count; ++i) {
+    auto segment = std::make_unique<Segment>();
+    segment->path = config_.directory / ("packets-" + std::to_string(i) + ".pslog");
+    segment->size = config_.file_bytes;
+    segments_.push_back(std::move(segment));
+  }
+  std::tie(calibration_ns_, calibration_ticks_) = ReadClockPair();
+  std::this_thread::sleep_for(CALIBRATION_TIME);
+  if (!Open(*segments_.front(), 0)) {
+    throw std::runtime_error("cannot create packet log file " +
+                             segments_.front()->path.string());
+  }
+  current_.store(segments_.front().get(), std::memory_order_release);
+  preparer_ = std::thread([this] { PrepareLoop(); });
+}
+
+PacketLog::~PacketLog() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  prepare_wake_.notify_one();
+  spare_ready_.notify_all();
+  preparer_.join();
+
+  Segment* current = current_.exchange(nullptr, std::memory_order_acq_rel);
+  for (Segment* segment : retiring_) {
+    Close(*segment);
+  }
+  for (Segment* segment : {current, spare_}) {
+    if (segment != nullptr) {
+      segment->state.fetch_or(CLOSED_BIT, std::memory_order_acq_rel);
+      Close(*segment);
+    }
+  }
+}
+
+void PacketLog::SetRule(PacketDirection direction, int32_t packet_id, PacketLogRule rule) {
+  if (packet_id < 0 || packet_id >= PACKET_LOG_RULE_IDS) {
+    throw std::invalid_argument("packet id " + std::to_string(packet_id) +
+                                " has no rule of its own; use SetDefaultRule()");
+  }
+  rules_[static_cast<size_t>(direction)][static_cast<size_t>(packet_id)].store(
+      PackRule(rule), std::memory_order_relaxed);
+}
+
+void PacketLog::SetDefaultRule(PacketLogRule rule) {
+  const uint32_t previous = default_rule_.exchange(PackRule(rule), std::memory_order_relaxed);
+  // Types still on the old default follow the new one
+  for (auto& direction : rules_) {
+    for (std::atomic<uint32_t>& entry : direction) {
+      uint32_t expected = previous;
+      entry.compare_exchange_strong(expected, PackRule(rule), std::memory_order_relaxed);
+    }
+  }
+}
+
+uint32_t PacketLog::PackRule(PacketLogRule rule) {
+  return static_cast<uint32_t>(rule.sample_one_in) << 16 | rule.payload_bytes;
+}
+
+bool PacketLog::Record(uint32_t connection, PacketDirection direction, ConnectionState state,
+                       int32_t packet_id, std::span<const uint8_t> packet) {
+  const uint32_t rule =
+      packet_id >= 0 && packet_id < PACKET_LOG_RULE_IDS
+          ? rules_[static_cast<size_t>(direction)][static_cast<size_t>(packet_id)].load(
+                std::memory_order_relaxed)
+          : default_rule_.load(std::memory_order_relaxed);
+  const uint32_t sample_one_in = rule >> 16;
+  if (sample_one_in == 0 || (sample_one_in > 1 && NextRandom() % sample_one_in != 0)) {
+    return false;
+  }
+
+  const size_t payload = std::min<size_t>(rule & 0xFFFF, packet.size());
+  const uint64_t bytes =
+      (sizeof(PacketLogRecord) + payload + PACKET_LOG_ALIGNMENT - 1) & ~(PACKET_LOG_ALIGNMENT - 1);
+  const uint64_t ticks = ReadTicks();
+  PacketLogRecord record;
+  record.connection = connection;
+  record.packet_id = packet_id;
+  record.length = static_cast<uint32_t>(packet.size());
+  record.payload_bytes = static_cast<uint16_t>(payload);
+  record.direction = static_cast<uint8_t>(direction);
+  record.state = static_cast<uint8_t>(state);
+
+  for (;;) {
+    Segment* segment = current_.load(std::memory_order_acquire);
+    if (segment == nullptr) {
+      return false;
+    }
+    const uint64_t previous =
+        segment->state.fetch_add((bytes << WRITER_BITS) | 1, std::memory_order_acq_rel);
+    const uint64_t offset = (previous & ~CLOSED_BIT) >> WRITER_BITS;
+    if ((previous & CLOSED_BIT) == 0 && offset + bytes <= segment->size) {
+      const auto since_anchor = static_cast<int64_t>(ticks - segment->anchor_ticks);
+      record.timestamp_ns = segment->anchor_ns + static_cast<int64_t>(
+                                                     static_cast<double>(since_anchor) *
+                                                     segment->ns_per_tick);
+      uint8_t* destination = segment->base + offset;
+      if (payload != 0) {
+        std::memcpy(destination + sizeof(PacketLogRecord), packet.data(), payload);
+      }
+      // The timestamp ends the record list while zero, so it goes in last
+      std::memcpy(destination + sizeof(record.timestamp_ns),
+                  reinterpret_cast<const uint8_t*>(&record) + sizeof(record.timestamp_ns),
+                  sizeof(PacketLogRecord) - sizeof(record.timestamp_ns));
+      std::atomic_ref<uint64_t>(*reinterpret_cast<uint64_t*>(destination))
+          .store(record.timestamp_ns, std::memory_order_release);
+      segment->state.fetch_sub(1, std::memory_order_release);
+      return true;
+    }
+    segment->state.fetch_sub(1, std::memory_order_release);
+    Rotate(segment);
+  }
+}
+
+void PacketLog::Rotate(Segment* full) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (current_.load(std::memory_order_acquire) != full) {
+    return;
+  }
+  // Writers that reserve from now on see the closed bit and come back here
+  full->state.fetch_or(CLOSED_BIT, std::memory_order_acq_rel);
+  spare_ready_.wait(lock, [&] {
+    return spare_ != nullptr || failed_.load(std::memory_order_relaxed) || stopping_;
+  });
+  if (current_.load(std::memory_order_acquire) != full) {
+    return;
+  }
+
+  current_.store(spare_, std::memory_order_release);
+  if (spare_ != nullptr) {
+    rotations_.fetch_add(1, std::memory_order_relaxed);
+  }
+  spare_ = nullptr;
+  retiring_.push_back(full);
+  prepare_wake_.notify_one();
+}
+
+void PacketLog::PrepareLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    prepare_wake_.wait(lock, [&] {
+      return stopping_ || !retiring_.empty() ||
+             (spare_ == nullptr && !failed_.load(std::memory_order_relaxed));
+    });
+    if (stopping_) {
+      return;
+    }
+    std::vector<Segment*> retiring = std::move(retiring_);
+    retiring_.clear();
+    Segment* target = nullptr;
+    uint64_t sequence = 0;
+    if (spare_ == nullptr && !failed_.load(std::memory_order_relaxed)) {
+      target = segments_[next_index_].get();
+      next_index_ = (next_index_ + 1) % segments_.size();
+      sequence = sequence_++;
+    }
+    lock.unlock();
+
+    // Retire first: with three files the file to prepare is the one retired a rotation ago
+    for (Segment* segment : retiring) {
+      Close(*segment);
+    }
+    const bool opened = target != nullptr && Open(*target, sequence);
+
+    lock.lock();
+    if (target != nullptr) {
+      if (opened) {
+        spare_ = target;
+      } else {
+        failed_.store(true, std::memory_order_relaxed);
+        spdlog::error("Packet log stopped: cannot create {}", target->path.string());
+      }
+      spare_ready_.notify_all();
+    }
+  }
+}
+
+bool PacketLog::Open(Segment& segment, uint64_t sequence) {
+  const uint64_t size = segment.size;
+#ifdef PLATFORM_WINDOWS
+  segment.file = ::CreateFileW(segment.path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                               nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (segment.file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  segment.mapping = ::CreateFileMappingW(segment.file, nullptr, PAGE_READWRITE,
+                                         static_cast<DWORD>(size >> 32),
+                                         static_cast<DWORD>(size & 0xFFFFFFFF), nullptr);
+  void* base =
+      segment.mapping != nullptr
+          ? ::MapViewOfFile(segment.mapping, FILE_MAP_WRITE, 0, 0, static_cast<SIZE_T>(size))
+          : nullptr;
+  if (base == nullptr) {
+    if (segment.mapping != nullptr) {
+      ::CloseHandle(segment.mapping);
+      segment.mapping = nullptr;
+    }
+    ::CloseHandle(segment.file);
+    segment.file = INVALID_HANDLE_VALUE;
+    return false;
+  }
+#else
+  // Truncating first leaves an all-zero file: unwritten records read as the end
+  segment.fd = ::open(segment.path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (segment.fd < 0) {
+    return false;
+  }
+  void* base = ::ftruncate(segment.fd, static_cast<off_t>(size)) == 0
+                   ? ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, segment.fd, 0)
+                   : MAP_FAILED;
+  if (base == MAP_FAILED) {
+    ::close(segment.fd);
+    segment.fd = -1;
+    return false;
+  }
+#endif
+  segment.base = static_cast<uint8_t*>(base);
+  Calibrate(segment);
+  // Fault every page in now rather than one fault per 170 records on the logging threads
+  for (uint64_t offset = 0; offset < size; offset += PREFAULT_STRIDE) {
+    reinterpret_cast<volatile uint8_t*>(segment.base)[offset] = 0;
+  }
+
+  PacketLogFileHeader header{};
+  header.magic = PACKET_LOG_MAGIC;
+  header.version = PACKET_LOG_VERSION;
+  header.header_bytes = sizeof(PacketLogFileHeader);
+  header.sequence = sequence;
+  header.created_ns = segment.anchor_ns;
+  header.file_bytes = size;
+  header.minecraft_version = MINECRAFT_VERSION;
+  std::memcpy(segment.base, &header, sizeof(header));
+
+  // Keep the writer count of stragglers that still hold this segment from its last use
+  uint64_t state = segment.state.load(std::memory_order_relaxed);
+  while (!segment.state.compare_exchange_weak(
+      state, (uint64_t{sizeof(PacketLogFileHeader)} << WRITER_BITS) | (state & WRITER_MASK),
+      std::memory_order_acq_rel)) {
+  }
+  return true;
+}
+
+void PacketLog::Calibrate(Segment& segment) {
+  std::tie(segment.anchor_ns, segment.anchor_ticks) = ReadClockPair();
+  // Measured over the whole life of the log, so every file gets a more precise rate
+  const uint64_t elapsed_ticks = segment.anchor_ticks - calibration_ticks_;
+  const uint64_t elapsed_ns = segment.anchor_ns - calibration_ns_;
+  segment.ns_per_tick = elapsed_ticks == 0 ? 1.0
+                                           : static_cast<double>(elapsed_ns) /
+                                                 static_cast<double>(elapsed_ticks);
+}
+
+void PacketLog::Close(Segment& segment) {
+  if (segment.base == nullptr) {
+    return;
+  }
+  while ((segment.state.load(std::memory_order_acquire) & WRITER_MASK) != 0) {
+    std::this_thread::yield();
+  }
+  const uint64_t end = (segment.state.load(std::memory_order_acquire) & ~CLOSED_BIT) >> WRITER_BITS;
+  closed_bytes_.fetch_add(std::min(end, segment.size) - sizeof(PacketLogFileHeader),
+                          std::memory_order_relaxed);
+#ifdef PLATFORM_WINDOWS
+  ::UnmapViewOfFile(segment.base);
+  ::CloseHandle(segment.mapping);
+  ::CloseHandle(segment.file);
+  segment.mapping = nullptr;
+  segment.file = INVALID_HANDLE_VALUE;
+#else
+  ::munmap(segment.base, segment.size);
+  ::close(segment.fd);
+  segment.fd = -1;
+#endif
+  segment.base = nullptr;
+}
+
+void PacketLog::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Segment* segment = current_.load(std::memory_order_acquire);
+  if (segment == nullptr) {
+    return;
+  }
+#ifdef PLATFORM_WINDOWS
+  ::FlushViewOfFile(segment->base, 0);
+#else
+  ::msync(segment->base, segment->size, MS_ASYNC);
+#endif
+}
+
+PacketLogStats PacketLog::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  PacketLogStats stats;
+  stats.bytes = closed_bytes_.load(std::memory_order_relaxed);
+  if (const Segment* segment = current_.load(std::memory_order_acquire)) {
+    const uint64_t end =
+        (segment->state.load(std::memory_order_relaxed) & ~CLOSED_BIT) >> WRITER_BITS;
+    stats.bytes += std::min(end, segment->size) - sizeof(PacketLogFileHeader);
+  }
+  stats.rotations = rotations_.load(std::memory_order_relaxed);
+  stats.failed = failed_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace Network
@@ -0,0 +1,200 @@
+#include "network/packet_pool.h"
+
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "util/memory_accounting.h"
+
+namespace Network {
+
+namespace {
+
+/** @brief Index of the smallest class holding @p size, or the class count when none does */
+size_t ClassFor(size_t size) {
+  auto it = std::lower_bound(PACKET_POOL_CLASSES.begin(), PACKET_POOL_CLASSES.end(), size);
+  return static_cast<size_t>(it - PACKET_POOL_CLASSES.begin());
+}
+
+/** @brief Index of the largest class a buffer of @p capacity satisfies, or the class count */
+size_t ClassOfCapacity(size_t capacity) {
+  auto it = std::upper_bound(PACKET_POOL_CLASSES.begin(), PACKET_POOL_CLASSES.end(), capacity);
+  if (it == PACKET_POOL_CLASSES.begin()) {
+    return PACKET_POOL_CLASSES.size();
+  }
+  return static_cast<size_t>(it - PACKET_POOL_CLASSES.begin()) - 1;
+}
+
+}  // namespace
+
+struct PacketPool::State {
+  PacketPoolConfig config;
+
+  mutable std::mutex mutex;
+  std::array<std::vector<std::vector<uint8_t>>, PACKET_POOL_CLASSES.size()> buffers;
+  std::vector<EncodedPacket*> packets;
+  std::vector<void*> blocks;  ///< shared_ptr control blocks, all of block_size bytes
+  size_t block_size = 0;
+  PacketPoolStats stats;
+
+  ~State() {
+    for (EncodedPacket* packet : packets) {
+      delete packet;
+    }
+    for (void* block : blocks) {
+      ::operator delete(block);
+    }
+    for (const auto& size_class : buffers) {
+      for (const std::vector<uint8_t>& bytes : size_class) {
+        Util::TrackRelease(Util::MemorySubsystem::NETWORK, bytes.capacity());
+      }
+    }
+  }
+
+  void Recycle(EncodedPacket* packet) {
+    std::vector<uint8_t> bytes = std::move(packet->bytes);
+    size_t size_class = ClassOfCapacity(bytes.capacity());
+    const bool over_budget = Util::OverMemoryBudget(Util::MemorySubsystem::NETWORK);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++stats.recycled;
+      if (packets.size() < config.max_packets) {
+        packets.push_back(packet);
+        packet = nullptr;
+      }
+      if (!over_budget && bytes.capacity() <= PACKET_POOL_CLASSES.back() &&
+          size_class < PACKET_POOL_CLASSES.size() &&
+          buffers[size_class].size() < config.max_buffers_per_class) {
+        // Stays accounted while idle in the pool
+        buffers[size_class].push_back(std::move(bytes));
+      } else {
+        ++stats.discarded;
+      }
+    }
+    Util::TrackRelease(Util::MemorySubsystem::NETWORK, bytes.capacity());
+    // Freed outside the lock
+    delete packet;
+  }
+
+  void* AllocateBlock(size_t size) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (block_size == 0) {
+        block_size = size;
+      }
+      if (size == block_size && !blocks.empty()) {
+        void* block = blocks.back();
+        blocks.pop_back();
+        return block;
+      }
+    }
+    return ::operator new(size);
+  }
+
+  void FreeBlock(void* block, size_t size) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (size == block_size && blocks.size() < config.max_packets) {
+        blocks.push_back(block);
+        return;
+      }
+    }
+    ::operator delete(block);
+  }
+};
+
+/**
+ * @brief Allocator for shared_ptr control blocks
+ *
+ * Holds a reference to the pool state: the control block is destroyed
+ * (dropping the deleter's reference) before it is deallocated.
+ */
+template <typename T>
+struct PacketPool::BlockAllocator {
+  using value_type = T;
+
+  explicit BlockAllocator(std::shared_ptr<State> pool_state)
+      : state(std::move(pool_state)) {}
+  template <typename U>
+  BlockAllocator(const BlockAllocator<U>& other) : state(other.state) {}
+
+  T* allocate(size_t count) { return static_cast<T*>(state->AllocateBlock(count * sizeof(T))); }
+  void deallocate(T* block, size_t count) { state->FreeBlock(block, count * sizeof(T)); }
+
+  template <typename U>
+  bool operator==(const BlockAllocator<U>& other) const {
+    return state == other.state;
+  }
+
+  std::shared_ptr<State> state;
+};
+
+/** @brief shared_ptr deleter returning the packet to its pool */
+struct PacketPool::Recycler {
+  std::shared_ptr<State> state;
+
+  void operator()(const EncodedPacket* packet) const {
+    state->Recycle(const_cast<EncodedPacket*>(packet));
+  }
+};
+
+PacketPool::PacketPool(PacketPoolConfig config) : state_(std::make_shared<State>()) {
+  state_->config = config;
+}
+
+PacketBuffer PacketPool::Acquire(int32_t packet_id, size_t size_hint) {
+  std::vector<uint8_t> storage;
+  size_t size_class = ClassFor(size_hint);
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    ++state_->stats.acquired;
+    // A buffer one class up is still a better deal than a fresh allocation
+    for (size_t c = size_class; c < std::min(size_class + 2, PACKET_POOL_CLASSES.size()); ++c) {
+      if (!state_->buffers[c].empty()) {
+        storage = std::move(state_->buffers[c].back());
+        state_->buffers[c].pop_back();
+        // Accounted again by Finish(), at the capacity it grew to
+        Util::TrackRelease(Util::MemorySubsystem::NETWORK, storage.capacity());
+        ++state_->stats.buffers_reused;
+        break;
+      }
+    }
+    if (storage.capacity() == 0) {
+      ++state_->stats.buffers_allocated;
+    }
+  }
+  if (storage.capacity() == 0) {
+    storage.reserve(size_class < PACKET_POOL_CLASSES.size() ? PACKET_POOL_CLASSES[size_class]
+                                                            : size_hint);
+  }
+  return PacketBuffer(packet_id, std::move(storage));
+}
+
+SharedPacket PacketPool::Finish(PacketBuffer& buffer) {
+  EncodedPacket* packet = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (!state_->packets.empty()) {
+      packet = state_->packets.back();
+      state_->packets.pop_back();
+      ++state_->stats.packets_reused;
+    }
+  }
+  if (packet == nullptr) {
+    packet = new EncodedPacket();
+  }
+  packet->packet_id = buffer.PacketId();
+  packet->bytes = buffer.TakeBytes();
+  Util::TrackAllocation(Util::MemorySubsystem::NETWORK, packet->bytes.capacity());
+  return SharedPacket(static_cast<const EncodedPacket*>(packet), Recycler{state_},
+                      BlockAllocator<EncodedPacket>(state_));
+}
+
+PacketPoolStats PacketPool::GetStats() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->stats;
+}
+
+}  // namespace Network
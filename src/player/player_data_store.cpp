@@ -0,0 +1,378 @@
+#include "player/player_data_store.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "network/packet_buffer.h"
+#include "platform.h"
+#include "util/hash.h"
+
+namespace Player {
+
+namespace {
+
+constexpr uint32_t MAGIC = 0x50535044;  // "PSPD"
+constexpr uint16_t FORMAT_VERSION = 1;
+
+/** @brief Upper bounds for counts and byte lengths, guard against corrupt files */
+constexpr int32_t MAX_ELEMENTS = 1 << 16;
+constexpr int32_t MAX_BYTES = 1 << 21;
+
+/** @brief Bounds-checked big-endian reader for the file format */
+class ByteReader {
+ public:
+  explicit ByteReader(std::span<const uint8_t> bytes) : bytes_(bytes) {}
+
+  bool Ok() const { return ok_; }
+  bool AtEnd() const { return position_ == bytes_.size(); }
+
+  template <typename T>
+  T ReadBigEndian() {
+    if (!Require(sizeof(T))) {
+      return T{};
+    }
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      value = static_cast<T>((value << 8) | bytes_[position_++]);
+    }
+    return value;
+  }
+
+  int32_t ReadVarInt() {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      if (!Require(1)) {
+        return 0;
+      }
+      const uint8_t byte = bytes_[position_++];
+      value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return static_cast<int32_t>(value);
+      }
+    }
+    ok_ = false;
+    return 0;
+  }
+
+  int32_t ReadCount(int32_t limit = MAX_ELEMENTS) {
+    const int32_t count = ReadVarInt();
+    if (count < 0 || count > limit) {
+      ok_ = false;
+      return 0;
+    }
+    return count;
+  }
+
+  float ReadFloat() {
+    const auto bits = ReadBigEndian<uint32_t>();
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  double ReadDouble() {
+    const auto bits = ReadBigEndian<uint64_t>();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  std::vector<uint8_t> ReadBytes(size_t length) {
+    if (!Require(length)) {
+      return {};
+    }
+    std::vector<uint8_t> out(bytes_.begin() + position_, bytes_.begin() + position_ + length);
+    position_ += length;
+    return out;
+  }
+
+  std::string ReadString() {
+    const auto bytes = ReadBytes(static_cast<size_t>(ReadCount(MAX_BYTES)));
+    return {bytes.begin(), bytes.end()};
+  }
+
+ private:
+  bool Require(size_t length) {
+    if (!ok_ || bytes_.size() - position_ < length) {
+      ok_ = false;
+    }
+    return ok_;
+  }
+
+  std::span<const uint8_t> bytes_;
+  size_t position_ = 0;
+  bool ok_ = true;
+};
+
+}  // namespace
+
+PlayerDataStore::PlayerDataStore(std::filesystem::path directory, Util::WorkerPool& io)
+    : directory_(std::move(directory)), io_(io) {
+  std::error_code error;
+  std::filesystem::create_directories(directory_, error);
+}
+
+std::filesystem::path PlayerDataStore::PathOf(const Util::Uuid& uuid) const {
+  return directory_ / (uuid.ToString() + ".dat");
+}
+
+std::shared_future<LoadResult> PlayerDataStore::Prefetch(const Util::Uuid& uuid) {
+  std::lock_guard lock(mutex_);
+  if (auto it = loads_.find(uuid); it != loads_.end()) {
+    return it->second;
+  }
+
+  auto promise = std::make_shared<std::promise<LoadResult>>();
+  std::shared_future<LoadResult> future = promise->get_future().share();
+  loads_.emplace(uuid, future);
+  ++stats_.loads;
+
+  // A snapshot that has not reached disk yet is newer than the file.
+  if (auto it = saves_.find(uuid); it != saves_.end()) {
+    const PendingSave& pending = it->second;
+    ++stats_.loads_from_pending_save;
+    promise->set_value({LoadStatus::LOADED, pending.queued ? *pending.queued : *pending.writing, 0});
+    return future;
+  }
+
+  const auto started = std::chrono::steady_clock::now();
+  io_.Post([this, uuid, promise, started] {
+    LoadResult result = LoadFromDisk(uuid);
+    result.load_micros = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                              started)
+            .count());
+    if (result.status == LoadStatus::CORRUPT || result.status == LoadStatus::IO_ERROR) {
+      std::lock_guard lock(mutex_);
+      ++stats_.load_failures;
+    }
+    promise->set_value(std::move(result));
+  });
+  return future;
+}
+
+void PlayerDataStore::Release(const Util::Uuid& uuid) {
+  std::lock_guard lock(mutex_);
+  loads_.erase(uuid);
+}
+
+LoadResult PlayerDataStore::LoadFromDisk(const Util::Uuid& uuid) const {
+  LoadResult result;
+  result.data.uuid = uuid;
+
+  const std::filesystem::path path = PathOf(uuid);
+  std::error_code error;
+  if (!std::filesystem::exists(path, error)) {
+    result.status = error ? LoadStatus::IO_ERROR : LoadStatus::NEW_PLAYER;
+    return result;
+  }
+
+  std::ifstream file(path, std::ios::binary);
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)),
+                             std::istreambuf_iterator<char>());
+  if (!file && !file.eof()) {
+    result.status = LoadStatus::IO_ERROR;
+    return result;
+  }
+
+  std::optional<PlayerData> data = Deserialize(bytes);
+  if (!data || data->uuid != uuid) {
+    result.status = LoadStatus::CORRUPT;
+    return result;
+  }
+  result.status = LoadStatus::LOADED;
+  result.data = std::move(*data);
+  return result;
+}
+
+void PlayerDataStore::Save(PlayerData snapshot) {
+  const Util::Uuid uuid = snapshot.uuid;
+  std::lock_guard lock(mutex_);
+  ++stats_.saves_requested;
+  // A cached prefetch result is older than this snapshot.
+  loads_.erase(uuid);
+
+  PendingSave& pending = saves_[uuid];
+  if (pending.queued) {
+    ++stats_.saves_coalesced;
+  }
+  pending.queued = std::move(snapshot);
+  if (!pending.writing) {
+    pending.writing = std::move(pending.queued);
+    pending.queued.reset();
+    io_.Post([this, uuid] { WriteLoop(uuid); });
+  }
+}
+
+void PlayerDataStore::WriteLoop(Util::Uuid uuid) {
+  for (;;) {
+    const PlayerData* data;
+    {
+      // Nodes of saves_ are stable and `writing` is only replaced below.
+      std::lock_guard lock(mutex_);
+      data = &*saves_.find(uuid)->second.writing;
+    }
+    const size_t written = WriteFile(*data);
+
+    std::lock_guard lock(mutex_);
+    if (written != 0) {
+      ++stats_.saves_written;
+      stats_.bytes_written += written;
+    } else {
+      ++stats_.save_failures;
+    }
+    auto it = saves_.find(uuid);
+    if (it->second.queued) {
+      it->second.writing = std::move(it->second.queued);
+      it->second.queued.reset();
+      continue;
+    }
+    saves_.erase(it);
+    if (saves_.empty()) {
+      saves_done_.notify_all();
+    }
+    return;
+  }
+}
+
+size_t PlayerDataStore::WriteFile(const PlayerData& data) const {
+  const std::vector<uint8_t> bytes = Serialize(data);
+  const std::filesystem::path path = PathOf(data.uuid);
+  std::filesystem::path temporary = path;
+  temporary += ".tmp";
+
+  // The data must be durable before the rename, or a power loss can leave the rename
+  // without it: an empty or partial "<uuid>.dat" in place of the old one.
+  if (!Platform::WriteFileSynced(temporary, bytes.data(), bytes.size())) {
+    return 0;
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary, path, error);
+  if (error || !Platform::SyncDirectory(path.parent_path())) {
+    return 0;
+  }
+  return bytes.size();
+}
+
+void PlayerDataStore::Flush() {
+  std::unique_lock lock(mutex_);
+  saves_done_.wait(lock, [this] { return saves_.empty(); });
+}
+
+PlayerDataStats PlayerDataStore::GetStats() const {
+  std::lock_guard lock(mutex_);
+  return stats_;
+}
+
+std::vector<uint8_t> PlayerDataStore::Serialize(const PlayerData& data) {
+  Network::PacketBuffer buffer;
+  buffer.Reserve(128 + data.inventory.size() * 16 + data.statistics.size() * 6);
+  buffer.WriteInt(static_cast<int32_t>(MAGIC));
+  buffer.WriteShort(static_cast<int16_t>(FORMAT_VERSION));
+  buffer.WriteUuid(data.uuid);
+  buffer.WriteString(data.dimension);
+  buffer.WriteDouble(data.x);
+  buffer.WriteDouble(data.y);
+  buffer.WriteDouble(data.z);
+  buffer.WriteFloat(data.yaw);
+  buffer.WriteFloat(data.pitch);
+  buffer.WriteFloat(data.health);
+  buffer.WriteVarInt(data.food);
+  buffer.WriteFloat(data.saturation);
+  buffer.WriteVarInt(data.experience_level);
+  buffer.WriteVarInt(data.experience_total);
+  buffer.WriteVarInt(data.game_mode);
+  buffer.WriteVarInt(data.selected_slot);
+
+  buffer.WriteVarInt(static_cast<int32_t>(data.inventory.size()));
+  for (const InventoryEntry& entry : data.inventory) {
+    buffer.WriteVarInt(entry.slot);
+    buffer.WriteVarInt(entry.stack.item_id);
+    buffer.WriteVarInt(entry.stack.count);
+    const auto& components = entry.stack.components;
+    buffer.WriteBool(components != nullptr);
+    if (components) {
+      buffer.WriteVarInt(components->AddedCount());
+      buffer.WriteVarInt(components->RemovedCount());
+      buffer.WriteVarInt(static_cast<int32_t>(components->Encoded().size()));
+      buffer.WriteBytes(components->Encoded());
+    }
+  }
+
+  buffer.WriteVarInt(static_cast<int32_t>(data.statistics.size()));
+  for (const auto& [statistic, value] : data.statistics) {
+    buffer.WriteVarInt(statistic);
+    buffer.WriteVarInt(value);
+  }
+
+  buffer.WriteLong(static_cast<int64_t>(Util::Fnv1a(buffer.Data())));
+  const auto bytes = buffer.Data();
+  return {bytes.begin(), bytes.end()};
+}
+
+std::optional<PlayerData> PlayerDataStore::Deserialize(std::span<const uint8_t> bytes) {
+  if (bytes.size() < 8) {
+    return std::nullopt;
+  }
+  const auto body = bytes.first(bytes.size() - 8);
+  ByteReader trailer(bytes.last(8));
+  if (trailer.ReadBigEndian<uint64_t>() != Util::Fnv1a(body)) {
+    return std::nullopt;
+  }
+
+  ByteReader reader(body);
+  if (reader.ReadBigEndian<uint32_t>() != MAGIC ||
+      reader.ReadBigEndian<uint16_t>() != FORMAT_VERSION) {
+    return std::nullopt;
+  }
+
+  PlayerData data;
+  data.uuid.most = reader.ReadBigEndian<uint64_t>();
+  data.uuid.least = reader.ReadBigEndian<uint64_t>();
+  data.dimension = reader.ReadString();
+  data.x = reader.ReadDouble();
+  data.y = reader.ReadDouble();
+  data.z = reader.ReadDouble();
+  data.yaw = reader.ReadFloat();
+  data.pitch = reader.ReadFloat();
+  data.health = reader.ReadFloat();
+  data.food = reader.ReadVarInt();
+  data.saturation = reader.ReadFloat();
+  data.experience_level = reader.ReadVarInt();
+  data.experience_total = reader.ReadVarInt();
+  data.game_mode = reader.ReadVarInt();
+  data.selected_slot = reader.ReadVarInt();
+
+  const int32_t slots = reader.ReadCount();
+  data.inventory.reserve(static_cast<size_t>(slots));
+  for (int32_t i = 0; i < slots && reader.Ok(); ++i) {
+    InventoryEntry& entry = data.inventory.emplace_back();
+    entry.slot = reader.ReadVarInt();
+    entry.stack.item_id = reader.ReadVarInt();
+    entry.stack.count = reader.ReadVarInt();
+    if (reader.ReadBigEndian<uint8_t>() != 0) {
+      const int32_t added = reader.ReadVarInt();
+      const int32_t removed = reader.ReadVarInt();
+      const int32_t length = reader.ReadCount(MAX_BYTES);
+      std::vector<uint8_t> encoded = reader.ReadBytes(static_cast<size_t>(length));
+      entry.stack.components =
+          std::make_shared<const Inventory::ItemComponentPatch>(added, removed, std::move(encoded));
+    }
+  }
+
+  const int32_t statistics = reader.ReadCount();
+  data.statistics.reserve(static_cast<size_t>(statistics));
+  for (int32_t i = 0; i < statistics && reader.Ok(); ++i) {
+    const int32_t statistic = reader.ReadVarInt();
+    data.statistics.emplace_back(statistic, reader.ReadVarInt());
+  }
+
+  if (!reader.Ok() || !reader.AtEnd()) {
+    return std::nullopt;
+  }
+  return data;
+}
+
+}  // namespace Player
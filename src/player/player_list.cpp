@@ -0,0 +1,233 @@
+#include "player/player_list.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "network/packet_buffer.h"
+#include "protocol/packet_ids.h"
+#include "protocol/text_component.h"
+
+namespace Player {
+
+namespace {
+
+std::vector<uint8_t> EncodeProfile(const PlayerListEntry& entry) {
+  Network::PacketBuffer buffer;
+  buffer.WriteString(entry.name);
+  buffer.WriteVarInt(static_cast<int32_t>(entry.properties.size()));
+  for (const ProfileProperty& property : entry.properties) {
+    buffer.WriteString(property.name);
+    buffer.WriteString(property.value);
+    buffer.WriteBool(property.signature.has_value());
+    if (property.signature) {
+      buffer.WriteString(*property.signature);
+    }
+  }
+  const auto data = buffer.Data();
+  return {data.begin(), data.end()};
+}
+
+}  // namespace
+
+void PlayerList::Add(PlayerListEntry entry) {
+  const Util::Uuid uuid = entry.uuid;
+  auto [it, inserted] = records_.try_emplace(uuid);
+  Record& record = it->second;
+  if (!inserted && !(record.pending & ADD_PLAYER)) {
+    // Clients ignore a second add for a known UUID, so replace it explicitly.
+    removed_.push_back(uuid);
+  }
+  record.profile = EncodeProfile(entry);
+  record.entry = std::move(entry);
+  MarkPending(record, ALL_PLAYER_INFO_ACTIONS);
+}
+
+bool PlayerList::Remove(const Util::Uuid& uuid) {
+  auto it = records_.find(uuid);
+  if (it == records_.end()) {
+    return false;
+  }
+  if (it->second.pending & ADD_PLAYER) {
+    ++stats_.cancelled_joins;
+  } else {
+    removed_.push_back(uuid);
+  }
+  records_.erase(it);
+  return true;
+}
+
+void PlayerList::MarkPending(Record& record, uint8_t actions) {
+  if (record.pending == 0) {
+    dirty_.push_back(record.entry.uuid);
+  }
+  record.pending |= actions;
+}
+
+template <typename Field, typename Value>
+void PlayerList::Update(const Util::Uuid& uuid, Field PlayerListEntry::*field, Value&& value,
+                        PlayerInfoAction action) {
+  auto it = records_.find(uuid);
+  if (it == records_.end() || it->second.entry.*field == value) {
+    return;
+  }
+  it->second.entry.*field = std::forward<Value>(value);
+  if (action & ALL_PLAYER_INFO_ACTIONS) {
+    MarkPending(it->second, action);
+  }
+}
+
+void PlayerList::SetChatSession(const Util::Uuid& uuid, std::optional<ChatSessionData> session) {
+  auto it = records_.find(uuid);
+  if (it == records_.end()) {
+    return;
+  }
+  it->second.entry.chat_session = std::move(session);
+  MarkPending(it->second, INITIALIZE_CHAT);
+}
+
+void PlayerList::SetGameMode(const Util::Uuid& uuid, int32_t game_mode) {
+  Update(uuid, &PlayerListEntry::game_mode, game_mode, UPDATE_GAME_MODE);
+}
+
+void PlayerList::SetListed(const Util::Uuid& uuid, bool listed) {
+  Update(uuid, &PlayerListEntry::listed, listed, UPDATE_LISTED);
+}
+
+void PlayerList::SetLatency(const Util::Uuid& uuid, int32_t latency) {
+  Update(uuid, &PlayerListEntry::latency, latency, UPDATE_LATENCY);
+}
+
+void PlayerList::SetDisplayName(const Util::Uuid& uuid, std::optional<std::string> display_name) {
+  Update(uuid, &PlayerListEntry::display_name, std::move(display_name), UPDATE_DISPLAY_NAME);
+}
+
+void PlayerList::SetListPriority(const Util::Uuid& uuid, int32_t list_priority) {
+  Update(uuid, &PlayerListEntry::list_priority, list_priority, UPDATE_LIST_PRIORITY);
+}
+
+void PlayerList::SetShowHat(const Util::Uuid& uuid, bool show_hat) {
+  Update(uuid, &PlayerListEntry::show_hat, show_hat, UPDATE_HAT);
+}
+
+const PlayerListEntry* PlayerList::Find(const Util::Uuid& uuid) const {
+  auto it = records_.find(uuid);
+  return it == records_.end() ? nullptr : &it->second.entry;
+}
+
+size_t PlayerList::Flush(const BroadcastFunction& broadcast) {
+  size_t packets = 0;
+
+  if (!removed_.empty()) {
+    Network::PacketBuffer buffer(Protocol::Play::Clientbound::PLAYER_INFO_REMOVE,
+                                 8 + removed_.size() * 16);
+    buffer.WriteVarInt(static_cast<int32_t>(removed_.size()));
+    for (const Util::Uuid& uuid : removed_) {
+      buffer.WriteUuid(uuid);
+    }
+    removed_.clear();
+    ++stats_.remove_packets;
+    stats_.bytes_encoded += buffer.Size();
+    broadcast(buffer.Finish());
+    ++packets;
+  }
+
+  // Collect pending entries, clearing their bits so duplicates left in
+  // dirty_ by a remove/re-add are skipped, then emit one packet per action set.
+  std::vector<std::pair<uint8_t, const Record*>> pending;
+  pending.reserve(dirty_.size());
+  for (const Util::Uuid& uuid : dirty_) {
+    auto it = records_.find(uuid);
+    if (it != records_.end() && it->second.pending != 0) {
+      pending.emplace_back(it->second.pending, &it->second);
+      it->second.pending = 0;
+    }
+  }
+  dirty_.clear();
+  std::stable_sort(pending.begin(), pending.end(),
+                   [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  std::vector<const Record*> group;
+  for (size_t begin = 0; begin < pending.size();) {
+    const uint8_t actions = pending[begin].first;
+    group.clear();
+    size_t end = begin;
+    for (; end < pending.size() && pending[end].first == actions; ++end) {
+      group.push_back(pending[end].second);
+    }
+    broadcast(EncodeUpdate(actions, group));
+    ++packets;
+    begin = end;
+  }
+  return packets;
+}
+
+Network::SharedPacket PlayerList::SnapshotPacket() {
+  if (records_.empty()) {
+    return nullptr;
+  }
+  std::vector<const Record*> all;
+  all.reserve(records_.size());
+  for (const auto& [uuid, record] : records_) {
+    all.push_back(&record);
+  }
+  return EncodeUpdate(ALL_PLAYER_INFO_ACTIONS, all);
+}
+
+Network::SharedPacket PlayerList::EncodeUpdate(uint8_t actions,
+                                               const std::vector<const Record*>& records) {
+  size_t estimate = 8;
+  for (const Record* record : records) {
+    estimate += 32 + ((actions & ADD_PLAYER) ? record->profile.size() : 0);
+  }
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::PLAYER_INFO_UPDATE, estimate);
+  buffer.WriteByte(actions);
+  buffer.WriteVarInt(static_cast<int32_t>(records.size()));
+
+  for (const Record* record : records) {
+    const PlayerListEntry& entry = record->entry;
+    buffer.WriteUuid(entry.uuid);
+    if (actions & ADD_PLAYER) {
+      buffer.WriteBytes(record->profile);
+    }
+    if (actions & INITIALIZE_CHAT) {
+      buffer.WriteBool(entry.chat_session.has_value());
+      if (entry.chat_session) {
+        const ChatSessionData& session = *entry.chat_session;
+        buffer.WriteUuid(session.session_id);
+        buffer.WriteLong(session.expires_at);
+        buffer.WriteVarInt(static_cast<int32_t>(session.public_key.size()));
+        buffer.WriteBytes(session.public_key);
+        buffer.WriteVarInt(static_cast<int32_t>(session.key_signature.size()));
+        buffer.WriteBytes(session.key_signature);
+      }
+    }
+    if (actions & UPDATE_GAME_MODE) {
+      buffer.WriteVarInt(entry.game_mode);
+    }
+    if (actions & UPDATE_LISTED) {
+      buffer.WriteBool(entry.listed);
+    }
+    if (actions & UPDATE_LATENCY) {
+      buffer.WriteVarInt(entry.latency);
+    }
+    if (actions & UPDATE_DISPLAY_NAME) {
+      buffer.WriteBool(entry.display_name.has_value());
+      if (entry.display_name) {
+        Protocol::WritePlainText(buffer, *entry.display_name);
+      }
+    }
+    if (actions & UPDATE_LIST_PRIORITY) {
+      buffer.WriteVarInt(entry.list_priority);
+    }
+    if (actions & UPDATE_HAT) {
+      buffer.WriteBool(entry.show_hat);
+    }
+  }
+
+  ++stats_.update_packets;
+  stats_.entries_sent += records.size();
+  stats_.bytes_encoded += buffer.Size();
+  return buffer.Finish();
+}
+
+}  // namespace Player
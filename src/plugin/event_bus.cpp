@@ -0,0 +1,26 @@
+#include "plugin/event_bus.h"
+
+#include <algorithm>
+
+namespace Plugin {
+
+void EventBus::Subscribe(EventType type, int32_t priority, ps_event_handler handler,
+                         void* user_data, PluginId owner) {
+  std::vector<Handler>& handlers = handlers_[static_cast<size_t>(type)];
+  auto position = std::upper_bound(
+      handlers.begin(), handlers.end(), priority,
+      [](int32_t value, const Handler& existing) { return value < existing.priority; });
+  handlers.insert(position, Handler{handler, user_data, priority, owner});
+}
+
+size_t EventBus::UnsubscribeAll(PluginId owner) {
+  size_t removed = 0;
+  for (std::vector<Handler>& handlers : handlers_) {
+    removed += std::erase_if(handlers, [owner](const Handler& handler) {
+      return handler.owner == owner;
+    });
+  }
+  return removed;
+}
+
+}  // namespace Plugin
@@ -0,0 +1,207 @@
+#include "plugin/plugin_manager.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+
+#include "platform.h"
+
+#ifndef PLATFORM_WINDOWS
+#include <dlfcn.h>
+#endif
+
+namespace Plugin {
+
+namespace {
+
+#ifdef PLATFORM_WINDOWS
+constexpr const char* LIBRARY_EXTENSION = ".dll";
+#elif defined(PLATFORM_MACOS)
+constexpr const char* LIBRARY_EXTENSION = ".dylib";
+#else
+constexpr const char* LIBRARY_EXTENSION = ".so";
+#endif
+
+void* OpenLibrary(const std::filesystem::path& path, std::string& error) {
+#ifdef PLATFORM_WINDOWS
+  HMODULE module = ::LoadLibraryW(path.c_str());
+  if (module == nullptr) {
+    error = std::system_category().message(static_cast<int>(::GetLastError()));
+  }
+  return reinterpret_cast<void*>(module);
+#else
+  void* library = ::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (library == nullptr) {
+    error = ::dlerror();
+  }
+  return library;
+#endif
+}
+
+void* FindSymbol(void* library, const char* name) {
+#ifdef PLATFORM_WINDOWS
+  return reinterpret_cast<void*>(::GetProcAddress(reinterpret_cast<HMODULE>(library), name));
+#else
+  return ::dlsym(library, name);
+#endif
+}
+
+void CloseLibrary(void* library) {
+#ifdef PLATFORM_WINDOWS
+  ::FreeLibrary(reinterpret_cast<HMODULE>(library));
+#else
+  ::dlclose(library);
+#endif
+}
+
+}  // namespace
+
+PluginManager::PluginManager(EventBus& bus) : bus_(bus) {}
+
+PluginManager::~PluginManager() { UnloadAll(); }
+
+PluginId PluginManager::Load(const std::filesystem::path& path) {
+  std::string error;
+  void* library = OpenLibrary(path, error);
+  if (library == nullptr) {
+    throw std::runtime_error("cannot open plugin " + path.string() + ": " + error);
+  }
+
+  auto entry = reinterpret_cast<ps_plugin_entry_fn>(FindSymbol(library, PS_PLUGIN_ENTRY_SYMBOL));
+  const ps_plugin_info* info = entry != nullptr ? entry() : nullptr;
+  if (info == nullptr || info->on_enable == nullptr) {
+    CloseLibrary(library);
+    throw std::runtime_error("plugin " + path.string() + " has no valid " +
+                             PS_PLUGIN_ENTRY_SYMBOL);
+  }
+  if (info->abi_version != PS_PLUGIN_ABI_VERSION) {
+    CloseLibrary(library);
+    throw std::runtime_error("plugin " + path.string() + " was built for ABI version " +
+                             std::to_string(info->abi_version) + ", server implements " +
+                             std::to_string(PS_PLUGIN_ABI_VERSION));
+  }
+
+  auto plugin = std::make_unique<LoadedPlugin>();
+  plugin->description.id = next_id_++;
+  plugin->description.name = info->name != nullptr ? info->name : path.stem().string();
+  plugin->description.version = info->version != nullptr ? info->version : "";
+  plugin->description.path = path;
+  plugin->library = library;
+  plugin->info = info;
+  plugin->bus = &bus_;
+  plugin->api.abi_version = PS_PLUGIN_ABI_VERSION;
+  plugin->api.size = sizeof(ps_host_api);
+  plugin->api.host = plugin.get();
+  plugin->api.register_handler = &PluginManager::RegisterHandler;
+  plugin->api.log = &PluginManager::Log;
+
+  if (int32_t status = info->on_enable(&plugin->api); status != 0) {
+    bus_.UnsubscribeAll(plugin->description.id);
+    CloseLibrary(library);
+    throw std::runtime_error("plugin " + plugin->description.name +
+                             " failed to enable (status " + std::to_string(status) + ")");
+  }
+
+  spdlog::info("Enabled plugin {} {}", plugin->description.name, plugin->description.version);
+  PluginId id = plugin->description.id;
+  plugins_.push_back(std::move(plugin));
+  return id;
+}
+
+size_t PluginManager::LoadDirectory(const std::filesystem::path& directory) {
+  std::error_code error;
+  if (!std::filesystem::is_directory(directory, error)) {
+    return 0;
+  }
+
+  std::vector<std::filesystem::path> paths;
+  for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+    if (entry.is_regular_file() && entry.path().extension() == LIBRARY_EXTENSION) {
+      paths.push_back(entry.path());
+    }
+  }
+  // Deterministic load order, and therefore handler order within a priority
+  std::sort(paths.begin(), paths.end());
+
+  size_t loaded = 0;
+  for (const auto& path : paths) {
+    try {
+      Load(path);
+      ++loaded;
+    } catch (const std::exception& e) {
+      spdlog::error("{}", e.what());
+    }
+  }
+  return loaded;
+}
+
+bool PluginManager::Unload(PluginId id) {
+  auto it = std::find_if(plugins_.begin(), plugins_.end(),
+                         [id](const auto& plugin) { return plugin->description.id == id; });
+  if (it == plugins_.end()) {
+    return false;
+  }
+  Close(**it);
+  plugins_.erase(it);
+  return true;
+}
+
+void PluginManager::UnloadAll() {
+  while (!plugins_.empty()) {
+    Close(*plugins_.back());
+    plugins_.pop_back();
+  }
+}
+
+std::vector<PluginDescription> PluginManager::Plugins() const {
+  std::vector<PluginDescription> descriptions;
+  descriptions.reserve(plugins_.size());
+  for (const auto& plugin : plugins_) {
+    descriptions.push_back(plugin->description);
+  }
+  return descriptions;
+}
+
+void PluginManager::Close(LoadedPlugin& plugin) {
+  if (plugin.info->on_disable != nullptr) {
+    plugin.info->on_disable();
+  }
+  // Handlers point into the library; drop them before it is unmapped
+  bus_.UnsubscribeAll(plugin.description.id);
+  CloseLibrary(plugin.library);
+  spdlog::info("Disabled plugin {}", plugin.description.name);
+}
+
+int32_t PluginManager::RegisterHandler(void* host, uint32_t event_type, int32_t priority,
+                                       ps_event_handler handler, void* user_data) {
+  auto* plugin = static_cast<LoadedPlugin*>(host);
+  if (event_type >= EVENT_TYPE_COUNT || handler == nullptr) {
+    return -1;
+  }
+  plugin->bus->Subscribe(static_cast<EventType>(event_type), priority, handler, user_data,
+                         plugin->description.id);
+  return 0;
+}
+
+void PluginManager::Log(void* host, int32_t level, const char* message) {
+  const auto* plugin = static_cast<const LoadedPlugin*>(host);
+  const char* text = message != nullptr ? message : "";
+  switch (level) {
+    case PS_LOG_DEBUG:
+      spdlog::debug("[{}] {}", plugin->description.name, text);
+      break;
+    case PS_LOG_WARN:
+      spdlog::warn("[{}] {}", plugin->description.name, text);
+      break;
+    case PS_LOG_ERROR:
+      spdlog::error("[{}] {}", plugin->description.name, text);
+      break;
+    default:
+      spdlog::info("[{}] {}", plugin->description.name, text);
+      break;
+  }
+}
+
+}  // namespace Plugin
@@ -0,0 +1,415 @@
+#include "plugin/wasm_plugin_host.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+#include "util/memory_accounting.h"
+
+#ifdef PARELLELSTONE_WASM_PLUGINS
+#include <wasm_export.h>
+#endif
+
+namespace Plugin {
+
+#ifdef PARELLELSTONE_WASM_PLUGINS
+
+namespace {
+
+int64_t NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/** @brief Little-endian writer into the module's event buffer */
+class EventWriter {
+ public:
+  EventWriter(uint8_t* out, size_t capacity) : out_(out), capacity_(capacity) {}
+
+  template <typename T>
+  void Put(T value) {
+    // WebAssembly memory is little-endian, as are all supported hosts
+    std::memcpy(out_ + size_, &value, sizeof(T));
+    size_ += sizeof(T);
+  }
+
+  void PutText(const char* text, size_t length) {
+    length = std::min(length, capacity_ - size_ - sizeof(uint32_t));
+    Put(static_cast<uint32_t>(length));
+    if (length > 0) {
+      std::memcpy(out_ + size_, text, length);
+      size_ += length;
+    }
+  }
+
+  uint32_t Size() const { return static_cast<uint32_t>(size_); }
+
+ private:
+  uint8_t* out_;
+  size_t capacity_;
+  size_t size_ = 0;
+};
+
+/** @brief Smallest event buffer holding every fixed-size field */
+constexpr uint32_t MIN_EVENT_BUFFER = 64;
+
+uint32_t WriteEvent(uint8_t* out, size_t capacity, const void* event) {
+  const auto* header = static_cast<const ps_event_header*>(event);
+  EventWriter writer(out, capacity);
+  writer.Put(header->type);
+  writer.Put(header->cancelled);
+  switch (header->type) {
+    case PS_EVENT_BLOCK_PLACE:
+    case PS_EVENT_BLOCK_BREAK: {
+      const auto* block = static_cast<const ps_block_event*>(event);
+      writer.Put(block->player.most);
+      writer.Put(block->player.least);
+      writer.Put(block->x);
+      writer.Put(block->y);
+      writer.Put(block->z);
+      writer.Put(block->state_id);
+      break;
+    }
+    case PS_EVENT_PLAYER_JOIN:
+    case PS_EVENT_PLAYER_QUIT: {
+      const auto* player = static_cast<const ps_player_event*>(event);
+      writer.Put(player->player.most);
+      writer.Put(player->player.least);
+      const char* name = player->name != nullptr ? player->name : "";
+      writer.PutText(name, std::strlen(name));
+      break;
+    }
+    case PS_EVENT_PLAYER_CHAT: {
+      const auto* chat = static_cast<const ps_chat_event*>(event);
+      writer.Put(chat->player.most);
+      writer.Put(chat->player.least);
+      writer.PutText(chat->message, chat->message != nullptr ? chat->length : 0);
+      break;
+    }
+    default:
+      break;
+  }
+  return writer.Size();
+}
+
+}  // namespace
+
+struct WasmPluginHost::Module {
+  WasmPluginHost* host = nullptr;
+  PluginId id = SERVER_PLUGIN;
+  std::string name;
+  std::vector<uint8_t> bytes;  ///< WAMR references the image while the module is loaded
+  wasm_module_t module = nullptr;
+  wasm_module_inst_t instance = nullptr;
+  wasm_exec_env_t exec_env = nullptr;
+  wasm_function_inst_t on_event = nullptr;
+  uint64_t buffer_offset = 0;  ///< Event buffer, in linear memory
+  uint8_t* buffer = nullptr;   ///< Same buffer, host address
+  bool initializing = false;   ///< Subscribe() is only accepted from ps_plugin_init
+  uint64_t tick_nanos = 0;
+  std::atomic<bool> timed_out{false};
+  WasmPluginStats stats;
+  size_t accounted_bytes = 0;  ///< Image, stack and heap, as tracked under PLUGINS
+
+  ~Module() {
+    Util::TrackRelease(Util::MemorySubsystem::PLUGINS, accounted_bytes);
+    if (buffer_offset != 0) {
+      wasm_runtime_module_free(instance, buffer_offset);
+    }
+    if (exec_env != nullptr) {
+      wasm_runtime_destroy_exec_env(exec_env);
+    }
+    if (instance != nullptr) {
+      wasm_runtime_deinstantiate(instance);
+    }
+    if (module != nullptr) {
+      wasm_runtime_unload(module);
+    }
+  }
+};
+
+WasmPluginHost::WasmPluginHost(EventBus& bus, WasmLimits limits)
+    : bus_(bus), limits_(limits), runtime_thread_(std::this_thread::get_id()) {
+  if (limits_.event_buffer_size < MIN_EVENT_BUFFER) {
+    throw std::invalid_argument("event_buffer_size must be at least " +
+                                std::to_string(MIN_EVENT_BUFFER));
+  }
+  if (!wasm_runtime_init()) {
+    throw std::runtime_error("cannot initialize the WebAssembly runtime");
+  }
+  static NativeSymbol natives[] = {
+      {"subscribe", reinterpret_cast<void*>(&WasmPluginHost::Subscribe), "(ii)i", nullptr},
+      {"log", reinterpret_cast<void*>(&WasmPluginHost::Log), "(i*~)", nullptr},
+  };
+  if (!wasm_runtime_register_natives("ps", natives, std::size(natives))) {
+    wasm_runtime_destroy();
+    throw std::runtime_error("cannot register the WebAssembly host API");
+  }
+  watchdog_ = std::thread([this] { WatchdogLoop(); });
+}
+
+WasmPluginHost::~WasmPluginHost() {
+  stop_.store(true, std::memory_order_relaxed);
+  watchdog_.join();
+  for (const auto& module : modules_) {
+    bus_.UnsubscribeAll(module->id);
+  }
+  modules_.clear();
+  wasm_runtime_destroy();
+}
+
+bool WasmPluginHost::Available() { return true; }
+
+PluginId WasmPluginHost::Load(const std::filesystem::path& path) {
+  auto module = std::make_unique<Module>();
+  module->host = this;
+  module->name = path.stem().string();
+
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("cannot open WebAssembly plugin " + path.string());
+  }
+  module->bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+  char error[128] = {};
+  module->module = wasm_runtime_load(module->bytes.data(),
+                                     static_cast<uint32_t>(module->bytes.size()), error,
+                                     sizeof(error));
+  if (module->module == nullptr) {
+    throw std::runtime_error("invalid WebAssembly plugin " + path.string() + ": " + error);
+  }
+  module->instance = wasm_runtime_instantiate(module->module, limits_.stack_size,
+                                              limits_.heap_size, error, sizeof(error));
+  if (module->instance == nullptr) {
+    throw std::runtime_error("cannot instantiate " + module->name + ": " + error);
+  }
+  // Linear memory declared by the module itself is not included
+  module->accounted_bytes = module->bytes.size() + limits_.stack_size + limits_.heap_size;
+  Util::TrackAllocation(Util::MemorySubsystem::PLUGINS, module->accounted_bytes);
+  module->exec_env = wasm_runtime_create_exec_env(module->instance, limits_.stack_size);
+  if (module->exec_env == nullptr) {
+    throw std::runtime_error("cannot create an execution environment for " + module->name);
+  }
+  wasm_runtime_set_user_data(module->exec_env, module.get());
+
+  wasm_function_inst_t init = wasm_runtime_lookup_function(module->instance, "ps_plugin_init");
+  module->on_event = wasm_runtime_lookup_function(module->instance, "ps_on_event");
+  if (init == nullptr || module->on_event == nullptr) {
+    throw std::runtime_error(module->name + " does not export ps_plugin_init and ps_on_event");
+  }
+
+  void* buffer = nullptr;
+  module->buffer_offset =
+      wasm_runtime_module_malloc(module->instance, limits_.event_buffer_size, &buffer);
+  if (module->buffer_offset == 0) {
+    throw std::runtime_error("cannot allocate the event buffer of " + module->name);
+  }
+  module->buffer = static_cast<uint8_t*>(buffer);
+
+  module->id = next_id_++;
+  module->initializing = true;
+  uint32_t result[1] = {0};
+  bool called = Call(*module, init, 0, result);
+  module->initializing = false;
+  if (!called || result[0] != 0) {
+    bus_.UnsubscribeAll(module->id);
+    throw std::runtime_error(module->name + " failed to initialize");
+  }
+
+  spdlog::info("Enabled WebAssembly plugin {}", module->name);
+  PluginId id = module->id;
+  modules_.push_back(std::move(module));
+  return id;
+}
+
+bool WasmPluginHost::Unload(PluginId id) {
+  auto it = std::find_if(modules_.begin(), modules_.end(),
+                         [id](const auto& module) { return module->id == id; });
+  if (it == modules_.end()) {
+    return false;
+  }
+  bus_.UnsubscribeAll(id);
+  spdlog::info("Disabled WebAssembly plugin {}", (*it)->name);
+  modules_.erase(it);
+  return true;
+}
+
+void WasmPluginHost::BeginTick() {
+  for (const auto& module : modules_) {
+    module->tick_nanos = 0;
+  }
+}
+
+WasmPluginStats WasmPluginHost::GetStats(PluginId id) const {
+  for (const auto& module : modules_) {
+    if (module->id == id) {
+      return module->stats;
+    }
+  }
+  return {};
+}
+
+int32_t WasmPluginHost::Subscribe(void* exec_env, int32_t event_type, int32_t priority) {
+  auto* module = static_cast<Module*>(
+      wasm_runtime_get_user_data(static_cast<wasm_exec_env_t>(exec_env)));
+  // Subscribing from a handler would reallocate the array being dispatched
+  if (!module->initializing || event_type < 0 ||
+      static_cast<size_t>(event_type) >= EVENT_TYPE_COUNT) {
+    return -1;
+  }
+  module->host->bus_.Subscribe(static_cast<EventType>(event_type), priority,
+                               &WasmPluginHost::HandleEvent, module, module->id);
+  return 0;
+}
+
+void WasmPluginHost::Log(void* exec_env, int32_t level, const char* text, uint32_t length) {
+  const auto* module = static_cast<const Module*>(
+      wasm_runtime_get_user_data(static_cast<wasm_exec_env_t>(exec_env)));
+  std::string_view message(text, length);
+  switch (level) {
+    case PS_LOG_DEBUG:
+      spdlog::debug("[{}] {}", module->name, message);
+      break;
+    case PS_LOG_WARN:
+      spdlog::warn("[{}] {}", module->name, message);
+      break;
+    case PS_LOG_ERROR:
+      spdlog::error("[{}] {}", module->name, message);
+      break;
+    default:
+      spdlog::info("[{}] {}", module->name, message);
+      break;
+  }
+}
+
+int32_t WasmPluginHost::HandleEvent(void* user_data, void* event) {
+  auto& module = *static_cast<Module*>(user_data);
+  WasmPluginHost& host = *module.host;
+  if (module.stats.disabled) {
+    return PS_EVENT_CONTINUE;
+  }
+  if (module.tick_nanos >= static_cast<uint64_t>(std::chrono::nanoseconds(
+                               host.limits_.tick_budget).count())) {
+    ++module.stats.over_budget_skips;
+    return PS_EVENT_CONTINUE;
+  }
+
+  if (std::this_thread::get_id() != host.runtime_thread_) {
+    thread_local bool thread_ready = false;
+    if (!thread_ready) {
+      thread_ready = wasm_runtime_init_thread_env();
+    }
+  }
+
+  uint32_t length = WriteEvent(module.buffer, host.limits_.event_buffer_size, event);
+  uint32_t argv[3] = {static_cast<const ps_event_header*>(event)->type,
+                      static_cast<uint32_t>(module.buffer_offset), length};
+  if (!host.Call(module, module.on_event, 3, argv)) {
+    return PS_EVENT_CONTINUE;
+  }
+  ++module.stats.events;
+  if (static_cast<int32_t>(argv[0]) == PS_EVENT_CANCEL) {
+    ++module.stats.cancelled;
+    return PS_EVENT_CANCEL;
+  }
+  return PS_EVENT_CONTINUE;
+}
+
+bool WasmPluginHost::Call(Module& module, void* function, uint32_t argc, uint32_t* argv) {
+  wasm_runtime_clear_exception(module.instance);
+  module.timed_out.store(false, std::memory_order_relaxed);
+
+  int64_t start = NowNanos();
+  running_since_.store(start, std::memory_order_relaxed);
+  running_.store(&module, std::memory_order_release);
+  bool ok = wasm_runtime_call_wasm(module.exec_env, static_cast<wasm_function_inst_t>(function),
+                                   argc, argv);
+  bool timed_out = false;
+  {
+    // After this the watchdog can no longer hold a pointer to the module
+    std::lock_guard<std::mutex> lock(watchdog_mutex_);
+    running_.store(nullptr, std::memory_order_relaxed);
+    timed_out = module.timed_out.load(std::memory_order_relaxed);
+  }
+
+  auto elapsed = static_cast<uint64_t>(NowNanos() - start);
+  module.tick_nanos += elapsed;
+  module.stats.cpu_nanos += elapsed;
+  module.stats.max_call_nanos = std::max(module.stats.max_call_nanos, elapsed);
+
+  if (!ok) {
+    ++module.stats.traps;
+    if (timed_out) {
+      ++module.stats.timeouts;
+    }
+    const char* exception = wasm_runtime_get_exception(module.instance);
+    spdlog::warn("WebAssembly plugin {} trapped: {}", module.name,
+                 exception != nullptr ? exception : "unknown");
+    if (module.stats.traps >= limits_.max_traps && !module.stats.disabled) {
+      module.stats.disabled = true;
+      spdlog::error("Disabled WebAssembly plugin {} after {} traps", module.name,
+                    module.stats.traps);
+    }
+  }
+
+  if (timed_out) {
+    // The watchdog can terminate just after the function returned. The request then stays
+    // pending on the instance and exec env and would abort the next call, so drop both.
+    wasm_runtime_clear_exception(module.instance);
+    wasm_runtime_destroy_exec_env(module.exec_env);
+    module.exec_env = wasm_runtime_create_exec_env(module.instance, limits_.stack_size);
+    if (module.exec_env != nullptr) {
+      wasm_runtime_set_user_data(module.exec_env, &module);
+    } else if (!module.stats.disabled) {
+      module.stats.disabled = true;
+      spdlog::error("Disabled WebAssembly plugin {}: cannot recreate its execution environment",
+                    module.name);
+    }
+  }
+  return ok;
+}
+
+void WasmPluginHost::WatchdogLoop() {
+  const int64_t timeout = std::chrono::nanoseconds(limits_.call_timeout).count();
+  while (!stop_.load(std::memory_order_relaxed)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::lock_guard<std::mutex> lock(watchdog_mutex_);
+    Module* module = running_.load(std::memory_order_acquire);
+    if (module != nullptr && !module->timed_out.load(std::memory_order_relaxed) &&
+        NowNanos() - running_since_.load(std::memory_order_relaxed) > timeout) {
+      module->timed_out.store(true, std::memory_order_relaxed);
+      wasm_runtime_terminate(module->instance);
+    }
+  }
+}
+
+#else  // PARELLELSTONE_WASM_PLUGINS
+
+struct WasmPluginHost::Module {};
+
+WasmPluginHost::WasmPluginHost(EventBus& bus, WasmLimits limits) : bus_(bus), limits_(limits) {}
+
+WasmPluginHost::~WasmPluginHost() = default;
+
+bool WasmPluginHost::Available() { return false; }
+
+PluginId WasmPluginHost::Load(const std::filesystem::path& path) {
+  throw std::runtime_error("cannot load " + path.string() +
+                           ": built without PARELLELSTONE_WASM_PLUGINS");
+}
+
+bool WasmPluginHost::Unload(PluginId) { return false; }
+
+void WasmPluginHost::BeginTick() {}
+
+WasmPluginStats WasmPluginHost::GetStats(PluginId) const { return {}; }
+
+#endif  // PARELLELSTONE_WASM_PLUGINS
+
+}  // namespace Plugin
@@ -0,0 +1,80 @@
+#include "protocol/text_component.h"
+
+#include <string>
+
+namespace Protocol {
+
+namespace {
+
+#if MINECRAFT_VERSION >= 120300
+constexpr uint8_t TAG_STRING = 8;
+
+/** @brief Convert UTF-8 to the modified UTF-8 used by NBT strings */
+std::string ToModifiedUtf8(std::string_view text) {
+  std::string out;
+  out.reserve(text.size());
+  for (size_t i = 0; i < text.size();) {
+    const auto lead = static_cast<uint8_t>(text[i]);
+    if (lead == 0) {
+      out += "\xC0\x80";
+      ++i;
+    } else if (lead >= 0xF0 && i + 3 < text.size()) {
+      // Supplementary code point: re-encode as a surrogate pair of 3-byte sequences.
+      const uint32_t code = ((lead & 0x07u) << 18) |
+                            ((static_cast<uint8_t>(text[i + 1]) & 0x3Fu) << 12) |
+                            ((static_cast<uint8_t>(text[i + 2]) & 0x3Fu) << 6) |
+                            (static_cast<uint8_t>(text[i + 3]) & 0x3Fu);
+      const uint32_t offset = code - 0x10000;
+      for (uint32_t unit : {0xD800 | (offset >> 10), 0xDC00 | (offset & 0x3FF)}) {
+        out += static_cast<char>(0xE0 | (unit >> 12));
+        out += static_cast<char>(0x80 | ((unit >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (unit & 0x3F));
+      }
+      i += 4;
+    } else {
+      out += text[i++];
+    }
+  }
+  return out;
+}
+#endif
+
+}  // namespace
+
+void WritePlainText(Network::PacketBuffer& buffer, std::string_view text) {
+#if MINECRAFT_VERSION >= 120300
+  std::string encoded = ToModifiedUtf8(text);
+  if (encoded.size() > 0xFFFF) {
+    encoded.resize(0xFFFF);
+  }
+  buffer.WriteByte(TAG_STRING);
+  buffer.WriteShort(static_cast<int16_t>(encoded.size()));
+  buffer.WriteBytes({reinterpret_cast<const uint8_t*>(encoded.data()), encoded.size()});
+#else
+  std::string json;
+  json.reserve(text.size() + 2);
+  json += '"';
+  for (char c : text) {
+    switch (c) {
+      case '"': json += "\\\""; break;
+      case '\\': json += "\\\\"; break;
+      case '\n': json += "\\n"; break;
+      case '\r': json += "\\r"; break;
+      case '\t': json += "\\t"; break;
+      default:
+        if (static_cast<uint8_t>(c) < 0x20) {
+          static constexpr char HEX[] = "0123456789abcdef";
+          json += "\\u00";
+          json += HEX[(c >> 4) & 0xF];
+          json += HEX[c & 0xF];
+        } else {
+          json += c;
+        }
+    }
+  }
+  json += '"';
+  buffer.WriteString(json);
+#endif
+}
+
+}  // namespace Protocol
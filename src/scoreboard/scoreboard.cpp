@@ -0,0 +1,411 @@
+#include "scoreboard/scoreboard.h"
+
+#include <algorithm>
+
+#include "network/packet_buffer.h"
+#include "protocol/packet_ids.h"
+#include "protocol/text_component.h"
+
+namespace Scoreboard {
+
+namespace {
+
+constexpr uint8_t OBJECTIVE_CREATE = 0;
+constexpr uint8_t OBJECTIVE_REMOVE = 1;
+constexpr uint8_t OBJECTIVE_UPDATE = 2;
+
+constexpr uint8_t TEAM_CREATE = 0;
+constexpr uint8_t TEAM_REMOVE = 1;
+constexpr uint8_t TEAM_UPDATE = 2;
+constexpr uint8_t TEAM_ADD_MEMBERS = 3;
+constexpr uint8_t TEAM_REMOVE_MEMBERS = 4;
+
+#if MINECRAFT_VERSION < 121500
+constexpr const char* VISIBILITY_NAMES[] = {"always", "never", "hideForOtherTeams",
+                                            "hideForOwnTeam"};
+constexpr const char* COLLISION_NAMES[] = {"always", "never", "pushOtherTeams", "pushOwnTeam"};
+#endif
+
+}  // namespace
+
+Scoreboard::Objective* Scoreboard::FindObjective(std::string_view name) {
+  auto it = objectives_.find(name);
+  return it == objectives_.end() ? nullptr : &it->second;
+}
+
+Scoreboard::Team* Scoreboard::FindTeam(std::string_view name) {
+  auto it = teams_.find(name);
+  return it == teams_.end() ? nullptr : &it->second;
+}
+
+void Scoreboard::Emit(Network::SharedPacket packet) {
+  structural_.push_back(std::move(packet));
+}
+
+void Scoreboard::Queue(std::string_view name, Objective& objective) {
+  if (!objective.queued) {
+    objective.queued = true;
+    dirty_objectives_.emplace_back(name);
+  }
+}
+
+bool Scoreboard::AddObjective(std::string_view name, std::string_view display_name,
+                              RenderType render_type) {
+  auto [it, inserted] = objectives_.try_emplace(std::string(name));
+  if (!inserted) {
+    return false;
+  }
+  it->second.display_name = display_name;
+  it->second.render_type = render_type;
+  Emit(EncodeObjective(name, it->second, OBJECTIVE_CREATE));
+  return true;
+}
+
+bool Scoreboard::RemoveObjective(std::string_view name) {
+  auto it = objectives_.find(name);
+  if (it == objectives_.end()) {
+    return false;
+  }
+  objectives_.erase(it);
+  for (std::string& slot : display_slots_) {
+    if (slot == name) {
+      slot.clear();  // The client clears slots of removed objectives itself.
+    }
+  }
+  Emit(EncodeObjectiveRemoval(name));
+  return true;
+}
+
+void Scoreboard::SetObjectiveDisplayName(std::string_view name, std::string_view display_name) {
+  Objective* objective = FindObjective(name);
+  if (!objective || objective->display_name == display_name) {
+    return;
+  }
+  objective->display_name = display_name;
+  objective->dirty = true;
+  Queue(name, *objective);
+}
+
+void Scoreboard::SetDisplaySlot(DisplaySlot slot, std::string_view objective) {
+  std::string& current = display_slots_[static_cast<size_t>(slot)];
+  if (current == objective || (!objective.empty() && !FindObjective(objective))) {
+    return;
+  }
+  current = objective;
+  Emit(EncodeDisplaySlot(slot, objective));
+}
+
+void Scoreboard::SetScore(std::string_view entry, std::string_view objective_name, int32_t value,
+                          std::optional<std::string_view> display_name) {
+  Objective* objective = FindObjective(objective_name);
+  if (!objective) {
+    return;
+  }
+  ++stats_.score_sets;
+
+  auto [it, inserted] = objective->scores.try_emplace(std::string(entry));
+  Score& score = it->second;
+  const bool same_display = display_name ? score.display_name == *display_name
+                                         : !score.display_name.has_value();
+  if (!inserted && score.value == value && same_display) {
+    ++stats_.unchanged_sets;
+    return;
+  }
+  score.value = value;
+  if (!same_display) {
+    score.display_name = display_name ? std::optional<std::string>(*display_name) : std::nullopt;
+  }
+  if (score.dirty) {
+    ++stats_.coalesced_sets;
+    return;
+  }
+  score.dirty = true;
+  objective->dirty_scores.emplace_back(entry);
+  Queue(objective_name, *objective);
+}
+
+void Scoreboard::ResetScore(std::string_view entry, std::string_view objective_name) {
+  Objective* objective = FindObjective(objective_name);
+  if (!objective) {
+    return;
+  }
+  auto it = objective->scores.find(entry);
+  if (it == objective->scores.end()) {
+    return;
+  }
+  objective->scores.erase(it);
+  objective->reset_scores.emplace_back(entry);
+  Queue(objective_name, *objective);
+}
+
+std::optional<int32_t> Scoreboard::GetScore(std::string_view entry,
+                                            std::string_view objective_name) const {
+  auto objective = objectives_.find(objective_name);
+  if (objective == objectives_.end()) {
+    return std::nullopt;
+  }
+  auto it = objective->second.scores.find(entry);
+  if (it == objective->second.scores.end()) {
+    return std::nullopt;
+  }
+  return it->second.value;
+}
+
+bool Scoreboard::AddTeam(std::string_view name, TeamOptions options) {
+  auto [it, inserted] = teams_.try_emplace(std::string(name));
+  if (!inserted) {
+    return false;
+  }
+  it->second.options = std::move(options);
+  Emit(EncodeTeam(name, it->second, TEAM_CREATE));
+  return true;
+}
+
+bool Scoreboard::RemoveTeam(std::string_view name) {
+  auto it = teams_.find(name);
+  if (it == teams_.end()) {
+    return false;
+  }
+  teams_.erase(it);
+  Emit(EncodeTeam(name, Team{}, TEAM_REMOVE));
+  return true;
+}
+
+void Scoreboard::UpdateTeam(std::string_view name, const TeamOptions& options) {
+  Team* team = FindTeam(name);
+  if (!team || team->options == options) {
+    return;
+  }
+  team->options = options;
+  if (!team->dirty) {
+    team->dirty = true;
+    dirty_teams_.emplace_back(name);
+  }
+}
+
+void Scoreboard::SetTeamAffixes(std::string_view name, std::string_view prefix,
+                                std::string_view suffix) {
+  Team* team = FindTeam(name);
+  if (!team) {
+    return;
+  }
+  TeamOptions options = team->options;
+  options.prefix = prefix;
+  options.suffix = suffix;
+  UpdateTeam(name, options);
+}
+
+void Scoreboard::AddTeamMember(std::string_view name, std::string_view member) {
+  Team* team = FindTeam(name);
+  if (!team || std::find(team->members.begin(), team->members.end(), member) != team->members.end()) {
+    return;
+  }
+  team->members.emplace_back(member);
+  Emit(EncodeTeamMembers(name, TEAM_ADD_MEMBERS, member));
+}
+
+void Scoreboard::RemoveTeamMember(std::string_view name, std::string_view member) {
+  Team* team = FindTeam(name);
+  if (!team) {
+    return;
+  }
+  auto it = std::find(team->members.begin(), team->members.end(), member);
+  if (it == team->members.end()) {
+    return;
+  }
+  team->members.erase(it);
+  Emit(EncodeTeamMembers(name, TEAM_REMOVE_MEMBERS, member));
+}
+
+size_t Scoreboard::Flush(const BroadcastFunction& broadcast) {
+  size_t packets = 0;
+  auto send = [&](const Network::SharedPacket& packet) {
+    ++packets;
+    ++stats_.packets;
+    stats_.bytes_encoded += packet->bytes.size();
+    broadcast(packet);
+  };
+
+  for (const Network::SharedPacket& packet : structural_) {
+    send(packet);
+  }
+  structural_.clear();
+
+  for (const std::string& name : dirty_objectives_) {
+    Objective* objective = FindObjective(name);
+    if (!objective || !objective->queued) {
+      continue;  // Removed, or a duplicate entry after a remove and re-add
+    }
+    objective->queued = false;
+    if (objective->dirty) {
+      objective->dirty = false;
+      send(EncodeObjective(name, *objective, OBJECTIVE_UPDATE));
+    }
+    // Resets first: a score reset and set again within the tick must end up set.
+    for (const std::string& entry : objective->reset_scores) {
+      send(EncodeReset(entry, name));
+    }
+    objective->reset_scores.clear();
+    for (const std::string& entry : objective->dirty_scores) {
+      auto it = objective->scores.find(entry);
+      if (it != objective->scores.end() && it->second.dirty) {
+        it->second.dirty = false;
+        send(EncodeScore(entry, name, it->second));
+      }
+    }
+    objective->dirty_scores.clear();
+  }
+  dirty_objectives_.clear();
+
+  for (const std::string& name : dirty_teams_) {
+    Team* team = FindTeam(name);
+    if (team && team->dirty) {
+      team->dirty = false;
+      send(EncodeTeam(name, *team, TEAM_UPDATE));
+    }
+  }
+  dirty_teams_.clear();
+  return packets;
+}
+
+std::vector<Network::SharedPacket> Scoreboard::SnapshotPackets() const {
+  std::vector<Network::SharedPacket> packets;
+  for (const auto& [name, objective] : objectives_) {
+    packets.push_back(EncodeObjective(name, objective, OBJECTIVE_CREATE));
+  }
+  for (size_t slot = 0; slot < display_slots_.size(); ++slot) {
+    if (!display_slots_[slot].empty()) {
+      packets.push_back(EncodeDisplaySlot(static_cast<DisplaySlot>(slot), display_slots_[slot]));
+    }
+  }
+  for (const auto& [name, team] : teams_) {
+    packets.push_back(EncodeTeam(name, team, TEAM_CREATE));
+  }
+  for (const auto& [name, objective] : objectives_) {
+    for (const auto& [entry, score] : objective.scores) {
+      packets.push_back(EncodeScore(entry, name, score));
+    }
+  }
+  return packets;
+}
+
+Network::SharedPacket Scoreboard::EncodeObjective(std::string_view name,
+                                                  const Objective& objective,
+                                                  uint8_t mode) const {
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::UPDATE_OBJECTIVES,
+                               16 + name.size() + objective.display_name.size());
+  buffer.WriteString(name);
+  buffer.WriteByte(mode);
+  Protocol::WritePlainText(buffer, objective.display_name);
+  buffer.WriteVarInt(static_cast<int32_t>(objective.render_type));
+#if MINECRAFT_VERSION >= 120300
+  buffer.WriteBool(false);  // Default number format
+#endif
+  return buffer.Finish();
+}
+
+Network::SharedPacket Scoreboard::EncodeObjectiveRemoval(std::string_view name) const {
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::UPDATE_OBJECTIVES, 8 + name.size());
+  buffer.WriteString(name);
+  buffer.WriteByte(OBJECTIVE_REMOVE);
+  return buffer.Finish();
+}
+
+Network::SharedPacket Scoreboard::EncodeDisplaySlot(DisplaySlot slot,
+                                                    std::string_view objective) const {
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::DISPLAY_OBJECTIVE,
+                               8 + objective.size());
+#if MINECRAFT_VERSION >= 120200
+  buffer.WriteVarInt(static_cast<int32_t>(slot));
+#else
+  buffer.WriteByte(static_cast<uint8_t>(slot));
+#endif
+  buffer.WriteString(objective);
+  return buffer.Finish();
+}
+
+Network::SharedPacket Scoreboard::EncodeTeam(std::string_view name, const Team& team,
+                                             uint8_t mode) const {
+  const TeamOptions& options = team.options;
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::UPDATE_TEAMS,
+                               32 + name.size() + options.prefix.size() + options.suffix.size());
+  buffer.WriteString(name);
+  buffer.WriteByte(mode);
+  if (mode == TEAM_REMOVE) {
+    return buffer.Finish();
+  }
+
+  Protocol::WritePlainText(buffer, options.display_name);
+  buffer.WriteByte(static_cast<uint8_t>((options.allow_friendly_fire ? 0x01 : 0) |
+                                        (options.see_friendly_invisibles ? 0x02 : 0)));
+#if MINECRAFT_VERSION >= 121500
+  buffer.WriteVarInt(options.name_tag_visibility);
+  buffer.WriteVarInt(options.collision_rule);
+#else
+  buffer.WriteString(VISIBILITY_NAMES[options.name_tag_visibility]);
+  buffer.WriteString(COLLISION_NAMES[options.collision_rule]);
+#endif
+  buffer.WriteVarInt(options.color);
+  Protocol::WritePlainText(buffer, options.prefix);
+  Protocol::WritePlainText(buffer, options.suffix);
+
+  if (mode == TEAM_CREATE) {
+    buffer.WriteVarInt(static_cast<int32_t>(team.members.size()));
+    for (const std::string& member : team.members) {
+      buffer.WriteString(member);
+    }
+  }
+  return buffer.Finish();
+}
+
+Network::SharedPacket Scoreboard::EncodeTeamMembers(std::string_view name, uint8_t mode,
+                                                    std::string_view member) const {
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::UPDATE_TEAMS,
+                               8 + name.size() + member.size());
+  buffer.WriteString(name);
+  buffer.WriteByte(mode);
+  buffer.WriteVarInt(1);
+  buffer.WriteString(member);
+  return buffer.Finish();
+}
+
+Network::SharedPacket Scoreboard::EncodeScore(std::string_view entry, std::string_view objective,
+                                              const Score& score) const {
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::UPDATE_SCORE,
+                               16 + entry.size() + objective.size());
+  buffer.WriteString(entry);
+#if MINECRAFT_VERSION >= 120300
+  buffer.WriteString(objective);
+  buffer.WriteVarInt(score.value);
+  buffer.WriteBool(score.display_name.has_value());
+  if (score.display_name) {
+    Protocol::WritePlainText(buffer, *score.display_name);
+  }
+  buffer.WriteBool(false);  // Objective's number format
+#else
+  buffer.WriteVarInt(0);  // Create or update
+  buffer.WriteString(objective);
+  buffer.WriteVarInt(score.value);
+#endif
+  return buffer.Finish();
+}
+
+Network::SharedPacket Scoreboard::EncodeReset(std::string_view entry,
+                                              std::string_view objective) const {
+#if MINECRAFT_VERSION >= 120300
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::RESET_SCORE,
+                               8 + entry.size() + objective.size());
+  buffer.WriteString(entry);
+  buffer.WriteBool(true);
+  buffer.WriteString(objective);
+#else
+  Network::PacketBuffer buffer(Protocol::Play::Clientbound::UPDATE_SCORE,
+                               8 + entry.size() + objective.size());
+  buffer.WriteString(entry);
+  buffer.WriteVarInt(1);  // Remove
+  buffer.WriteString(objective);
+#endif
+  return buffer.Finish();
+}
+
+}  // namespace Scoreboard
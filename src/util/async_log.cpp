@@ -0,0 +1,335 @@
+#include "util/async_log.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <exception>
+
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/spdlog.h>
+
+namespace Util {
+
+namespace {
+
+/** @brief Lines written per batch before the writer looks at flushes and drops */
+constexpr size_t WRITE_BATCH = 1024;
+
+/** @brief Formatter clones kept per thread; one per sink the thread logs to */
+constexpr size_t THREAD_FORMATTERS = 4;
+
+// Versions are unique across sinks so a thread's clone can never match the wrong sink
+std::atomic<uint64_t> next_formatter_version{1};
+
+struct ThreadFormatter {
+  uint64_t version = 0;
+  std::unique_ptr<spdlog::formatter> formatter;
+};
+
+struct ThreadFormatState {
+  std::array<ThreadFormatter, THREAD_FORMATTERS> formatters;
+  size_t next_victim = 0;
+  spdlog::memory_buf_t line;
+};
+
+ThreadFormatState& LocalFormatState() {
+  thread_local ThreadFormatState state;
+  return state;
+}
+
+std::unique_ptr<spdlog::formatter> MakeFormatter(const std::string& pattern) {
+  // No end of line: downstream sinks terminate the line themselves
+  return std::make_unique<spdlog::pattern_formatter>(pattern, spdlog::pattern_time_type::local,
+                                                     std::string());
+}
+
+}  // namespace
+
+struct AsyncLogSink::Slot {
+  std::atomic<uint64_t> sequence{0};
+  spdlog::level::level_enum level = spdlog::level::info;
+  spdlog::log_clock::time_point time;
+  std::string text;  ///< Keeps its capacity, so steady-state pushes do not allocate
+};
+
+AsyncLogSink::AsyncLogSink(std::vector<spdlog::sink_ptr> sinks, AsyncLogConfig config)
+    : sinks_(std::move(sinks)),
+      config_(std::move(config)),
+      formatter_(MakeFormatter(config_.pattern)),
+      formatter_version_(next_formatter_version.fetch_add(1, std::memory_order_relaxed)) {
+  const size_t capacity = std::bit_ceil(std::max<size_t>(config_.queue_capacity, 2));
+  slots_ = std::make_unique<Slot[]>(capacity);
+  mask_ = capacity - 1;
+  popped_ = std::make_unique<Slot>();
+  for (size_t i = 0; i < capacity; ++i) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  writer_ = std::thread([this] { WriterLoop(); });
+}
+
+AsyncLogSink::~AsyncLogSink() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_one();
+  writer_.join();
+}
+
+void AsyncLogSink::log(const spdlog::details::log_msg& msg) {
+  ThreadFormatState& state = LocalFormatState();
+  const uint64_t version = formatter_version_.load(std::memory_order_acquire);
+  auto cached =
+      std::find_if(state.formatters.begin(), state.formatters.end(),
+                   [version](const ThreadFormatter& entry) { return entry.version == version; });
+  if (cached == state.formatters.end()) {
+    cached = state.formatters.begin() + state.next_victim;
+    state.next_victim = (state.next_victim + 1) % THREAD_FORMATTERS;
+    std::lock_guard<std::mutex> lock(formatter_mutex_);
+    cached->formatter = formatter_->clone();
+    cached->version = formatter_version_.load(std::memory_order_relaxed);
+  }
+  state.line.clear();
+  cached->formatter->format(msg, state.line);
+
+  if (TryPush(msg, state.line)) {
+    WakeWriter();
+    return;
+  }
+  if (config_.overflow == LogOverflowPolicy::DROP_OLDEST) {
+    do {
+      if (TryPop(true)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+      }
+    } while (!TryPush(msg, state.line));
+    WakeWriter();
+    return;
+  }
+
+  blocked_.fetch_add(1, std::memory_order_relaxed);
+  waiting_producers_.fetch_add(1, std::memory_order_seq_cst);
+  for (;;) {
+    const uint64_t seen = written_.load(std::memory_order_seq_cst);
+    WakeWriter();
+    if (TryPush(msg, state.line)) {
+      break;
+    }
+    written_.wait(seen, std::memory_order_seq_cst);
+  }
+  waiting_producers_.fetch_sub(1, std::memory_order_relaxed);
+  WakeWriter();
+}
+
+void AsyncLogSink::flush() {
+  flush_requested_.store(true, std::memory_order_relaxed);
+  WakeWriter();
+}
+
+void AsyncLogSink::set_pattern(const std::string& pattern) {
+  set_formatter(MakeFormatter(pattern));
+}
+
+void AsyncLogSink::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) {
+  std::lock_guard<std::mutex> lock(formatter_mutex_);
+  formatter_ = std::move(sink_formatter);
+  formatter_version_.store(next_formatter_version.fetch_add(1, std::memory_order_relaxed),
+                           std::memory_order_release);
+}
+
+void AsyncLogSink::Drain() {
+  const uint64_t target = enqueue_position_.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock(mutex_);
+  drain_target_ = std::max(drain_target_, target);
+  wake_.notify_one();
+  drained_.wait(lock, [&] { return flushed_position_ >= target || stopping_; });
+}
+
+AsyncLogStats AsyncLogSink::GetStats() const {
+  AsyncLogStats stats;
+  stats.enqueued = enqueue_position_.load(std::memory_order_relaxed);
+  stats.written = written_.load(std::memory_order_relaxed);
+  stats.dropped = dropped_.load(std::memory_order_relaxed);
+  stats.blocked = blocked_.load(std::memory_order_relaxed);
+  const uint64_t dequeued = dequeue_position_.load(std::memory_order_relaxed);
+  stats.depth = stats.enqueued > dequeued ? static_cast<size_t>(stats.enqueued - dequeued) : 0;
+  return stats;
+}
+
+// Bounded MPMC ring after Vyukov: a slot's sequence says whose turn it is. Producers
+// also pop, to discard the oldest line under DROP_OLDEST.
+bool AsyncLogSink::TryPush(const spdlog::details::log_msg& msg, const spdlog::memory_buf_t& line) {
+  uint64_t position = enqueue_position_.load(std::memory_order_relaxed);
+  for (;;) {
+    Slot& slot = slots_[position & mask_];
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    const int64_t difference = static_cast<int64_t>(sequence - position);
+    if (difference == 0) {
+      if (enqueue_position_.compare_exchange_weak(position, position + 1,
+                                                  std::memory_order_relaxed)) {
+        slot.level = msg.level;
+        slot.time = msg.time;
+        slot.text.assign(line.data(), line.size());
+        slot.sequence.store(position + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (difference < 0) {
+      return false;
+    } else {
+      position = enqueue_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool AsyncLogSink::TryPop(bool discard) {
+  uint64_t position = dequeue_position_.load(std::memory_order_relaxed);
+  for (;;) {
+    Slot& slot = slots_[position & mask_];
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    const int64_t difference = static_cast<int64_t>(sequence - (position + 1));
+    if (difference == 0) {
+      if (dequeue_position_.compare_exchange_weak(position, position + 1,
+                                                  std::memory_order_relaxed)) {
+        if (!discard) {
+          popped_->level = slot.level;
+          popped_->time = slot.time;
+          popped_->text.swap(slot.text);
+        }
+        slot.sequence.store(position + mask_ + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (difference < 0) {
+      return false;
+    } else {
+      position = dequeue_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void AsyncLogSink::Write(spdlog::level::level_enum level, spdlog::log_clock::time_point time,
+                         std::string_view text) {
+  // Formatters installed through set_formatter() may still end the line
+  while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) {
+    text.remove_suffix(1);
+  }
+  const spdlog::details::log_msg msg(time, spdlog::source_loc{}, spdlog::string_view_t(), level,
+                                     spdlog::string_view_t(text.data(), text.size()));
+  for (const spdlog::sink_ptr& sink : sinks_) {
+    if (!sink->should_log(level)) {
+      continue;
+    }
+    try {
+      sink->log(msg);
+    } catch (const std::exception& e) {
+      std::fprintf(stderr, "async log sink failed: %s\n", e.what());
+    }
+  }
+}
+
+void AsyncLogSink::WakeWriter() {
+  // Pairs with the writer announcing it is about to sleep, then re-checking the queue
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (writer_sleeping_.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wake_.notify_one();
+  }
+}
+
+void AsyncLogSink::FlushSinks() {
+  for (const spdlog::sink_ptr& sink : sinks_) {
+    try {
+      sink->flush();
+    } catch (const std::exception& e) {
+      std::fprintf(stderr, "async log flush failed: %s\n", e.what());
+    }
+  }
+}
+
+void AsyncLogSink::WriterLoop() {
+  uint64_t reported_dropped = 0;
+  uint64_t unflushed = 0;
+  auto last_flush = std::chrono::steady_clock::now();
+
+  for (;;) {
+    size_t batch = 0;
+    while (batch < WRITE_BATCH && TryPop(false)) {
+      Write(popped_->level, popped_->time, popped_->text);
+      ++batch;
+    }
+    if (batch > 0) {
+      unflushed += batch;
+      written_.fetch_add(batch, std::memory_order_seq_cst);
+      if (waiting_producers_.load(std::memory_order_seq_cst) > 0) {
+        written_.notify_all();
+      }
+    }
+
+    const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped > reported_dropped) {
+      Write(spdlog::level::warn, spdlog::log_clock::now(),
+            fmt::format("Log queue full, dropped {} lines", dropped - reported_dropped));
+      reported_dropped = dropped;
+      ++unflushed;
+    }
+
+    const uint64_t position = dequeue_position_.load(std::memory_order_acquire);
+    if (position != enqueue_position_.load(std::memory_order_acquire)) {
+      if (batch == 0) {
+        // A producer claimed the next slot and is still filling it
+        std::this_thread::yield();
+      }
+      continue;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    bool flush = flush_requested_.exchange(false, std::memory_order_relaxed) ||
+                 (unflushed > 0 && now - last_flush >= config_.flush_interval);
+    bool stopping = false;
+    {
+      // A Drain() arriving after this point is seen by the idle check below
+      std::lock_guard<std::mutex> lock(mutex_);
+      flush = flush || drain_target_ > flushed_position_ || stopping_;
+      stopping = stopping_;
+    }
+    if (flush) {
+      FlushSinks();
+      unflushed = 0;
+      last_flush = now;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Only a pass that flushed may advance it: Drain() promises flushed lines
+    if (flush) {
+      flushed_position_ = std::max(flushed_position_, position);
+      drained_.notify_all();
+    }
+    if (stopping) {
+      return;
+    }
+    writer_sleeping_.store(true, std::memory_order_seq_cst);
+    const bool idle = enqueue_position_.load(std::memory_order_seq_cst) == position &&
+                      !flush_requested_.load(std::memory_order_relaxed) &&
+                      drain_target_ <= flushed_position_ && !stopping_;
+    if (idle) {
+      wake_.wait_for(lock, unflushed > 0 ? config_.flush_interval : std::chrono::seconds(60));
+    }
+    writer_sleeping_.store(false, std::memory_order_relaxed);
+  }
+}
+
+std::shared_ptr<AsyncLogSink> InstallAsyncLogging(const std::string& name,
+                                                  std::vector<spdlog::sink_ptr> sinks,
+                                                  AsyncLogConfig config,
+                                                  spdlog::level::level_enum level) {
+  for (const spdlog::sink_ptr& sink : sinks) {
+    sink->set_pattern("%^%v%$");
+  }
+  auto sink = std::make_shared<AsyncLogSink>(std::move(sinks), std::move(config));
+  auto logger = std::make_shared<spdlog::logger>(name, sink);
+  logger->set_level(level);
+  logger->flush_on(spdlog::level::warn);
+  spdlog::set_default_logger(logger);
+  return sink;
+}
+
+}  // namespace Util
@@ -0,0 +1,48 @@
+#include "util/global_allocator.h"
+
+#include <string>
+
+#include "platform.h"
+
+#if defined(PARELLELSTONE_ALLOCATOR_MIMALLOC)
+#include <mimalloc.h>
+#ifdef PLATFORM_WINDOWS
+// The override build already defines operator new/delete on Linux and macOS (alloc-override.c),
+// so including this there as well is a multiple definition. Windows only redirects the CRT
+// malloc, so new/delete are routed here; must appear in exactly one translation unit.
+#include <mimalloc-new-delete.h>
+#endif
+#elif defined(PARELLELSTONE_ALLOCATOR_JEMALLOC)
+#include <jemalloc/jemalloc.h>
+#elif defined(PLATFORM_WINDOWS)
+#include <malloc.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace Util {
+
+std::string_view GlobalAllocatorName() {
+#if defined(PARELLELSTONE_ALLOCATOR_MIMALLOC)
+  return "mimalloc";
+#elif defined(PARELLELSTONE_ALLOCATOR_JEMALLOC)
+  return "jemalloc";
+#else
+  return "system";
+#endif
+}
+
+void TrimGlobalAllocator() {
+#if defined(PARELLELSTONE_ALLOCATOR_MIMALLOC)
+  mi_collect(true);
+#elif defined(PARELLELSTONE_ALLOCATOR_JEMALLOC)
+  const std::string purge = "arena." + std::to_string(MALLCTL_ARENAS_ALL) + ".purge";
+  mallctl(purge.c_str(), nullptr, nullptr, nullptr, 0);
+#elif defined(PLATFORM_WINDOWS)
+  _heapmin();
+#elif defined(__GLIBC__)
+  malloc_trim(0);
+#endif
+}
+
+}  // namespace Util
@@ -0,0 +1,78 @@
+#include "util/health_checks.h"
+
+#include <cstdio>
+
+namespace Util {
+
+namespace {
+
+void AddCheck(HealthReport& report, bool passed, const char* name, const std::string& detail) {
+  report.ok = report.ok && passed;
+  report.detail += passed ? "[+]" : "[-]";
+  report.detail += name;
+  report.detail += ' ';
+  report.detail += detail;
+  report.detail += '\n';
+}
+
+std::string Seconds(std::chrono::steady_clock::duration duration) {
+  char text[32];
+  std::snprintf(text, sizeof(text), "%.1fs",
+                std::chrono::duration<double>(duration).count());
+  return text;
+}
+
+Network::HttpResponse ToResponse(const HealthReport& report) {
+  return {report.ok ? 200 : 503, "text/plain; charset=utf-8", report.detail};
+}
+
+}  // namespace
+
+HealthChecks::HealthChecks(const ServerMetrics& metrics, HealthConfig config)
+    : metrics_(metrics), config_(config), created_(std::chrono::steady_clock::now()) {}
+
+void HealthChecks::SetWorldsLoaded(bool loaded) noexcept {
+  worlds_loaded_.store(loaded, std::memory_order_relaxed);
+}
+
+void HealthChecks::SetAcceptingLogins(bool accepting) noexcept {
+  accepting_logins_.store(accepting, std::memory_order_relaxed);
+}
+
+HealthReport HealthChecks::Liveness() const {
+  HealthReport report;
+  const auto now = std::chrono::steady_clock::now();
+  const auto last_tick = metrics_.LastTickTime();
+  if (!last_tick) {
+    // Worlds load before the loop starts; only a startup that never ends is fatal
+    const auto waited = now - created_;
+    AddCheck(report, waited <= config_.startup_grace, "tick",
+             "no tick yet after " + Seconds(waited));
+  } else {
+    const auto silence = now - *last_tick;
+    AddCheck(report, silence <= config_.tick_stall, "tick",
+             "last tick " + Seconds(silence) + " ago");
+  }
+  return report;
+}
+
+HealthReport HealthChecks::Readiness() const {
+  HealthReport report = Liveness();
+  const bool worlds = worlds_loaded_.load(std::memory_order_relaxed);
+  AddCheck(report, worlds, "worlds", worlds ? "loaded" : "not loaded");
+  const bool logins = accepting_logins_.load(std::memory_order_relaxed);
+  AddCheck(report, logins, "logins", logins ? "accepted" : "not accepted");
+
+  const double mspt = metrics_.MillisecondsPerTick();
+  char detail[64];
+  std::snprintf(detail, sizeof(detail), "%.1f ms (limit %.1f ms)", mspt, config_.max_mspt);
+  AddCheck(report, mspt <= config_.max_mspt, "mspt", detail);
+  return report;
+}
+
+void HealthChecks::Serve(Network::HttpServer& server) const {
+  server.Handle("/healthz", [this](const Network::HttpRequest&) { return ToResponse(Liveness()); });
+  server.Handle("/readyz", [this](const Network::HttpRequest&) { return ToResponse(Readiness()); });
+}
+
+}  // namespace Util
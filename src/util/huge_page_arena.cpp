@@ -0,0 +1,53 @@
+#include "util/huge_page_arena.h"
+
+#include <algorithm>
+#include <new>
+
+namespace Util {
+
+HugePageArena::HugePageArena(size_t region_size) : region_size_(region_size) {}
+
+HugePageArena::~HugePageArena() {
+  for (const Platform::PageAllocation& region : regions_) {
+    Platform::FreeHugePages(region);
+  }
+}
+
+void* HugePageArena::Allocate(size_t size, size_t alignment) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!regions_.empty()) {
+    const Platform::PageAllocation& region = regions_.back();
+    const auto base = reinterpret_cast<uintptr_t>(region.address);
+    const uintptr_t aligned = (base + offset_ + alignment - 1) & ~(uintptr_t{alignment} - 1);
+    const size_t end = static_cast<size_t>(aligned - base) + size;
+    if (end <= region.size) {
+      stats_.bytes_used += end - offset_;
+      offset_ = end;
+      return reinterpret_cast<void*>(aligned);
+    }
+  }
+
+  // The rest of the current region is abandoned; regions are large enough for that not to matter
+  Platform::PageAllocation region = Platform::AllocateHugePages(std::max(region_size_, size + alignment));
+  if (region.address == nullptr) {
+    throw std::bad_alloc();
+  }
+  regions_.push_back(region);
+  ++stats_.regions;
+  stats_.huge_regions += region.huge_pages ? 1 : 0;
+  stats_.bytes_reserved += region.size;
+
+  // Regions are HUGE_PAGE_SIZE aligned (64 KiB on the Windows fallback)
+  const auto base = reinterpret_cast<uintptr_t>(region.address);
+  const uintptr_t aligned = (base + alignment - 1) & ~(uintptr_t{alignment} - 1);
+  offset_ = static_cast<size_t>(aligned - base) + size;
+  stats_.bytes_used += offset_;
+  return reinterpret_cast<void*>(aligned);
+}
+
+HugePageArenaStats HugePageArena::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace Util
@@ -0,0 +1,118 @@
+#include "util/identifier.h"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace Util {
+
+namespace {
+
+/** @brief Process-wide interning table */
+struct IdentifierTable {
+  mutable std::shared_mutex mutex;
+  std::deque<std::string> names;  ///< Indexed by handle; a deque keeps the keys below stable
+  std::unordered_map<std::string_view, uint32_t> by_name;
+};
+
+IdentifierTable& Table() {
+  // Never destroyed: identifiers may be resolved from static destructors
+  static IdentifierTable* table = new IdentifierTable();
+  return *table;
+}
+
+bool IsNamespaceChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '.';
+}
+
+bool IsWellFormed(std::string_view name) {
+  const size_t colon = name.find(':');
+  if (colon == 0 || colon == std::string_view::npos || colon + 1 == name.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < name.size(); ++i) {
+    if (i != colon && !IsNamespaceChar(name[i]) && !(i > colon && name[i] == '/')) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** @brief Add the default namespace when @p name has none */
+std::string_view Qualify(std::string_view name, std::string& storage) {
+  if (name.find(':') != std::string_view::npos) {
+    return name;
+  }
+  storage.reserve(DEFAULT_NAMESPACE.size() + 1 + name.size());
+  storage.append(DEFAULT_NAMESPACE).append(1, ':').append(name);
+  return storage;
+}
+
+}  // namespace
+
+Identifier Identifier::Intern(std::string_view name) {
+  std::string storage;
+  const std::string_view qualified = Qualify(name, storage);
+  IdentifierTable& table = Table();
+  {
+    std::shared_lock lock(table.mutex);
+    if (auto it = table.by_name.find(qualified); it != table.by_name.end()) {
+      return Identifier(it->second);
+    }
+  }
+  if (!IsWellFormed(qualified)) {
+    throw std::invalid_argument("invalid identifier: " + std::string(name));
+  }
+  std::unique_lock lock(table.mutex);
+  if (auto it = table.by_name.find(qualified); it != table.by_name.end()) {
+    return Identifier(it->second);
+  }
+  const auto index = static_cast<uint32_t>(table.names.size());
+  const std::string& stored = table.names.emplace_back(qualified);
+  table.by_name.emplace(stored, index);
+  return Identifier(index);
+}
+
+std::optional<Identifier> Identifier::Find(std::string_view name) {
+  std::string storage;
+  const std::string_view qualified = Qualify(name, storage);
+  IdentifierTable& table = Table();
+  std::shared_lock lock(table.mutex);
+  auto it = table.by_name.find(qualified);
+  if (it == table.by_name.end()) {
+    return std::nullopt;
+  }
+  return Identifier(it->second);
+}
+
+size_t Identifier::TableSize() {
+  IdentifierTable& table = Table();
+  std::shared_lock lock(table.mutex);
+  return table.names.size();
+}
+
+std::string_view Identifier::Name() const {
+  if (!IsValid()) {
+    return {};
+  }
+  IdentifierTable& table = Table();
+  std::shared_lock lock(table.mutex);
+  // The string itself never moves, so the view outlives the lock
+  return table.names[index_];
+}
+
+std::string_view Identifier::Namespace() const {
+  const std::string_view name = Name();
+  return name.substr(0, name.find(':'));
+}
+
+std::string_view Identifier::Path() const {
+  const std::string_view name = Name();
+  const size_t colon = name.find(':');
+  return colon == std::string_view::npos ? std::string_view{} : name.substr(colon + 1);
+}
+
+}  // namespace Util
@@ -0,0 +1,143 @@
+#include "util/latency_histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Util {
+
+namespace {
+
+constexpr uint64_t SUB_BUCKETS = uint64_t{1} << LATENCY_SUB_BUCKET_BITS;
+constexpr uint64_t LARGEST_TRACKED = (uint64_t{1} << LATENCY_RANGE_BITS) - 1;
+
+std::atomic<uint32_t> next_histogram_id{0};
+
+/** @brief @p total minus the totals at @p start, with the maximum at bucket precision */
+LatencySnapshot Difference(const LatencySnapshot& total, const LatencySnapshot& start) {
+  LatencySnapshot difference;
+  difference.count = total.count - start.count;
+  difference.sum_ns = total.sum_ns - start.sum_ns;
+  for (size_t i = 0; i < LATENCY_BUCKETS; ++i) {
+    difference.buckets[i] = total.buckets[i] - start.buckets[i];
+    if (difference.buckets[i] != 0) {
+      difference.max_ns = std::min(LatencyHistogram::BucketUpperBound(i), total.max_ns);
+    }
+  }
+  return difference;
+}
+
+}  // namespace
+
+uint64_t LatencySnapshot::Percentile(double percentile) const {
+  if (count == 0) {
+    return 0;
+  }
+  const auto target = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 *
+                                         static_cast<double>(count))));
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < LATENCY_BUCKETS; ++i) {
+    cumulative += buckets[i];
+    if (cumulative >= target) {
+      return std::min(LatencyHistogram::BucketUpperBound(i), max_ns);
+    }
+  }
+  return max_ns;
+}
+
+struct LatencyHistogram::Shard {
+  std::array<std::atomic<uint64_t>, LATENCY_BUCKETS> buckets{};
+  std::atomic<uint64_t> sum_ns{0};
+  std::atomic<uint64_t> max_ns{0};
+};
+
+LatencyHistogram::LatencyHistogram(std::chrono::steady_clock::duration window)
+    : id_(next_histogram_id.fetch_add(1, std::memory_order_relaxed)),
+      window_(window),
+      window_rotated_(std::chrono::steady_clock::now()) {}
+
+LatencyHistogram::~LatencyHistogram() = default;
+
+size_t LatencyHistogram::BucketIndex(uint64_t nanoseconds) {
+  const uint64_t value = std::min(nanoseconds, LARGEST_TRACKED);
+  if (value < SUB_BUCKETS) {
+    return static_cast<size_t>(value);
+  }
+  // value lies in [2^(bits + group - 1), 2^(bits + group)), split into SUB_BUCKETS steps
+  const auto group = static_cast<uint32_t>(std::bit_width(value)) - LATENCY_SUB_BUCKET_BITS;
+  return static_cast<size_t>(group * SUB_BUCKETS + (value >> (group - 1)) - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t bucket) {
+  if (bucket < SUB_BUCKETS) {
+    return bucket;
+  }
+  const uint64_t group = bucket / SUB_BUCKETS;
+  const uint64_t lower = (bucket % SUB_BUCKETS + SUB_BUCKETS) << (group - 1);
+  return lower + (uint64_t{1} << (group - 1)) - 1;
+}
+
+LatencyHistogram::Shard& LatencyHistogram::LocalShard() {
+  // Indexed by histogram id; ids are never reused, so entries of destroyed histograms are
+  // simply never looked up again
+  thread_local std::vector<Shard*> cache;
+  if (id_ < cache.size() && cache[id_] != nullptr) {
+    return *cache[id_];
+  }
+  auto shard = std::make_unique<Shard>();
+  Shard* local = shard.get();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shards_.push_back(std::move(shard));
+  }
+  if (cache.size() <= id_) {
+    cache.resize(id_ + 1, nullptr);
+  }
+  cache[id_] = local;
+  return *local;
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds latency) noexcept {
+  const uint64_t value = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+  Shard& shard = LocalShard();
+  // Single writer per shard: plain loads and stores, no read-modify-write
+  std::atomic<uint64_t>& bucket = shard.buckets[BucketIndex(value)];
+  bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  shard.sum_ns.store(shard.sum_ns.load(std::memory_order_relaxed) + value,
+                     std::memory_order_relaxed);
+  if (value > shard.max_ns.load(std::memory_order_relaxed)) {
+    shard.max_ns.store(value, std::memory_order_relaxed);
+  }
+}
+
+LatencySnapshot LatencyHistogram::Merge() const {
+  LatencySnapshot snapshot;
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    for (size_t i = 0; i < LATENCY_BUCKETS; ++i) {
+      snapshot.buckets[i] += shard->buckets[i].load(std::memory_order_relaxed);
+    }
+    snapshot.sum_ns += shard->sum_ns.load(std::memory_order_relaxed);
+    snapshot.max_ns = std::max(snapshot.max_ns, shard->max_ns.load(std::memory_order_relaxed));
+  }
+  for (const uint64_t count : snapshot.buckets) {
+    snapshot.count += count;
+  }
+  return snapshot;
+}
+
+LatencyReading LatencyHistogram::Read() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LatencyReading reading;
+  reading.total = Merge();
+  const auto now = std::chrono::steady_clock::now();
+  if (now - window_rotated_ >= window_) {
+    window_start_ = std::move(window_next_);
+    window_next_ = reading.total;
+    window_rotated_ = now;
+  }
+  reading.recent = Difference(reading.total, window_start_);
+  return reading;
+}
+
+}  // namespace Util
@@ -0,0 +1,144 @@
+#include "util/latency_metrics.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <fmt/format.h>
+
+namespace Util {
+
+namespace {
+
+constexpr std::string_view TICK_PHASE_NAME = "parellelstone_tick_phase_seconds";
+constexpr std::string_view TICK_PHASE_HELP = "Time spent in each tick phase";
+constexpr std::string_view PACKET_NAME = "parellelstone_packet_handling_seconds";
+constexpr std::string_view PACKET_HELP = "Serverbound packet handler latency, per play packet id";
+
+/** @brief Exposed quantiles; 1 is the window's maximum */
+constexpr double QUANTILES[] = {0.5, 0.99, 0.999, 1.0};
+
+double Seconds(uint64_t nanoseconds) { return static_cast<double>(nanoseconds) * 1e-9; }
+
+void RegisterSummary(MetricsRegistry& registry, std::string_view name, std::string_view help,
+                     MetricLabels labels, const LatencyHistogram& histogram) {
+  registry.AddSummaryCallback(std::string(name), std::string(help), std::move(labels),
+                              [&histogram] {
+                                const LatencyReading reading = histogram.Read();
+                                MetricSummary summary;
+                                for (const double quantile : QUANTILES) {
+                                  summary.quantiles.emplace_back(
+                                      quantile,
+                                      Seconds(reading.recent.Percentile(quantile * 100.0)));
+                                }
+                                summary.sum = Seconds(reading.total.sum_ns);
+                                summary.count = reading.total.count;
+                                return summary;
+                              });
+}
+
+std::string PacketIdName(int32_t packet_id) { return fmt::format("0x{:02X}", packet_id); }
+
+LatencyLine Summarize(std::string name, const LatencyHistogram& histogram) {
+  const LatencySnapshot recent = histogram.Read().recent;
+  LatencyLine line;
+  line.name = std::move(name);
+  line.samples = recent.count;
+  line.p50_ns = recent.Percentile(50.0);
+  line.p99_ns = recent.Percentile(99.0);
+  line.p999_ns = recent.Percentile(99.9);
+  line.max_ns = recent.max_ns;
+  return line;
+}
+
+}  // namespace
+
+LatencyMetrics::LatencyMetrics(MetricsRegistry& registry,
+                               std::chrono::steady_clock::duration window)
+    : registry_(registry), window_(window), join_(window), chunk_delivery_(window) {
+  RegisterSummary(registry_, "parellelstone_join_seconds",
+                  "Time from login start until the player is in the world", {}, join_);
+  RegisterSummary(registry_, "parellelstone_chunk_delivery_seconds",
+                  "Time from a chunk entering view until its packet is sent", {},
+                  chunk_delivery_);
+}
+
+LatencyMetrics::~LatencyMetrics() = default;
+
+LatencyHistogram& LatencyMetrics::TickPhase(std::string_view phase) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const Named& named : phases_) {
+    if (named.name == phase) {
+      return *named.histogram;
+    }
+  }
+  auto histogram = std::make_unique<LatencyHistogram>(window_);
+  RegisterSummary(registry_, TICK_PHASE_NAME, TICK_PHASE_HELP, {{"phase", std::string(phase)}},
+                  *histogram);
+  phases_.push_back({std::string(phase), std::move(histogram)});
+  return *phases_.back().histogram;
+}
+
+void LatencyMetrics::RecordPacket(int32_t packet_id, std::chrono::nanoseconds latency) {
+  if (packet_id < 0 || packet_id >= LATENCY_PACKET_IDS) {
+    return;
+  }
+  LatencyHistogram* histogram = packets_[packet_id].load(std::memory_order_acquire);
+  if (histogram == nullptr) {
+    histogram = &AddPacket(packet_id);
+  }
+  histogram->Record(latency);
+}
+
+LatencyHistogram& LatencyMetrics::AddPacket(int32_t packet_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Another thread may have won the race for this id
+  if (LatencyHistogram* existing = packets_[packet_id].load(std::memory_order_relaxed)) {
+    return *existing;
+  }
+  auto histogram = std::make_unique<LatencyHistogram>(window_);
+  RegisterSummary(registry_, PACKET_NAME, PACKET_HELP, {{"packet_id", PacketIdName(packet_id)}},
+                  *histogram);
+  LatencyHistogram* added = histogram.get();
+  packet_histograms_.push_back({PacketIdName(packet_id), std::move(histogram)});
+  packets_[packet_id].store(added, std::memory_order_release);
+  return *added;
+}
+
+std::vector<LatencyLine> LatencyMetrics::Report(LatencyCategory category) const {
+  std::vector<LatencyLine> lines;
+  const auto add = [&lines](std::string name, const LatencyHistogram& histogram) {
+    LatencyLine line = Summarize(std::move(name), histogram);
+    if (line.samples != 0) {
+      lines.push_back(std::move(line));
+    }
+  };
+  switch (category) {
+    case LatencyCategory::TICK_PHASES: {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const Named& named : phases_) {
+        add(named.name, *named.histogram);
+      }
+      break;
+    }
+    case LatencyCategory::PACKETS: {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const Named& named : packet_histograms_) {
+        add(named.name, *named.histogram);
+      }
+      // Worst tail first
+      std::sort(lines.begin(), lines.end(), [](const LatencyLine& a, const LatencyLine& b) {
+        return a.p99_ns > b.p99_ns;
+      });
+      break;
+    }
+    case LatencyCategory::JOIN:
+      add("join", join_);
+      break;
+    case LatencyCategory::CHUNK_DELIVERY:
+      add("chunk delivery", chunk_delivery_);
+      break;
+  }
+  return lines;
+}
+
+}  // namespace Util
@@ -0,0 +1,206 @@
+#include "util/memory_accounting.h"
+
+#include <atomic>
+#include <charconv>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace Util {
+
+namespace {
+
+/** @brief Counters of one subsystem, on their own cache line */
+struct alignas(64) Account {
+  std::atomic<int64_t> live{0};
+  std::atomic<int64_t> peak{0};
+  std::atomic<uint64_t> allocations{0};
+  std::atomic<uint64_t> budget{0};
+  std::atomic<uint64_t> pressure_events{0};
+};
+
+std::array<Account, MEMORY_SUBSYSTEM_COUNT> accounts;
+
+/**
+ * @brief Net bytes a thread accumulates before publishing them
+ *
+ * Keeps the shared counters off the allocator hot path; live bytes are
+ * exact to within this much per thread and subsystem.
+ */
+constexpr int64_t FLUSH_BYTES = 64 * 1024;
+
+/** @brief Allocations after which a thread publishes even when its net bytes stayed flat */
+constexpr uint64_t FLUSH_ALLOCATIONS = 4096;
+
+/** @brief Unpublished counts of one thread; trivially destructible so it stays usable at exit */
+struct LocalAccount {
+  int64_t delta = 0;
+  uint64_t allocations = 0;
+};
+thread_local std::array<LocalAccount, MEMORY_SUBSYSTEM_COUNT> local_accounts{};
+thread_local bool local_flusher_registered = false;
+
+std::mutex handler_mutex;
+std::array<MemoryPressureHandler, MEMORY_SUBSYSTEM_COUNT> handlers;
+
+Account& AccountOf(MemorySubsystem subsystem) { return accounts[static_cast<size_t>(subsystem)]; }
+
+void Publish(Account& account, LocalAccount& local) {
+  const int64_t live = account.live.fetch_add(local.delta, std::memory_order_relaxed) + local.delta;
+  account.allocations.fetch_add(local.allocations, std::memory_order_relaxed);
+  local.delta = 0;
+  local.allocations = 0;
+  int64_t peak = account.peak.load(std::memory_order_relaxed);
+  while (live > peak &&
+         !account.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+/** @brief Publishes the thread's remaining counts when it exits */
+struct LocalFlusher {
+  ~LocalFlusher() {
+    for (size_t i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+      Publish(accounts[i], local_accounts[i]);
+    }
+  }
+};
+thread_local LocalFlusher local_flusher;
+
+/** @brief The thread's counts of @p subsystem, registering the exit flush on first use */
+LocalAccount& LocalAccountOf(MemorySubsystem subsystem) {
+  if (!local_flusher_registered) [[unlikely]] {
+    // Touching the flusher registers its destructor for this thread, so
+    // counts below the publish thresholds are not lost when the thread exits
+    (void)&local_flusher;
+    local_flusher_registered = true;
+  }
+  return local_accounts[static_cast<size_t>(subsystem)];
+}
+
+}  // namespace
+
+std::string_view MemorySubsystemName(MemorySubsystem subsystem) {
+  switch (subsystem) {
+    case MemorySubsystem::CHUNKS:
+      return "chunks";
+    case MemorySubsystem::ENTITIES:
+      return "entities";
+    case MemorySubsystem::NETWORK:
+      return "network";
+    case MemorySubsystem::CACHES:
+      return "caches";
+    case MemorySubsystem::PLUGINS:
+      return "plugins";
+    case MemorySubsystem::OTHER:
+      break;
+  }
+  return "other";
+}
+
+void TrackAllocation(MemorySubsystem subsystem, size_t bytes) noexcept {
+  LocalAccount& local = LocalAccountOf(subsystem);
+  local.delta += static_cast<int64_t>(bytes);
+  ++local.allocations;
+  if (local.delta >= FLUSH_BYTES || local.allocations >= FLUSH_ALLOCATIONS) {
+    Publish(AccountOf(subsystem), local);
+  }
+}
+
+void TrackRelease(MemorySubsystem subsystem, size_t bytes) noexcept {
+  LocalAccount& local = LocalAccountOf(subsystem);
+  local.delta -= static_cast<int64_t>(bytes);
+  if (local.delta <= -FLUSH_BYTES) {
+    Publish(AccountOf(subsystem), local);
+  }
+}
+
+void SetMemoryBudget(MemorySubsystem subsystem, uint64_t bytes) {
+  AccountOf(subsystem).budget.store(bytes, std::memory_order_relaxed);
+}
+
+bool OverMemoryBudget(MemorySubsystem subsystem) noexcept {
+  const Account& account = AccountOf(subsystem);
+  const uint64_t budget = account.budget.load(std::memory_order_relaxed);
+  return budget != 0 &&
+         account.live.load(std::memory_order_relaxed) > static_cast<int64_t>(budget);
+}
+
+MemoryUsage GetMemoryUsage(MemorySubsystem subsystem) {
+  const Account& account = AccountOf(subsystem);
+  MemoryUsage usage;
+  usage.subsystem = subsystem;
+  usage.live_bytes = account.live.load(std::memory_order_relaxed);
+  usage.peak_bytes = account.peak.load(std::memory_order_relaxed);
+  usage.allocations = account.allocations.load(std::memory_order_relaxed);
+  usage.budget_bytes = account.budget.load(std::memory_order_relaxed);
+  usage.pressure_events = account.pressure_events.load(std::memory_order_relaxed);
+  return usage;
+}
+
+std::array<MemoryUsage, MEMORY_SUBSYSTEM_COUNT> GetAllMemoryUsage() {
+  std::array<MemoryUsage, MEMORY_SUBSYSTEM_COUNT> usage;
+  for (size_t i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+    usage[i] = GetMemoryUsage(static_cast<MemorySubsystem>(i));
+  }
+  return usage;
+}
+
+void SetMemoryPressureHandler(MemorySubsystem subsystem, MemoryPressureHandler handler) {
+  std::lock_guard<std::mutex> lock(handler_mutex);
+  handlers[static_cast<size_t>(subsystem)] = std::move(handler);
+}
+
+size_t EnforceMemoryBudgets() {
+  size_t called = 0;
+  for (size_t i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+    const auto subsystem = static_cast<MemorySubsystem>(i);
+    if (!OverMemoryBudget(subsystem)) {
+      continue;
+    }
+    MemoryPressureHandler handler;
+    {
+      std::lock_guard<std::mutex> lock(handler_mutex);
+      handler = handlers[i];
+    }
+    if (!handler) {
+      continue;
+    }
+    Account& account = accounts[i];
+    const int64_t excess = account.live.load(std::memory_order_relaxed) -
+                           static_cast<int64_t>(account.budget.load(std::memory_order_relaxed));
+    if (excess <= 0) {
+      continue;
+    }
+    account.pressure_events.fetch_add(1, std::memory_order_relaxed);
+    handler(static_cast<uint64_t>(excess));
+    ++called;
+  }
+  return called;
+}
+
+uint64_t ParseByteSize(std::string_view text) {
+  uint64_t value = 0;
+  const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+  if (error != std::errc() || end == text.data()) {
+    throw std::invalid_argument("not a byte size: " + std::string(text));
+  }
+  const std::string_view suffix(end, static_cast<size_t>(text.data() + text.size() - end));
+  int shift = 0;
+  if (suffix.empty() || suffix == "B" || suffix == "b") {
+    shift = 0;
+  } else if (suffix == "K" || suffix == "k" || suffix == "KiB") {
+    shift = 10;
+  } else if (suffix == "M" || suffix == "m" || suffix == "MiB") {
+    shift = 20;
+  } else if (suffix == "G" || suffix == "g" || suffix == "GiB") {
+    shift = 30;
+  } else {
+    throw std::invalid_argument("unknown byte size suffix: " + std::string(text));
+  }
+  if (shift != 0 && value > (UINT64_MAX >> shift)) {
+    throw std::invalid_argument("byte size out of range: " + std::string(text));
+  }
+  return value << shift;
+}
+
+}  // namespace Util
@@ -0,0 +1,350 @@
+#include "util/memory_pressure.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "platform.h"
+#include "util/global_allocator.h"
+
+#ifdef PLATFORM_WINDOWS
+#include <psapi.h>
+#endif
+
+namespace Util {
+
+namespace {
+
+/** @brief cgroup v1 reports "no limit" as a page-rounded INT64_MAX */
+constexpr uint64_t UNLIMITED_THRESHOLD = uint64_t{1} << 60;
+
+const char* const CGROUP_ROOT = "/sys/fs/cgroup";
+const char* const SYSTEM_PSI = "/proc/pressure/memory";
+
+/** @brief First number in a file, or 0 when missing or not numeric ("max") */
+uint64_t ReadNumber(const std::filesystem::path& path) {
+  std::ifstream file(path);
+  uint64_t value = 0;
+  file >> value;
+  return file ? value : 0;
+}
+
+/** @brief Value of one key in a memory.stat style "key value" file */
+uint64_t ReadStat(const std::filesystem::path& path, std::string_view key) {
+  std::ifstream file(path);
+  std::string name;
+  uint64_t value = 0;
+  while (file >> name >> value) {
+    if (name == key) {
+      return value;
+    }
+  }
+  return 0;
+}
+
+/** @brief avg10 of the "some" and "full" lines of a PSI file */
+void ReadPsi(const std::filesystem::path& path, MemoryPressureSample& sample) {
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    double avg10 = 0;
+    if (std::sscanf(line.c_str(), "some avg10=%lf", &avg10) == 1) {
+      sample.psi_some_avg10 = avg10;
+    } else if (std::sscanf(line.c_str(), "full avg10=%lf", &avg10) == 1) {
+      sample.psi_full_avg10 = avg10;
+    }
+  }
+}
+
+/**
+ * @brief Locate the memory cgroup of this process
+ *
+ * Inside a cgroup namespace the path in /proc/self/cgroup does not exist
+ * under the mount, whose root already is the container's group, so the
+ * mount root is tried as well.
+ */
+std::filesystem::path DetectCgroup(bool& v2) {
+  std::ifstream file("/proc/self/cgroup");
+  std::string line;
+  std::string v1_path, v2_path;
+  while (std::getline(file, line)) {
+    const size_t first = line.find(':');
+    const size_t second = line.find(':', first + 1);
+    if (first == std::string::npos || second == std::string::npos) {
+      continue;
+    }
+    const std::string controllers = line.substr(first + 1, second - first - 1);
+    const std::string path = line.substr(second + 1);
+    if (controllers.empty()) {
+      v2_path = path;
+    } else {
+      std::stringstream list(controllers);
+      std::string controller;
+      while (std::getline(list, controller, ',')) {
+        if (controller == "memory") {
+          v1_path = path;
+        }
+      }
+    }
+  }
+
+  // The group's own directory, then the mount root
+  auto find = [](const std::filesystem::path& mount, const std::string& path, const char* probe) {
+    std::error_code error;
+    const std::filesystem::path own = mount / std::filesystem::path(path).relative_path();
+    for (const std::filesystem::path& dir : {own, mount}) {
+      if (std::filesystem::exists(dir / probe, error)) {
+        return dir;
+      }
+    }
+    return std::filesystem::path();
+  };
+  if (!v2_path.empty()) {
+    if (std::filesystem::path dir = find(CGROUP_ROOT, v2_path, "memory.current"); !dir.empty()) {
+      v2 = true;
+      return dir;
+    }
+  }
+  if (!v1_path.empty()) {
+    const std::filesystem::path mount = std::filesystem::path(CGROUP_ROOT) / "memory";
+    if (std::filesystem::path dir = find(mount, v1_path, "memory.usage_in_bytes"); !dir.empty()) {
+      v2 = false;
+      return dir;
+    }
+  }
+  return {};
+}
+
+uint64_t PhysicalMemory() {
+#ifdef PLATFORM_WINDOWS
+  MEMORYSTATUSEX status{};
+  status.dwLength = sizeof(status);
+  return ::GlobalMemoryStatusEx(&status) ? status.ullTotalPhys : 0;
+#else
+  const long pages = ::sysconf(_SC_PHYS_PAGES);
+  const long page_size = ::sysconf(_SC_PAGESIZE);
+  return pages > 0 && page_size > 0 ? static_cast<uint64_t>(pages) * page_size : 0;
+#endif
+}
+
+uint64_t ProcessResident() {
+#ifdef PLATFORM_WINDOWS
+  PROCESS_MEMORY_COUNTERS counters{};
+  return ::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters))
+             ? counters.WorkingSetSize
+             : 0;
+#elif defined(PLATFORM_LINUX)
+  std::ifstream file("/proc/self/statm");
+  uint64_t size = 0, resident = 0;
+  file >> size >> resident;
+  return resident * static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+#else
+  return 0;
+#endif
+}
+
+}  // namespace
+
+std::string_view MemoryPressureLevelName(MemoryPressureLevel level) {
+  switch (level) {
+    case MemoryPressureLevel::NONE:
+      return "none";
+    case MemoryPressureLevel::MODERATE:
+      return "moderate";
+    case MemoryPressureLevel::CRITICAL:
+      return "critical";
+  }
+  return "none";
+}
+
+MemoryPressureMonitor::MemoryPressureMonitor(MemoryPressureConfig config)
+    : config_(std::move(config)) {
+#ifdef PLATFORM_LINUX
+  if (config_.cgroup_dir.empty()) {
+    cgroup_dir_ = DetectCgroup(cgroup_v2_);
+  } else {
+    cgroup_dir_ = config_.cgroup_dir;
+    std::error_code error;
+    cgroup_v2_ = std::filesystem::exists(cgroup_dir_ / "memory.current", error);
+  }
+#endif
+}
+
+MemoryPressureMonitor::~MemoryPressureMonitor() { Stop(); }
+
+void MemoryPressureMonitor::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (thread_.joinable()) {
+    return;
+  }
+  stopping_ = false;
+  thread_ = std::thread([this] { Loop(); });
+}
+
+void MemoryPressureMonitor::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (budgets_overridden_) {
+    ApplyBudgets(MemoryPressureLevel::NONE);
+  }
+}
+
+MemoryPressureSample MemoryPressureMonitor::Update() {
+  MemoryPressureSample sample = Read();
+  std::vector<Listener> listeners;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sample.level = Classify(sample);
+    last_ = sample;
+    const MemoryPressureLevel previous = level_.exchange(sample.level, std::memory_order_relaxed);
+    if (sample.level == previous) {
+      return sample;
+    }
+    if (config_.adjust_budgets) {
+      ApplyBudgets(sample.level);
+    }
+    listeners = listeners_;
+  }
+  const auto level_log = sample.level > MemoryPressureLevel::NONE ? spdlog::level::warn
+                                                                  : spdlog::level::info;
+  spdlog::log(level_log,
+              "Memory pressure {}: working set {} MiB of {} MiB, PSI some {:.1f}% full {:.1f}%",
+              MemoryPressureLevelName(sample.level), sample.working_set_bytes >> 20,
+              sample.limit_bytes >> 20, sample.psi_some_avg10, sample.psi_full_avg10);
+  for (const Listener& listener : listeners) {
+    listener(sample.level);
+  }
+  if (sample.level == MemoryPressureLevel::CRITICAL) {
+    TrimGlobalAllocator();
+  }
+  return sample;
+}
+
+MemoryPressureSample MemoryPressureMonitor::LastSample() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return last_;
+}
+
+void MemoryPressureMonitor::AddListener(Listener listener) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  listeners_.push_back(std::move(listener));
+}
+
+MemoryPressureSample MemoryPressureMonitor::Read() const {
+  MemoryPressureSample sample;
+  if (!cgroup_dir_.empty()) {
+    sample.cgroup = true;
+    uint64_t usage, limit, inactive_file;
+    if (cgroup_v2_) {
+      usage = ReadNumber(cgroup_dir_ / "memory.current");
+      limit = ReadNumber(cgroup_dir_ / "memory.max");
+      inactive_file = ReadStat(cgroup_dir_ / "memory.stat", "inactive_file");
+    } else {
+      usage = ReadNumber(cgroup_dir_ / "memory.usage_in_bytes");
+      limit = ReadNumber(cgroup_dir_ / "memory.limit_in_bytes");
+      inactive_file = ReadStat(cgroup_dir_ / "memory.stat", "total_inactive_file");
+    }
+    // Inactive page cache is reclaimed before the OOM killer runs
+    sample.working_set_bytes = usage > inactive_file ? usage - inactive_file : 0;
+    sample.limit_bytes = limit >= UNLIMITED_THRESHOLD ? 0 : limit;
+  } else {
+    sample.working_set_bytes = ProcessResident();
+  }
+  if (config_.limit_bytes != 0) {
+    sample.limit_bytes = config_.limit_bytes;
+  } else if (sample.limit_bytes == 0) {
+    sample.limit_bytes = PhysicalMemory();
+  }
+
+#ifdef PLATFORM_LINUX
+  std::error_code error;
+  if (cgroup_v2_ && std::filesystem::exists(cgroup_dir_ / "memory.pressure", error)) {
+    ReadPsi(cgroup_dir_ / "memory.pressure", sample);
+  } else {
+    ReadPsi(SYSTEM_PSI, sample);
+  }
+#endif
+  return sample;
+}
+
+MemoryPressureLevel MemoryPressureMonitor::Classify(const MemoryPressureSample& sample) const {
+  const MemoryPressureLevel current = level_.load(std::memory_order_relaxed);
+  const double ratio = sample.limit_bytes == 0
+                           ? 0.0
+                           : static_cast<double>(sample.working_set_bytes) / sample.limit_bytes;
+  // A level is left only once the ratio is a margin below the threshold that entered it
+  auto threshold = [&](double value, MemoryPressureLevel level) {
+    return current >= level ? value - config_.recovery_margin : value;
+  };
+  if (ratio >= threshold(config_.critical_ratio, MemoryPressureLevel::CRITICAL) ||
+      sample.psi_full_avg10 >= config_.critical_psi) {
+    return MemoryPressureLevel::CRITICAL;
+  }
+  if (ratio >= threshold(config_.moderate_ratio, MemoryPressureLevel::MODERATE) ||
+      sample.psi_some_avg10 >= config_.moderate_psi) {
+    return MemoryPressureLevel::MODERATE;
+  }
+  return MemoryPressureLevel::NONE;
+}
+
+void MemoryPressureMonitor::ApplyBudgets(MemoryPressureLevel level) {
+  if (level == MemoryPressureLevel::NONE) {
+    for (size_t i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+      SetMemoryBudget(static_cast<MemorySubsystem>(i), saved_budgets_[i]);
+    }
+    budgets_overridden_ = false;
+    return;
+  }
+  if (!budgets_overridden_) {
+    for (size_t i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+      saved_budgets_[i] = GetMemoryUsage(static_cast<MemorySubsystem>(i)).budget_bytes;
+    }
+    budgets_overridden_ = true;
+  }
+
+  // Budget below current use, never above what the operator configured
+  auto tighten = [&](MemorySubsystem subsystem, uint64_t target) {
+    const uint64_t saved = saved_budgets_[static_cast<size_t>(subsystem)];
+    target = std::max<uint64_t>(target, 1);
+    SetMemoryBudget(subsystem, saved == 0 ? target : std::min(saved, target));
+  };
+  auto live = [](MemorySubsystem subsystem) {
+    return static_cast<uint64_t>(std::max<int64_t>(GetMemoryUsage(subsystem).live_bytes, 0));
+  };
+
+  const bool critical = level == MemoryPressureLevel::CRITICAL;
+  // Caches rebuild on demand: halve them, or drop them entirely when critical
+  tighten(MemorySubsystem::CACHES, critical ? 1 : live(MemorySubsystem::CACHES) / 2);
+  if (critical) {
+    // The packet pool stops keeping idle buffers, unused chunks are evicted
+    tighten(MemorySubsystem::NETWORK, 1);
+    tighten(MemorySubsystem::CHUNKS, live(MemorySubsystem::CHUNKS) / 10 * 9);
+  } else {
+    for (MemorySubsystem subsystem : {MemorySubsystem::NETWORK, MemorySubsystem::CHUNKS}) {
+      SetMemoryBudget(subsystem, saved_budgets_[static_cast<size_t>(subsystem)]);
+    }
+  }
+}
+
+void MemoryPressureMonitor::Loop() {
+  for (;;) {
+    Update();
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (wake_.wait_for(lock, config_.interval, [this] { return stopping_; })) {
+      return;
+    }
+  }
+}
+
+}  // namespace Util
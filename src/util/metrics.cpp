@@ -0,0 +1,418 @@
+#include "util/metrics.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace Util {
+
+namespace {
+
+/** @brief Slots per lazily allocated block of a shard */
+constexpr size_t BLOCK_SLOTS = 256;
+constexpr size_t SHARD_BLOCKS = METRIC_SLOTS / BLOCK_SLOTS;
+
+struct SlotBlock {
+  std::array<std::atomic<uint64_t>, BLOCK_SLOTS> values{};
+};
+
+/** @brief Counter slots written by one thread; blocks appear as the thread touches them */
+struct Shard {
+  std::array<std::atomic<SlotBlock*>, SHARD_BLOCKS> blocks{};
+
+  ~Shard() {
+    for (std::atomic<SlotBlock*>& block : blocks) {
+      delete block.load(std::memory_order_relaxed);
+    }
+  }
+
+  std::atomic<uint64_t>& Slot(uint32_t slot) {
+    std::atomic<SlotBlock*>& entry = blocks[slot / BLOCK_SLOTS];
+    SlotBlock* block = entry.load(std::memory_order_relaxed);
+    if (block == nullptr) {
+      // Only the owning thread allocates; scrapers pick the block up with acquire
+      block = new SlotBlock();
+      entry.store(block, std::memory_order_release);
+    }
+    return block->values[slot % BLOCK_SLOTS];
+  }
+};
+
+struct ShardList {
+  std::mutex mutex;
+  std::vector<Shard*> live;
+  Shard retired;  ///< Totals of threads that exited
+};
+
+ShardList& Shards() {
+  // Never destroyed: threads may still exit and retire their shard during static destruction
+  static ShardList* list = new ShardList();
+  return *list;
+}
+
+std::atomic<uint32_t> next_slot{0};
+
+uint32_t AllocateSlots(size_t count) {
+  const uint32_t first =
+      next_slot.fetch_add(static_cast<uint32_t>(count), std::memory_order_relaxed);
+  if (first + count > METRIC_SLOTS) {
+    throw std::length_error("Out of metric counter slots");
+  }
+  return first;
+}
+
+thread_local Shard* local_shard = nullptr;
+
+/** @brief Folds the thread's counts into the retired totals when it exits */
+struct ShardOwner {
+  ~ShardOwner() {
+    if (local_shard == nullptr) {
+      return;
+    }
+    ShardList& list = Shards();
+    std::lock_guard<std::mutex> lock(list.mutex);
+    for (size_t b = 0; b < SHARD_BLOCKS; ++b) {
+      const SlotBlock* block = local_shard->blocks[b].load(std::memory_order_relaxed);
+      if (block == nullptr) {
+        continue;
+      }
+      for (size_t i = 0; i < BLOCK_SLOTS; ++i) {
+        const uint64_t value = block->values[i].load(std::memory_order_relaxed);
+        if (value != 0) {
+          std::atomic<uint64_t>& total =
+              list.retired.Slot(static_cast<uint32_t>(b * BLOCK_SLOTS + i));
+          total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+      }
+    }
+    list.live.erase(std::find(list.live.begin(), list.live.end(), local_shard));
+    delete local_shard;
+    local_shard = nullptr;
+  }
+};
+thread_local ShardOwner shard_owner;
+
+Shard& LocalShard() {
+  if (local_shard == nullptr) {
+    auto shard = std::make_unique<Shard>();
+    ShardList& list = Shards();
+    std::lock_guard<std::mutex> lock(list.mutex);
+    list.live.push_back(shard.get());
+    // Touch the owner so its destructor is registered for this thread
+    (void)&shard_owner;
+    local_shard = shard.release();
+  }
+  return *local_shard;
+}
+
+void AddToSlot(uint32_t slot, uint64_t amount) noexcept {
+  std::atomic<uint64_t>& value = LocalShard().Slot(slot);
+  // Single writer per shard: no read-modify-write instruction needed
+  value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+uint64_t ReadBlockSlot(const Shard& shard, uint32_t slot) {
+  const SlotBlock* block = shard.blocks[slot / BLOCK_SLOTS].load(std::memory_order_acquire);
+  return block == nullptr ? 0 : block->values[slot % BLOCK_SLOTS].load(std::memory_order_relaxed);
+}
+
+/** @brief Totals of @p count consecutive slots over every shard */
+std::vector<uint64_t> ReadSlots(uint32_t first, size_t count) {
+  std::vector<uint64_t> totals(count, 0);
+  ShardList& list = Shards();
+  std::lock_guard<std::mutex> lock(list.mutex);
+  for (size_t i = 0; i < count; ++i) {
+    const auto slot = static_cast<uint32_t>(first + i);
+    totals[i] = ReadBlockSlot(list.retired, slot);
+    for (const Shard* shard : list.live) {
+      totals[i] += ReadBlockSlot(*shard, slot);
+    }
+  }
+  return totals;
+}
+
+bool ValidMetricName(std::string_view name) {
+  if (name.empty() || (name[0] >= '0' && name[0] <= '9')) {
+    return false;
+  }
+  return std::all_of(name.begin(), name.end(), [](char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == ':';
+  });
+}
+
+bool ValidLabelName(std::string_view name) {
+  return ValidMetricName(name) && name.find(':') == std::string_view::npos &&
+         !name.starts_with("__") && name != "le" && name != "quantile";
+}
+
+void AppendEscaped(std::string& out, std::string_view text, bool quotes) {
+  for (const char c : text) {
+    if (c == '\\') {
+      out += "\\\\";
+    } else if (c == '\n') {
+      out += "\\n";
+    } else if (c == '"' && quotes) {
+      out += "\\\"";
+    } else {
+      out += c;
+    }
+  }
+}
+
+void AppendNumber(std::string& out, double value) {
+  if (std::isnan(value)) {
+    out += "NaN";
+  } else if (std::isinf(value)) {
+    out += value > 0 ? "+Inf" : "-Inf";
+  } else {
+    // 15 significant digits hides the binary error of scaled bounds such as 50000 * 1e-6
+    char buffer[32];
+    const auto result =
+        std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 15);
+    out.append(buffer, result.ptr);
+  }
+}
+
+void AppendNumber(std::string& out, uint64_t value) {
+  char buffer[24];
+  const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out.append(buffer, result.ptr);
+}
+
+/** @brief One sample line: name{labels,extra} value */
+template <typename Value>
+void AppendSample(std::string& out, std::string_view name, std::string_view suffix,
+                  std::string_view labels, std::string_view extra_label, Value value) {
+  out += name;
+  out += suffix;
+  if (!labels.empty() || !extra_label.empty()) {
+    out += '{';
+    out += labels;
+    if (!labels.empty() && !extra_label.empty()) {
+      out += ',';
+    }
+    out += extra_label;
+    out += '}';
+  }
+  out += ' ';
+  AppendNumber(out, value);
+  out += '\n';
+}
+
+}  // namespace
+
+std::string_view MetricsContentType(MetricsFormat format) {
+  return format == MetricsFormat::OPENMETRICS
+             ? "application/openmetrics-text; version=1.0.0; charset=utf-8"
+             : "text/plain; version=0.0.4; charset=utf-8";
+}
+
+MetricsFormat NegotiateMetricsFormat(std::string_view accept) {
+  return accept.find("application/openmetrics-text") != std::string_view::npos
+             ? MetricsFormat::OPENMETRICS
+             : MetricsFormat::PROMETHEUS;
+}
+
+void Counter::Add(uint64_t amount) noexcept { AddToSlot(slot_, amount); }
+
+uint64_t Counter::Value() const { return ReadSlots(slot_, 1)[0]; }
+
+void Histogram::Observe(uint64_t value) noexcept {
+  const auto bucket = static_cast<uint32_t>(
+      std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin());
+  AddToSlot(first_slot_ + bucket, 1);
+  AddToSlot(first_slot_ + static_cast<uint32_t>(bounds_.size()) + 1, value);
+}
+
+struct MetricsRegistry::Series {
+  std::string labels;  ///< Rendered label pairs without braces
+  std::unique_ptr<Counter> counter;
+  std::unique_ptr<Gauge> gauge;
+  std::unique_ptr<Histogram> histogram;
+  std::function<double()> read_gauge;
+  std::function<uint64_t()> read_counter;
+  std::function<MetricSummary()> read_summary;
+};
+
+struct MetricsRegistry::Family {
+  std::string name;
+  std::string help;
+  Type type;
+  std::vector<std::unique_ptr<Series>> series;
+};
+
+MetricsRegistry::MetricsRegistry() = default;
+MetricsRegistry::~MetricsRegistry() = default;
+
+MetricsRegistry::Series& MetricsRegistry::AddSeries(std::string name, std::string help, Type type,
+                                                    MetricLabels labels) {
+  if (!ValidMetricName(name)) {
+    throw std::invalid_argument("Invalid metric name: " + name);
+  }
+  std::string rendered;
+  for (const auto& [label, value] : labels) {
+    if (!ValidLabelName(label)) {
+      throw std::invalid_argument("Invalid label name on " + name + ": " + label);
+    }
+    if (!rendered.empty()) {
+      rendered += ',';
+    }
+    rendered += label;
+    rendered += "=\"";
+    AppendEscaped(rendered, value, true);
+    rendered += '"';
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Family* family = nullptr;
+  if (const auto found = by_name_.find(name); found != by_name_.end()) {
+    family = found->second;
+    if (family->type != type) {
+      throw std::invalid_argument("Metric " + name + " is registered with another type");
+    }
+    for (const std::unique_ptr<Series>& series : family->series) {
+      if (series->labels == rendered) {
+        throw std::invalid_argument("Metric series registered twice: " + name + "{" +
+                                    rendered + "}");
+      }
+    }
+  } else {
+    auto created = std::make_unique<Family>();
+    created->name = name;
+    created->help = std::move(help);
+    created->type = type;
+    family = created.get();
+    families_.push_back(std::move(created));
+    by_name_.emplace(std::move(name), family);
+  }
+  family->series.push_back(std::make_unique<Series>());
+  family->series.back()->labels = std::move(rendered);
+  return *family->series.back();
+}
+
+Counter& MetricsRegistry::AddCounter(std::string name, std::string help, MetricLabels labels) {
+  const uint32_t slot = AllocateSlots(1);
+  Series& series = AddSeries(std::move(name), std::move(help), Type::COUNTER, std::move(labels));
+  series.counter.reset(new Counter(slot));
+  return *series.counter;
+}
+
+Gauge& MetricsRegistry::AddGauge(std::string name, std::string help, MetricLabels labels) {
+  Series& series = AddSeries(std::move(name), std::move(help), Type::GAUGE, std::move(labels));
+  series.gauge.reset(new Gauge());
+  return *series.gauge;
+}
+
+void MetricsRegistry::AddGaugeCallback(std::string name, std::string help, MetricLabels labels,
+                                       std::function<double()> read) {
+  Series& series = AddSeries(std::move(name), std::move(help), Type::GAUGE, std::move(labels));
+  series.read_gauge = std::move(read);
+}
+
+void MetricsRegistry::AddCounterCallback(std::string name, std::string help, MetricLabels labels,
+                                         std::function<uint64_t()> read) {
+  Series& series = AddSeries(std::move(name), std::move(help), Type::COUNTER, std::move(labels));
+  series.read_counter = std::move(read);
+}
+
+void MetricsRegistry::AddSummaryCallback(std::string name, std::string help, MetricLabels labels,
+                                         std::function<MetricSummary()> read) {
+  Series& series = AddSeries(std::move(name), std::move(help), Type::SUMMARY, std::move(labels));
+  series.read_summary = std::move(read);
+}
+
+Histogram& MetricsRegistry::AddHistogram(std::string name, std::string help,
+                                         std::vector<uint64_t> bounds, double scale,
+                                         MetricLabels labels) {
+  if (bounds.empty() || std::adjacent_find(bounds.begin(), bounds.end(),
+                                           std::greater_equal<uint64_t>()) != bounds.end()) {
+    throw std::invalid_argument("Histogram bounds of " + name + " must be ascending");
+  }
+  // Buckets, the +Inf bucket and the sum
+  const uint32_t first_slot = AllocateSlots(bounds.size() + 2);
+  Series& series =
+      AddSeries(std::move(name), std::move(help), Type::HISTOGRAM, std::move(labels));
+  series.histogram.reset(new Histogram(first_slot, std::move(bounds), scale));
+  return *series.histogram;
+}
+
+std::string MetricsRegistry::Render(MetricsFormat format) const {
+  const bool openmetrics = format == MetricsFormat::OPENMETRICS;
+  std::string out;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const std::unique_ptr<Family>& family : families_) {
+    // Prometheus text names a counter family after its samples; OpenMetrics drops _total
+    const std::string family_name =
+        family->type == Type::COUNTER && !openmetrics ? family->name + "_total" : family->name;
+    out += "# HELP ";
+    out += family_name;
+    out += ' ';
+    AppendEscaped(out, family->help, false);
+    out += "\n# TYPE ";
+    out += family_name;
+    out += family->type == Type::COUNTER     ? " counter\n"
+           : family->type == Type::GAUGE   ? " gauge\n"
+           : family->type == Type::SUMMARY ? " summary\n"
+                                             : " histogram\n";
+
+    for (const std::unique_ptr<Series>& series : family->series) {
+      switch (family->type) {
+        case Type::COUNTER: {
+          const uint64_t value =
+              series->counter ? series->counter->Value() : series->read_counter();
+          AppendSample(out, family->name, "_total", series->labels, "", value);
+          break;
+        }
+        case Type::GAUGE: {
+          const double value = series->gauge ? series->gauge->Value() : series->read_gauge();
+          AppendSample(out, family->name, "", series->labels, "", value);
+          break;
+        }
+        case Type::HISTOGRAM: {
+          const Histogram& histogram = *series->histogram;
+          const std::vector<uint64_t> slots =
+              ReadSlots(histogram.first_slot_, histogram.bounds_.size() + 2);
+          uint64_t cumulative = 0;
+          std::string le;
+          for (size_t i = 0; i <= histogram.bounds_.size(); ++i) {
+            cumulative += slots[i];
+            le = "le=\"";
+            if (i < histogram.bounds_.size()) {
+              AppendNumber(le, static_cast<double>(histogram.bounds_[i]) * histogram.scale_);
+            } else {
+              le += "+Inf";
+            }
+            le += '"';
+            AppendSample(out, family->name, "_bucket", series->labels, le, cumulative);
+          }
+          AppendSample(out, family->name, "_sum", series->labels, "",
+                       static_cast<double>(slots.back()) * histogram.scale_);
+          AppendSample(out, family->name, "_count", series->labels, "", cumulative);
+          break;
+        }
+        case Type::SUMMARY: {
+          const MetricSummary summary = series->read_summary();
+          std::string quantile;
+          for (const auto& [rank, value] : summary.quantiles) {
+            quantile = "quantile=\"";
+            AppendNumber(quantile, rank);
+            quantile += '"';
+            AppendSample(out, family->name, "", series->labels, quantile, value);
+          }
+          AppendSample(out, family->name, "_sum", series->labels, "", summary.sum);
+          AppendSample(out, family->name, "_count", series->labels, "", summary.count);
+          break;
+        }
+      }
+    }
+  }
+  if (openmetrics) {
+    out += "# EOF\n";
+  }
+  return out;
+}
+
+}  // namespace Util
@@ -0,0 +1,200 @@
+#include "util/numa.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "platform.h"
+
+#ifdef PLATFORM_LINUX
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+namespace Util {
+
+namespace {
+
+#ifdef PLATFORM_LINUX
+
+// From <numaif.h>; declared here to avoid a libnuma dependency
+constexpr int MPOL_PREFERRED = 1;
+constexpr unsigned MPOL_MF_MOVE = 1u << 1;
+
+const char* const NODE_ROOT = "/sys/devices/system/node";
+
+/** @brief Parse a sysfs list such as "0-3,8,10-11" */
+std::vector<int> ParseList(const std::string& text) {
+  std::vector<int> values;
+  std::stringstream stream(text);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    if (range.empty() || range == "\n") {
+      continue;
+    }
+    const size_t dash = range.find('-');
+    try {
+      const int first = std::stoi(range.substr(0, dash));
+      const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int value = first; value <= last; ++value) {
+        values.push_back(value);
+      }
+    } catch (const std::exception&) {
+      return {};
+    }
+  }
+  return values;
+}
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream file(path);
+  std::string content;
+  std::getline(file, content);
+  return content;
+}
+
+#endif  // PLATFORM_LINUX
+
+NumaTopology DiscoverTopology() {
+  NumaTopology topology;
+#ifdef PLATFORM_LINUX
+  for (int node : ParseList(ReadFile(std::string(NODE_ROOT) + "/online"))) {
+    if (topology.node_cpus.size() <= static_cast<size_t>(node)) {
+      topology.node_cpus.resize(node + 1);
+    }
+    topology.node_cpus[node] =
+        ParseList(ReadFile(std::string(NODE_ROOT) + "/node" + std::to_string(node) + "/cpulist"));
+  }
+#elif defined(PLATFORM_WINDOWS)
+  ULONG highest = 0;
+  if (::GetNumaHighestNodeNumber(&highest)) {
+    topology.node_cpus.resize(highest + 1);
+    for (USHORT node = 0; node <= highest; ++node) {
+      GROUP_AFFINITY affinity{};
+      if (!::GetNumaNodeProcessorMaskEx(node, &affinity)) {
+        continue;
+      }
+      for (int bit = 0; bit < 64; ++bit) {
+        if (affinity.Mask & (KAFFINITY{1} << bit)) {
+          topology.node_cpus[node].push_back(affinity.Group * 64 + bit);
+        }
+      }
+    }
+  }
+#endif
+  if (topology.node_cpus.empty()) {
+    const int cpus = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    topology.node_cpus.resize(1);
+    for (int cpu = 0; cpu < cpus; ++cpu) {
+      topology.node_cpus[0].push_back(cpu);
+    }
+  }
+  for (size_t node = 0; node < topology.node_cpus.size(); ++node) {
+    for (int cpu : topology.node_cpus[node]) {
+      if (topology.cpu_node.size() <= static_cast<size_t>(cpu)) {
+        topology.cpu_node.resize(cpu + 1, -1);
+      }
+      topology.cpu_node[cpu] = static_cast<int>(node);
+    }
+  }
+  return topology;
+}
+
+}  // namespace
+
+const NumaTopology& GetNumaTopology() {
+  static const NumaTopology topology = DiscoverTopology();
+  return topology;
+}
+
+int CurrentNumaNode() {
+  const NumaTopology& topology = GetNumaTopology();
+  if (topology.NodeCount() == 1) {
+    return 0;
+  }
+#ifdef PLATFORM_LINUX
+  const int cpu = ::sched_getcpu();
+#elif defined(PLATFORM_WINDOWS)
+  PROCESSOR_NUMBER processor{};
+  ::GetCurrentProcessorNumberEx(&processor);
+  const int cpu = processor.Group * 64 + processor.Number;
+#else
+  const int cpu = -1;
+#endif
+  if (cpu < 0 || static_cast<size_t>(cpu) >= topology.cpu_node.size()) {
+    return 0;
+  }
+  return std::max(topology.cpu_node[cpu], 0);
+}
+
+bool PinCurrentThreadToNode(int node) {
+  const NumaTopology& topology = GetNumaTopology();
+  if (node < 0 || static_cast<size_t>(node) >= topology.NodeCount() ||
+      topology.node_cpus[node].empty()) {
+    return false;
+  }
+#ifdef PLATFORM_LINUX
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : topology.node_cpus[node]) {
+    CPU_SET(cpu, &set);
+  }
+  return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(PLATFORM_WINDOWS)
+  GROUP_AFFINITY affinity{};
+  if (!::GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity)) {
+    return false;
+  }
+  return ::SetThreadGroupAffinity(::GetCurrentThread(), &affinity, nullptr) != 0;
+#else
+  return false;
+#endif
+}
+
+bool BindMemoryToNode(void* address, size_t size, int node, bool migrate) {
+#ifdef PLATFORM_LINUX
+  if (node < 0 || static_cast<size_t>(node) >= 64 || GetNumaTopology().NodeCount() < 2) {
+    return false;
+  }
+  unsigned long mask = 1ul << node;
+  return ::syscall(SYS_mbind, address, size, MPOL_PREFERRED, &mask, sizeof(mask) * 8,
+                   migrate ? MPOL_MF_MOVE : 0u) == 0;
+#else
+  (void)address;
+  (void)size;
+  (void)node;
+  (void)migrate;
+  return false;
+#endif
+}
+
+std::vector<NumaNodeCounters> ReadNumaCounters() {
+  std::vector<NumaNodeCounters> counters;
+#ifdef PLATFORM_LINUX
+  const NumaTopology& topology = GetNumaTopology();
+  counters.resize(topology.NodeCount());
+  for (size_t node = 0; node < topology.NodeCount(); ++node) {
+    std::ifstream file(std::string(NODE_ROOT) + "/node" + std::to_string(node) + "/numastat");
+    std::string name;
+    uint64_t value = 0;
+    while (file >> name >> value) {
+      if (name == "numa_hit") {
+        counters[node].numa_hit = value;
+      } else if (name == "numa_miss") {
+        counters[node].numa_miss = value;
+      } else if (name == "numa_foreign") {
+        counters[node].numa_foreign = value;
+      } else if (name == "local_node") {
+        counters[node].local_node = value;
+      } else if (name == "other_node") {
+        counters[node].other_node = value;
+      }
+    }
+  }
+#endif
+  return counters;
+}
+
+}  // namespace Util
@@ -0,0 +1,182 @@
+#include "util/server_metrics.h"
+
+#include <algorithm>
+#include <string_view>
+
+#include "util/global_allocator.h"
+#include "util/memory_accounting.h"
+#include "util/slab_allocator.h"
+
+namespace Util {
+
+namespace {
+
+/** @brief Tick duration bucket bounds in microseconds; 50 ms is the budget at 20 TPS */
+const std::vector<uint64_t> TICK_DURATION_BOUNDS_US = {
+    1000, 2500, 5000, 10000, 20000, 30000, 40000, 50000, 60000, 75000, 100000, 250000, 1000000};
+
+/** @brief A loop silent for longer than this counts as stalled in TicksPerSecond() */
+constexpr int64_t STALL_NS = 100'000'000;
+
+int64_t SteadyNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void RegisterAllocatorMetrics(MetricsRegistry& registry) {
+  for (size_t i = 0; i < MEMORY_SUBSYSTEM_COUNT; ++i) {
+    const auto subsystem = static_cast<MemorySubsystem>(i);
+    const MetricLabels labels = {{"subsystem", std::string(MemorySubsystemName(subsystem))}};
+    registry.AddGaugeCallback("parellelstone_memory_live_bytes",
+                              "Bytes currently allocated, per subsystem", labels, [subsystem] {
+                                return static_cast<double>(GetMemoryUsage(subsystem).live_bytes);
+                              });
+    registry.AddGaugeCallback("parellelstone_memory_peak_bytes",
+                              "Highest live bytes seen, per subsystem", labels, [subsystem] {
+                                return static_cast<double>(GetMemoryUsage(subsystem).peak_bytes);
+                              });
+    registry.AddGaugeCallback("parellelstone_memory_budget_bytes",
+                              "Memory budget per subsystem; 0 when unlimited", labels, [subsystem] {
+                                return static_cast<double>(GetMemoryUsage(subsystem).budget_bytes);
+                              });
+    registry.AddCounterCallback("parellelstone_memory_allocations",
+                                "Tracked allocations, per subsystem", labels,
+                                [subsystem] { return GetMemoryUsage(subsystem).allocations; });
+    registry.AddCounterCallback("parellelstone_memory_pressure_events",
+                                "Budget pressure handler invocations, per subsystem", labels,
+                                [subsystem] { return GetMemoryUsage(subsystem).pressure_events; });
+  }
+
+  registry.AddGaugeCallback("parellelstone_slabs", "Slabs currently held", {},
+                            [] { return static_cast<double>(GetSlabStats().slabs_live); });
+  registry.AddCounterCallback("parellelstone_slabs_allocated", "Slabs obtained from the system",
+                              {}, [] { return GetSlabStats().slabs_allocated; });
+  registry.AddCounterCallback("parellelstone_slabs_released", "Empty slabs given back", {},
+                              [] { return GetSlabStats().slabs_released; });
+  registry.AddCounterCallback("parellelstone_slab_remote_frees",
+                              "Slab blocks freed by a thread other than the owner", {},
+                              [] { return GetSlabStats().remote_frees; });
+  registry.AddCounterCallback("parellelstone_slab_large_allocations",
+                              "Slab requests above the largest size class", {},
+                              [] { return GetSlabStats().large_allocations; });
+  registry.AddGaugeCallback("parellelstone_allocator_info", "Global allocator the server runs on",
+                            {{"allocator", std::string(GlobalAllocatorName())}},
+                            [] { return 1.0; });
+}
+
+}  // namespace
+
+ServerMetrics::ServerMetrics(MetricsRegistry& registry, ServerMetricSources sources)
+    : sources_(std::move(sources)),
+      ticks_(registry.AddCounter("parellelstone_ticks", "Server ticks completed")),
+      tick_duration_(registry.AddHistogram("parellelstone_tick_duration_seconds",
+                                           "Time spent in each tick (MSPT)",
+                                           TICK_DURATION_BOUNDS_US, 1e-6)),
+      bytes_received_(registry.AddCounter("parellelstone_network_bytes",
+                                          "Packet bytes exchanged with clients",
+                                          {{"direction", "in"}})),
+      bytes_sent_(registry.AddCounter("parellelstone_network_bytes",
+                                      "Packet bytes exchanged with clients",
+                                      {{"direction", "out"}})),
+      packets_received_(registry.AddCounter("parellelstone_network_packets",
+                                            "Packets exchanged with clients",
+                                            {{"direction", "in"}})),
+      packets_sent_(registry.AddCounter("parellelstone_network_packets",
+                                        "Packets exchanged with clients",
+                                        {{"direction", "out"}})) {
+  registry.AddGaugeCallback("parellelstone_tps", "Ticks per second over the last 100 ticks", {},
+                            [this] { return TicksPerSecond(); });
+  registry.AddGaugeCallback("parellelstone_mspt",
+                            "Mean milliseconds per tick over the last 100 ticks", {},
+                            [this] { return MillisecondsPerTick(); });
+
+  const auto add_count = [&registry](const char* name, const char* help,
+                                     const std::function<size_t()>& read) {
+    if (read) {
+      registry.AddGaugeCallback(name, help, {},
+                                [read] { return static_cast<double>(read()); });
+    }
+  };
+  add_count("parellelstone_players", "Players online", sources_.players);
+  add_count("parellelstone_loaded_chunks", "Chunk columns in memory", sources_.loaded_chunks);
+  add_count("parellelstone_entities", "Entities across all worlds", sources_.entities);
+  for (const auto& [name, read] : sources_.queues) {
+    registry.AddGaugeCallback("parellelstone_queue_depth", "Items waiting in a queue",
+                              {{"queue", name}}, [read] { return static_cast<double>(read()); });
+  }
+
+  RegisterAllocatorMetrics(registry);
+}
+
+void ServerMetrics::RecordTick(std::chrono::nanoseconds duration) noexcept {
+  const int64_t nanoseconds = std::max<int64_t>(duration.count(), 0);
+  ticks_.Add();
+  tick_duration_.Observe(static_cast<uint64_t>(nanoseconds / 1000));
+
+  const uint64_t count = tick_count_.load(std::memory_order_relaxed);
+  const size_t index = count % TICK_WINDOW;
+  tick_ends_ns_[index].store(SteadyNanoseconds(), std::memory_order_relaxed);
+  tick_durations_ns_[index].store(nanoseconds, std::memory_order_relaxed);
+  tick_count_.store(count + 1, std::memory_order_release);
+}
+
+void ServerMetrics::CountReceived(size_t bytes) noexcept {
+  bytes_received_.Add(bytes);
+  packets_received_.Add();
+}
+
+void ServerMetrics::CountSent(size_t bytes) noexcept {
+  bytes_sent_.Add(bytes);
+  packets_sent_.Add();
+}
+
+double ServerMetrics::TicksPerSecond() const {
+  const uint64_t count = tick_count_.load(std::memory_order_acquire);
+  const uint64_t window = std::min<uint64_t>(count, TICK_WINDOW);
+  if (window < 2) {
+    return 0.0;
+  }
+  const int64_t newest = tick_ends_ns_[(count - 1) % TICK_WINDOW].load(std::memory_order_relaxed);
+  const int64_t oldest =
+      tick_ends_ns_[(count - window) % TICK_WINDOW].load(std::memory_order_relaxed);
+  int64_t span = newest - oldest;
+  // A stalled loop records no ticks; count the silence so TPS drops instead of freezing
+  const int64_t silence = SteadyNanoseconds() - newest;
+  if (silence > STALL_NS) {
+    span += silence;
+  }
+  return span <= 0 ? 0.0 : static_cast<double>(window - 1) * 1e9 / static_cast<double>(span);
+}
+
+double ServerMetrics::MillisecondsPerTick() const {
+  const uint64_t count = tick_count_.load(std::memory_order_acquire);
+  const uint64_t window = std::min<uint64_t>(count, TICK_WINDOW);
+  if (window == 0) {
+    return 0.0;
+  }
+  int64_t total = 0;
+  for (uint64_t i = count - window; i < count; ++i) {
+    total += tick_durations_ns_[i % TICK_WINDOW].load(std::memory_order_relaxed);
+  }
+  return static_cast<double>(total) / static_cast<double>(window) / 1e6;
+}
+
+std::optional<std::chrono::steady_clock::time_point> ServerMetrics::LastTickTime() const {
+  const uint64_t count = tick_count_.load(std::memory_order_acquire);
+  if (count == 0) {
+    return std::nullopt;
+  }
+  const int64_t newest = tick_ends_ns_[(count - 1) % TICK_WINDOW].load(std::memory_order_relaxed);
+  return std::chrono::steady_clock::time_point(std::chrono::nanoseconds(newest));
+}
+
+void ServeMetrics(Network::HttpServer& server, const MetricsRegistry& registry, std::string path) {
+  server.Handle(std::move(path), [&registry](const Network::HttpRequest& request) {
+    const MetricsFormat format = NegotiateMetricsFormat(request.accept);
+    return Network::HttpResponse{200, std::string(MetricsContentType(format)),
+                                 registry.Render(format)};
+  });
+}
+
+}  // namespace Util
@@ -0,0 +1,377 @@
+#include "util/slab_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "platform.h"
+#include "util/huge_page_arena.h"
+#include "util/numa.h"
+
+#ifndef PLATFORM_WINDOWS
+#include <sys/mman.h>
+#endif
+
+namespace Util {
+
+namespace {
+
+constexpr size_t CLASS_COUNT = SLAB_CLASSES.size();
+
+/** @brief Empty slabs a heap keeps before giving further ones back */
+constexpr size_t RETAINED_EMPTY_SLABS = 4;
+
+/**
+ * @brief Address space reserved from the system at a time
+ *
+ * Slabs are carved from large segments instead of being allocated one by
+ * one: a general-purpose heap pads or fragments 64 KiB-aligned requests,
+ * and mapping each slab separately would create one kernel mapping per
+ * slab. Released slabs are decommitted, so they stop counting towards RSS
+ * while their address range is kept for reuse.
+ */
+constexpr size_t SEGMENT_SIZE = 4 * 1024 * 1024;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct Heap;
+
+/** @brief Header at the start of every SLAB_SIZE-aligned slab */
+struct Slab {
+  Heap* owner;
+  Slab* prev;  ///< Neighbours in the owner's available list
+  Slab* next;
+  FreeBlock* free;  ///< Blocks freed back to this slab
+  uint32_t size_class;
+  uint32_t used;      ///< Blocks handed out
+  uint32_t capacity;  ///< Blocks that fit in the slab
+  uint32_t bump;      ///< Blocks carved so far; the rest were never used
+  uint32_t node;      ///< NUMA node the slab's memory is placed on
+  bool listed;        ///< In the available list, i.e. not full
+};
+
+constexpr size_t HEADER_SIZE = (sizeof(Slab) + SLAB_ALIGNMENT - 1) / SLAB_ALIGNMENT * SLAB_ALIGNMENT;
+
+/** @brief Per-thread allocation state; only the remote list is shared */
+struct Heap {
+  std::array<Slab*, CLASS_COUNT> available{};  ///< Slabs with at least one free block
+  size_t empty_slabs = 0;
+  std::atomic<FreeBlock*> remote{nullptr};  ///< Blocks freed by other threads
+  Heap* next_abandoned = nullptr;
+  uint32_t node = 0;  ///< NUMA node new slabs are taken from
+};
+
+std::atomic<uint64_t> slabs_live{0};
+std::atomic<uint64_t> slabs_allocated{0};
+std::atomic<uint64_t> slabs_released{0};
+std::atomic<uint64_t> remote_frees{0};
+std::atomic<uint64_t> large_allocations{0};
+std::atomic<uint64_t> heaps_created{0};
+
+std::atomic<uint64_t> segments_reserved{0};
+std::array<std::atomic<uint64_t>, MAX_NUMA_NODES> node_slabs{};
+std::atomic<bool> use_huge_pages{false};
+
+std::mutex segment_mutex;
+/** @brief Decommitted slabs ready for reuse, per node; their range keeps the node's placement */
+std::array<std::vector<void*>, MAX_NUMA_NODES> free_slabs;
+
+HugePageArena& SegmentArena() {
+  // Never destroyed: slabs may still be freed by static and thread-local destructors
+  static HugePageArena* arena = new HugePageArena(16 * SEGMENT_SIZE);
+  return *arena;
+}
+
+std::mutex abandoned_mutex;
+Heap* abandoned_heaps = nullptr;
+
+/** @brief Heap of this thread; trivially destructible so it stays readable at thread exit */
+thread_local Heap* current_heap = nullptr;
+
+/** @brief Hands the thread's heap over for adoption when the thread exits */
+struct HeapOwner {
+  ~HeapOwner() {
+    if (current_heap != nullptr) {
+      std::lock_guard<std::mutex> lock(abandoned_mutex);
+      current_heap->next_abandoned = abandoned_heaps;
+      abandoned_heaps = current_heap;
+      current_heap = nullptr;
+    }
+  }
+};
+thread_local HeapOwner heap_owner;
+
+void DrainRemote(Heap& heap);
+
+Heap& ThisHeap() {
+  if (current_heap == nullptr) {
+    {
+      std::lock_guard<std::mutex> lock(abandoned_mutex);
+      if (abandoned_heaps != nullptr) {
+        current_heap = abandoned_heaps;
+        abandoned_heaps = current_heap->next_abandoned;
+      }
+    }
+    if (current_heap != nullptr) {
+      // Blocks freed while the heap had no thread
+      DrainRemote(*current_heap);
+    } else {
+      current_heap = new Heap();
+      heaps_created.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Pinned threads stay on their node; others get memory where they first ran
+    current_heap->node =
+        static_cast<uint32_t>(std::min<size_t>(CurrentNumaNode(), MAX_NUMA_NODES - 1));
+    // Touch the owner so its destructor is registered for this thread
+    (void)&heap_owner;
+  }
+  return *current_heap;
+}
+
+size_t ClassFor(size_t size) {
+  return static_cast<size_t>(
+      std::lower_bound(SLAB_CLASSES.begin(), SLAB_CLASSES.end(), size) - SLAB_CLASSES.begin());
+}
+
+Slab* SlabOf(void* block) {
+  return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(block) & ~(uintptr_t{SLAB_SIZE} - 1));
+}
+
+void Link(Heap& heap, Slab* slab) {
+  Slab*& head = heap.available[slab->size_class];
+  slab->prev = nullptr;
+  slab->next = head;
+  if (head != nullptr) {
+    head->prev = slab;
+  }
+  head = slab;
+  slab->listed = true;
+}
+
+void Unlink(Heap& heap, Slab* slab) {
+  if (slab->prev != nullptr) {
+    slab->prev->next = slab->next;
+  } else {
+    heap.available[slab->size_class] = slab->next;
+  }
+  if (slab->next != nullptr) {
+    slab->next->prev = slab->prev;
+  }
+  slab->prev = slab->next = nullptr;
+  slab->listed = false;
+}
+
+/** @brief Reserve a segment aligned to SLAB_SIZE */
+uint8_t* MapSegment() {
+  if (use_huge_pages.load(std::memory_order_relaxed)) {
+    return static_cast<uint8_t*>(SegmentArena().Allocate(SEGMENT_SIZE, SLAB_SIZE));
+  }
+#ifdef PLATFORM_WINDOWS
+  // The allocation granularity is 64 KiB, which already is the slab alignment
+  void* memory = ::VirtualAlloc(nullptr, SEGMENT_SIZE, MEM_RESERVE, PAGE_NOACCESS);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  return static_cast<uint8_t*>(memory);
+#else
+  const size_t mapped = SEGMENT_SIZE + SLAB_SIZE;
+  void* memory = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  auto begin = reinterpret_cast<uintptr_t>(memory);
+  uintptr_t aligned = (begin + SLAB_SIZE - 1) & ~(uintptr_t{SLAB_SIZE} - 1);
+  if (aligned != begin) {
+    ::munmap(memory, aligned - begin);
+  }
+  if (size_t tail = begin + mapped - (aligned + SEGMENT_SIZE); tail != 0) {
+    ::munmap(reinterpret_cast<void*>(aligned + SEGMENT_SIZE), tail);
+  }
+  return reinterpret_cast<uint8_t*>(aligned);
+#endif
+}
+
+/** @brief Reserve a segment whose pages will be faulted in on @p node */
+uint8_t* ReserveSegment(uint32_t node) {
+  uint8_t* segment = MapSegment();
+  segments_reserved.fetch_add(1, std::memory_order_relaxed);
+  // Nothing is resident yet, so the policy alone places every page; no-op on one node
+  BindMemoryToNode(segment, SEGMENT_SIZE, static_cast<int>(node), false);
+  return segment;
+}
+
+void* AcquireSlabMemory(uint32_t node) {
+  std::vector<void*>& slabs = free_slabs[node];
+  void* memory;
+  {
+    std::lock_guard<std::mutex> lock(segment_mutex);
+    if (slabs.empty()) {
+      uint8_t* segment = ReserveSegment(node);
+      for (size_t offset = SEGMENT_SIZE; offset > 0; offset -= SLAB_SIZE) {
+        slabs.push_back(segment + offset - SLAB_SIZE);
+      }
+    }
+    memory = slabs.back();
+    slabs.pop_back();
+  }
+#ifdef PLATFORM_WINDOWS
+  // Huge-page segments are committed; committing again is a no-op. Pages land on the node.
+  if (::VirtualAllocExNuma(::GetCurrentProcess(), memory, SLAB_SIZE, MEM_COMMIT, PAGE_READWRITE,
+                           node) == nullptr) {
+    std::lock_guard<std::mutex> lock(segment_mutex);
+    slabs.push_back(memory);
+    throw std::bad_alloc();
+  }
+#endif
+  return memory;
+}
+
+void ReleaseSlabMemory(void* memory, uint32_t node) {
+  if (!use_huge_pages.load(std::memory_order_relaxed)) {
+#ifdef PLATFORM_WINDOWS
+    ::VirtualFree(memory, SLAB_SIZE, MEM_DECOMMIT);
+#else
+    ::madvise(memory, SLAB_SIZE, MADV_DONTNEED);
+#endif
+  }
+  std::lock_guard<std::mutex> lock(segment_mutex);
+  free_slabs[node].push_back(memory);
+}
+
+Slab* NewSlab(Heap& heap, size_t size_class) {
+  void* memory = AcquireSlabMemory(heap.node);
+  auto* slab = new (memory) Slab{};
+  slab->owner = &heap;
+  slab->node = heap.node;
+  slab->size_class = static_cast<uint32_t>(size_class);
+  slab->capacity = static_cast<uint32_t>((SLAB_SIZE - HEADER_SIZE) / SLAB_CLASSES[size_class]);
+  Link(heap, slab);
+  ++heap.empty_slabs;
+  slabs_live.fetch_add(1, std::memory_order_relaxed);
+  node_slabs[heap.node].fetch_add(1, std::memory_order_relaxed);
+  slabs_allocated.fetch_add(1, std::memory_order_relaxed);
+  return slab;
+}
+
+void ReleaseSlab(Slab* slab) {
+  const uint32_t node = slab->node;
+  slab->~Slab();
+  ReleaseSlabMemory(slab, node);
+  slabs_live.fetch_sub(1, std::memory_order_relaxed);
+  node_slabs[node].fetch_sub(1, std::memory_order_relaxed);
+  slabs_released.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FreeLocal(Heap& heap, Slab* slab, void* block) {
+  auto* free_block = static_cast<FreeBlock*>(block);
+  free_block->next = slab->free;
+  slab->free = free_block;
+  if (!slab->listed) {
+    Link(heap, slab);
+  }
+  if (--slab->used == 0) {
+    // The class's only available slab stays, or alternating allocate/free would map it each time
+    const bool last_of_class = slab->prev == nullptr && slab->next == nullptr;
+    if (heap.empty_slabs >= RETAINED_EMPTY_SLABS && !last_of_class) {
+      Unlink(heap, slab);
+      ReleaseSlab(slab);
+    } else {
+      ++heap.empty_slabs;
+    }
+  }
+}
+
+void DrainRemote(Heap& heap) {
+  FreeBlock* block = heap.remote.exchange(nullptr, std::memory_order_acquire);
+  while (block != nullptr) {
+    FreeBlock* next = block->next;
+    FreeLocal(heap, SlabOf(block), block);
+    block = next;
+  }
+}
+
+}  // namespace
+
+void* SlabAllocate(size_t size) {
+  if (size > SLAB_CLASSES.back()) {
+    large_allocations.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(size);
+  }
+  const size_t size_class = ClassFor(size);
+  Heap& heap = ThisHeap();
+
+  Slab* slab = heap.available[size_class];
+  if (slab == nullptr ||
+      (slab->free == nullptr && heap.remote.load(std::memory_order_relaxed) != nullptr)) {
+    // Reuse blocks other threads returned before carving fresh memory
+    DrainRemote(heap);
+    slab = heap.available[size_class];
+    if (slab == nullptr) {
+      slab = NewSlab(heap, size_class);
+    }
+  }
+
+  void* block;
+  if (slab->free != nullptr) {
+    block = slab->free;
+    slab->free = slab->free->next;
+  } else {
+    block = reinterpret_cast<uint8_t*>(slab) + HEADER_SIZE +
+            static_cast<size_t>(slab->bump) * SLAB_CLASSES[size_class];
+    ++slab->bump;
+  }
+  if (slab->used++ == 0) {
+    --heap.empty_slabs;
+  }
+  if (slab->free == nullptr && slab->bump == slab->capacity) {
+    Unlink(heap, slab);
+  }
+  return block;
+}
+
+void SlabFree(void* block, size_t size) noexcept {
+  if (block == nullptr) {
+    return;
+  }
+  if (size > SLAB_CLASSES.back()) {
+    ::operator delete(block);
+    return;
+  }
+  Slab* slab = SlabOf(block);
+  Heap* owner = slab->owner;
+  if (owner == current_heap) {
+    FreeLocal(*owner, slab, block);
+    return;
+  }
+  // Lock-free push; the owner takes the whole list at once, so there is no ABA
+  auto* free_block = static_cast<FreeBlock*>(block);
+  FreeBlock* head = owner->remote.load(std::memory_order_relaxed);
+  do {
+    free_block->next = head;
+  } while (!owner->remote.compare_exchange_weak(head, free_block, std::memory_order_release,
+                                                std::memory_order_relaxed));
+  remote_frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+SlabStats GetSlabStats() {
+  SlabStats stats;
+  stats.slabs_live = slabs_live.load(std::memory_order_relaxed);
+  stats.slabs_allocated = slabs_allocated.load(std::memory_order_relaxed);
+  stats.slabs_released = slabs_released.load(std::memory_order_relaxed);
+  stats.remote_frees = remote_frees.load(std::memory_order_relaxed);
+  stats.large_allocations = large_allocations.load(std::memory_order_relaxed);
+  stats.heaps = heaps_created.load(std::memory_order_relaxed);
+  stats.segments = segments_reserved.load(std::memory_order_relaxed);
+  stats.huge_pages = use_huge_pages.load(std::memory_order_relaxed);
+  for (size_t node = 0; node < MAX_NUMA_NODES; ++node) {
+    stats.slabs_per_node[node] = node_slabs[node].load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+void SetSlabHugePages(bool enable) { use_huge_pages.store(enable, std::memory_order_relaxed); }
+
+}  // namespace Util
@@ -0,0 +1,69 @@
+#include "util/tag_registry.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace Util {
+
+void TagRegistry::Define(Identifier tag, std::span<const int32_t> entries,
+                         std::span<const Identifier> included_tags) {
+  if (!tags_.Contains(tag)) {
+    order_.push_back(tag);
+  }
+  Tag& definition = tags_[tag];
+  definition.entries.insert(definition.entries.end(), entries.begin(), entries.end());
+  definition.included.insert(definition.included.end(), included_tags.begin(), included_tags.end());
+  definition.state = State::UNRESOLVED;
+}
+
+void TagRegistry::Resolve() {
+  for (Identifier id : order_) {
+    tags_.Find(id)->state = State::UNRESOLVED;
+  }
+  for (Identifier id : order_) {
+    Tag& tag = *tags_.Find(id);
+    if (tag.state == State::UNRESOLVED) {
+      ResolveTag(id, tag);
+    }
+  }
+}
+
+void TagRegistry::ResolveTag(Identifier id, Tag& tag) {
+  tag.state = State::RESOLVING;
+  for (Identifier included_id : tag.included) {
+    Tag* included = tags_.Find(included_id);
+    if (included == nullptr) {
+      throw std::invalid_argument("tag #" + std::string(id.Name()) + " includes undefined tag #" +
+                                  std::string(included_id.Name()));
+    }
+    if (included->state == State::RESOLVING) {
+      throw std::invalid_argument("tag #" + std::string(id.Name()) + " includes itself through #" +
+                                  std::string(included_id.Name()));
+    }
+    if (included->state == State::UNRESOLVED) {
+      ResolveTag(included_id, *included);
+    }
+    tag.entries.insert(tag.entries.end(), included->entries.begin(), included->entries.end());
+  }
+  std::sort(tag.entries.begin(), tag.entries.end());
+  tag.entries.erase(std::unique(tag.entries.begin(), tag.entries.end()), tag.entries.end());
+  tag.entries.erase(tag.entries.begin(),
+                    std::lower_bound(tag.entries.begin(), tag.entries.end(), 0));
+
+  tag.bits.assign(tag.entries.empty() ? 0 : static_cast<size_t>(tag.entries.back()) / 64 + 1, 0);
+  for (int32_t entry : tag.entries) {
+    tag.bits[static_cast<size_t>(entry) / 64] |= uint64_t{1} << (entry % 64);
+  }
+  tag.state = State::RESOLVED;
+}
+
+std::span<const int32_t> TagRegistry::Entries(Identifier tag) const {
+  const Tag* found = tags_.Find(tag);
+  if (found == nullptr) {
+    return {};
+  }
+  return found->entries;
+}
+
+}  // namespace Util
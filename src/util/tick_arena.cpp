@@ -0,0 +1,76 @@
+#include "util/tick_arena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace Util {
+
+TickArena::TickArena(size_t initial_size, bool poison) : poison_(poison) {
+  AddBlock(std::max<size_t>(initial_size, 64));
+}
+
+void* TickArena::do_allocate(size_t bytes, size_t alignment) {
+  ++stats_.allocations;
+  for (;;) {
+    Block& block = blocks_[current_];
+    auto base = reinterpret_cast<uintptr_t>(block.memory.get());
+    uintptr_t aligned = (base + offset_ + alignment - 1) & ~(uintptr_t{alignment} - 1);
+    size_t end = static_cast<size_t>(aligned - base) + bytes;
+    if (end <= block.size) {
+      offset_ = end;
+      void* result = reinterpret_cast<void*>(aligned);
+      if (poison_) {
+        std::memset(result, ARENA_ALLOCATED_POISON, bytes);
+      }
+      return result;
+    }
+    if (current_ + 1 == blocks_.size()) {
+      AddBlock(std::max(block.size * 2, bytes + alignment));
+    }
+    used_before_current_ += offset_;
+    ++current_;
+    offset_ = 0;
+  }
+}
+
+void TickArena::Reset() {
+  const size_t used = BytesUsed();
+  ++stats_.ticks;
+  stats_.peak_bytes = std::max(stats_.peak_bytes, used);
+
+  if (poison_) {
+    for (size_t i = 0; i < current_; ++i) {
+      std::memset(blocks_[i].memory.get(), ARENA_RELEASED_POISON, blocks_[i].size);
+    }
+    std::memset(blocks_[current_].memory.get(), ARENA_RELEASED_POISON, offset_);
+  }
+
+  if (blocks_.size() > 1) {
+    // Next tick fits in one block
+    size_t total = 0;
+    for (const Block& block : blocks_) {
+      total += block.size;
+    }
+    blocks_.clear();
+    stats_.capacity = 0;
+    AddBlock(total);
+  }
+  current_ = 0;
+  offset_ = 0;
+  used_before_current_ = 0;
+}
+
+void TickArena::AddBlock(size_t size) {
+  Block block;
+  block.memory.reset(new std::byte[size]);
+  block.size = size;
+  if (poison_) {
+    std::memset(block.memory.get(), ARENA_RELEASED_POISON, size);
+  }
+  blocks_.push_back(std::move(block));
+  ++stats_.upstream_allocations;
+  stats_.capacity += size;
+}
+
+}  // namespace Util
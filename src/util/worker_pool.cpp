@@ -0,0 +1,81 @@
+#include "util/worker_pool.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <exception>
+
+#include "util/numa.h"
+
+namespace Util {
+
+WorkerPool::WorkerPool(size_t thread_count, int numa_node) : numa_node_(numa_node) {
+  const NumaTopology& topology = GetNumaTopology();
+  if (numa_node_ >= static_cast<int>(topology.NodeCount())) {
+    numa_node_ = -1;
+  }
+  if (thread_count == 0) {
+    thread_count = numa_node_ >= 0 ? topology.node_cpus[numa_node_].size()
+                                   : std::thread::hardware_concurrency();
+    thread_count = std::max<size_t>(1, thread_count);
+  }
+  threads_.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads_.emplace_back([this] {
+      if (numa_node_ >= 0) {
+        // Before the first allocation, so the thread's slab heap is created on the node
+        PinCurrentThreadToNode(numa_node_);
+      }
+      WorkerLoop();
+    });
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkerPool::Post(std::function<void()> task) {
+  {
+    std::lock_guard lock(mutex_);
+    queue_.push_back(std::move(task));
+  }
+  wake_.notify_one();
+}
+
+size_t WorkerPool::QueueDepth() const {
+  std::lock_guard lock(mutex_);
+  return queue_.size();
+}
+
+void WorkerPool::WorkerLoop() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock lock(mutex_);
+      wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    try {
+      task();
+    } catch (const std::exception& e) {
+      // Submit() routes exceptions through the future; only Post() tasks get here
+      spdlog::error("Worker pool task failed: {}", e.what());
+    } catch (...) {
+      spdlog::error("Worker pool task failed with a non-standard exception");
+    }
+  }
+}
+
+}  // namespace Util
@@ -0,0 +1,311 @@
+#include "world/bulk_editor.h"
+
+#include <array>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
+#include "util/worker_pool.h"
+
+namespace World {
+
+namespace {
+
+/** @brief Intersection of @p box with one section; false when empty */
+bool ClipToSection(const BlockBox& box, const SectionPosition& section, BlockBox& clip) {
+  const BlockPosition origin{section.x * SECTION_SIZE, section.y * SECTION_SIZE,
+                             section.z * SECTION_SIZE};
+  clip.min = {std::max(box.min.x, origin.x), std::max(box.min.y, origin.y),
+              std::max(box.min.z, origin.z)};
+  clip.max = {std::min(box.max.x, origin.x + SECTION_SIZE - 1),
+              std::min(box.max.y, origin.y + SECTION_SIZE - 1),
+              std::min(box.max.z, origin.z + SECTION_SIZE - 1)};
+  return clip.min.x <= clip.max.x && clip.min.y <= clip.max.y && clip.min.z <= clip.max.z;
+}
+
+constexpr size_t LocalIndex(int32_t x, int32_t y, int32_t z) {
+  return static_cast<size_t>(((y & 15) << 8) | ((z & 15) << 4) | (x & 15));
+}
+
+void RequireUpright(const BlockBox& box) {
+  if (box.Inverted()) {
+    throw std::invalid_argument("inverted block box; build it with BlockBox::FromCorners");
+  }
+}
+
+void Accumulate(BulkEditResult& total, const BulkEditResult& part) {
+  total.blocks_written += part.blocks_written;
+  total.sections_filled += part.sections_filled;
+  total.sections_rewritten += part.sections_rewritten;
+  total.columns_updated += part.columns_updated;
+  total.columns_skipped += part.columns_skipped;
+}
+
+}  // namespace
+
+void BulkEditor::ForEachColumn(const BlockBox& box, ColumnTask task, DoneFunction on_done) {
+  struct Job {
+    std::mutex mutex;
+    BulkEditResult total;
+    std::exception_ptr error;
+    size_t remaining = 0;
+    std::chrono::steady_clock::time_point start;
+    ColumnTask task;
+    DoneFunction on_done;
+  };
+
+  // No column would run, so nothing would ever complete the job
+  if (box.Inverted()) {
+    on_done({}, nullptr);
+    return;
+  }
+
+  auto job = std::make_shared<Job>();
+  job->start = std::chrono::steady_clock::now();
+  job->task = std::move(task);
+  job->on_done = std::move(on_done);
+
+  const int32_t min_cx = box.min.x >> 4;
+  const int32_t max_cx = box.max.x >> 4;
+  const int32_t min_cz = box.min.z >> 4;
+  const int32_t max_cz = box.max.z >> 4;
+  job->remaining = static_cast<size_t>(max_cx - min_cx + 1) * (max_cz - min_cz + 1);
+
+  ChunkMap* chunks = &chunks_;
+  for (int32_t cx = min_cx; cx <= max_cx; ++cx) {
+    for (int32_t cz = min_cz; cz <= max_cz; ++cz) {
+      workers_.Post([chunks, job, position = ChunkPosition{cx, cz}] {
+        BulkEditResult part;
+        std::exception_ptr error;
+        try {
+          // The pin keeps Evict() and Unload() off the column while the task runs
+          if (ColumnPin column = chunks->Pin(position)) {
+            std::lock_guard column_lock(column->Mutex());
+            job->task(*column, part);
+          } else {
+            part.columns_skipped = 1;
+          }
+        } catch (...) {
+          error = std::current_exception();
+        }
+
+        {
+          std::lock_guard lock(job->mutex);
+          Accumulate(job->total, part);
+          if (error && !job->error) {
+            job->error = error;
+          }
+          if (--job->remaining != 0) {
+            return;
+          }
+        }
+        job->total.elapsed = std::chrono::steady_clock::now() - job->start;
+        job->on_done(job->total, job->error);
+      });
+    }
+  }
+}
+
+void BulkEditor::ApplyToColumn(ChunkColumn& column, const BlockBox& box,
+                               const SectionOperation& operation,
+                               const BulkEditListener& listener, BulkEditResult& result) {
+  const int32_t min_sy = std::max(box.min.y, column.MinY()) >> 4;
+  const int32_t max_sy = std::min(box.max.y, column.MaxY() - 1) >> 4;
+  if (min_sy > max_sy) {
+    return;
+  }
+
+  std::array<int32_t, SECTION_VOLUME> states;
+  const ChunkPosition chunk = column.Position();
+  for (int32_t section_y = min_sy; section_y <= max_sy; ++section_y) {
+    BlockBox clip;
+    if (!ClipToSection(box, {chunk.x, section_y, chunk.z}, clip)) {
+      continue;
+    }
+    ChunkSection& section = *column.SectionAt(section_y);
+    const bool covers_section = clip.Volume() == SECTION_VOLUME;
+
+    if (operation.fill_state >= 0 && covers_section) {
+      section.Fill(operation.fill_state);
+      ++result.sections_filled;
+    } else {
+      if (!(covers_section && operation.overwrites_clip)) {
+        section.Export(states);
+      }
+      operation.write(clip, states);
+      section.Assign(states);
+      ++result.sections_rewritten;
+    }
+    result.blocks_written += static_cast<uint64_t>(clip.Volume());
+
+    if (listener.on_section_changed) {
+      listener.on_section_changed(column, section_y);
+    }
+  }
+
+  column.RecomputeHeightmap();
+  ++result.columns_updated;
+  if (listener.on_column_changed) {
+    listener.on_column_changed(column);
+  }
+}
+
+void BulkEditor::Apply(const BlockBox& box, std::shared_ptr<const SectionOperation> operation,
+                       BulkEditListener listener, DoneFunction on_done) {
+  ForEachColumn(
+      box,
+      [box, operation, listener = std::move(listener)](ChunkColumn& column,
+                                                       BulkEditResult& result) {
+        ApplyToColumn(column, box, *operation, listener, result);
+      },
+      std::move(on_done));
+}
+
+namespace {
+
+/** @brief Completion callback that fulfils @p promise */
+auto Fulfil(std::shared_ptr<std::promise<BulkEditResult>> promise) {
+  return [promise = std::move(promise)](const BulkEditResult& result, std::exception_ptr error) {
+    if (error) {
+      promise->set_exception(error);
+    } else {
+      promise->set_value(result);
+    }
+  };
+}
+
+/** @brief Section writer copying @p schematic placed at @p origin */
+auto SchematicWriter(std::shared_ptr<const Schematic> schematic, BlockPosition origin,
+                     bool ignore_air) {
+  return [schematic = std::move(schematic), origin, ignore_air](
+             const BlockBox& clip, std::span<int32_t, SECTION_VOLUME> states) {
+    for (int32_t y = clip.min.y; y <= clip.max.y; ++y) {
+      for (int32_t z = clip.min.z; z <= clip.max.z; ++z) {
+        for (int32_t x = clip.min.x; x <= clip.max.x; ++x) {
+          const int32_t state = schematic->Get(x - origin.x, y - origin.y, z - origin.z);
+          if (ignore_air && state == AIR_STATE) {
+            continue;
+          }
+          states[LocalIndex(x, y, z)] = state;
+        }
+      }
+    }
+  };
+}
+
+BlockBox PlacedBox(const Schematic& schematic, const BlockPosition& origin) {
+  return {origin,
+          {origin.x + schematic.SizeX() - 1, origin.y + schematic.SizeY() - 1,
+           origin.z + schematic.SizeZ() - 1}};
+}
+
+}  // namespace
+
+std::future<BulkEditResult> BulkEditor::Fill(const BlockBox& box, int32_t state_id,
+                                             BulkEditListener listener) {
+  RequireUpright(box);
+  auto operation = std::make_shared<SectionOperation>();
+  operation->fill_state = state_id;
+  operation->overwrites_clip = true;
+  operation->write = [state_id](const BlockBox& clip, std::span<int32_t, SECTION_VOLUME> states) {
+    for (int32_t y = clip.min.y; y <= clip.max.y; ++y) {
+      for (int32_t z = clip.min.z; z <= clip.max.z; ++z) {
+        for (int32_t x = clip.min.x; x <= clip.max.x; ++x) {
+          states[LocalIndex(x, y, z)] = state_id;
+        }
+      }
+    }
+  };
+
+  auto promise = std::make_shared<std::promise<BulkEditResult>>();
+  std::future<BulkEditResult> future = promise->get_future();
+  Apply(box, std::move(operation), std::move(listener), Fulfil(std::move(promise)));
+  return future;
+}
+
+std::future<BulkEditResult> BulkEditor::Paste(std::shared_ptr<const Schematic> schematic,
+                                              const BlockPosition& origin, bool ignore_air,
+                                              BulkEditListener listener) {
+  const BlockBox box = PlacedBox(*schematic, origin);
+  auto operation = std::make_shared<SectionOperation>();
+  operation->overwrites_clip = !ignore_air;
+  operation->write = SchematicWriter(std::move(schematic), origin, ignore_air);
+
+  auto promise = std::make_shared<std::promise<BulkEditResult>>();
+  std::future<BulkEditResult> future = promise->get_future();
+  Apply(box, std::move(operation), std::move(listener), Fulfil(std::move(promise)));
+  return future;
+}
+
+void BulkEditor::CaptureThen(
+    const BlockBox& box,
+    std::function<void(std::shared_ptr<Schematic>, std::exception_ptr)> on_done) {
+  auto schematic = std::make_shared<Schematic>(box.SizeX(), box.SizeY(), box.SizeZ());
+  ForEachColumn(
+      box,
+      [box, schematic](ChunkColumn& column, BulkEditResult&) {
+        // Columns write disjoint parts of the schematic, so no extra locking.
+        std::array<int32_t, SECTION_VOLUME> states;
+        const ChunkPosition chunk = column.Position();
+        const int32_t min_sy = std::max(box.min.y, column.MinY()) >> 4;
+        const int32_t max_sy = std::min(box.max.y, column.MaxY() - 1) >> 4;
+        for (int32_t section_y = min_sy; section_y <= max_sy; ++section_y) {
+          BlockBox clip;
+          if (!ClipToSection(box, {chunk.x, section_y, chunk.z}, clip)) {
+            continue;
+          }
+          column.SectionAt(section_y)->Export(states);
+          for (int32_t y = clip.min.y; y <= clip.max.y; ++y) {
+            for (int32_t z = clip.min.z; z <= clip.max.z; ++z) {
+              for (int32_t x = clip.min.x; x <= clip.max.x; ++x) {
+                schematic->Set(x - box.min.x, y - box.min.y, z - box.min.z,
+                               states[LocalIndex(x, y, z)]);
+              }
+            }
+          }
+        }
+      },
+      [schematic, on_done = std::move(on_done)](const BulkEditResult&, std::exception_ptr error) {
+        on_done(schematic, error);
+      });
+}
+
+std::future<std::shared_ptr<Schematic>> BulkEditor::Capture(const BlockBox& box) {
+  RequireUpright(box);
+  auto promise = std::make_shared<std::promise<std::shared_ptr<Schematic>>>();
+  std::future<std::shared_ptr<Schematic>> future = promise->get_future();
+  CaptureThen(box, [promise](std::shared_ptr<Schematic> schematic, std::exception_ptr error) {
+    if (error) {
+      promise->set_exception(error);
+    } else {
+      promise->set_value(std::move(schematic));
+    }
+  });
+  return future;
+}
+
+std::future<BulkEditResult> BulkEditor::Clone(const BlockBox& source,
+                                              const BlockPosition& destination,
+                                              BulkEditListener listener) {
+  RequireUpright(source);
+  auto promise = std::make_shared<std::promise<BulkEditResult>>();
+  std::future<BulkEditResult> future = promise->get_future();
+
+  // The paste is chained from the capture's completion callback so no
+  // worker ever blocks waiting on another task.
+  CaptureThen(source, [this, destination, promise, listener = std::move(listener)](
+                          std::shared_ptr<Schematic> snapshot, std::exception_ptr error) mutable {
+    if (error) {
+      promise->set_exception(error);
+      return;
+    }
+    const BlockBox box = PlacedBox(*snapshot, destination);
+    auto operation = std::make_shared<SectionOperation>();
+    operation->overwrites_clip = true;
+    operation->write = SchematicWriter(std::move(snapshot), destination, false);
+    Apply(box, std::move(operation), std::move(listener), Fulfil(promise));
+  });
+  return future;
+}
+
+}  // namespace World
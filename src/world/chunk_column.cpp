@@ -0,0 +1,162 @@
+#include "world/chunk_column.h"
+
+#include <array>
+
+namespace World {
+
+ChunkColumn::ChunkColumn(ChunkPosition position, int32_t min_y, int32_t section_count)
+    : position_(position), min_y_(min_y), sections_(static_cast<size_t>(section_count)) {}
+
+ChunkSection* ChunkColumn::SectionAt(int32_t section_y) {
+  const int32_t index = section_y - (min_y_ >> 4);
+  if (index < 0 || index >= SectionCount()) {
+    return nullptr;
+  }
+  return &sections_[static_cast<size_t>(index)];
+}
+
+const ChunkSection* ChunkColumn::SectionAt(int32_t section_y) const {
+  return const_cast<ChunkColumn*>(this)->SectionAt(section_y);
+}
+
+int32_t ChunkColumn::GetBlock(const BlockPosition& position) const {
+  const ChunkSection* section = SectionAt(position.y >> 4);
+  return section ? section->GetBlock(position.SectionIndex()) : AIR_STATE;
+}
+
+int32_t ChunkColumn::SetBlock(const BlockPosition& position, int32_t state_id) {
+  ChunkSection* section = SectionAt(position.y >> 4);
+  if (!section) {
+    return AIR_STATE;
+  }
+  const int32_t previous = section->SetBlock(position.SectionIndex(), state_id);
+
+  int16_t& height = heightmap_[((position.z & 15) << 4) | (position.x & 15)];
+  const int32_t block_height = position.y - min_y_ + 1;
+  if (state_id != AIR_STATE && block_height > height) {
+    height = static_cast<int16_t>(block_height);
+  } else if (state_id == AIR_STATE && block_height == height) {
+    BlockPosition below = position;
+    while (below.y > min_y_ && GetBlock({below.x, below.y - 1, below.z}) == AIR_STATE) {
+      --below.y;
+    }
+    height = static_cast<int16_t>(below.y - min_y_);
+  }
+  return previous;
+}
+
+void ChunkColumn::RecomputeHeightmap() {
+  heightmap_.fill(0);
+  int32_t remaining = SECTION_SIZE * SECTION_SIZE;
+  std::array<int32_t, SECTION_VOLUME> states;
+
+  for (int32_t index = SectionCount() - 1; index >= 0 && remaining > 0; --index) {
+    const ChunkSection& section = sections_[static_cast<size_t>(index)];
+    if (section.IsEmpty()) {
+      continue;
+    }
+    const int32_t base_height = index * SECTION_SIZE;
+    if (section.NonAirCount() == SECTION_VOLUME) {
+      // Fully solid: every still-unset column tops out here.
+      for (int16_t& height : heightmap_) {
+        if (height == 0) {
+          height = static_cast<int16_t>(base_height + SECTION_SIZE);
+        }
+      }
+      break;
+    }
+
+    section.Export(states);
+    for (int32_t column = 0; column < SECTION_SIZE * SECTION_SIZE; ++column) {
+      if (heightmap_[column] != 0) {
+        continue;
+      }
+      for (int32_t y = SECTION_SIZE - 1; y >= 0; --y) {
+        if (states[(y << 8) | column] != AIR_STATE) {
+          heightmap_[column] = static_cast<int16_t>(base_height + y + 1);
+          --remaining;
+          break;
+        }
+      }
+    }
+  }
+}
+
+void ChunkColumn::Relocate() {
+  std::lock_guard lock(mutex_);
+  for (ChunkSection& section : sections_) {
+    // The copy allocates from this thread's heap; the old storage goes back to its owner
+    ChunkSection local = section;
+    section = std::move(local);
+  }
+}
+
+size_t ChunkColumn::StorageBytes() const {
+  size_t bytes = 0;
+  for (const ChunkSection& section : sections_) {
+    bytes += section.StorageBytes();
+  }
+  return bytes;
+}
+
+ChunkColumn* ChunkMap::Find(ChunkPosition position) const {
+  std::shared_lock lock(mutex_);
+  const auto it = columns_.find(position);
+  return it == columns_.end() ? nullptr : it->second.get();
+}
+
+ChunkColumn& ChunkMap::GetOrCreate(ChunkPosition position) {
+  std::unique_lock lock(mutex_);
+  std::unique_ptr<ChunkColumn>& column = columns_[position];
+  if (!column) {
+    column = std::make_unique<ChunkColumn>(position);
+  }
+  return *column;
+}
+
+ColumnPin ChunkMap::Pin(ChunkPosition position) const {
+  // Pins are taken under the shared lock, so Unload() and Evict(), which
+  // check them under the exclusive lock, never miss one
+  std::shared_lock lock(mutex_);
+  const auto it = columns_.find(position);
+  if (it == columns_.end()) {
+    return {};
+  }
+  it->second->pins_.fetch_add(1, std::memory_order_relaxed);
+  return ColumnPin(it->second.get());
+}
+
+bool ChunkMap::Unload(ChunkPosition position) {
+  std::unique_lock lock(mutex_);
+  const auto it = columns_.find(position);
+  if (it == columns_.end() || it->second->Pinned()) {
+    return false;
+  }
+  columns_.erase(it);
+  return true;
+}
+
+size_t ChunkMap::Evict(uint64_t bytes, const std::function<bool(ChunkPosition)>& in_use) {
+  // Freed bytes are summed here: the published CHUNKS counter lags releases
+  // by up to a thread's batch and would make this evict too much
+  uint64_t freed = 0;
+  size_t evicted = 0;
+  std::unique_lock lock(mutex_);
+  for (auto it = columns_.begin(); it != columns_.end() && freed < bytes;) {
+    if (it->second->Pinned() || in_use(it->first)) {
+      ++it;
+      continue;
+    }
+    freed += it->second->StorageBytes();
+    it = columns_.erase(it);
+    ++evicted;
+  }
+  return evicted;
+}
+
+size_t ChunkMap::Size() const {
+  std::shared_lock lock(mutex_);
+  return columns_.size();
+}
+
+}  // namespace World
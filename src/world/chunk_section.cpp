@@ -0,0 +1,197 @@
+#include "world/chunk_section.h"
+
+#include <algorithm>
+#include <array>
+
+#include "network/packet_buffer.h"
+#include "protocol/version.h"
+
+namespace World {
+
+namespace {
+
+constexpr size_t LongsFor(uint8_t bits) {
+  const size_t values_per_long = 64 / bits;
+  return (SECTION_VOLUME + values_per_long - 1) / values_per_long;
+}
+
+}  // namespace
+
+uint8_t ChunkSection::BitsForPaletteSize(size_t palette_size) {
+  if (palette_size <= 1) {
+    return 0;
+  }
+  uint8_t bits = 0;
+  while ((size_t{1} << bits) < palette_size) {
+    ++bits;
+  }
+  if (bits > 8) {
+    return DIRECT_BITS;
+  }
+  return std::max<uint8_t>(bits, 4);
+}
+
+uint32_t ChunkSection::ReadRaw(uint16_t index) const {
+  const uint32_t values_per_long = 64 / bits_;
+  const uint64_t word = data_[index / values_per_long];
+  const uint32_t shift = (index % values_per_long) * bits_;
+  return static_cast<uint32_t>((word >> shift) & ((uint64_t{1} << bits_) - 1));
+}
+
+void ChunkSection::WriteRaw(uint16_t index, uint32_t value) {
+  const uint32_t values_per_long = 64 / bits_;
+  uint64_t& word = data_[index / values_per_long];
+  const uint32_t shift = (index % values_per_long) * bits_;
+  const uint64_t mask = ((uint64_t{1} << bits_) - 1) << shift;
+  word = (word & ~mask) | ((static_cast<uint64_t>(value) << shift) & mask);
+}
+
+int32_t ChunkSection::GetBlock(uint16_t index) const {
+  if (bits_ == 0) {
+    return palette_.front();
+  }
+  const uint32_t raw = ReadRaw(index);
+  return palette_.empty() ? static_cast<int32_t>(raw) : palette_[raw];
+}
+
+void ChunkSection::Repack(uint8_t new_bits) {
+  const uint8_t old_bits = bits_;
+  SectionVector<uint64_t> old_data = std::move(data_);
+  const bool to_direct = new_bits == DIRECT_BITS;
+
+  bits_ = new_bits;
+  data_.assign(LongsFor(new_bits), 0);
+
+  if (old_bits == 0) {
+    // Every entry was palette index 0.
+    if (to_direct) {
+      for (uint16_t i = 0; i < SECTION_VOLUME; ++i) {
+        WriteRaw(i, static_cast<uint32_t>(palette_.front()));
+      }
+      palette_.clear();
+    }
+    return;
+  }
+
+  const uint32_t old_values_per_long = 64 / old_bits;
+  const uint64_t old_mask = (uint64_t{1} << old_bits) - 1;
+  for (uint16_t i = 0; i < SECTION_VOLUME; ++i) {
+    const uint64_t word = old_data[i / old_values_per_long];
+    uint32_t raw = static_cast<uint32_t>((word >> ((i % old_values_per_long) * old_bits)) & old_mask);
+    if (to_direct) {
+      raw = static_cast<uint32_t>(palette_[raw]);
+    }
+    WriteRaw(i, raw);
+  }
+  if (to_direct) {
+    palette_.clear();
+  }
+}
+
+int32_t ChunkSection::PaletteIndexOf(int32_t state_id) {
+  if (bits_ == DIRECT_BITS) {
+    return state_id;
+  }
+  for (size_t i = 0; i < palette_.size(); ++i) {
+    if (palette_[i] == state_id) {
+      return static_cast<int32_t>(i);
+    }
+  }
+  palette_.push_back(state_id);
+  const uint8_t needed = BitsForPaletteSize(palette_.size());
+  if (needed != bits_) {
+    Repack(needed);
+    if (needed == DIRECT_BITS) {
+      return state_id;
+    }
+  }
+  return static_cast<int32_t>(palette_.size() - 1);
+}
+
+int32_t ChunkSection::SetBlock(uint16_t index, int32_t state_id) {
+  const int32_t previous = GetBlock(index);
+  if (previous == state_id) {
+    return previous;
+  }
+
+  WriteRaw(index, static_cast<uint32_t>(PaletteIndexOf(state_id)));
+
+  if (previous == AIR_STATE) {
+    ++non_air_count_;
+  } else if (state_id == AIR_STATE) {
+    --non_air_count_;
+  }
+  return previous;
+}
+
+void ChunkSection::Fill(int32_t state_id) {
+  bits_ = 0;
+  palette_.assign(1, state_id);
+  data_.clear();
+  non_air_count_ = state_id == AIR_STATE ? 0 : SECTION_VOLUME;
+}
+
+void ChunkSection::Assign(std::span<const int32_t, SECTION_VOLUME> states) {
+  std::array<int32_t, SECTION_VOLUME> sorted;
+  std::copy(states.begin(), states.end(), sorted.begin());
+  std::sort(sorted.begin(), sorted.end());
+  const auto unique_end = std::unique(sorted.begin(), sorted.end());
+  const size_t unique_count = static_cast<size_t>(unique_end - sorted.begin());
+
+  if (unique_count == 1) {
+    Fill(sorted.front());
+    return;
+  }
+
+  bits_ = BitsForPaletteSize(unique_count);
+  data_.assign(LongsFor(bits_), 0);
+  non_air_count_ = static_cast<int16_t>(
+      SECTION_VOLUME - std::count(states.begin(), states.end(), AIR_STATE));
+
+  if (bits_ == DIRECT_BITS) {
+    palette_.clear();
+    for (uint16_t i = 0; i < SECTION_VOLUME; ++i) {
+      WriteRaw(i, static_cast<uint32_t>(states[i]));
+    }
+    return;
+  }
+
+  palette_.assign(sorted.begin(), unique_end);
+  for (uint16_t i = 0; i < SECTION_VOLUME; ++i) {
+    const auto slot = std::lower_bound(palette_.begin(), palette_.end(), states[i]);
+    WriteRaw(i, static_cast<uint32_t>(slot - palette_.begin()));
+  }
+}
+
+void ChunkSection::Export(std::span<int32_t, SECTION_VOLUME> states) const {
+  if (bits_ == 0) {
+    std::fill(states.begin(), states.end(), palette_.front());
+    return;
+  }
+  for (uint16_t i = 0; i < SECTION_VOLUME; ++i) {
+    const uint32_t raw = ReadRaw(i);
+    states[i] = palette_.empty() ? static_cast<int32_t>(raw) : palette_[raw];
+  }
+}
+
+void ChunkSection::Serialize(Network::PacketBuffer& buffer) const {
+  buffer.WriteShort(non_air_count_);
+  buffer.WriteByte(bits_);
+  if (bits_ == 0) {
+    buffer.WriteVarInt(palette_.front());
+  } else if (bits_ != DIRECT_BITS) {
+    buffer.WriteVarInt(static_cast<int32_t>(palette_.size()));
+    for (int32_t state_id : palette_) {
+      buffer.WriteVarInt(state_id);
+    }
+  }
+#if MINECRAFT_VERSION < 121500
+  // The data array length prefix was dropped in 1.21.5.
+  buffer.WriteVarInt(static_cast<int32_t>(data_.size()));
+#endif
+  for (uint64_t word : data_) {
+    buffer.WriteLong(static_cast<int64_t>(word));
+  }
+}
+
+}  // namespace World
@@ -0,0 +1,100 @@
+#include "world/section_change_tracker.h"
+
+#include "network/packet_buffer.h"
+#include "protocol/packet_ids.h"
+
+namespace World {
+
+uint16_t SectionChangeTracker::PackedLocal(const BlockPosition& position) {
+  // Update Section Blocks orders the local coordinates x, z, y.
+  return static_cast<uint16_t>(((position.x & 15) << 8) | ((position.z & 15) << 4) |
+                               (position.y & 15));
+}
+
+void SectionChangeTracker::RecordChange(const BlockPosition& position, int32_t state_id) {
+  ++stats_.changes_recorded;
+
+  const SectionPosition section_position = position.Section();
+  auto it = pending_.find(section_position);
+  if (it == pending_.end()) {
+    if (spare_.empty()) {
+      it = pending_.try_emplace(section_position).first;
+    } else {
+      PendingMap::node_type node = std::move(spare_.back());
+      spare_.pop_back();
+      node.key() = section_position;
+      it = pending_.insert(std::move(node)).position;
+    }
+  }
+  PendingSection& section = it->second;
+
+  const uint16_t local = PackedLocal(position);
+  const uint64_t entry = (static_cast<uint64_t>(state_id) << 12) | local;
+  const uint16_t index = position.SectionIndex();
+
+  if (section.touched.test(index)) {
+    // Rare within a tick; a linear scan keeps the common path allocation free.
+    for (uint64_t& existing : section.entries) {
+      if ((existing & 0xFFF) == local) {
+        existing = entry;
+        break;
+      }
+    }
+    ++stats_.changes_overwritten;
+    return;
+  }
+
+  section.touched.set(index);
+  section.entries.push_back(entry);
+}
+
+void SectionChangeTracker::Flush(const BroadcastFunction& broadcast) {
+  while (!pending_.empty()) {
+    PendingMap::node_type node = pending_.extract(pending_.begin());
+    const SectionPosition& position = node.key();
+    PendingSection& section = node.mapped();
+    Network::SharedPacket packet = section.entries.size() == 1
+                                       ? EncodeSingle(position, section.entries.front())
+                                       : EncodeMultiple(position, section.entries);
+    stats_.bytes_encoded += packet->bytes.size();
+    broadcast(position, packet);
+
+    section.touched.reset();
+    section.entries.clear();
+    spare_.push_back(std::move(node));
+  }
+}
+
+Network::SharedPacket SectionChangeTracker::EncodeSingle(const SectionPosition& section,
+                                                         uint64_t entry) {
+  const BlockPosition position{
+      section.x * SECTION_SIZE + static_cast<int32_t>((entry >> 8) & 15),
+      section.y * SECTION_SIZE + static_cast<int32_t>(entry & 15),
+      section.z * SECTION_SIZE + static_cast<int32_t>((entry >> 4) & 15)};
+
+  constexpr int32_t packet_id = Protocol::Play::Clientbound::BLOCK_UPDATE;
+  Network::PacketBuffer buffer =
+      pool_ != nullptr ? pool_->Acquire(packet_id, 16) : Network::PacketBuffer(packet_id, 16);
+  buffer.WriteLong(position.Encode());
+  buffer.WriteVarInt(static_cast<int32_t>(entry >> 12));
+  ++stats_.block_update_packets;
+  return pool_ != nullptr ? pool_->Finish(buffer) : buffer.Finish();
+}
+
+Network::SharedPacket SectionChangeTracker::EncodeMultiple(const SectionPosition& section,
+                                                           const std::vector<uint64_t>& entries) {
+  // Typical entries take 3-4 bytes; the buffer grows if states need more.
+  constexpr int32_t packet_id = Protocol::Play::Clientbound::UPDATE_SECTION_BLOCKS;
+  const size_t estimate = 16 + entries.size() * 4;
+  Network::PacketBuffer buffer = pool_ != nullptr ? pool_->Acquire(packet_id, estimate)
+                                                  : Network::PacketBuffer(packet_id, estimate);
+  buffer.WriteLong(section.Encode());
+  buffer.WriteVarInt(static_cast<int32_t>(entries.size()));
+  for (uint64_t entry : entries) {
+    buffer.WriteVarLong(static_cast<int64_t>(entry));
+  }
+  ++stats_.section_update_packets;
+  return pool_ != nullptr ? pool_->Finish(buffer) : buffer.Finish();
+}
+
+}  // namespace World
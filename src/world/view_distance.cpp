@@ -0,0 +1,36 @@
+#include "world/view_distance.h"
+
+#include <algorithm>
+
+namespace World {
+
+ViewDistancePolicy::ViewDistancePolicy(int32_t view_distance, int32_t simulation_distance,
+                                       int32_t minimum)
+    : configured_view_(view_distance),
+      configured_simulation_(simulation_distance),
+      minimum_(minimum),
+      view_distance_(view_distance),
+      simulation_distance_(simulation_distance) {}
+
+void ViewDistancePolicy::OnPressure(Util::MemoryPressureLevel level) {
+  view_distance_.store(Reduce(configured_view_, level), std::memory_order_relaxed);
+  simulation_distance_.store(Reduce(configured_simulation_, level), std::memory_order_relaxed);
+}
+
+int32_t ViewDistancePolicy::Reduce(int32_t distance, Util::MemoryPressureLevel level) const {
+  int32_t reduced = distance;
+  switch (level) {
+    case Util::MemoryPressureLevel::NONE:
+      break;
+    case Util::MemoryPressureLevel::MODERATE:
+      reduced = distance * 3 / 4;
+      break;
+    case Util::MemoryPressureLevel::CRITICAL:
+      reduced = distance / 2;
+      break;
+  }
+  // A configured distance below the minimum is kept as is
+  return std::max(reduced, std::min(minimum_, distance));
+}
+
+}  // namespace World
@@ -0,0 +1,181 @@
+#include "advancement/advancement_index.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "network/packet_buffer.h"
+#include "protocol/packet_ids.h"
+#include "protocol/version.h"
+
+namespace {
+
+constexpr int32_t STONE = 1;
+constexpr int32_t IRON_INGOT = 2;
+constexpr int32_t DIAMOND = 3;
+constexpr int32_t ZOMBIE = 54;
+constexpr int64_t NOW = 1760000000000;
+
+Advancement::CriterionDefinition Criterion(std::string name, Advancement::TriggerType trigger,
+                                           std::vector<int32_t> subjects = {},
+                                           Advancement::CriterionPredicate predicate = nullptr) {
+  return {.name = std::move(name),
+          .trigger = trigger,
+          .subjects = std::move(subjects),
+          .predicate = std::move(predicate)};
+}
+
+Advancement::AdvancementDefinition Definition(
+    std::string id, std::vector<Advancement::CriterionDefinition> criteria) {
+  Advancement::AdvancementDefinition definition;
+  definition.id = std::move(id);
+  definition.criteria = std::move(criteria);
+  return definition;
+}
+
+Advancement::TriggerEvent Event(Advancement::TriggerType type, int32_t subject, int64_t value = 0) {
+  Advancement::TriggerEvent event;
+  event.type = type;
+  event.subject = subject;
+  event.value = value;
+  return event;
+}
+
+}  // namespace
+
+TEST(AdvancementTest, EventsOnlyEvaluateCriteriaOfTheirTriggerAndSubject) {
+  using Advancement::TriggerType;
+  Advancement::AdvancementRegistry registry;
+  auto at_least = [](int64_t amount) {
+    return [amount](const Advancement::TriggerEvent& event) { return event.value >= amount; };
+  };
+  registry.Add(Definition("test:mine_stone",
+                          {Criterion("stone", TriggerType::INVENTORY_CHANGED, {STONE})}));
+  registry.Add(Definition("test:iron_stack", {Criterion("iron", TriggerType::INVENTORY_CHANGED,
+                                                        {IRON_INGOT}, at_least(64))}));
+  registry.Add(Definition("test:kill_zombie",
+                          {Criterion("zombie", TriggerType::PLAYER_KILLED_ENTITY, {ZOMBIE},
+                                     at_least(1))}));
+  Advancement::PlayerAdvancements progress(registry);
+
+  EXPECT_EQ(progress.Trigger(Event(TriggerType::INVENTORY_CHANGED, DIAMOND), NOW), 0u);
+  EXPECT_EQ(progress.Trigger(Event(TriggerType::INVENTORY_CHANGED, IRON_INGOT, 10), NOW), 0u);
+  EXPECT_EQ(progress.Trigger(Event(TriggerType::INVENTORY_CHANGED, IRON_INGOT, 64), NOW), 1u);
+  EXPECT_EQ(progress.Trigger(Event(TriggerType::INVENTORY_CHANGED, STONE), NOW), 1u);
+  EXPECT_EQ(progress.GetStats().predicates_evaluated, 2u);
+
+  // Every INVENTORY_CHANGED criterion is granted now, so further events return at once
+  EXPECT_EQ(progress.Trigger(Event(TriggerType::INVENTORY_CHANGED, IRON_INGOT, 64), NOW), 0u);
+  EXPECT_EQ(progress.Trigger(Event(TriggerType::TICK, -1), NOW), 0u);
+  const Advancement::AdvancementStats& stats = progress.GetStats();
+  EXPECT_EQ(stats.events_skipped, 2u);
+  EXPECT_EQ(stats.predicates_evaluated, 2u);
+  EXPECT_EQ(stats.advancements_completed, 2u);
+  EXPECT_FALSE(progress.IsDone(*registry.Find("test:kill_zombie")));
+}
+
+TEST(AdvancementTest, RequirementGroupsAreAndOfOr) {
+  using Advancement::TriggerType;
+  Advancement::AdvancementRegistry registry;
+  Advancement::AdvancementDefinition definition =
+      Definition("test:any_ore_and_a_kill",
+                 {Criterion("iron", TriggerType::INVENTORY_CHANGED, {IRON_INGOT}),
+                  Criterion("diamond", TriggerType::INVENTORY_CHANGED, {DIAMOND}),
+                  Criterion("zombie", TriggerType::PLAYER_KILLED_ENTITY, {ZOMBIE})});
+  definition.requirements = {{"iron", "diamond"}, {"zombie"}};
+  const Advancement::AdvancementId id = registry.Add(std::move(definition));
+  Advancement::PlayerAdvancements progress(registry);
+  std::vector<Advancement::AdvancementId> completed;
+  progress.OnCompleted([&](Advancement::AdvancementId done) { completed.push_back(done); });
+
+  progress.Trigger(Event(TriggerType::INVENTORY_CHANGED, DIAMOND), NOW);
+  EXPECT_FALSE(progress.IsDone(id));
+  progress.Trigger(Event(TriggerType::PLAYER_KILLED_ENTITY, ZOMBIE), NOW);
+  EXPECT_TRUE(progress.IsDone(id));
+  EXPECT_EQ(completed, (std::vector<Advancement::AdvancementId>{id}));
+
+  // The unused alternative stopped listening with the completion
+  EXPECT_EQ(progress.Trigger(Event(TriggerType::INVENTORY_CHANGED, IRON_INGOT), NOW), 0u);
+  EXPECT_FALSE(progress.IsObtained(*registry.FindCriterion(id, "iron")));
+  EXPECT_EQ(progress.GetStats().events_skipped, 1u);
+}
+
+TEST(AdvancementTest, RevokingReopensTheAdvancement) {
+  using Advancement::TriggerType;
+  Advancement::AdvancementRegistry registry;
+  const Advancement::AdvancementId id = registry.Add(Definition(
+      "test:kill", {Criterion("zombie", TriggerType::PLAYER_KILLED_ENTITY, {ZOMBIE})}));
+  Advancement::PlayerAdvancements progress(registry);
+  const Advancement::CriterionId zombie = *registry.FindCriterion(id, "zombie");
+
+  EXPECT_TRUE(progress.Grant(zombie, NOW));
+  EXPECT_FALSE(progress.Grant(zombie, NOW));
+  EXPECT_TRUE(progress.IsDone(id));
+  EXPECT_TRUE(progress.Revoke(zombie));
+  EXPECT_FALSE(progress.Revoke(zombie));
+  EXPECT_FALSE(progress.IsDone(id));
+
+  EXPECT_EQ(progress.Trigger(Event(TriggerType::PLAYER_KILLED_ENTITY, ZOMBIE), NOW), 1u);
+  EXPECT_TRUE(progress.IsDone(id));
+  EXPECT_EQ(progress.GetStats().advancements_completed, 2u);
+}
+
+TEST(AdvancementTest, UpdatesCarryOnlyChangedProgress) {
+  using Advancement::TriggerType;
+  Advancement::AdvancementRegistry registry;
+  registry.Add(Definition("test:stone", {Criterion("stone", TriggerType::INVENTORY_CHANGED,
+                                                   {STONE})}));
+  registry.Add(Definition("test:iron", {Criterion("iron", TriggerType::INVENTORY_CHANGED,
+                                                  {IRON_INGOT})}));
+  Advancement::PlayerAdvancements progress(registry);
+  EXPECT_EQ(progress.FlushUpdate(), nullptr);
+
+  progress.Trigger(Event(TriggerType::INVENTORY_CHANGED, IRON_INGOT), NOW);
+  const Network::SharedPacket update = progress.FlushUpdate();
+  ASSERT_NE(update, nullptr);
+
+  Network::PacketBuffer expected(Protocol::Play::Clientbound::UPDATE_ADVANCEMENTS);
+  expected.WriteBool(false);  // No reset
+  expected.WriteVarInt(0);    // No definitions
+  expected.WriteVarInt(0);    // No removals
+  expected.WriteVarInt(1);
+  expected.WriteString("test:iron");
+  expected.WriteVarInt(1);
+  expected.WriteString("iron");
+  expected.WriteBool(true);
+  expected.WriteLong(NOW);
+#if MINECRAFT_VERSION >= 121500
+  expected.WriteBool(true);
+#endif
+  EXPECT_EQ(update->bytes, expected.Finish()->bytes);
+  EXPECT_EQ(progress.FlushUpdate(), nullptr);
+
+  // The full sync carries every definition, and is larger than the delta
+  const Network::SharedPacket full = progress.FullSyncPacket();
+  EXPECT_EQ(full->bytes[1], 1);  // Reset flag after the single-byte packet id
+  EXPECT_GT(full->bytes.size(), update->bytes.size());
+}
+
+TEST(AdvancementTest, MalformedDefinitionsAreRejected) {
+  using Advancement::TriggerType;
+  Advancement::AdvancementRegistry registry;
+  registry.Add(Definition("test:once", {Criterion("a", TriggerType::TICK)}));
+  EXPECT_THROW(registry.Add(Definition("test:once", {Criterion("a", TriggerType::TICK)})),
+               std::invalid_argument);
+  EXPECT_THROW(registry.Add(Definition("test:twice", {Criterion("a", TriggerType::TICK),
+                                                      Criterion("a", TriggerType::TICK)})),
+               std::invalid_argument);
+  Advancement::AdvancementDefinition unknown =
+      Definition("test:unknown", {Criterion("a", TriggerType::TICK)});
+  unknown.requirements = {{"b"}};
+  EXPECT_THROW(registry.Add(std::move(unknown)), std::invalid_argument);
+  EXPECT_EQ(registry.Size(), 1u);
+
+  // An advancement without criteria is done from the start
+  const Advancement::AdvancementId root = registry.Add(Definition("test:root", {}));
+  Advancement::PlayerAdvancements progress(registry);
+  EXPECT_TRUE(progress.IsDone(root));
+}
@@ -0,0 +1,197 @@
+#include "chat/chat_pipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/** @brief Records the text of every chat packet it receives, in order */
+class RecordingSink : public Network::PacketSink {
+ public:
+  explicit RecordingSink(std::vector<std::string> texts) : texts_(std::move(texts)) {}
+
+  void SendPacket(const Network::SharedPacket& packet) override {
+    const std::string bytes(packet->bytes.begin(), packet->bytes.end());
+    std::lock_guard lock(mutex_);
+    for (const std::string& text : texts_) {
+      if (bytes.find(text) != std::string::npos) {
+        received_.push_back(text);
+        return;
+      }
+    }
+    received_.push_back("?");
+  }
+
+  std::vector<std::string> Received() {
+    std::lock_guard lock(mutex_);
+    return received_;
+  }
+
+ private:
+  std::vector<std::string> texts_;
+  std::mutex mutex_;
+  std::vector<std::string> received_;
+};
+
+class ThrowingSink : public Network::PacketSink {
+ public:
+  void SendPacket(const Network::SharedPacket&) override {
+    throw std::runtime_error("connection closed");
+  }
+};
+
+Chat::ChatMessage Message(int32_t index, std::string text) {
+  Chat::ChatMessage message;
+  message.sender_name = "Steve";
+  message.text = std::move(text);
+  message.index = index;
+  message.signature = Chat::MessageSignature{};
+  return message;
+}
+
+/** @brief Distinct texts that do not contain each other */
+std::vector<std::string> Texts(int count) {
+  std::vector<std::string> texts;
+  for (int i = 0; i < count; ++i) {
+    texts.push_back("message-" + std::to_string(1000 + i));
+  }
+  return texts;
+}
+
+bool WaitFor(const std::function<bool()>& done) {
+  const auto deadline = std::chrono::steady_clock::now() + 10s;
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(ChatPipelineTest, BroadcastsInSubmissionOrderWhenVerificationFinishesOutOfOrder) {
+  constexpr int COUNT = 8;
+  const std::vector<std::string> texts = Texts(COUNT);
+  std::atomic<int> verified_later{0};
+
+  Util::WorkerPool workers(4);
+  // The first message finishes verification only after all the others did
+  Chat::ChatPipeline chat(workers, [&](const Chat::ChatMessage& message) {
+    if (message.index == 0) {
+      WaitFor([&] { return verified_later.load() == COUNT - 1; });
+    } else {
+      verified_later.fetch_add(1);
+    }
+    return true;
+  });
+  RecordingSink sink(texts);
+  chat.SetRecipients(std::make_shared<const Chat::RecipientList>(
+      Chat::RecipientList{std::make_shared<Chat::ChatRecipient>(sink)}));
+
+  for (int i = 0; i < COUNT; ++i) {
+    chat.Submit(Message(i, texts[i]));
+  }
+  ASSERT_TRUE(WaitFor([&] { return chat.GetStats().broadcast == COUNT; }));
+  EXPECT_EQ(sink.Received(), texts);
+}
+
+TEST(ChatPipelineTest, RejectedMessagesDoNotHoldUpLaterOnes) {
+  const std::vector<std::string> texts = Texts(4);
+  Util::WorkerPool workers(2);
+  Chat::ChatPipeline chat(workers, [](const Chat::ChatMessage& message) {
+    return message.index != 1;
+  });
+  std::atomic<int> rejected{0};
+  chat.OnReject([&](const Chat::ChatMessage&, Chat::RejectReason reason) {
+    EXPECT_EQ(reason, Chat::RejectReason::BAD_SIGNATURE);
+    rejected.fetch_add(1);
+  });
+  RecordingSink sink(texts);
+  chat.SetRecipients(std::make_shared<const Chat::RecipientList>(
+      Chat::RecipientList{std::make_shared<Chat::ChatRecipient>(sink)}));
+
+  for (int i = 0; i < 4; ++i) {
+    chat.Submit(Message(i, texts[i]));
+  }
+  ASSERT_TRUE(WaitFor([&] { return chat.GetStats().broadcast == 3; }));
+  EXPECT_EQ(sink.Received(), (std::vector<std::string>{texts[0], texts[2], texts[3]}));
+  EXPECT_EQ(rejected.load(), 1);
+}
+
+TEST(ChatPipelineTest, ThrowingVerifierDropsOnlyItsMessage) {
+  const std::vector<std::string> texts = Texts(4);
+  Util::WorkerPool workers(2);
+  Chat::ChatPipeline chat(workers, [](const Chat::ChatMessage& message) -> bool {
+    if (message.index == 1) {
+      throw std::runtime_error("key lookup failed");
+    }
+    return true;
+  });
+  RecordingSink sink(texts);
+  chat.SetRecipients(std::make_shared<const Chat::RecipientList>(
+      Chat::RecipientList{std::make_shared<Chat::ChatRecipient>(sink)}));
+
+  for (int i = 0; i < 4; ++i) {
+    chat.Submit(Message(i, texts[i]));
+  }
+  ASSERT_TRUE(WaitFor([&] { return chat.GetStats().broadcast == 3; }));
+  EXPECT_EQ(sink.Received(), (std::vector<std::string>{texts[0], texts[2], texts[3]}));
+}
+
+TEST(ChatPipelineTest, ThrowingRejectHandlerDoesNotStallChat) {
+  const std::vector<std::string> texts = Texts(3);
+  Util::WorkerPool workers(2);
+  Chat::ChatPipeline chat(workers, nullptr, {.enforce_secure_chat = true});
+  chat.OnReject([](const Chat::ChatMessage&, Chat::RejectReason) {
+    throw std::runtime_error("kick failed");
+  });
+  RecordingSink sink(texts);
+  chat.SetRecipients(std::make_shared<const Chat::RecipientList>(
+      Chat::RecipientList{std::make_shared<Chat::ChatRecipient>(sink)}));
+
+  chat.Submit(Message(0, texts[0]));
+  Chat::ChatMessage unsigned_message = Message(1, texts[1]);
+  unsigned_message.signature.reset();
+  chat.Submit(std::move(unsigned_message));
+  chat.Submit(Message(2, texts[2]));
+
+  ASSERT_TRUE(WaitFor([&] { return chat.GetStats().broadcast == 2; }));
+  EXPECT_EQ(sink.Received(), (std::vector<std::string>{texts[0], texts[2]}));
+}
+
+TEST(ChatPipelineTest, ThrowingSinkDoesNotSkipOtherRecipients) {
+  const std::vector<std::string> texts = Texts(3);
+  Util::WorkerPool workers(2);
+  Chat::ChatPipeline chat(workers, nullptr);
+  ThrowingSink broken;
+  RecordingSink sink(texts);
+  chat.SetRecipients(std::make_shared<const Chat::RecipientList>(
+      Chat::RecipientList{std::make_shared<Chat::ChatRecipient>(broken),
+                          std::make_shared<Chat::ChatRecipient>(sink)}));
+
+  for (int i = 0; i < 3; ++i) {
+    chat.Submit(Message(i, texts[i]));
+  }
+  ASSERT_TRUE(WaitFor([&] { return sink.Received().size() == 3; }));
+  EXPECT_EQ(sink.Received(), texts);
+}
+
+TEST(ChatPipelineTest, ValidateRejectsFormattingCodes) {
+  EXPECT_EQ(Chat::ChatPipeline::Validate(Message(0, "hello")), std::nullopt);
+  EXPECT_EQ(Chat::ChatPipeline::Validate(Message(0, "\xC2\xA7" "cred")),
+            Chat::RejectReason::ILLEGAL_CHARACTERS);
+  EXPECT_EQ(Chat::ChatPipeline::Validate(Message(0, std::string(257, 'a'))),
+            Chat::RejectReason::TOO_LONG);
+}
@@ -0,0 +1,141 @@
+#include "command/command_graph.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief say <message: greedy>, msg <target> <message: quotable>,
+ *        setblock <pos> <block> and gamemode <mode> (level 2)
+ */
+Command::CommandGraph BuildTestGraph() {
+  Command::CommandGraphBuilder builder;
+  auto run = [](const Command::CommandSource&, const Command::ParseResult&) { return 1; };
+
+  const Command::NodeId say = builder.Literal(Command::ROOT_NODE, "say");
+  builder.Executes(builder.Argument(say, "message", {.type = Command::ArgumentType::GREEDY_STRING,
+                                                     .suggestions = {"hello", "help"}}),
+                   run);
+
+  const Command::NodeId msg = builder.Literal(Command::ROOT_NODE, "msg");
+  const Command::NodeId target = builder.Argument(msg, "target", {});
+  builder.Executes(builder.Argument(target, "message",
+                                    {.type = Command::ArgumentType::QUOTABLE_STRING,
+                                     .suggestions = {"\"good game\"", "gg"}}),
+                   run);
+
+  const Command::NodeId setblock = builder.Literal(Command::ROOT_NODE, "setblock");
+  const Command::NodeId pos =
+      builder.Argument(setblock, "pos", {.type = Command::ArgumentType::BLOCK_POS,
+                                         .suggestions = {"~ ~ ~"}});
+  builder.Executes(builder.Argument(pos, "block", {.suggestions = {"stone", "stone_bricks"}}),
+                   run);
+
+  const Command::NodeId gamemode = builder.Literal(Command::ROOT_NODE, "gamemode", 2);
+  for (std::string_view mode : {"survival", "creative", "spectator"}) {
+    builder.Executes(builder.Literal(gamemode, mode), run);
+  }
+  return builder.Build();
+}
+
+std::vector<std::string> Completions(const Command::CommandGraph& graph, std::string_view input,
+                                     uint8_t permission_level, size_t& start) {
+  std::vector<std::string_view> matches;
+  graph.Complete(input, permission_level, start, matches);
+  return {matches.begin(), matches.end()};
+}
+
+}  // namespace
+
+TEST(CommandGraphTest, ParsesArgumentsIntoTheResult) {
+  const Command::CommandGraph graph = BuildTestGraph();
+
+  const Command::ParseResult msg = graph.Parse("msg Steve \"good game\"", 0);
+  ASSERT_EQ(msg.status, Command::ParseStatus::OK);
+  ASSERT_EQ(msg.argument_count, 2u);
+  EXPECT_EQ(msg.Find(graph, "target")->text, "Steve");
+  EXPECT_EQ(msg.Find(graph, "message")->text, "good game");
+
+  const Command::ParseResult setblock = graph.Parse("setblock 1 -2 3 stone", 0);
+  ASSERT_EQ(setblock.status, Command::ParseStatus::OK);
+  EXPECT_EQ(setblock.Find(graph, "pos")->position, (std::array<int32_t, 3>{1, -2, 3}));
+
+  const Command::ParseResult say = graph.Parse("say hi there", 0);
+  ASSERT_EQ(say.status, Command::ParseStatus::OK);
+  EXPECT_EQ(say.Find(graph, "message")->text, "hi there");
+}
+
+TEST(CommandGraphTest, ReportsWhereParsingFailed) {
+  const Command::CommandGraph graph = BuildTestGraph();
+
+  EXPECT_EQ(graph.Parse("nope", 4).status, Command::ParseStatus::UNKNOWN_COMMAND);
+  EXPECT_EQ(graph.Parse("gamemode creative", 0).status, Command::ParseStatus::UNKNOWN_COMMAND);
+  EXPECT_EQ(graph.Parse("gamemode creative", 2).status, Command::ParseStatus::OK);
+  EXPECT_EQ(graph.Parse("msg Steve", 0).status, Command::ParseStatus::INCOMPLETE);
+
+  const Command::ParseResult bad = graph.Parse("setblock 1 x 3 stone", 0);
+  EXPECT_EQ(bad.status, Command::ParseStatus::INVALID_ARGUMENT);
+  EXPECT_EQ(bad.error_offset, 9u);
+}
+
+TEST(CommandGraphTest, CompletesLiteralsForThePermissionLevel) {
+  const Command::CommandGraph graph = BuildTestGraph();
+  size_t start = 99;
+
+  EXPECT_EQ(Completions(graph, "s", 0, start), (std::vector<std::string>{"say", "setblock"}));
+  EXPECT_EQ(start, 0u);
+  EXPECT_TRUE(Completions(graph, "game", 0, start).empty());
+  EXPECT_EQ(Completions(graph, "game", 2, start), (std::vector<std::string>{"gamemode"}));
+  EXPECT_EQ(Completions(graph, "gamemode s", 2, start),
+            (std::vector<std::string>{"spectator", "survival"}));
+  EXPECT_EQ(start, 9u);
+}
+
+TEST(CommandGraphTest, CompletesMultiWordArgumentsFromTheirStart) {
+  const Command::CommandGraph graph = BuildTestGraph();
+  size_t start = 0;
+
+  // A quoted string still being typed starts at its opening quote
+  EXPECT_EQ(Completions(graph, "msg Steve \"good g", 0, start),
+            (std::vector<std::string>{"\"good game\""}));
+  EXPECT_EQ(start, 10u);
+
+  // The remaining axes of a block position belong to the same argument
+  EXPECT_EQ(Completions(graph, "setblock ~ ~", 0, start), (std::vector<std::string>{"~ ~ ~"}));
+  EXPECT_EQ(start, 9u);
+
+  // Once the position is complete, the next node is the block
+  EXPECT_EQ(Completions(graph, "setblock 1 2 3 st", 0, start),
+            (std::vector<std::string>{"stone", "stone_bricks"}));
+  EXPECT_EQ(start, 15u);
+
+  // A greedy string is never complete, so its suggestions match the whole message
+  EXPECT_EQ(Completions(graph, "say hel", 0, start), (std::vector<std::string>{"hello", "help"}));
+  EXPECT_TRUE(Completions(graph, "say oh hel", 0, start).empty());
+  EXPECT_EQ(start, 4u);
+}
+
+TEST(CommandGraphTest, CommandsPacketHidesNodesAboveTheLevel) {
+  const Command::CommandGraph graph = BuildTestGraph();
+  const std::vector<uint8_t>& player = graph.CommandsPacket(0)->bytes;
+  const std::vector<uint8_t>& op = graph.CommandsPacket(2)->bytes;
+  const std::vector<uint8_t>& clamped = graph.CommandsPacket(200)->bytes;
+
+  auto contains = [](const std::vector<uint8_t>& bytes, std::string_view text) {
+    return std::search(bytes.begin(), bytes.end(), text.begin(), text.end()) != bytes.end();
+  };
+  // Root, say, message, msg, target, message, setblock, pos, block: then gamemode and 3 modes
+  EXPECT_EQ(player[1], 9);
+  EXPECT_EQ(op[1], 13);
+  EXPECT_FALSE(contains(player, "gamemode"));
+  EXPECT_TRUE(contains(op, "gamemode"));
+  EXPECT_TRUE(contains(player, "minecraft:ask_server"));
+  EXPECT_EQ(clamped, graph.CommandsPacket(Command::MAX_PERMISSION_LEVEL)->bytes);
+}
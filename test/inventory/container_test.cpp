@@ -0,0 +1,159 @@
+#include "inventory/container.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "inventory/item_stack_cache.h"
+#include "network/packet_buffer.h"
+#include "protocol/packet_ids.h"
+#include "protocol/version.h"
+
+namespace {
+
+constexpr size_t SLOTS = 46;  // Player inventory window
+constexpr int32_t WINDOW = 0;
+
+/** @brief Keeps every packet a view sends */
+class RecordingSink : public Network::PacketSink {
+ public:
+  void SendPacket(const Network::SharedPacket& packet) override { packets.push_back(packet); }
+
+  std::vector<int32_t> Ids() const {
+    std::vector<int32_t> ids;
+    for (const Network::SharedPacket& packet : packets) {
+      ids.push_back(packet->packet_id);
+    }
+    return ids;
+  }
+
+  std::vector<Network::SharedPacket> packets;
+};
+
+Inventory::ItemStack Stack(int32_t item_id, int32_t count) {
+  return {.item_id = item_id, .count = count, .components = nullptr};
+}
+
+}  // namespace
+
+TEST(ContainerTest, EqualWritesDoNotBumpTheRevision) {
+  Inventory::Container container(SLOTS);
+  EXPECT_TRUE(container.SetSlot(3, Stack(1, 5)));
+  EXPECT_EQ(container.Revision(), 1u);
+  EXPECT_FALSE(container.SetSlot(3, Stack(1, 5)));
+  // Every empty stack is the same stack
+  EXPECT_FALSE(container.SetSlot(4, Stack(99, 0)));
+  EXPECT_EQ(container.Revision(), 1u);
+  EXPECT_EQ(container.SlotRevision(3), 1u);
+  EXPECT_EQ(container.SlotRevision(4), 0u);
+}
+
+TEST(ContainerViewTest, FirstFlushSendsTheFullContentOnce) {
+  Inventory::Container container(SLOTS);
+  container.SetSlot(0, Stack(1, 1));
+  Inventory::ItemStackCache cache;
+  RecordingSink sink;
+  Inventory::ContainerView view(container, WINDOW);
+
+  EXPECT_EQ(view.Flush(cache, sink), 1u);
+  EXPECT_EQ(view.Flush(cache, sink), 0u);
+  EXPECT_EQ(sink.Ids(),
+            (std::vector<int32_t>{Protocol::Play::Clientbound::SET_CONTAINER_CONTENT}));
+  EXPECT_EQ(view.StateId(), 1);
+  EXPECT_EQ(view.GetStats().bytes_sent, sink.packets[0]->bytes.size());
+}
+
+TEST(ContainerViewTest, ChangedSlotsAreSentOneByOne) {
+  Inventory::Container container(SLOTS);
+  Inventory::ItemStackCache cache;
+  RecordingSink sink;
+  Inventory::ContainerView view(container, WINDOW);
+  view.Flush(cache, sink);
+  sink.packets.clear();
+
+  container.SetSlot(36, Stack(7, 64));
+  container.SetSlot(9, Stack(8, 1));
+  EXPECT_EQ(view.Flush(cache, sink), 2u);
+  ASSERT_EQ(sink.Ids(), (std::vector<int32_t>(2, Protocol::Play::Clientbound::SET_CONTAINER_SLOT)));
+
+  // Slots go out in index order with a fresh state id each
+  Network::PacketBuffer expected(Protocol::Play::Clientbound::SET_CONTAINER_SLOT);
+#if MINECRAFT_VERSION >= 121300
+  expected.WriteVarInt(WINDOW);
+#else
+  expected.WriteByte(WINDOW);
+#endif
+  expected.WriteVarInt(2);
+  expected.WriteShort(9);
+  Inventory::ItemStackCache::Encode(expected, Stack(8, 1));
+  EXPECT_EQ(sink.packets[0]->bytes, expected.Finish()->bytes);
+  EXPECT_EQ(view.StateId(), 3);
+
+  const Inventory::ContainerSyncStats& stats = view.GetStats();
+  EXPECT_EQ(stats.content_packets, 1u);
+  EXPECT_EQ(stats.slot_packets, 2u);
+}
+
+TEST(ContainerViewTest, ManyChangesCollapseIntoOneContentPacket) {
+  Inventory::Container container(SLOTS);
+  Inventory::ItemStackCache cache;
+  RecordingSink sink;
+  Inventory::ContainerView view(container, WINDOW);
+  view.Flush(cache, sink);
+  sink.packets.clear();
+
+  for (size_t i = 0; i < SLOTS; ++i) {
+    container.SetSlot(i, Stack(static_cast<int32_t>(i + 1), 2));
+  }
+  view.SetCarried(Stack(5, 1));
+  EXPECT_EQ(view.Flush(cache, sink), 1u);
+  EXPECT_EQ(sink.Ids(),
+            (std::vector<int32_t>{Protocol::Play::Clientbound::SET_CONTAINER_CONTENT}));
+  // The content packet carried the cursor, so nothing is left to send
+  EXPECT_EQ(view.Flush(cache, sink), 0u);
+  EXPECT_EQ(view.GetStats().cursor_packets, 0u);
+}
+
+TEST(ContainerViewTest, CursorChangesAloneSendOnlyTheCursor) {
+  Inventory::Container container(SLOTS);
+  Inventory::ItemStackCache cache;
+  RecordingSink sink;
+  Inventory::ContainerView view(container, WINDOW);
+  view.Flush(cache, sink);
+
+  view.SetCarried(Stack(5, 1));
+  view.SetCarried(Stack(5, 2));
+  EXPECT_EQ(view.Flush(cache, sink), 1u);
+  view.SetCarried(Stack(5, 2));
+  EXPECT_EQ(view.Flush(cache, sink), 0u);
+
+  const Inventory::ContainerSyncStats& stats = view.GetStats();
+  EXPECT_EQ(stats.cursor_packets, 1u);
+  EXPECT_EQ(stats.slot_packets, 0u);
+#if MINECRAFT_VERSION >= 121300
+  EXPECT_EQ(sink.packets.back()->packet_id, Protocol::Play::Clientbound::SET_CURSOR_ITEM);
+#endif
+}
+
+TEST(ContainerViewTest, ViewsSyncIndependently) {
+  Inventory::Container container(SLOTS);
+  Inventory::ItemStackCache cache;
+  RecordingSink first_sink;
+  RecordingSink second_sink;
+  Inventory::ContainerView first(container, WINDOW);
+  Inventory::ContainerView second(container, 2);
+  first.Flush(cache, first_sink);
+  second.Flush(cache, second_sink);
+
+  container.SetSlot(0, Stack(1, 1));
+  first.Flush(cache, first_sink);
+  container.SetSlot(1, Stack(2, 1));
+  EXPECT_EQ(first.Flush(cache, first_sink), 1u);
+  EXPECT_EQ(second.Flush(cache, second_sink), 2u);
+
+  second.Resync();
+  EXPECT_EQ(second.Flush(cache, second_sink), 1u);
+  EXPECT_EQ(second.GetStats().content_packets, 2u);
+  EXPECT_GT(cache.GetStats().hits, 0u);
+}
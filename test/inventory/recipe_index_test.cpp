@@ -0,0 +1,138 @@
+#include "inventory/recipe_index.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int32_t PLANKS = 10;  // 10-13 are the plank variants
+constexpr int32_t STICK = 20;
+constexpr int32_t IRON = 30;
+constexpr int32_t DYE = 40;
+constexpr int32_t WOOL = 50;
+
+const Inventory::Ingredient NONE{};
+const Inventory::Ingredient ANY_PLANKS{{13, 11, PLANKS, 12}};
+const Inventory::Ingredient STICKS{{STICK}};
+
+Inventory::CraftingRecipe Shaped(std::string id, int32_t width, int32_t height,
+                                 std::vector<Inventory::Ingredient> pattern) {
+  Inventory::CraftingRecipe recipe;
+  recipe.id = std::move(id);
+  recipe.width = width;
+  recipe.height = height;
+  recipe.ingredients = std::move(pattern);
+  return recipe;
+}
+
+Inventory::CraftingRecipe Shapeless(std::string id, std::vector<Inventory::Ingredient> list) {
+  Inventory::CraftingRecipe recipe;
+  recipe.id = std::move(id);
+  recipe.kind = Inventory::CraftingRecipe::SHAPELESS;
+  recipe.ingredients = std::move(list);
+  return recipe;
+}
+
+Inventory::CraftingGrid Grid(std::array<int32_t, 9> items) {
+  Inventory::CraftingGrid grid;
+  grid.items = items;
+  return grid;
+}
+
+std::string MatchedId(const Inventory::RecipeIndex& index, const Inventory::CraftingGrid& grid) {
+  const Inventory::CraftingRecipe* recipe = index.Match(grid);
+  return recipe != nullptr ? recipe->id : "";
+}
+
+}  // namespace
+
+TEST(RecipeIndexTest, ShapedRecipesMatchAtAnyOffsetAndMirrored) {
+  Inventory::RecipeIndex index;
+  // Axe: planks planks / planks stick / - stick, registered with padding to be trimmed
+  index.Add(Shaped("axe", 3, 3,
+                   {ANY_PLANKS, ANY_PLANKS, NONE, ANY_PLANKS, STICKS, NONE, NONE, STICKS, NONE}));
+
+  EXPECT_EQ(MatchedId(index, Grid({PLANKS, 11, 0, 12, STICK, 0, 0, STICK, 0})), "axe");
+  EXPECT_EQ(MatchedId(index, Grid({0, 13, PLANKS, 0, 13, STICK, 0, 0, STICK})), "axe");
+  EXPECT_EQ(MatchedId(index, Grid({0, PLANKS, PLANKS, 0, STICK, PLANKS, 0, STICK, 0})), "axe");
+  // Off by one cell, and a stray item next to the pattern
+  EXPECT_EQ(MatchedId(index, Grid({PLANKS, PLANKS, 0, PLANKS, STICK, 0, STICK, 0, 0})), "");
+  EXPECT_EQ(MatchedId(index, Grid({PLANKS, PLANKS, IRON, PLANKS, STICK, 0, 0, STICK, 0})), "");
+
+  const Inventory::CraftingRecipe* axe =
+      index.Match(Grid({PLANKS, PLANKS, 0, PLANKS, STICK, 0, 0, STICK, 0}));
+  ASSERT_NE(axe, nullptr);
+  EXPECT_EQ(axe->width, 2);
+  EXPECT_EQ(axe->height, 3);
+}
+
+TEST(RecipeIndexTest, SmallCraftingGridsUseTheirOwnWidth) {
+  Inventory::RecipeIndex index;
+  index.Add(Shaped("sticks", 1, 2, {ANY_PLANKS, ANY_PLANKS}));
+  Inventory::CraftingGrid grid;
+  grid.width = 2;
+  grid.height = 2;
+  grid.items = {0, PLANKS, 0, 12};
+  EXPECT_EQ(MatchedId(index, grid), "sticks");
+  grid.items = {PLANKS, 0, 0, 12};
+  EXPECT_EQ(MatchedId(index, grid), "");
+}
+
+TEST(RecipeIndexTest, ShapelessIngredientsAreAssignedWithBacktracking) {
+  Inventory::RecipeIndex index;
+  // The first ingredient accepts both items; only one assignment works
+  index.Add(Shapeless("dyed_wool", {Inventory::Ingredient{{WOOL, DYE}},
+                                    Inventory::Ingredient{{WOOL}}}));
+  EXPECT_EQ(MatchedId(index, Grid({0, 0, DYE, 0, WOOL, 0, 0, 0, 0})), "dyed_wool");
+  EXPECT_EQ(MatchedId(index, Grid({WOOL, 0, 0, 0, 0, 0, 0, 0, WOOL})), "dyed_wool");
+  EXPECT_EQ(MatchedId(index, Grid({DYE, 0, 0, 0, 0, 0, 0, 0, DYE})), "");
+  EXPECT_EQ(MatchedId(index, Grid({WOOL, DYE, WOOL, 0, 0, 0, 0, 0, 0})), "");
+}
+
+TEST(RecipeIndexTest, TheRecipeAddedFirstWins) {
+  Inventory::RecipeIndex shaped_first;
+  shaped_first.Add(Shaped("shaped", 2, 1, {Inventory::Ingredient{{IRON}}, STICKS}));
+  shaped_first.Add(Shapeless("shapeless", {Inventory::Ingredient{{IRON}}, STICKS}));
+  Inventory::RecipeIndex shapeless_first;
+  shapeless_first.Add(Shapeless("shapeless", {Inventory::Ingredient{{IRON}}, STICKS}));
+  shapeless_first.Add(Shaped("shaped", 2, 1, {Inventory::Ingredient{{IRON}}, STICKS}));
+
+  const Inventory::CraftingGrid both = Grid({IRON, STICK, 0, 0, 0, 0, 0, 0, 0});
+  EXPECT_EQ(MatchedId(shaped_first, both), "shaped");
+  EXPECT_EQ(MatchedId(shapeless_first, both), "shapeless");
+  // Only the shapeless recipe accepts the swapped order
+  EXPECT_EQ(MatchedId(shaped_first, Grid({STICK, 0, 0, 0, 0, 0, 0, 0, IRON})), "shapeless");
+}
+
+TEST(RecipeIndexTest, InvalidRecipesAreRejected) {
+  Inventory::RecipeIndex index;
+  EXPECT_THROW(index.Add(Shaped("wide", 4, 1, {STICKS, STICKS, STICKS, STICKS})),
+               std::invalid_argument);
+  EXPECT_THROW(index.Add(Shaped("short", 2, 2, {STICKS, STICKS, STICKS})),
+               std::invalid_argument);
+  EXPECT_THROW(index.Add(Shaped("empty", 1, 1, {NONE})), std::invalid_argument);
+  EXPECT_THROW(index.Add(Shapeless("nothing", {})), std::invalid_argument);
+  EXPECT_EQ(index.Size(), 0u);
+  EXPECT_EQ(index.Match(Grid({})), nullptr);
+}
+
+TEST(CraftingMatcherTest, RepeatedGridsAreAnsweredFromTheCache) {
+  Inventory::RecipeIndex index;
+  index.Add(Shaped("sticks", 1, 2, {ANY_PLANKS, ANY_PLANKS}));
+  Inventory::CraftingMatcher matcher(index);
+  const Inventory::CraftingGrid grid = Grid({PLANKS, 0, 0, PLANKS, 0, 0, 0, 0, 0});
+
+  EXPECT_NE(matcher.Match(grid), nullptr);
+  EXPECT_NE(matcher.Match(grid), nullptr);
+  EXPECT_EQ(matcher.Match(Grid({PLANKS, 0, 0, 0, 0, 0, 0, 0, 0})), nullptr);
+  EXPECT_EQ(matcher.Match(Grid({PLANKS, 0, 0, 0, 0, 0, 0, 0, 0})), nullptr);
+
+  const Inventory::CraftingMatcherStats& stats = matcher.GetStats();
+  EXPECT_EQ(stats.lookups, 4u);
+  EXPECT_EQ(stats.cache_hits, 2u);
+}
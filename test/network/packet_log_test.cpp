@@ -0,0 +1,168 @@
+#include "network/packet_log.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+struct LogFile {
+  Network::PacketLogFileHeader header;
+  std::vector<Network::PacketLogRecord> records;
+};
+
+/** @brief Fresh directory under the system temp path, removed again on destruction */
+class TempDirectory {
+ public:
+  explicit TempDirectory(const std::string& name)
+      : path_(std::filesystem::temp_directory_path() /
+              (name + "-" + std::to_string(::getpid()))) {
+    std::filesystem::remove_all(path_);
+  }
+
+  ~TempDirectory() {
+    std::error_code error;
+    std::filesystem::remove_all(path_, error);
+  }
+
+  const std::filesystem::path& Path() const { return path_; }
+
+ private:
+  std::filesystem::path path_;
+};
+
+LogFile ReadLogFile(const std::filesystem::path& path) {
+  std::ifstream stream(path, std::ios::binary);
+  const std::vector<char> bytes((std::istreambuf_iterator<char>(stream)),
+                                std::istreambuf_iterator<char>());
+  LogFile file{};
+  EXPECT_GE(bytes.size(), sizeof(file.header)) << path;
+  if (bytes.size() < sizeof(file.header)) {
+    return file;
+  }
+  std::memcpy(&file.header, bytes.data(), sizeof(file.header));
+  size_t offset = file.header.header_bytes;
+  while (offset + sizeof(Network::PacketLogRecord) <= bytes.size()) {
+    Network::PacketLogRecord record;
+    std::memcpy(&record, bytes.data() + offset, sizeof(record));
+    if (record.timestamp_ns == 0) {
+      break;
+    }
+    file.records.push_back(record);
+    offset += (sizeof(record) + record.payload_bytes + Network::PACKET_LOG_ALIGNMENT - 1) &
+              ~(Network::PACKET_LOG_ALIGNMENT - 1);
+  }
+  return file;
+}
+
+std::vector<LogFile> ReadRing(const std::filesystem::path& directory) {
+  std::vector<LogFile> files;
+  for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+    if (entry.path().extension() == ".pslog") {
+      files.push_back(ReadLogFile(entry.path()));
+    }
+  }
+  std::sort(files.begin(), files.end(), [](const LogFile& a, const LogFile& b) {
+    return a.header.sequence < b.header.sequence;
+  });
+  return files;
+}
+
+}  // namespace
+
+TEST(PacketLogTest, RotationKeepsTheNewestRecordsInOrder) {
+  TempDirectory directory("parellelstone-packet-log-test");
+  Network::PacketLogConfig config;
+  config.directory = directory.Path();
+  config.file_bytes = 1ull << 20;
+  config.file_count = 3;
+  config.default_rule = {.sample_one_in = 1, .payload_bytes = 100};
+
+  // A record with 100 payload bytes takes 128, so a 1 MiB file holds about 8000
+  constexpr uint32_t PACKETS = 40000;
+  const std::vector<uint8_t> packet(300, 0x5A);
+  uint64_t rotations = 0;
+  {
+    Network::PacketLog log(config);
+    for (uint32_t i = 0; i < PACKETS; ++i) {
+      ASSERT_TRUE(log.Record(i, Network::PacketDirection::CLIENTBOUND,
+                             Network::ConnectionState::PLAY, 0x27, packet));
+    }
+    const Network::PacketLogStats stats = log.GetStats();
+    EXPECT_FALSE(stats.failed);
+    rotations = stats.rotations;
+  }
+  EXPECT_GE(rotations, 3u);
+
+  const std::vector<LogFile> files = ReadRing(directory.Path());
+  ASSERT_EQ(files.size(), 3u);
+  std::vector<Network::PacketLogRecord> records;
+  for (const LogFile& file : files) {
+    EXPECT_EQ(file.header.magic, Network::PACKET_LOG_MAGIC);
+    EXPECT_EQ(file.header.version, Network::PACKET_LOG_VERSION);
+    EXPECT_EQ(file.header.file_bytes, config.file_bytes);
+    // Each file anchors its own timestamps, so they only order within a file
+    for (size_t i = 1; i < file.records.size(); ++i) {
+      ASSERT_GE(file.records[i].timestamp_ns, file.records[i - 1].timestamp_ns);
+    }
+    records.insert(records.end(), file.records.begin(), file.records.end());
+  }
+
+  // Older files were overwritten, but what is left is the contiguous tail
+  ASSERT_FALSE(records.empty());
+  EXPECT_LT(records.size(), PACKETS);
+  EXPECT_EQ(records.back().connection, PACKETS - 1);
+  for (size_t i = 1; i < records.size(); ++i) {
+    ASSERT_EQ(records[i].connection, records[i - 1].connection + 1) << "record " << i;
+  }
+  EXPECT_EQ(records.front().length, packet.size());
+  EXPECT_EQ(records.front().payload_bytes, 100u);
+  EXPECT_EQ(records.front().packet_id, 0x27);
+}
+
+TEST(PacketLogTest, RulesSampleAndDisableTypes) {
+  TempDirectory directory("parellelstone-packet-log-rules-test");
+  Network::PacketLogConfig config;
+  config.directory = directory.Path();
+  config.file_bytes = 1ull << 20;
+  config.file_count = 3;
+  Network::PacketLog log(config);
+  log.SetRule(Network::PacketDirection::SERVERBOUND, 0x1D, {.sample_one_in = 10});
+  log.SetRule(Network::PacketDirection::SERVERBOUND, 0x1E, {.sample_one_in = 0});
+
+  const std::vector<uint8_t> packet(16, 0);
+  int sampled = 0;
+  int disabled = 0;
+  for (int i = 0; i < 1000; ++i) {
+    sampled += log.Record(1, Network::PacketDirection::SERVERBOUND,
+                          Network::ConnectionState::PLAY, 0x1D, packet);
+    disabled += log.Record(1, Network::PacketDirection::SERVERBOUND,
+                           Network::ConnectionState::PLAY, 0x1E, packet);
+  }
+  // Sampling is random; 100 expected, these bounds are about ten deviations wide
+  EXPECT_GT(sampled, 10);
+  EXPECT_LT(sampled, 200);
+  EXPECT_EQ(disabled, 0);
+  // The rule is per direction
+  EXPECT_TRUE(log.Record(1, Network::PacketDirection::CLIENTBOUND,
+                         Network::ConnectionState::PLAY, 0x1E, packet));
+}
+
+TEST(PacketLogTest, RingSmallerThanThreeFilesIsRejected) {
+  TempDirectory directory("parellelstone-packet-log-small-test");
+  Network::PacketLogConfig config;
+  config.directory = directory.Path();
+  config.file_bytes = 1ull << 20;
+  config.file_count = 2;
+  EXPECT_THROW(Network::PacketLog log(config), std::invalid_argument);
+}
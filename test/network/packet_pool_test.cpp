@@ -0,0 +1,64 @@
+#include "network/packet_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+TEST(PacketPoolTest, FinishedPacketCarriesIdAndBytes) {
+  Network::PacketPool pool;
+  Network::PacketBuffer buffer = pool.Acquire(0x27, 16);
+  buffer.WriteInt(0x01020304);
+  const Network::SharedPacket packet = pool.Finish(buffer);
+  EXPECT_EQ(packet->packet_id, 0x27);
+  EXPECT_EQ(packet->bytes, (std::vector<uint8_t>{0x27, 0x01, 0x02, 0x03, 0x04}));
+}
+
+TEST(PacketPoolTest, ReleasedPacketsAreReused) {
+  Network::PacketPool pool;
+  for (int i = 0; i < 10; ++i) {
+    Network::PacketBuffer buffer = pool.Acquire(0x10, 200);
+    buffer.WriteLong(i);
+    const Network::SharedPacket packet = pool.Finish(buffer);
+    EXPECT_EQ(packet->bytes.size(), 9u);
+  }
+  const Network::PacketPoolStats stats = pool.GetStats();
+  EXPECT_EQ(stats.acquired, 10u);
+  EXPECT_EQ(stats.recycled, 10u);
+  EXPECT_EQ(stats.buffers_allocated, 1u);
+  EXPECT_EQ(stats.buffers_reused, 9u);
+  EXPECT_EQ(stats.packets_reused, 9u);
+}
+
+TEST(PacketPoolTest, LiveReferencesKeepTheirBytes) {
+  Network::PacketPool pool;
+  Network::PacketBuffer first = pool.Acquire(0x01, 64);
+  first.WriteByte(0xAA);
+  const Network::SharedPacket kept = pool.Finish(first);
+  for (int i = 0; i < 4; ++i) {
+    Network::PacketBuffer buffer = pool.Acquire(0x02, 64);
+    buffer.WriteByte(0xBB);
+    pool.Finish(buffer);
+  }
+  EXPECT_EQ(kept->bytes, (std::vector<uint8_t>{0x01, 0xAA}));
+}
+
+TEST(PacketPoolTest, OversizedBuffersAreDiscarded) {
+  Network::PacketPool pool;
+  Network::PacketBuffer buffer = pool.Acquire(0x01, Network::PACKET_POOL_CLASSES.back() * 2);
+  buffer.WriteBytes(std::vector<uint8_t>(Network::PACKET_POOL_CLASSES.back() + 1, 0));
+  pool.Finish(buffer);
+  EXPECT_EQ(pool.GetStats().discarded, 1u);
+}
+
+TEST(PacketPoolTest, PacketsMayOutliveThePool) {
+  Network::SharedPacket packet;
+  {
+    Network::PacketPool pool;
+    Network::PacketBuffer buffer = pool.Acquire(0x05, 64);
+    buffer.WriteByte(0x42);
+    packet = pool.Finish(buffer);
+  }
+  EXPECT_EQ(packet->bytes, (std::vector<uint8_t>{0x05, 0x42}));
+  packet.reset();
+}
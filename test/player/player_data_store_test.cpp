@@ -0,0 +1,206 @@
+#include "player/player_data_store.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "util/worker_pool.h"
+
+namespace {
+
+/** @brief Empty per-test data directory, removed afterwards */
+class DataDirectory {
+ public:
+  DataDirectory()
+      : path_(std::filesystem::temp_directory_path() /
+              ("ps_player_data_" +
+               std::string(testing::UnitTest::GetInstance()->current_test_info()->name()))) {
+    std::filesystem::remove_all(path_);
+  }
+  ~DataDirectory() { std::filesystem::remove_all(path_); }
+
+  const std::filesystem::path& Path() const { return path_; }
+
+ private:
+  std::filesystem::path path_;
+};
+
+Player::PlayerData Sample(uint64_t n) {
+  Player::PlayerData data;
+  data.uuid = {.most = 0xABCD, .least = n};
+  data.dimension = "minecraft:the_nether";
+  data.x = 12.5;
+  data.y = -30;
+  data.z = 1e6;
+  data.health = 7.5f;
+  data.experience_level = 30;
+  data.game_mode = 1;
+  data.inventory.push_back(
+      {.slot = 0, .stack = {.item_id = 1, .count = 64, .components = nullptr}});
+  data.inventory.push_back(
+      {.slot = 36,
+       .stack = {.item_id = 812,
+                 .count = 1,
+                 .components = std::make_shared<const Inventory::ItemComponentPatch>(
+                     1, 0, std::vector<uint8_t>{0x0A, 0x02, 0x0D, 0x05})}});
+  data.statistics = {{5, 1200}, {9, 3}};
+  return data;
+}
+
+void ExpectSame(const Player::PlayerData& actual, const Player::PlayerData& expected) {
+  EXPECT_EQ(actual.uuid, expected.uuid);
+  EXPECT_EQ(actual.dimension, expected.dimension);
+  EXPECT_EQ(actual.x, expected.x);
+  EXPECT_EQ(actual.y, expected.y);
+  EXPECT_EQ(actual.z, expected.z);
+  EXPECT_EQ(actual.health, expected.health);
+  EXPECT_EQ(actual.experience_level, expected.experience_level);
+  EXPECT_EQ(actual.game_mode, expected.game_mode);
+  ASSERT_EQ(actual.inventory.size(), expected.inventory.size());
+  for (size_t i = 0; i < actual.inventory.size(); ++i) {
+    EXPECT_EQ(actual.inventory[i].slot, expected.inventory[i].slot);
+    EXPECT_EQ(actual.inventory[i].stack, expected.inventory[i].stack);
+  }
+  EXPECT_EQ(actual.statistics, expected.statistics);
+}
+
+/** @brief Occupies the only worker of a pool until released */
+class BlockedPool {
+ public:
+  BlockedPool() : pool(1) {
+    pool.Post([gate = gate_.get_future().share()] { gate.wait(); });
+  }
+  ~BlockedPool() { Release(); }
+
+  void Release() {
+    if (!released_) {
+      released_ = true;
+      gate_.set_value();
+    }
+  }
+
+  Util::WorkerPool pool;
+
+ private:
+  std::promise<void> gate_;
+  bool released_ = false;
+};
+
+}  // namespace
+
+TEST(PlayerDataStoreTest, SerializationRoundTripsAndDetectsCorruption) {
+  const Player::PlayerData data = Sample(1);
+  std::vector<uint8_t> bytes = Player::PlayerDataStore::Serialize(data);
+  const std::optional<Player::PlayerData> parsed = Player::PlayerDataStore::Deserialize(bytes);
+  ASSERT_TRUE(parsed.has_value());
+  ExpectSame(*parsed, data);
+
+  std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 1);
+  EXPECT_FALSE(Player::PlayerDataStore::Deserialize(truncated).has_value());
+  bytes[bytes.size() / 2] ^= 0x40;
+  EXPECT_FALSE(Player::PlayerDataStore::Deserialize(bytes).has_value());
+  EXPECT_FALSE(Player::PlayerDataStore::Deserialize({}).has_value());
+}
+
+TEST(PlayerDataStoreTest, SavedDataIsLoadedBack) {
+  DataDirectory directory;
+  Util::WorkerPool io(2);
+  const Player::PlayerData data = Sample(2);
+  {
+    Player::PlayerDataStore store(directory.Path(), io);
+    const Player::LoadResult fresh = store.Prefetch(data.uuid).get();
+    EXPECT_EQ(fresh.status, Player::LoadStatus::NEW_PLAYER);
+    EXPECT_EQ(fresh.data.uuid, data.uuid);
+
+    store.Save(data);
+    store.Flush();
+    EXPECT_EQ(store.GetStats().saves_written, 1u);
+  }
+  const std::filesystem::path file = directory.Path() / (data.uuid.ToString() + ".dat");
+  EXPECT_TRUE(std::filesystem::exists(file));
+  EXPECT_FALSE(std::filesystem::exists(file.string() + ".tmp"));
+
+  Player::PlayerDataStore store(directory.Path(), io);
+  const Player::LoadResult loaded = store.Prefetch(data.uuid).get();
+  EXPECT_EQ(loaded.status, Player::LoadStatus::LOADED);
+  ExpectSame(loaded.data, data);
+}
+
+TEST(PlayerDataStoreTest, CorruptFilesAreReportedNotLoaded) {
+  DataDirectory directory;
+  Util::WorkerPool io(1);
+  Player::PlayerDataStore store(directory.Path(), io);
+  const Player::PlayerData data = Sample(3);
+  {
+    std::ofstream file(directory.Path() / (data.uuid.ToString() + ".dat"), std::ios::binary);
+    file << "PSPD but not really";
+  }
+  EXPECT_EQ(store.Prefetch(data.uuid).get().status, Player::LoadStatus::CORRUPT);
+  EXPECT_EQ(store.GetStats().load_failures, 1u);
+
+  // A valid file under another player's name is just as unusable
+  const Player::PlayerData other = Sample(4);
+  const std::vector<uint8_t> bytes = Player::PlayerDataStore::Serialize(other);
+  {
+    std::ofstream file(directory.Path() / (data.uuid.ToString() + ".dat"),
+                       std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+  }
+  store.Release(data.uuid);
+  EXPECT_EQ(store.Prefetch(data.uuid).get().status, Player::LoadStatus::CORRUPT);
+}
+
+TEST(PlayerDataStoreTest, PrefetchesAreSharedUntilReleased) {
+  DataDirectory directory;
+  Util::WorkerPool io(1);
+  Player::PlayerDataStore store(directory.Path(), io);
+  const Util::Uuid uuid = Sample(5).uuid;
+
+  std::shared_future<Player::LoadResult> first = store.Prefetch(uuid);
+  std::shared_future<Player::LoadResult> second = store.Prefetch(uuid);
+  EXPECT_EQ(&first.get(), &second.get());
+  EXPECT_EQ(store.GetStats().loads, 1u);
+
+  store.Release(uuid);
+  store.Prefetch(uuid).get();
+  EXPECT_EQ(store.GetStats().loads, 2u);
+}
+
+TEST(PlayerDataStoreTest, PendingSavesAreCoalescedAndServePrefetches) {
+  DataDirectory directory;
+  BlockedPool io;
+  Player::PlayerDataStore store(directory.Path(), io.pool);
+
+  Player::PlayerData data = Sample(6);
+  store.Save(data);
+  data.experience_level = 31;
+  store.Save(data);
+  data.experience_level = 32;
+  store.Save(data);
+
+  // Nothing reached disk yet; the newest snapshot answers at once
+  std::shared_future<Player::LoadResult> pending = store.Prefetch(data.uuid);
+  ASSERT_EQ(pending.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+  EXPECT_EQ(pending.get().status, Player::LoadStatus::LOADED);
+  EXPECT_EQ(pending.get().data.experience_level, 32);
+
+  io.Release();
+  store.Flush();
+  const Player::PlayerDataStats stats = store.GetStats();
+  EXPECT_EQ(stats.saves_requested, 3u);
+  EXPECT_EQ(stats.saves_coalesced, 1u);
+  EXPECT_EQ(stats.saves_written, 2u);  // The first snapshot, then the newest
+  EXPECT_EQ(stats.loads_from_pending_save, 1u);
+
+  store.Release(data.uuid);
+  EXPECT_EQ(store.Prefetch(data.uuid).get().data.experience_level, 32);
+}
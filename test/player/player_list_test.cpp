@@ -0,0 +1,165 @@
+#include "player/player_list.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "network/packet_buffer.h"
+#include "protocol/packet_ids.h"
+
+namespace {
+
+Util::Uuid Id(uint64_t n) { return {.most = 0x1234, .least = n}; }
+
+Player::PlayerListEntry Entry(uint64_t n) {
+  Player::PlayerListEntry entry;
+  entry.uuid = Id(n);
+  entry.name = "player" + std::to_string(n);
+  entry.properties.push_back({.name = "textures", .value = "e30=", .signature = std::nullopt});
+  return entry;
+}
+
+std::vector<Network::SharedPacket> FlushAll(Player::PlayerList& players) {
+  std::vector<Network::SharedPacket> packets;
+  players.Flush([&](const Network::SharedPacket& packet) { packets.push_back(packet); });
+  return packets;
+}
+
+/** @brief Action byte of a Player Info Update; the packet ids are all single-byte VarInts */
+uint8_t Actions(const Network::SharedPacket& packet) { return packet->bytes[1]; }
+
+/** @brief Entry count of a Player Info Update */
+uint8_t UpdateEntries(const Network::SharedPacket& packet) { return packet->bytes[2]; }
+
+}  // namespace
+
+TEST(PlayerListTest, PendingEntriesAreGroupedByActionSet) {
+  Player::PlayerList players;
+  for (uint64_t n = 0; n < 4; ++n) {
+    players.Add(Entry(n));
+  }
+  ASSERT_EQ(FlushAll(players).size(), 1u);
+
+  players.Add(Entry(10));
+  players.Add(Entry(11));
+  players.SetLatency(Id(0), 30);
+  players.SetLatency(Id(1), 45);
+  players.SetLatency(Id(2), 60);
+  players.SetLatency(Id(2), 61);
+  players.SetGameMode(Id(3), 1);
+  players.SetLatency(Id(10), 5);  // Still pending as a join, so it rides along with it
+
+  const std::vector<Network::SharedPacket> packets = FlushAll(players);
+  ASSERT_EQ(packets.size(), 3u);
+  for (const Network::SharedPacket& packet : packets) {
+    EXPECT_EQ(packet->packet_id, Protocol::Play::Clientbound::PLAYER_INFO_UPDATE);
+  }
+  // Groups go out in ascending action order
+  EXPECT_EQ(Actions(packets[0]), Player::UPDATE_GAME_MODE);
+  EXPECT_EQ(UpdateEntries(packets[0]), 1);
+  EXPECT_EQ(Actions(packets[1]), Player::UPDATE_LATENCY);
+  EXPECT_EQ(UpdateEntries(packets[1]), 3);
+  EXPECT_EQ(Actions(packets[2]), Player::ALL_PLAYER_INFO_ACTIONS);
+  EXPECT_EQ(UpdateEntries(packets[2]), 2);
+  EXPECT_TRUE(FlushAll(players).empty());
+
+  const Player::PlayerListStats& stats = players.GetStats();
+  EXPECT_EQ(stats.update_packets, 4u);
+  EXPECT_EQ(stats.entries_sent, 10u);
+}
+
+TEST(PlayerListTest, LatencyUpdateIsEncodedOnce) {
+  Player::PlayerList players;
+  players.Add(Entry(7));
+  FlushAll(players);
+
+  players.SetLatency(Id(7), 150);
+  const std::vector<Network::SharedPacket> packets = FlushAll(players);
+  ASSERT_EQ(packets.size(), 1u);
+
+  Network::PacketBuffer expected(Protocol::Play::Clientbound::PLAYER_INFO_UPDATE);
+  expected.WriteByte(Player::UPDATE_LATENCY);
+  expected.WriteVarInt(1);
+  expected.WriteUuid(Id(7));
+  expected.WriteVarInt(150);
+  EXPECT_EQ(packets[0]->bytes, expected.Finish()->bytes);
+}
+
+TEST(PlayerListTest, UnchangedValuesAndUnknownPlayersAreIgnored) {
+  Player::PlayerList players;
+  players.Add(Entry(1));
+  FlushAll(players);
+
+  players.SetLatency(Id(1), 0);
+  players.SetListed(Id(1), true);
+  players.SetDisplayName(Id(1), std::nullopt);
+  players.SetLatency(Id(99), 20);
+  EXPECT_FALSE(players.Remove(Id(99)));
+  EXPECT_TRUE(FlushAll(players).empty());
+}
+
+TEST(PlayerListTest, RemovalsComeFirstInOnePacket) {
+  Player::PlayerList players;
+  for (uint64_t n = 0; n < 3; ++n) {
+    players.Add(Entry(n));
+  }
+  FlushAll(players);
+
+  EXPECT_TRUE(players.Remove(Id(0)));
+  players.SetLatency(Id(1), 20);
+  EXPECT_TRUE(players.Remove(Id(2)));
+  const std::vector<Network::SharedPacket> packets = FlushAll(players);
+  ASSERT_EQ(packets.size(), 2u);
+
+  Network::PacketBuffer expected(Protocol::Play::Clientbound::PLAYER_INFO_REMOVE);
+  expected.WriteVarInt(2);
+  expected.WriteUuid(Id(0));
+  expected.WriteUuid(Id(2));
+  EXPECT_EQ(packets[0]->bytes, expected.Finish()->bytes);
+  EXPECT_EQ(packets[1]->packet_id, Protocol::Play::Clientbound::PLAYER_INFO_UPDATE);
+  EXPECT_EQ(players.Size(), 1u);
+}
+
+TEST(PlayerListTest, JoinAndLeaveWithinOneTickNeverReachTheWire) {
+  Player::PlayerList players;
+  players.Add(Entry(5));
+  players.SetLatency(Id(5), 80);
+  EXPECT_TRUE(players.Remove(Id(5)));
+  EXPECT_EQ(players.Flush([](const Network::SharedPacket&) { FAIL(); }), 0u);
+  EXPECT_EQ(players.GetStats().cancelled_joins, 1u);
+}
+
+TEST(PlayerListTest, ReAddingAKnownPlayerRemovesItFirst) {
+  Player::PlayerList players;
+  players.Add(Entry(3));
+  FlushAll(players);
+
+  Player::PlayerListEntry renamed = Entry(3);
+  renamed.name = "renamed";
+  players.Add(renamed);
+  const std::vector<Network::SharedPacket> packets = FlushAll(players);
+  ASSERT_EQ(packets.size(), 2u);
+  EXPECT_EQ(packets[0]->packet_id, Protocol::Play::Clientbound::PLAYER_INFO_REMOVE);
+  EXPECT_EQ(Actions(packets[1]), Player::ALL_PLAYER_INFO_ACTIONS);
+  EXPECT_EQ(players.Find(Id(3))->name, "renamed");
+}
+
+TEST(PlayerListTest, SnapshotListsEveryPlayerWithEveryAction) {
+  Player::PlayerList players;
+  EXPECT_EQ(players.SnapshotPacket(), nullptr);
+  for (uint64_t n = 0; n < 3; ++n) {
+    players.Add(Entry(n));
+  }
+  FlushAll(players);
+  players.SetLatency(Id(1), 99);
+
+  const Network::SharedPacket snapshot = players.SnapshotPacket();
+  ASSERT_NE(snapshot, nullptr);
+  EXPECT_EQ(Actions(snapshot), Player::ALL_PLAYER_INFO_ACTIONS);
+  EXPECT_EQ(UpdateEntries(snapshot), 3);
+  // The pending latency change is still broadcast to everyone else
+  EXPECT_EQ(FlushAll(players).size(), 1u);
+}
@@ -0,0 +1,191 @@
+#include "plugin/wasm_plugin_host.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include "plugin/event_bus.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/**
+ * @brief Fixture plugin whose reaction is picked by the block's x coordinate
+ *
+ * (module
+ *   (import "ps" "subscribe" (func $subscribe (param i32 i32) (result i32)))
+ *   (memory (export "memory") 1)
+ *   (func (export "ps_plugin_init") (result i32)
+ *     (drop (call $subscribe (i32.const 0) (i32.const 0)))  ;; BLOCK_PLACE, priority 0
+ *     (i32.const 0))
+ *   (func (export "ps_on_event") (param $type i32) (param $event i32) (param $length i32)
+ *         (result i32) (local $x i32)
+ *     (local.set $x (i32.load offset=24 (local.get $event)))
+ *     (if (i32.eq (local.get $x) (i32.const 1)) (then (return (i32.const 1))))  ;; cancel
+ *     (if (i32.eq (local.get $x) (i32.const 2)) (then (unreachable)))            ;; trap
+ *     (if (i32.eq (local.get $x) (i32.const 3)) (then (loop (br 0))))            ;; spin
+ *     (i32.const 0)))
+ */
+constexpr uint8_t FIXTURE_WASM[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x12, 0x03, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x01, 0x7f, 0x60, 0x03, 0x7f,
+    0x7f, 0x7f, 0x01, 0x7f, 0x02, 0x10, 0x01, 0x02, 0x70, 0x73, 0x09, 0x73,
+    0x75, 0x62, 0x73, 0x63, 0x72, 0x69, 0x62, 0x65, 0x00, 0x00, 0x03, 0x03,
+    0x02, 0x01, 0x02, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07, 0x29, 0x03, 0x06,
+    0x6d, 0x65, 0x6d, 0x6f, 0x72, 0x79, 0x02, 0x00, 0x0e, 0x70, 0x73, 0x5f,
+    0x70, 0x6c, 0x75, 0x67, 0x69, 0x6e, 0x5f, 0x69, 0x6e, 0x69, 0x74, 0x00,
+    0x01, 0x0b, 0x70, 0x73, 0x5f, 0x6f, 0x6e, 0x5f, 0x65, 0x76, 0x65, 0x6e,
+    0x74, 0x00, 0x02, 0x0a, 0x3c, 0x02, 0x0b, 0x00, 0x41, 0x00, 0x41, 0x00,
+    0x10, 0x00, 0x1a, 0x41, 0x00, 0x0b, 0x2e, 0x01, 0x01, 0x7f, 0x20, 0x01,
+    0x28, 0x02, 0x18, 0x21, 0x03, 0x20, 0x03, 0x41, 0x01, 0x46, 0x04, 0x40,
+    0x41, 0x01, 0x0f, 0x0b, 0x20, 0x03, 0x41, 0x02, 0x46, 0x04, 0x40, 0x00,
+    0x0b, 0x20, 0x03, 0x41, 0x03, 0x46, 0x04, 0x40, 0x03, 0x40, 0x0c, 0x00,
+    0x0b, 0x0b, 0x41, 0x00, 0x0b,
+};
+
+constexpr int32_t CONTINUE_X = 0;
+constexpr int32_t CANCEL_X = 1;
+constexpr int32_t TRAP_X = 2;
+constexpr int32_t SPIN_X = 3;
+
+/** @brief Writes the fixture module to a temporary file for the lifetime of a test */
+class FixtureFile {
+ public:
+  FixtureFile()
+      : path_(std::filesystem::temp_directory_path() /
+              ("ps_wasm_fixture_" +
+               std::string(testing::UnitTest::GetInstance()->current_test_info()->name()) +
+               ".wasm")) {
+    std::ofstream file(path_, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(FIXTURE_WASM), std::size(FIXTURE_WASM));
+  }
+  ~FixtureFile() { std::filesystem::remove(path_); }
+
+  const std::filesystem::path& Path() const { return path_; }
+
+ private:
+  std::filesystem::path path_;
+};
+
+/** @brief Dispatch a block place at the given x; true when it was not cancelled */
+bool PlaceAt(Plugin::EventBus& bus, int32_t x) {
+  ps_block_event event{};
+  event.x = x;
+  event.y = 64;
+  return bus.Dispatch<Plugin::EventType::BLOCK_PLACE>(event);
+}
+
+}  // namespace
+
+TEST(WasmPluginHostTest, LoadFailsWithoutTheRuntime) {
+  if (Plugin::WasmPluginHost::Available()) {
+    GTEST_SKIP() << "built with PARELLELSTONE_WASM_PLUGINS";
+  }
+  Plugin::EventBus bus;
+  Plugin::WasmPluginHost host(bus);
+  FixtureFile fixture;
+  EXPECT_THROW((void)host.Load(fixture.Path()), std::runtime_error);
+  EXPECT_FALSE(bus.HasHandlers(Plugin::EventType::BLOCK_PLACE));
+}
+
+TEST(WasmPluginHostTest, SubscribesAndCancelsFromTheModule) {
+  if (!Plugin::WasmPluginHost::Available()) {
+    GTEST_SKIP() << "built without PARELLELSTONE_WASM_PLUGINS";
+  }
+  Plugin::EventBus bus;
+  Plugin::WasmPluginHost host(bus);
+  FixtureFile fixture;
+  const Plugin::PluginId id = host.Load(fixture.Path());
+  EXPECT_EQ(bus.HandlerCount(Plugin::EventType::BLOCK_PLACE), 1u);
+
+  EXPECT_TRUE(PlaceAt(bus, CONTINUE_X));
+  EXPECT_FALSE(PlaceAt(bus, CANCEL_X));
+  const Plugin::WasmPluginStats stats = host.GetStats(id);
+  EXPECT_EQ(stats.events, 2u);
+  EXPECT_EQ(stats.cancelled, 1u);
+  EXPECT_EQ(stats.traps, 0u);
+
+  EXPECT_TRUE(host.Unload(id));
+  EXPECT_FALSE(bus.HasHandlers(Plugin::EventType::BLOCK_PLACE));
+}
+
+TEST(WasmPluginHostTest, TrapsDisableThePluginAfterTheLimit) {
+  if (!Plugin::WasmPluginHost::Available()) {
+    GTEST_SKIP() << "built without PARELLELSTONE_WASM_PLUGINS";
+  }
+  Plugin::EventBus bus;
+  Plugin::WasmLimits limits;
+  limits.max_traps = 2;
+  Plugin::WasmPluginHost host(bus, limits);
+  FixtureFile fixture;
+  const Plugin::PluginId id = host.Load(fixture.Path());
+
+  EXPECT_TRUE(PlaceAt(bus, TRAP_X));
+  EXPECT_FALSE(host.GetStats(id).disabled);
+  EXPECT_TRUE(PlaceAt(bus, TRAP_X));
+  EXPECT_TRUE(host.GetStats(id).disabled);
+
+  // A disabled plugin is no longer called, so it cannot cancel either
+  EXPECT_TRUE(PlaceAt(bus, CANCEL_X));
+  const Plugin::WasmPluginStats stats = host.GetStats(id);
+  EXPECT_EQ(stats.traps, 2u);
+  EXPECT_EQ(stats.events, 0u);
+}
+
+TEST(WasmPluginHostTest, WatchdogTerminatesASpinningCall) {
+  if (!Plugin::WasmPluginHost::Available()) {
+    GTEST_SKIP() << "built without PARELLELSTONE_WASM_PLUGINS";
+  }
+  Plugin::EventBus bus;
+  Plugin::WasmLimits limits;
+  limits.call_timeout = 20ms;
+  limits.tick_budget = 10s;
+  Plugin::WasmPluginHost host(bus, limits);
+  FixtureFile fixture;
+  const Plugin::PluginId id = host.Load(fixture.Path());
+
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(PlaceAt(bus, SPIN_X));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+  Plugin::WasmPluginStats stats = host.GetStats(id);
+  EXPECT_EQ(stats.timeouts, 1u);
+  EXPECT_EQ(stats.traps, 1u);
+  EXPECT_GE(stats.max_call_nanos, static_cast<uint64_t>(std::chrono::nanoseconds(20ms).count()));
+
+  // The termination must not leak into the next call
+  EXPECT_FALSE(PlaceAt(bus, CANCEL_X));
+  stats = host.GetStats(id);
+  EXPECT_EQ(stats.traps, 1u);
+  EXPECT_EQ(stats.cancelled, 1u);
+}
+
+TEST(WasmPluginHostTest, TickBudgetSkipsCallsUntilTheNextTick) {
+  if (!Plugin::WasmPluginHost::Available()) {
+    GTEST_SKIP() << "built without PARELLELSTONE_WASM_PLUGINS";
+  }
+  Plugin::EventBus bus;
+  Plugin::WasmLimits limits;
+  limits.call_timeout = 5ms;
+  limits.tick_budget = 1ms;
+  limits.max_traps = 10;
+  Plugin::WasmPluginHost host(bus, limits);
+  FixtureFile fixture;
+  const Plugin::PluginId id = host.Load(fixture.Path());
+  host.BeginTick();
+
+  // The spinning call runs until the watchdog stops it and overspends the budget
+  EXPECT_TRUE(PlaceAt(bus, SPIN_X));
+  EXPECT_TRUE(PlaceAt(bus, CANCEL_X));
+  EXPECT_EQ(host.GetStats(id).over_budget_skips, 1u);
+
+  host.BeginTick();
+  EXPECT_FALSE(PlaceAt(bus, CANCEL_X));
+  EXPECT_EQ(host.GetStats(id).over_budget_skips, 1u);
+}
@@ -0,0 +1,154 @@
+#include "scoreboard/scoreboard.h"
+
+#include <gtest/gtest.h>
+
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "protocol/packet_ids.h"
+#include "protocol/version.h"
+
+namespace {
+
+/** @brief Names the kind of a scoreboard packet; every packet id here is a single-byte VarInt */
+std::string Kind(const Network::SharedPacket& packet) {
+  namespace Clientbound = Protocol::Play::Clientbound;
+  switch (packet->packet_id) {
+    case Clientbound::UPDATE_OBJECTIVES:
+      return "objective";
+    case Clientbound::DISPLAY_OBJECTIVE:
+      return "display";
+    case Clientbound::UPDATE_TEAMS:
+      return "team";
+#if MINECRAFT_VERSION >= 120300
+    case Clientbound::RESET_SCORE:
+      return "reset";
+    case Clientbound::UPDATE_SCORE:
+      return "score";
+#else
+    case Clientbound::UPDATE_SCORE: {
+      // Entry name, then the action: 0 sets, 1 removes
+      const size_t action = 2 + packet->bytes[1];
+      return packet->bytes[action] == 1 ? "reset" : "score";
+    }
+#endif
+    default:
+      return "?";
+  }
+}
+
+struct Flushed {
+  std::vector<std::string> kinds;
+  std::vector<Network::SharedPacket> packets;
+};
+
+Flushed FlushAll(Scoreboard::Scoreboard& board) {
+  Flushed flushed;
+  board.Flush([&](const Network::SharedPacket& packet) {
+    flushed.kinds.push_back(Kind(packet));
+    flushed.packets.push_back(packet);
+  });
+  return flushed;
+}
+
+std::vector<std::string> Kinds(std::initializer_list<const char*> kinds) {
+  return {kinds.begin(), kinds.end()};
+}
+
+}  // namespace
+
+TEST(ScoreboardTest, ResetThenSetWithinATickEndsSet) {
+  Scoreboard::Scoreboard board;
+  board.AddObjective("kills", "Kills");
+  board.SetScore("Steve", "kills", 5);
+  FlushAll(board);
+
+  board.ResetScore("Steve", "kills");
+  board.SetScore("Steve", "kills", 7);
+  const Flushed flushed = FlushAll(board);
+  EXPECT_EQ(flushed.kinds, Kinds({"reset", "score"}));
+  EXPECT_EQ(board.GetScore("Steve", "kills"), 7);
+
+  // The score packet carries the value set after the reset
+  const std::vector<Network::SharedPacket> snapshot = board.SnapshotPackets();
+  ASSERT_EQ(Kind(snapshot.back()), "score");
+  EXPECT_EQ(flushed.packets.back()->bytes, snapshot.back()->bytes);
+}
+
+TEST(ScoreboardTest, SetResetSetOfANewScoreSendsItOnce) {
+  Scoreboard::Scoreboard board;
+  board.AddObjective("kills", "Kills");
+  FlushAll(board);
+
+  board.SetScore("Alex", "kills", 1);
+  board.ResetScore("Alex", "kills");
+  board.SetScore("Alex", "kills", 2);
+  EXPECT_EQ(FlushAll(board).kinds, Kinds({"reset", "score"}));
+
+  board.SetScore("Alex", "kills", 3);
+  board.ResetScore("Alex", "kills");
+  EXPECT_EQ(FlushAll(board).kinds, Kinds({"reset"}));
+  EXPECT_EQ(board.GetScore("Alex", "kills"), std::nullopt);
+}
+
+TEST(ScoreboardTest, ValueChangesCoalesceToTheLastValue) {
+  Scoreboard::Scoreboard board;
+  board.AddObjective("sidebar", "Game");
+  FlushAll(board);
+
+  board.SetScore("line", "sidebar", 1);
+  board.SetScore("line", "sidebar", 2);
+  board.SetScore("line", "sidebar", 3);
+  EXPECT_EQ(FlushAll(board).kinds, Kinds({"score"}));
+
+  board.SetScore("line", "sidebar", 3);
+  board.SetScore("unknown", "missing", 3);
+  EXPECT_TRUE(FlushAll(board).kinds.empty());
+
+  const Scoreboard::ScoreboardStats& stats = board.GetStats();
+  EXPECT_EQ(stats.score_sets, 4u);
+  EXPECT_EQ(stats.coalesced_sets, 2u);
+  EXPECT_EQ(stats.unchanged_sets, 1u);
+}
+
+TEST(ScoreboardTest, StructuralChangesGoFirstInCallOrder) {
+  Scoreboard::Scoreboard board;
+  board.AddObjective("sidebar", "Game");
+  board.SetScore("line", "sidebar", 1);
+  board.SetObjectiveDisplayName("sidebar", "Game - round 2");
+  board.SetDisplaySlot(Scoreboard::DisplaySlot::SIDEBAR, "sidebar");
+  board.AddTeam("red");
+  board.AddTeamMember("red", "Steve");
+  board.AddTeamMember("red", "Steve");
+  board.SetTeamAffixes("red", "[R] ", "");
+  board.SetTeamAffixes("red", "[Red] ", "");
+
+  EXPECT_EQ(FlushAll(board).kinds,
+            Kinds({"objective", "display", "team", "team", "objective", "score", "team"}));
+  // Only a slot change is sent, and only for an objective that exists
+  board.SetDisplaySlot(Scoreboard::DisplaySlot::SIDEBAR, "sidebar");
+  board.SetDisplaySlot(Scoreboard::DisplaySlot::LIST, "missing");
+  EXPECT_TRUE(FlushAll(board).kinds.empty());
+}
+
+TEST(ScoreboardTest, RemovedObjectivesDropTheirPendingScores) {
+  Scoreboard::Scoreboard board;
+  board.AddObjective("kills", "Kills");
+  FlushAll(board);
+
+  board.SetScore("Steve", "kills", 4);
+  EXPECT_TRUE(board.RemoveObjective("kills"));
+  EXPECT_FALSE(board.RemoveObjective("kills"));
+  EXPECT_EQ(FlushAll(board).kinds, Kinds({"objective"}));
+
+  // Re-created in the same tick, only the new objective's score goes out
+  board.AddObjective("kills", "Kills");
+  board.SetScore("Steve", "kills", 1);
+  board.RemoveObjective("kills");
+  board.AddObjective("kills", "Kills");
+  board.SetScore("Alex", "kills", 2);
+  EXPECT_EQ(FlushAll(board).kinds, Kinds({"objective", "objective", "objective", "score"}));
+  EXPECT_EQ(board.GetScore("Steve", "kills"), std::nullopt);
+}
@@ -0,0 +1,157 @@
+#include "util/async_log.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <spdlog/sinks/base_sink.h>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/** @brief Records every line it is handed; can hold the writer thread at a gate */
+class RecordingSink : public spdlog::sinks::base_sink<std::mutex> {
+ public:
+  explicit RecordingSink(bool open = true) : open_(open) {}
+
+  void Open() { open_.store(true); }
+
+  bool Entered() const { return entered_.load(); }
+
+  std::vector<std::string> Lines() {
+    std::lock_guard lock(mutex_);
+    return lines_;
+  }
+
+  int Flushes() const { return flushes_.load(); }
+
+ protected:
+  void sink_it_(const spdlog::details::log_msg& msg) override {
+    entered_.store(true);
+    while (!open_.load()) {
+      std::this_thread::sleep_for(1ms);
+    }
+    lines_.emplace_back(msg.payload.data(), msg.payload.size());
+  }
+
+  void flush_() override { flushes_.fetch_add(1); }
+
+ private:
+  std::atomic<bool> open_;
+  std::atomic<bool> entered_{false};
+  std::atomic<int> flushes_{0};
+  std::vector<std::string> lines_;
+};
+
+bool WaitFor(const std::function<bool()>& done) {
+  const auto deadline = std::chrono::steady_clock::now() + 10s;
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+  return true;
+}
+
+Util::AsyncLogConfig SmallQueue(Util::LogOverflowPolicy overflow) {
+  Util::AsyncLogConfig config;
+  config.queue_capacity = 4;
+  config.overflow = overflow;
+  config.pattern = "%v";
+  return config;
+}
+
+}  // namespace
+
+TEST(AsyncLogTest, DropOldestKeepsTheNewestLines) {
+  auto downstream = std::make_shared<RecordingSink>(false);
+  auto sink = std::make_shared<Util::AsyncLogSink>(
+      std::vector<spdlog::sink_ptr>{downstream}, SmallQueue(Util::LogOverflowPolicy::DROP_OLDEST));
+  spdlog::logger logger("drop", sink);
+
+  // Hold the writer inside the first line so the queue overflows behind it
+  logger.info("line 0");
+  ASSERT_TRUE(WaitFor([&] { return downstream->Entered(); }));
+  for (int i = 1; i < 100; ++i) {
+    logger.info("line {}", i);
+  }
+  downstream->Open();
+  sink->Drain();
+
+  const Util::AsyncLogStats stats = sink->GetStats();
+  EXPECT_GT(stats.dropped, 0u);
+  EXPECT_EQ(stats.enqueued, 100u);
+  const std::vector<std::string> lines = downstream->Lines();
+  ASSERT_FALSE(lines.empty());
+  EXPECT_EQ(lines.front(), "line 0");
+  EXPECT_NE(std::find(lines.begin(), lines.end(), "line 99"), lines.end());
+  EXPECT_NE(std::find(lines.begin(), lines.end(),
+                      "Log queue full, dropped " + std::to_string(stats.dropped) + " lines"),
+            lines.end());
+}
+
+TEST(AsyncLogTest, BlockKeepsEveryLineInOrder) {
+  constexpr int COUNT = 50;
+  auto downstream = std::make_shared<RecordingSink>(false);
+  auto sink = std::make_shared<Util::AsyncLogSink>(
+      std::vector<spdlog::sink_ptr>{downstream}, SmallQueue(Util::LogOverflowPolicy::BLOCK));
+  spdlog::logger logger("block", sink);
+
+  std::thread producer([&] {
+    for (int i = 0; i < COUNT; ++i) {
+      logger.info("line {}", i);
+    }
+  });
+  ASSERT_TRUE(WaitFor([&] { return sink->GetStats().blocked > 0; }));
+  downstream->Open();
+  producer.join();
+  sink->Drain();
+
+  std::vector<std::string> expected;
+  for (int i = 0; i < COUNT; ++i) {
+    expected.push_back("line " + std::to_string(i));
+  }
+  EXPECT_EQ(downstream->Lines(), expected);
+  EXPECT_EQ(sink->GetStats().dropped, 0u);
+}
+
+TEST(AsyncLogTest, DrainFlushesAnIdleWriter) {
+  auto downstream = std::make_shared<RecordingSink>();
+  Util::AsyncLogConfig config;
+  config.pattern = "%v";
+  config.flush_interval = std::chrono::hours(1);
+  auto sink = std::make_shared<Util::AsyncLogSink>(std::vector<spdlog::sink_ptr>{downstream},
+                                                   std::move(config));
+  spdlog::logger logger("drain", sink);
+
+  logger.info("written but not flushed");
+  ASSERT_TRUE(WaitFor([&] { return sink->GetStats().written == 1; }));
+  // Let the writer go idle: the interval keeps it from flushing on its own
+  std::this_thread::sleep_for(50ms);
+  const int before = downstream->Flushes();
+
+  sink->Drain();
+  EXPECT_GT(downstream->Flushes(), before);
+  EXPECT_EQ(downstream->Lines(), std::vector<std::string>{"written but not flushed"});
+}
+
+TEST(AsyncLogTest, FlushRequestReachesDownstream) {
+  auto downstream = std::make_shared<RecordingSink>();
+  Util::AsyncLogConfig config;
+  config.flush_interval = std::chrono::hours(1);
+  auto sink = std::make_shared<Util::AsyncLogSink>(std::vector<spdlog::sink_ptr>{downstream},
+                                                   std::move(config));
+
+  sink->flush();
+  EXPECT_TRUE(WaitFor([&] { return downstream->Flushes() > 0; }));
+}
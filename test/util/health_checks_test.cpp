@@ -0,0 +1,132 @@
+#include "util/health_checks.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "network/http_server.h"
+#include "platform.h"
+#include "util/metrics.h"
+#include "util/server_metrics.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+bool Contains(const std::string& text, const std::string& line) {
+  return text.find(line) != std::string::npos;
+}
+
+#ifndef PLATFORM_WINDOWS
+/** @brief Status line of a one-shot HTTP/1.0 GET, or an empty string on failure */
+std::string StatusLine(uint16_t port, const std::string& path) {
+  const int socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  ::inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+  std::string response;
+  if (::connect(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0) {
+    const std::string request = "GET " + path + " HTTP/1.0\r\n\r\n";
+    ::send(socket, request.data(), request.size(), 0);
+    char buffer[1024];
+    ssize_t received;
+    while ((received = ::recv(socket, buffer, sizeof(buffer), 0)) > 0) {
+      response.append(buffer, static_cast<size_t>(received));
+    }
+  }
+  ::close(socket);
+  return response.substr(0, response.find("\r\n"));
+}
+#endif
+
+}  // namespace
+
+TEST(HealthChecksTest, ReadinessWaitsForWorldsAndLogins) {
+  Util::MetricsRegistry registry;
+  Util::ServerMetrics metrics(registry, {});
+  Util::HealthChecks health(metrics);
+  metrics.RecordTick(10ms);
+
+  EXPECT_TRUE(health.Liveness().ok);
+  Util::HealthReport ready = health.Readiness();
+  EXPECT_FALSE(ready.ok);
+  EXPECT_TRUE(Contains(ready.detail, "[+]tick "));
+  EXPECT_TRUE(Contains(ready.detail, "[-]worlds not loaded\n"));
+  EXPECT_TRUE(Contains(ready.detail, "[-]logins not accepted\n"));
+
+  health.SetWorldsLoaded(true);
+  EXPECT_FALSE(health.Readiness().ok);
+  health.SetAcceptingLogins(true);
+  ready = health.Readiness();
+  EXPECT_TRUE(ready.ok) << ready.detail;
+  EXPECT_TRUE(Contains(ready.detail, "[+]mspt 10.0 ms (limit 45.0 ms)\n"));
+
+  // Draining on shutdown turns the instance unready, not dead
+  health.SetAcceptingLogins(false);
+  EXPECT_FALSE(health.Readiness().ok);
+  EXPECT_TRUE(health.Liveness().ok);
+}
+
+TEST(HealthChecksTest, OverloadTurnsUnreadyButStaysAlive) {
+  Util::MetricsRegistry registry;
+  Util::ServerMetrics metrics(registry, {});
+  Util::HealthChecks health(metrics);
+  health.SetWorldsLoaded(true);
+  health.SetAcceptingLogins(true);
+  metrics.RecordTick(60ms);
+
+  EXPECT_TRUE(health.Liveness().ok);
+  const Util::HealthReport ready = health.Readiness();
+  EXPECT_FALSE(ready.ok);
+  EXPECT_TRUE(Contains(ready.detail, "[-]mspt 60.0 ms (limit 45.0 ms)\n"));
+}
+
+TEST(HealthChecksTest, StalledTickLoopFailsLiveness) {
+  Util::MetricsRegistry registry;
+  Util::ServerMetrics metrics(registry, {});
+  Util::HealthConfig config;
+  config.tick_stall = 100ms;
+  config.startup_grace = 100ms;
+  Util::HealthChecks health(metrics, config);
+  EXPECT_TRUE(health.Liveness().ok);
+
+  std::this_thread::sleep_for(150ms);
+  Util::HealthReport alive = health.Liveness();
+  EXPECT_FALSE(alive.ok);
+  EXPECT_TRUE(Contains(alive.detail, "[-]tick no tick yet after "));
+
+  metrics.RecordTick(1ms);
+  EXPECT_TRUE(health.Liveness().ok);
+  std::this_thread::sleep_for(150ms);
+  alive = health.Liveness();
+  EXPECT_FALSE(alive.ok);
+  EXPECT_TRUE(Contains(alive.detail, "[-]tick last tick "));
+  EXPECT_FALSE(health.Readiness().ok);
+}
+
+TEST(HealthChecksTest, ProbesAnswer200Or503OverHttp) {
+#ifdef PLATFORM_WINDOWS
+  GTEST_SKIP() << "the test client uses POSIX sockets";
+#else
+  Util::MetricsRegistry registry;
+  Util::ServerMetrics metrics(registry, {});
+  Util::HealthChecks health(metrics);
+  Network::HttpServerConfig http_config;
+  http_config.port = 0;
+  Network::HttpServer http(http_config);
+  health.Serve(http);
+  http.Start();
+  metrics.RecordTick(10ms);
+
+  EXPECT_EQ(StatusLine(http.Port(), "/healthz"), "HTTP/1.1 200 OK");
+  EXPECT_EQ(StatusLine(http.Port(), "/readyz"), "HTTP/1.1 503 Service Unavailable");
+  health.SetWorldsLoaded(true);
+  health.SetAcceptingLogins(true);
+  EXPECT_EQ(StatusLine(http.Port(), "/readyz"), "HTTP/1.1 200 OK");
+  http.Stop();
+#endif
+}
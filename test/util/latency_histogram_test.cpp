@@ -0,0 +1,127 @@
+#include "util/latency_histogram.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/** @brief Every value below 4096, then powers of two up to the range and their neighbours */
+std::vector<uint64_t> SampleValues() {
+  std::vector<uint64_t> values;
+  for (uint64_t value = 0; value < 4096; ++value) {
+    values.push_back(value);
+  }
+  for (uint32_t bit = 12; bit < Util::LATENCY_RANGE_BITS; ++bit) {
+    const uint64_t power = uint64_t{1} << bit;
+    values.insert(values.end(), {power - 1, power, power + 1, power + power / 3});
+  }
+  return values;
+}
+
+/** @brief True when @p reported is @p exact or above it by at most the bucket precision */
+bool WithinPrecision(uint64_t reported, uint64_t exact) {
+  return reported >= exact && reported - exact <= exact / 64;
+}
+
+}  // namespace
+
+TEST(LatencyHistogramTest, BucketsAreExactBelow64AndLogLinearAbove) {
+  for (uint64_t value = 0; value < 64; ++value) {
+    EXPECT_EQ(Util::LatencyHistogram::BucketIndex(value), value);
+    EXPECT_EQ(Util::LatencyHistogram::BucketUpperBound(value), value);
+  }
+  size_t previous = 0;
+  for (const uint64_t value : SampleValues()) {
+    const size_t bucket = Util::LatencyHistogram::BucketIndex(value);
+    ASSERT_LT(bucket, Util::LATENCY_BUCKETS) << value;
+    EXPECT_GE(bucket, previous) << value;
+    previous = bucket;
+    const uint64_t upper = Util::LatencyHistogram::BucketUpperBound(bucket);
+    EXPECT_TRUE(WithinPrecision(upper, value)) << value << " reported as " << upper;
+    // Bounds are consistent: the upper bound is in the bucket, the next value is not
+    EXPECT_EQ(Util::LatencyHistogram::BucketIndex(upper), bucket) << value;
+    if (bucket + 1 < Util::LATENCY_BUCKETS) {
+      EXPECT_EQ(Util::LatencyHistogram::BucketIndex(upper + 1), bucket + 1) << value;
+    }
+  }
+}
+
+TEST(LatencyHistogramTest, ValuesBeyondTheRangeShareTheLastBucket) {
+  const uint64_t range = uint64_t{1} << Util::LATENCY_RANGE_BITS;
+  EXPECT_EQ(Util::LatencyHistogram::BucketIndex(range - 1), Util::LATENCY_BUCKETS - 1);
+  EXPECT_EQ(Util::LatencyHistogram::BucketIndex(range), Util::LATENCY_BUCKETS - 1);
+  EXPECT_EQ(Util::LatencyHistogram::BucketIndex(UINT64_MAX), Util::LATENCY_BUCKETS - 1);
+  EXPECT_EQ(Util::LatencyHistogram::BucketUpperBound(Util::LATENCY_BUCKETS - 1), range - 1);
+}
+
+TEST(LatencyHistogramTest, PercentilesOfAUniformDistribution) {
+  Util::LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Read().total.Percentile(99), 0u);
+  for (int i = 1000; i >= 1; --i) {
+    histogram.Record(std::chrono::microseconds(i));
+  }
+  histogram.Record(-5ns);
+
+  const Util::LatencySnapshot total = histogram.Read().total;
+  EXPECT_EQ(total.count, 1001u);
+  EXPECT_EQ(total.max_ns, 1'000'000u);
+  EXPECT_EQ(total.buckets[0], 1u);
+  EXPECT_DOUBLE_EQ(total.Mean(), 500'500'000.0 / 1001);
+  EXPECT_EQ(total.Percentile(0), 0u);
+  EXPECT_TRUE(WithinPrecision(total.Percentile(50), 500'000)) << total.Percentile(50);
+  EXPECT_TRUE(WithinPrecision(total.Percentile(99), 990'000)) << total.Percentile(99);
+  EXPECT_TRUE(WithinPrecision(total.Percentile(99.9), 999'000)) << total.Percentile(99.9);
+  // Never above the largest sample, even though its bucket reaches further
+  EXPECT_EQ(total.Percentile(100), 1'000'000u);
+  EXPECT_EQ(total.Percentile(250), 1'000'000u);
+}
+
+TEST(LatencyHistogramTest, ThreadsAreMergedAfterTheyExit) {
+  Util::LatencyHistogram histogram;
+  std::vector<std::thread> threads;
+  for (int t = 1; t <= 4; ++t) {
+    threads.emplace_back([&histogram, t] {
+      for (int i = 0; i < 1000; ++i) {
+        histogram.Record(std::chrono::microseconds(t));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  histogram.Record(5us);
+
+  const Util::LatencySnapshot total = histogram.Read().total;
+  EXPECT_EQ(total.count, 4001u);
+  EXPECT_EQ(total.sum_ns, 10'005'000u);
+  EXPECT_EQ(total.max_ns, 5'000u);
+  EXPECT_TRUE(WithinPrecision(total.Percentile(50), 3'000)) << total.Percentile(50);
+}
+
+TEST(LatencyHistogramTest, RecentWindowDropsOlderSamples) {
+  Util::LatencyHistogram histogram(50ms);
+  for (int i = 0; i < 1000; ++i) {
+    histogram.Record(1ms);
+  }
+  // The first rotation only starts a window; every sample is still recent
+  std::this_thread::sleep_for(60ms);
+  Util::LatencyReading reading = histogram.Read();
+  EXPECT_EQ(reading.recent.count, 1000u);
+
+  for (int i = 0; i < 10; ++i) {
+    histogram.Record(10us);
+  }
+  std::this_thread::sleep_for(60ms);
+  reading = histogram.Read();
+  EXPECT_EQ(reading.total.count, 1010u);
+  EXPECT_EQ(reading.total.max_ns, 1'000'000u);
+  EXPECT_EQ(reading.recent.count, 10u);
+  EXPECT_TRUE(WithinPrecision(reading.recent.max_ns, 10'000)) << reading.recent.max_ns;
+  EXPECT_TRUE(WithinPrecision(reading.recent.Percentile(99), 10'000));
+}
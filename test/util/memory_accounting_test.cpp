@@ -0,0 +1,42 @@
+#include "util/memory_accounting.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+
+TEST(MemoryAccountingTest, ParseByteSizeAcceptsBinarySuffixes) {
+  EXPECT_EQ(Util::ParseByteSize("0"), 0u);
+  EXPECT_EQ(Util::ParseByteSize("1048576"), 1048576u);
+  EXPECT_EQ(Util::ParseByteSize("512B"), 512u);
+  EXPECT_EQ(Util::ParseByteSize("64k"), 64u << 10);
+  EXPECT_EQ(Util::ParseByteSize("64KiB"), 64u << 10);
+  EXPECT_EQ(Util::ParseByteSize("512M"), 512u << 20);
+  EXPECT_EQ(Util::ParseByteSize("512m"), 512u << 20);
+  EXPECT_EQ(Util::ParseByteSize("2G"), uint64_t{2} << 30);
+  EXPECT_EQ(Util::ParseByteSize("3GiB"), uint64_t{3} << 30);
+  EXPECT_EQ(Util::ParseByteSize("18446744073709551615"), UINT64_MAX);
+}
+
+TEST(MemoryAccountingTest, ParseByteSizeRejectsMalformedSizes) {
+  EXPECT_THROW(Util::ParseByteSize(""), std::invalid_argument);
+  EXPECT_THROW(Util::ParseByteSize("M"), std::invalid_argument);
+  EXPECT_THROW(Util::ParseByteSize("-1"), std::invalid_argument);
+  EXPECT_THROW(Util::ParseByteSize(" 1"), std::invalid_argument);
+  EXPECT_THROW(Util::ParseByteSize("1 M"), std::invalid_argument);
+  EXPECT_THROW(Util::ParseByteSize("1.5G"), std::invalid_argument);
+  EXPECT_THROW(Util::ParseByteSize("2T"), std::invalid_argument);
+  EXPECT_THROW(Util::ParseByteSize("2MB"), std::invalid_argument);
+}
+
+TEST(MemoryAccountingTest, ParseByteSizeRejectsSizesBeyond64Bits) {
+  EXPECT_EQ(Util::ParseByteSize("17179869183G"), uint64_t{17179869183} << 30);
+  EXPECT_THROW(Util::ParseByteSize("17179869184G"), std::invalid_argument);
+  EXPECT_THROW(Util::ParseByteSize("18446744073709551616"), std::invalid_argument);
+}
+
+TEST(MemoryAccountingTest, SubsystemsHaveLowerCaseNames) {
+  EXPECT_EQ(Util::MemorySubsystemName(Util::MemorySubsystem::CHUNKS), "chunks");
+  EXPECT_EQ(Util::MemorySubsystemName(Util::MemorySubsystem::NETWORK), "network");
+  EXPECT_EQ(Util::MemorySubsystemName(Util::MemorySubsystem::OTHER), "other");
+}
@@ -0,0 +1,127 @@
+#include "util/memory_pressure.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "platform.h"
+
+namespace {
+
+constexpr uint64_t MIB = 1 << 20;
+constexpr uint64_t LIMIT = 1000 * MIB;
+
+/** @brief Fake cgroup v2 directory whose files the test rewrites between samples */
+class FakeCgroup {
+ public:
+  FakeCgroup()
+      : path_(std::filesystem::temp_directory_path() /
+              ("ps_cgroup_" +
+               std::string(testing::UnitTest::GetInstance()->current_test_info()->name()))) {
+    std::filesystem::remove_all(path_);
+    std::filesystem::create_directories(path_);
+    Write("memory.max", std::to_string(LIMIT));
+    Set(0);
+  }
+  ~FakeCgroup() { std::filesystem::remove_all(path_); }
+
+  /** @brief Report a working set, with optional reclaimable cache on top */
+  void Set(uint64_t working_set, uint64_t inactive_file = 0, double psi_some = 0,
+           double psi_full = 0) {
+    Write("memory.current", std::to_string(working_set + inactive_file));
+    Write("memory.stat", "active_file 0\ninactive_file " + std::to_string(inactive_file) + "\n");
+    Write("memory.pressure", "some avg10=" + std::to_string(psi_some) +
+                                 " avg60=0.00 avg300=0.00 total=0\nfull avg10=" +
+                                 std::to_string(psi_full) + " avg60=0.00 avg300=0.00 total=0\n");
+  }
+
+  Util::MemoryPressureConfig Config() const {
+    Util::MemoryPressureConfig config;
+    config.cgroup_dir = path_;
+    config.adjust_budgets = false;  // Budgets are process-wide; leave them alone
+    return config;
+  }
+
+ private:
+  void Write(const char* name, const std::string& text) { std::ofstream(path_ / name) << text; }
+
+  std::filesystem::path path_;
+};
+
+/** @brief Reads come from the fake cgroup only where cgroups exist */
+class MemoryPressureTest : public testing::Test {
+ protected:
+  void SetUp() override {
+#ifndef PLATFORM_LINUX
+    GTEST_SKIP() << "memory cgroups are Linux only";
+#endif
+  }
+
+  FakeCgroup cgroup;
+};
+
+}  // namespace
+
+TEST_F(MemoryPressureTest, LevelsAreLeftOnlyBelowTheRecoveryMargin) {
+  using Util::MemoryPressureLevel;
+  Util::MemoryPressureMonitor monitor(cgroup.Config());
+  std::vector<MemoryPressureLevel> changes;
+  monitor.AddListener([&](MemoryPressureLevel level) { changes.push_back(level); });
+
+  // Working set per mille of the limit, and the level it must lead to
+  const std::vector<std::pair<uint64_t, MemoryPressureLevel>> steps{
+      {500, MemoryPressureLevel::NONE},      {790, MemoryPressureLevel::NONE},
+      {800, MemoryPressureLevel::MODERATE},  {760, MemoryPressureLevel::MODERATE},
+      {740, MemoryPressureLevel::NONE},      {900, MemoryPressureLevel::CRITICAL},
+      {860, MemoryPressureLevel::CRITICAL},  {840, MemoryPressureLevel::MODERATE},
+      {899, MemoryPressureLevel::MODERATE},  {100, MemoryPressureLevel::NONE},
+  };
+  for (const auto& [per_mille, level] : steps) {
+    cgroup.Set(per_mille * MIB);
+    const Util::MemoryPressureSample sample = monitor.Update();
+    EXPECT_EQ(sample.level, level) << "at " << per_mille << " per mille";
+    EXPECT_EQ(monitor.Level(), level);
+  }
+  EXPECT_EQ(changes, (std::vector<MemoryPressureLevel>{
+                         MemoryPressureLevel::MODERATE, MemoryPressureLevel::NONE,
+                         MemoryPressureLevel::CRITICAL, MemoryPressureLevel::MODERATE,
+                         MemoryPressureLevel::NONE}));
+}
+
+TEST_F(MemoryPressureTest, InactiveFileCacheIsNotCounted) {
+  Util::MemoryPressureMonitor monitor(cgroup.Config());
+  cgroup.Set(700 * MIB, 600 * MIB);
+
+  const Util::MemoryPressureSample sample = monitor.Update();
+  EXPECT_TRUE(sample.cgroup);
+  EXPECT_EQ(sample.working_set_bytes, 700 * MIB);
+  EXPECT_EQ(sample.limit_bytes, LIMIT);
+  EXPECT_EQ(sample.level, Util::MemoryPressureLevel::NONE);
+}
+
+TEST_F(MemoryPressureTest, StallsRaiseTheLevelBeforeTheLimitIsNear) {
+  using Util::MemoryPressureLevel;
+  Util::MemoryPressureMonitor monitor(cgroup.Config());
+
+  cgroup.Set(100 * MIB, 0, 12.5, 0);
+  EXPECT_EQ(monitor.Update().level, MemoryPressureLevel::MODERATE);
+  cgroup.Set(100 * MIB, 0, 40, 6);
+  const Util::MemoryPressureSample sample = monitor.Update();
+  EXPECT_EQ(sample.level, MemoryPressureLevel::CRITICAL);
+  EXPECT_DOUBLE_EQ(sample.psi_full_avg10, 6);
+  cgroup.Set(100 * MIB);
+  EXPECT_EQ(monitor.Update().level, MemoryPressureLevel::NONE);
+}
+
+TEST_F(MemoryPressureTest, ConfiguredLimitOverridesTheCgroup) {
+  Util::MemoryPressureConfig config = cgroup.Config();
+  config.limit_bytes = 500 * MIB;
+  Util::MemoryPressureMonitor monitor(config);
+  cgroup.Set(450 * MIB);
+  EXPECT_EQ(monitor.Update().level, Util::MemoryPressureLevel::CRITICAL);
+}
@@ -0,0 +1,105 @@
+#include "util/metrics.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+bool Contains(const std::string& text, const std::string& line) {
+  return text.find(line) != std::string::npos;
+}
+
+}  // namespace
+
+TEST(MetricsTest, CounterSumsLiveAndExitedThreads) {
+  Util::MetricsRegistry registry;
+  Util::Counter& counter = registry.AddCounter("test_events", "Events");
+  counter.Add(5);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&counter] {
+      for (int i = 0; i < 1000; ++i) {
+        counter.Add();
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  // The workers exited, so their shards were folded into the retired totals
+  EXPECT_EQ(counter.Value(), 4005u);
+}
+
+TEST(MetricsTest, RendersPrometheusText) {
+  Util::MetricsRegistry registry;
+  registry.AddCounter("test_packets", "Packets handled", {{"direction", "in"}}).Add(3);
+  registry.AddGauge("test_players", "Online players").Set(12);
+  registry.AddGaugeCallback("test_tps", "Ticks per second", {}, [] { return 19.5; });
+
+  const std::string text = registry.Render(Util::MetricsFormat::PROMETHEUS);
+  EXPECT_TRUE(Contains(text, "# HELP test_packets_total Packets handled\n"));
+  EXPECT_TRUE(Contains(text, "# TYPE test_packets_total counter\n"));
+  EXPECT_TRUE(Contains(text, "test_packets_total{direction=\"in\"} 3\n"));
+  EXPECT_TRUE(Contains(text, "# TYPE test_players gauge\ntest_players 12\n"));
+  EXPECT_TRUE(Contains(text, "test_tps 19.5\n"));
+  EXPECT_FALSE(Contains(text, "# EOF"));
+}
+
+TEST(MetricsTest, OpenMetricsNamesCounterFamiliesWithoutTotal) {
+  Util::MetricsRegistry registry;
+  registry.AddCounterCallback("test_bytes", "Bytes sent", {}, [] { return uint64_t{42}; });
+
+  const std::string text = registry.Render(Util::MetricsFormat::OPENMETRICS);
+  EXPECT_TRUE(Contains(text, "# TYPE test_bytes counter\n"));
+  EXPECT_TRUE(Contains(text, "test_bytes_total 42\n"));
+  EXPECT_TRUE(text.ends_with("# EOF\n"));
+}
+
+TEST(MetricsTest, HistogramBucketsAreCumulative) {
+  Util::MetricsRegistry registry;
+  Util::Histogram& histogram =
+      registry.AddHistogram("test_latency_seconds", "Latency", {1000, 5000}, 1e-6);
+  for (const uint64_t value : {500u, 1000u, 3000u, 9000u}) {
+    histogram.Observe(value);
+  }
+
+  const std::string text = registry.Render();
+  EXPECT_TRUE(Contains(text, "test_latency_seconds_bucket{le=\"0.001\"} 2\n"));
+  EXPECT_TRUE(Contains(text, "test_latency_seconds_bucket{le=\"0.005\"} 3\n"));
+  EXPECT_TRUE(Contains(text, "test_latency_seconds_bucket{le=\"+Inf\"} 4\n"));
+  EXPECT_TRUE(Contains(text, "test_latency_seconds_sum 0.0135\n"));
+  EXPECT_TRUE(Contains(text, "test_latency_seconds_count 4\n"));
+}
+
+TEST(MetricsTest, LabelValuesAreEscaped) {
+  Util::MetricsRegistry registry;
+  registry.AddGauge("test_labels", "Escaping", {{"path", "a\\b\"c\nd"}}).Set(1);
+  EXPECT_TRUE(Contains(registry.Render(), "test_labels{path=\"a\\\\b\\\"c\\nd\"} 1\n"));
+}
+
+TEST(MetricsTest, RejectsBadAndDuplicateSeries) {
+  Util::MetricsRegistry registry;
+  registry.AddCounter("test_dup", "Duplicate", {{"kind", "a"}});
+  EXPECT_NO_THROW(registry.AddCounter("test_dup", "Duplicate", {{"kind", "b"}}));
+  EXPECT_THROW(registry.AddCounter("test_dup", "Duplicate", {{"kind", "a"}}),
+               std::invalid_argument);
+  EXPECT_THROW(registry.AddGauge("test_dup", "Other type"), std::invalid_argument);
+  EXPECT_THROW(registry.AddGauge("9starts_with_digit", "Bad name"), std::invalid_argument);
+  EXPECT_THROW(registry.AddGauge("test_reserved", "Bad label", {{"le", "1"}}),
+               std::invalid_argument);
+  EXPECT_THROW(registry.AddHistogram("test_unsorted", "Bad bounds", {5, 1}),
+               std::invalid_argument);
+}
+
+TEST(MetricsTest, NegotiatesFormatFromAccept) {
+  EXPECT_EQ(Util::NegotiateMetricsFormat("application/openmetrics-text; version=1.0.0"),
+            Util::MetricsFormat::OPENMETRICS);
+  EXPECT_EQ(Util::NegotiateMetricsFormat("text/plain"), Util::MetricsFormat::PROMETHEUS);
+  EXPECT_EQ(Util::NegotiateMetricsFormat(""), Util::MetricsFormat::PROMETHEUS);
+}
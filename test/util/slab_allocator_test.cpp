@@ -0,0 +1,119 @@
+#include "util/slab_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/** @brief Allocate @p count blocks of @p size, fill each with its own byte and check none overlap */
+void CheckBlocksHoldTheirSize(size_t size, size_t count) {
+  std::vector<uint8_t*> blocks;
+  for (size_t i = 0; i < count; ++i) {
+    auto* block = static_cast<uint8_t*>(Util::SlabAllocate(size));
+    ASSERT_NE(block, nullptr);
+    std::memset(block, static_cast<int>(i & 0xFF), size);
+    blocks.push_back(block);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    const auto expected = static_cast<uint8_t>(i & 0xFF);
+    EXPECT_TRUE(std::all_of(blocks[i], blocks[i] + size,
+                            [expected](uint8_t byte) { return byte == expected; }))
+        << "block " << i << " of size " << size << " was overwritten";
+  }
+  for (uint8_t* block : blocks) {
+    Util::SlabFree(block, size);
+  }
+}
+
+}  // namespace
+
+TEST(SlabAllocatorTest, EveryClassIsAlignedToItsSize) {
+  for (const size_t size_class : Util::SLAB_CLASSES) {
+    void* block = Util::SlabAllocate(size_class);
+    const size_t alignment = std::min(size_class, Util::SLAB_ALIGNMENT);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % alignment, 0u) << "class " << size_class;
+    Util::SlabFree(block, size_class);
+  }
+}
+
+TEST(SlabAllocatorTest, SizesBetweenClassesRoundUp) {
+  // Exact class sizes and one byte past each, which must land in the next class
+  for (const size_t size : {1u, 32u, 33u, 2048u, 2049u, 2752u, 2753u, 3328u, 3712u, 3713u,
+                            4096u, 4097u, 8192u}) {
+    CheckBlocksHoldTheirSize(size, 64);
+  }
+}
+
+TEST(SlabAllocatorTest, LargeSizesBypassTheSlabs) {
+  const uint64_t before = Util::GetSlabStats().large_allocations;
+  void* block = Util::SlabAllocate(Util::SLAB_CLASSES.back() + 1);
+  std::memset(block, 0xAB, Util::SLAB_CLASSES.back() + 1);
+  Util::SlabFree(block, Util::SLAB_CLASSES.back() + 1);
+  EXPECT_EQ(Util::GetSlabStats().large_allocations, before + 1);
+}
+
+TEST(SlabAllocatorTest, FreeOfNullIsIgnored) { Util::SlabFree(nullptr, 64); }
+
+TEST(SlabAllocatorTest, RemoteFreesAreCounted) {
+  constexpr size_t BLOCKS = 100;
+  std::vector<void*> blocks;
+  for (size_t i = 0; i < BLOCKS; ++i) {
+    blocks.push_back(Util::SlabAllocate(256));
+  }
+  const uint64_t before = Util::GetSlabStats().remote_frees;
+  std::thread([&] {
+    for (void* block : blocks) {
+      Util::SlabFree(block, 256);
+    }
+  }).join();
+  EXPECT_EQ(Util::GetSlabStats().remote_frees, before + BLOCKS);
+}
+
+TEST(SlabAllocatorTest, OwnerReusesRemotelyFreedBlocks) {
+  // A producer allocates, another thread frees everything, over and over. If
+  // the owner did not take its remote list back, every round would carve
+  // fresh slabs and the live count would grow with the rounds.
+  constexpr size_t BLOCKS = 2000;
+  constexpr int ROUNDS = 20;
+  uint64_t live_after_first = 0;
+  uint64_t live_after_last = 0;
+
+  std::thread owner([&] {
+    for (int round = 0; round < ROUNDS; ++round) {
+      std::vector<void*> blocks;
+      for (size_t i = 0; i < BLOCKS; ++i) {
+        void* block = Util::SlabAllocate(3328);
+        std::memset(block, round, 3328);
+        blocks.push_back(block);
+      }
+      std::thread([&] {
+        for (void* block : blocks) {
+          Util::SlabFree(block, 3328);
+        }
+      }).join();
+      if (round == 0) {
+        live_after_first = Util::GetSlabStats().slabs_live;
+      }
+    }
+    live_after_last = Util::GetSlabStats().slabs_live;
+  });
+  owner.join();
+
+  // One round needs BLOCKS / (blocks per slab) slabs; allow a few for other heaps
+  EXPECT_LE(live_after_last, live_after_first + 4);
+}
+
+TEST(SlabAllocatorTest, ContainersUseTheAllocator) {
+  std::vector<uint64_t, Util::SlabAllocator<uint64_t>> values;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    values.push_back(i * i);
+  }
+  for (uint64_t i = 0; i < 1000; ++i) {
+    ASSERT_EQ(values[i], i * i);
+  }
+}
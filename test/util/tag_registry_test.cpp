@@ -0,0 +1,90 @@
+#include "util/tag_registry.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+Util::Identifier Tag(const char* name) { return Util::Identifier::Intern(name); }
+
+std::vector<int32_t> Entries(const Util::TagRegistry& tags, Util::Identifier tag) {
+  const std::span<const int32_t> entries = tags.Entries(tag);
+  return {entries.begin(), entries.end()};
+}
+
+}  // namespace
+
+TEST(TagRegistryTest, NestedTagsAreFlattenedIntoSortedMembers) {
+  Util::TagRegistry tags;
+  const Util::Identifier logs = Tag("test:logs");
+  const Util::Identifier oak = Tag("test:oak_logs");
+  const Util::Identifier birch = Tag("test:birch_logs");
+  // Included before being defined, as datapacks may order them
+  const std::vector<Util::Identifier> both{oak, birch};
+  tags.Define(logs, std::vector<int32_t>{300}, both);
+  tags.Define(oak, std::vector<int32_t>{70, 71});
+  tags.Define(birch, std::vector<int32_t>{71, 5, -1});
+  tags.Resolve();
+
+  EXPECT_EQ(Entries(tags, logs), (std::vector<int32_t>{5, 70, 71, 300}));
+  EXPECT_EQ(Entries(tags, birch), (std::vector<int32_t>{5, 71}));
+  EXPECT_TRUE(tags.Contains(logs, 300));
+  EXPECT_TRUE(tags.Contains(logs, 5));
+  EXPECT_FALSE(tags.Contains(logs, 6));
+  EXPECT_FALSE(tags.Contains(logs, 301));
+  EXPECT_FALSE(tags.Contains(logs, -1));
+  EXPECT_FALSE(tags.Contains(Tag("test:unknown"), 5));
+  EXPECT_TRUE(tags.Entries(Tag("test:unknown")).empty());
+}
+
+TEST(TagRegistryTest, RedefiningATagMergesItsMembers) {
+  Util::TagRegistry tags;
+  const Util::Identifier planks = Tag("test:planks");
+  tags.Define(planks, std::vector<int32_t>{10});
+  tags.Resolve();
+  tags.Define(planks, std::vector<int32_t>{12, 10});
+  tags.Resolve();
+  EXPECT_EQ(Entries(tags, planks), (std::vector<int32_t>{10, 12}));
+  EXPECT_EQ(tags.Size(), 1u);
+}
+
+TEST(TagRegistryTest, CyclesAreRejected) {
+  Util::TagRegistry tags;
+  const Util::Identifier a = Tag("test:cycle_a");
+  const Util::Identifier b = Tag("test:cycle_b");
+  const Util::Identifier c = Tag("test:cycle_c");
+  tags.Define(a, std::vector<int32_t>{1}, std::vector<Util::Identifier>{b});
+  tags.Define(b, std::vector<int32_t>{2}, std::vector<Util::Identifier>{c});
+  tags.Define(c, std::vector<int32_t>{3}, std::vector<Util::Identifier>{a});
+  EXPECT_THROW(tags.Resolve(), std::invalid_argument);
+
+  const Util::Identifier self = Tag("test:self");
+  Util::TagRegistry own;
+  own.Define(self, std::vector<int32_t>{1}, std::vector<Util::Identifier>{self});
+  EXPECT_THROW(own.Resolve(), std::invalid_argument);
+}
+
+TEST(TagRegistryTest, SharedIncludesAreNotCycles) {
+  Util::TagRegistry tags;
+  const Util::Identifier base = Tag("test:diamond_base");
+  const Util::Identifier left = Tag("test:diamond_left");
+  const Util::Identifier right = Tag("test:diamond_right");
+  const Util::Identifier top = Tag("test:diamond_top");
+  tags.Define(base, std::vector<int32_t>{1});
+  tags.Define(left, {}, std::vector<Util::Identifier>{base});
+  tags.Define(right, std::vector<int32_t>{2}, std::vector<Util::Identifier>{base});
+  tags.Define(top, {}, std::vector<Util::Identifier>{left, right});
+  EXPECT_NO_THROW(tags.Resolve());
+  EXPECT_EQ(Entries(tags, top), (std::vector<int32_t>{1, 2}));
+}
+
+TEST(TagRegistryTest, UndefinedIncludesAreRejected) {
+  Util::TagRegistry tags;
+  tags.Define(Tag("test:dangling"), std::vector<int32_t>{1},
+              std::vector<Util::Identifier>{Tag("test:never_defined")});
+  EXPECT_THROW(tags.Resolve(), std::invalid_argument);
+}
@@ -0,0 +1,61 @@
+#include "util/tick_arena.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <vector>
+
+TEST(TickArenaTest, AllocationsAreAligned) {
+  Util::TickArena arena(1024, false);
+  for (const size_t alignment : {1u, 2u, 4u, 8u, 16u, 64u}) {
+    (void)arena.allocate(1, 1);
+    void* block = arena.allocate(24, alignment);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % alignment, 0u) << "alignment " << alignment;
+  }
+}
+
+TEST(TickArenaTest, GrowsAndCoalescesOnReset) {
+  Util::TickArena arena(256, false);
+  for (int i = 0; i < 100; ++i) {
+    std::memset(arena.allocate(64, 8), i, 64);
+  }
+  EXPECT_GT(arena.GetStats().upstream_allocations, 1u);
+  EXPECT_GE(arena.BytesUsed(), 6400u);
+
+  arena.Reset();
+  EXPECT_EQ(arena.BytesUsed(), 0u);
+  const uint64_t upstream = arena.GetStats().upstream_allocations;
+  // The same tick again fits in the single block Reset() left behind
+  for (int i = 0; i < 100; ++i) {
+    (void)arena.allocate(64, 8);
+  }
+  EXPECT_EQ(arena.GetStats().upstream_allocations, upstream);
+  EXPECT_GE(arena.GetStats().peak_bytes, 6400u);
+  EXPECT_EQ(arena.GetStats().ticks, 1u);
+}
+
+TEST(TickArenaTest, PoisonMarksAllocatedAndReleasedMemory) {
+  Util::TickArena arena(1024, true);
+  auto* block = static_cast<uint8_t*>(arena.allocate(32, 8));
+  for (size_t i = 0; i < 32; ++i) {
+    ASSERT_EQ(block[i], Util::ARENA_ALLOCATED_POISON);
+  }
+  arena.Reset();
+  for (size_t i = 0; i < 32; ++i) {
+    ASSERT_EQ(block[i], Util::ARENA_RELEASED_POISON);
+  }
+}
+
+TEST(TickArenaTest, BacksPmrContainers) {
+  Util::TickArena arena(128, false);
+  std::pmr::vector<uint64_t> values(&arena);
+  for (uint64_t i = 0; i < 1000; ++i) {
+    values.push_back(i);
+  }
+  for (uint64_t i = 0; i < 1000; ++i) {
+    ASSERT_EQ(values[i], i);
+  }
+  EXPECT_GE(arena.GetStats().allocations, 2u);
+}
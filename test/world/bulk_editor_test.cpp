@@ -0,0 +1,93 @@
+#include "world/bulk_editor.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+
+#include "util/worker_pool.h"
+
+namespace {
+
+constexpr int32_t STONE = 1;
+constexpr int32_t DIRT = 10;
+
+/** @brief Wait for a bulk edit with a deadline, so a lost completion fails instead of hanging */
+template <typename T>
+T Await(std::future<T>& future) {
+  if (future.wait_for(std::chrono::seconds(10)) != std::future_status::ready) {
+    ADD_FAILURE() << "bulk edit never completed";
+    return T{};
+  }
+  return future.get();
+}
+
+}  // namespace
+
+TEST(BulkEditorTest, FillWritesLoadedColumnsAndSkipsOthers) {
+  World::ChunkMap chunks;
+  chunks.GetOrCreate({0, 0});
+  Util::WorkerPool workers(2);
+  World::BulkEditor editor(chunks, workers);
+
+  std::future<World::BulkEditResult> done =
+      editor.Fill(World::BlockBox::FromCorners({31, 0, 15}, {0, 15, 0}), STONE);
+  const World::BulkEditResult result = Await(done);
+
+  EXPECT_EQ(result.sections_filled, 1u);
+  EXPECT_EQ(result.blocks_written, 4096u);
+  EXPECT_EQ(result.columns_updated, 1u);
+  EXPECT_EQ(result.columns_skipped, 1u);
+  const World::ChunkColumn& column = *chunks.Find({0, 0});
+  EXPECT_EQ(column.GetBlock({7, 8, 7}), STONE);
+  EXPECT_EQ(column.HeightAt(7, 7), 64 + 16);
+}
+
+TEST(BulkEditorTest, InvertedBoxesAreRejected) {
+  World::ChunkMap chunks;
+  chunks.GetOrCreate({0, 0});
+  Util::WorkerPool workers(1);
+  World::BulkEditor editor(chunks, workers);
+  const World::BlockBox inverted{{15, 0, 0}, {0, 15, 15}};
+
+  EXPECT_TRUE(inverted.Inverted());
+  EXPECT_EQ(inverted.Volume(), 0);
+  EXPECT_THROW((void)editor.Fill(inverted, STONE), std::invalid_argument);
+  EXPECT_THROW((void)editor.Capture(inverted), std::invalid_argument);
+  EXPECT_THROW((void)editor.Clone(inverted, {0, 32, 0}), std::invalid_argument);
+}
+
+TEST(BulkEditorTest, EmptyPasteCompletesImmediately) {
+  World::ChunkMap chunks;
+  chunks.GetOrCreate({0, 0});
+  Util::WorkerPool workers(1);
+  World::BulkEditor editor(chunks, workers);
+
+  std::future<World::BulkEditResult> done =
+      editor.Paste(std::make_shared<World::Schematic>(4, 0, 4), {0, 0, 0});
+  ASSERT_EQ(done.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+  EXPECT_EQ(done.get().blocks_written, 0u);
+}
+
+TEST(BulkEditorTest, OverlappingCloneCopiesTheOriginalSource) {
+  World::ChunkMap chunks;
+  chunks.GetOrCreate({0, 0});
+  Util::WorkerPool workers(2);
+  World::BulkEditor editor(chunks, workers);
+  World::ChunkColumn& column = *chunks.Find({0, 0});
+  for (int32_t y = 0; y < 4; ++y) {
+    column.SetBlock({0, y, 0}, DIRT + y);
+  }
+
+  // Shift the stack up by two; the overlap must not copy already written blocks
+  std::future<World::BulkEditResult> done =
+      editor.Clone(World::BlockBox::FromCorners({0, 0, 0}, {0, 3, 0}), {0, 2, 0});
+  Await(done);
+
+  for (int32_t y = 0; y < 4; ++y) {
+    EXPECT_EQ(column.GetBlock({0, y + 2, 0}), DIRT + y) << "y " << y + 2;
+  }
+  EXPECT_EQ(column.GetBlock({0, 1, 0}), DIRT + 1);
+}
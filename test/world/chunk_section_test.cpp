@@ -0,0 +1,138 @@
+#include "world/chunk_section.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "network/packet_buffer.h"
+#include "protocol/version.h"
+
+namespace {
+
+constexpr int32_t STONE = 1;
+constexpr int32_t DIRT = 10;
+
+std::vector<uint8_t> Serialized(const World::ChunkSection& section) {
+  Network::PacketBuffer buffer(0);
+  section.Serialize(buffer);
+  return buffer.Finish()->bytes;
+}
+
+/** @brief Header and data longs of a section container, as Serialize() is expected to write it */
+std::vector<uint8_t> Expected(int16_t non_air, uint8_t bits, const std::vector<int32_t>& palette,
+                              const std::vector<uint64_t>& data) {
+  Network::PacketBuffer buffer(0);
+  buffer.WriteShort(non_air);
+  buffer.WriteByte(bits);
+  if (bits == 0) {
+    buffer.WriteVarInt(palette.front());
+  } else if (bits != World::ChunkSection::DIRECT_BITS) {
+    buffer.WriteVarInt(static_cast<int32_t>(palette.size()));
+    for (int32_t state_id : palette) {
+      buffer.WriteVarInt(state_id);
+    }
+  }
+#if MINECRAFT_VERSION < 121500
+  buffer.WriteVarInt(static_cast<int32_t>(data.size()));
+#endif
+  for (uint64_t word : data) {
+    buffer.WriteLong(static_cast<int64_t>(word));
+  }
+  return buffer.Finish()->bytes;
+}
+
+}  // namespace
+
+TEST(ChunkSectionTest, NewSectionIsSingleValueAir) {
+  const World::ChunkSection section;
+  EXPECT_TRUE(section.IsEmpty());
+  EXPECT_EQ(section.BitsPerEntry(), 0);
+  EXPECT_EQ(section.GetBlock(4095), World::AIR_STATE);
+  EXPECT_EQ(Serialized(section), Expected(0, 0, {World::AIR_STATE}, {}));
+}
+
+TEST(ChunkSectionTest, PaletteWidensThroughIndirectSizesToDirect) {
+  World::ChunkSection section;
+  // Distinct states 1..n, one per block; air stays in the palette as entry 0
+  auto place = [&section](int32_t count) {
+    for (int32_t state = 1; state <= count; ++state) {
+      section.SetBlock(static_cast<uint16_t>(state * 13 % World::SECTION_VOLUME), state);
+    }
+  };
+  place(15);
+  EXPECT_EQ(section.BitsPerEntry(), 4);
+  place(16);
+  EXPECT_EQ(section.BitsPerEntry(), 5);
+  place(255);
+  EXPECT_EQ(section.BitsPerEntry(), 8);
+  place(256);
+  EXPECT_EQ(section.BitsPerEntry(), World::ChunkSection::DIRECT_BITS);
+
+  for (int32_t state = 1; state <= 256; ++state) {
+    EXPECT_EQ(section.GetBlock(static_cast<uint16_t>(state * 13 % World::SECTION_VOLUME)), state);
+  }
+  EXPECT_EQ(section.GetBlock(1), World::AIR_STATE);
+  EXPECT_EQ(section.NonAirCount(), 256);
+}
+
+TEST(ChunkSectionTest, SetBlockTracksNonAirAndReturnsThePreviousState) {
+  World::ChunkSection section;
+  EXPECT_EQ(section.SetBlock(7, STONE), World::AIR_STATE);
+  EXPECT_EQ(section.SetBlock(7, DIRT), STONE);
+  EXPECT_EQ(section.SetBlock(8, DIRT), World::AIR_STATE);
+  EXPECT_EQ(section.NonAirCount(), 2);
+  EXPECT_EQ(section.SetBlock(7, World::AIR_STATE), DIRT);
+  EXPECT_EQ(section.NonAirCount(), 1);
+
+  section.Fill(STONE);
+  EXPECT_EQ(section.NonAirCount(), World::SECTION_VOLUME);
+  EXPECT_EQ(section.BitsPerEntry(), 0);
+  section.Fill(World::AIR_STATE);
+  EXPECT_TRUE(section.IsEmpty());
+}
+
+TEST(ChunkSectionTest, AssignPacksTheSmallestPaletteAndRoundTrips) {
+  std::array<int32_t, World::SECTION_VOLUME> states;
+  for (size_t i = 0; i < states.size(); ++i) {
+    states[i] = i % 3 == 0 ? World::AIR_STATE : static_cast<int32_t>(100 + i % 31);
+  }
+  World::ChunkSection section;
+  section.Assign(states);
+  EXPECT_EQ(section.BitsPerEntry(), 5);  // Air and 31 other states fill a 32-entry palette
+
+  std::array<int32_t, World::SECTION_VOLUME> exported;
+  section.Export(exported);
+  EXPECT_EQ(exported, states);
+  EXPECT_EQ(section.NonAirCount(), World::SECTION_VOLUME - (World::SECTION_VOLUME + 2) / 3);
+
+  states.fill(DIRT);
+  section.Assign(states);
+  EXPECT_EQ(section.BitsPerEntry(), 0);
+  EXPECT_EQ(section.GetBlock(0), DIRT);
+}
+
+TEST(ChunkSectionTest, SerializesIndirectAndDirectContainers) {
+  World::ChunkSection section;
+  section.SetBlock(0, STONE);
+  section.SetBlock(17, STONE);
+  // 4 bits: 16 entries per long, index 17 is the second entry of long 1
+  std::vector<uint64_t> data(World::SECTION_VOLUME / 16, 0);
+  data[0] = 1;
+  data[1] = 1 << 4;
+  EXPECT_EQ(Serialized(section), Expected(2, 4, {World::AIR_STATE, STONE}, data));
+
+  std::array<int32_t, World::SECTION_VOLUME> states{};
+  for (int32_t i = 0; i < 300; ++i) {
+    states[i] = i + 1;
+  }
+  section.Assign(states);
+  ASSERT_EQ(section.BitsPerEntry(), World::ChunkSection::DIRECT_BITS);
+  // 15 bits: four entries per long and the top four bits unused
+  std::vector<uint64_t> direct(World::SECTION_VOLUME / 4, 0);
+  for (size_t i = 0; i < 300; ++i) {
+    direct[i / 4] |= static_cast<uint64_t>(i + 1) << (i % 4 * 15);
+  }
+  EXPECT_EQ(Serialized(section), Expected(300, World::ChunkSection::DIRECT_BITS, {}, direct));
+}
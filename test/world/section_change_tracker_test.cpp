@@ -0,0 +1,125 @@
+#include "world/section_change_tracker.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "network/packet_buffer.h"
+#include "protocol/packet_ids.h"
+
+namespace {
+
+constexpr int32_t STONE = 1;
+constexpr int32_t DIRT = 10;
+constexpr int32_t GLASS = 300;  // Needs a two-byte state VarInt inside the entry
+
+struct FlushedPacket {
+  World::SectionPosition section;
+  Network::SharedPacket packet;
+};
+
+std::vector<FlushedPacket> FlushAll(World::SectionChangeTracker& tracker) {
+  std::vector<FlushedPacket> flushed;
+  tracker.Flush([&](const World::SectionPosition& section, const Network::SharedPacket& packet) {
+    flushed.push_back({section, packet});
+  });
+  return flushed;
+}
+
+/** @brief Update Section Blocks entry as the protocol packs it: state, then local x, z, y */
+int64_t Entry(int32_t state_id, const World::BlockPosition& position) {
+  return (static_cast<int64_t>(state_id) << 12) | ((position.x & 15) << 8) |
+         ((position.z & 15) << 4) | (position.y & 15);
+}
+
+}  // namespace
+
+TEST(SectionChangeTrackerTest, SingleChangeBecomesBlockUpdate) {
+  World::SectionChangeTracker tracker;
+  const World::BlockPosition position{-3, -1, 17};
+  tracker.RecordChange(position, STONE);
+  EXPECT_EQ(tracker.PendingSections(), 1u);
+
+  const std::vector<FlushedPacket> flushed = FlushAll(tracker);
+  ASSERT_EQ(flushed.size(), 1u);
+  EXPECT_EQ(flushed[0].section, (World::SectionPosition{-1, -1, 1}));
+
+  Network::PacketBuffer expected(Protocol::Play::Clientbound::BLOCK_UPDATE);
+  expected.WriteLong(position.Encode());
+  expected.WriteVarInt(STONE);
+  EXPECT_EQ(flushed[0].packet->packet_id, Protocol::Play::Clientbound::BLOCK_UPDATE);
+  EXPECT_EQ(flushed[0].packet->bytes, expected.Finish()->bytes);
+  EXPECT_TRUE(tracker.Empty());
+  EXPECT_EQ(tracker.GetStats().block_update_packets, 1u);
+}
+
+TEST(SectionChangeTrackerTest, RepeatedChangesKeepTheLastStateInFirstOrder) {
+  World::SectionChangeTracker tracker;
+  const World::BlockPosition first{1, 64, 2};
+  const World::BlockPosition second{15, 79, 0};
+  tracker.RecordChange(first, STONE);
+  tracker.RecordChange(second, DIRT);
+  tracker.RecordChange(first, DIRT);
+  tracker.RecordChange(first, GLASS);
+
+  const std::vector<FlushedPacket> flushed = FlushAll(tracker);
+  ASSERT_EQ(flushed.size(), 1u);
+  EXPECT_EQ(flushed[0].section, (World::SectionPosition{0, 4, 0}));
+
+  Network::PacketBuffer expected(Protocol::Play::Clientbound::UPDATE_SECTION_BLOCKS);
+  expected.WriteLong(flushed[0].section.Encode());
+  expected.WriteVarInt(2);
+  expected.WriteVarLong(Entry(GLASS, first));
+  expected.WriteVarLong(Entry(DIRT, second));
+  EXPECT_EQ(flushed[0].packet->packet_id, Protocol::Play::Clientbound::UPDATE_SECTION_BLOCKS);
+  EXPECT_EQ(flushed[0].packet->bytes, expected.Finish()->bytes);
+
+  const World::SectionChangeStats& stats = tracker.GetStats();
+  EXPECT_EQ(stats.changes_recorded, 4u);
+  EXPECT_EQ(stats.changes_overwritten, 2u);
+  EXPECT_EQ(stats.section_update_packets, 1u);
+  EXPECT_EQ(stats.bytes_encoded, flushed[0].packet->bytes.size());
+}
+
+TEST(SectionChangeTrackerTest, EachTouchedSectionIsFlushedOnce) {
+  World::SectionChangeTracker tracker;
+  for (int32_t x = -32; x < 32; x += 4) {
+    tracker.RecordChange({x, 0, 0}, STONE);
+    tracker.RecordChange({x + 1, 0, 0}, STONE);
+  }
+  EXPECT_EQ(tracker.PendingSections(), 4u);
+
+  std::vector<FlushedPacket> flushed = FlushAll(tracker);
+  ASSERT_EQ(flushed.size(), 4u);
+  std::vector<int32_t> section_xs;
+  for (const FlushedPacket& entry : flushed) {
+    section_xs.push_back(entry.section.x);
+    EXPECT_EQ(entry.packet->packet_id, Protocol::Play::Clientbound::UPDATE_SECTION_BLOCKS);
+  }
+  std::sort(section_xs.begin(), section_xs.end());
+  EXPECT_EQ(section_xs, (std::vector<int32_t>{-2, -1, 0, 1}));
+
+  // Recycled sections start the next tick empty
+  tracker.RecordChange({0, 0, 0}, DIRT);
+  flushed = FlushAll(tracker);
+  ASSERT_EQ(flushed.size(), 1u);
+  EXPECT_EQ(flushed[0].packet->packet_id, Protocol::Play::Clientbound::BLOCK_UPDATE);
+  EXPECT_TRUE(FlushAll(tracker).empty());
+}
+
+TEST(SectionChangeTrackerTest, PooledPacketsAreReusedAcrossTicks) {
+  Network::PacketPool pool;
+  World::SectionChangeTracker tracker(&pool);
+  for (int tick = 0; tick < 5; ++tick) {
+    tracker.RecordChange({0, 0, 0}, STONE);
+    tracker.RecordChange({1, 0, 0}, STONE);
+    // Viewers drop their references before the next tick
+    EXPECT_EQ(FlushAll(tracker).size(), 1u);
+  }
+  const Network::PacketPoolStats stats = pool.GetStats();
+  EXPECT_EQ(stats.acquired, 5u);
+  EXPECT_EQ(stats.buffers_allocated, 1u);
+  EXPECT_EQ(stats.packets_reused, 4u);
+}
@@ -0,0 +1,152 @@
+/**
+ * @file advancement_bench.cpp
+ * @brief Trigger cost of the indexed advancement criteria
+ *
+ * Builds a registry shaped like the vanilla one: many item advancements
+ * whose criteria each name one item, plus kill advancements with an
+ * unconditional criterion per entity type and a location criterion that
+ * never matches. One player then receives a stream of inventory-change
+ * events over every item id (the hottest trigger in survival play) and of
+ * location events. The inventory stream runs twice: first while the item
+ * criteria are still pending, then once they are all granted and the
+ * per-trigger pending count answers the events without evaluating
+ * anything. Prints nanoseconds per event for each phase, the share of
+ * skipped events and the sizes of the full and delta Update Advancements.
+ *
+ * @date 2026/10/18
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "advancement/advancement_index.h"
+
+namespace {
+
+struct BenchConfig {
+  int item_advancements = 600;  ///< Two item criteria each
+  int kill_advancements = 200;  ///< Five kill criteria and one location criterion each
+  int events = 1000000;         ///< Per phase
+};
+
+void Populate(const BenchConfig& config, Advancement::AdvancementRegistry& registry) {
+  using Advancement::TriggerType;
+  for (int i = 0; i < config.item_advancements; ++i) {
+    Advancement::AdvancementDefinition definition;
+    definition.id = "minecraft:husbandry/item_" + std::to_string(i);
+    if (i % 3 == 0) {
+      definition.display.emplace();
+      definition.display->title = "Item " + std::to_string(i);
+      definition.display->icon = {1, 1, nullptr};
+    }
+    for (int c = 0; c < 2; ++c) {
+      definition.criteria.push_back(
+          {"has_item_" + std::to_string(c), TriggerType::INVENTORY_CHANGED, {i * 2 + c},
+           [](const Advancement::TriggerEvent& event) { return !event.inventory.empty(); }});
+    }
+    definition.requirements = {{"has_item_0", "has_item_1"}};
+    registry.Add(std::move(definition));
+  }
+  for (int i = 0; i < config.kill_advancements; ++i) {
+    Advancement::AdvancementDefinition definition;
+    definition.id = "minecraft:adventure/kill_" + std::to_string(i);
+    for (int c = 0; c < 5; ++c) {
+      definition.criteria.push_back(
+          {"killed_" + std::to_string(c), TriggerType::PLAYER_KILLED_ENTITY, {c}, nullptr});
+    }
+    definition.criteria.push_back(
+        {"at_build_limit", TriggerType::LOCATION, {},
+         [](const Advancement::TriggerEvent& event) { return event.y > 1000; }});
+    registry.Add(std::move(definition));
+  }
+}
+
+/** @brief Nanoseconds per event of @p count events built by @p make */
+template <typename MakeEvent>
+double TimeEvents(Advancement::PlayerAdvancements& player, int count, MakeEvent make) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int n = 0; n < count; ++n) {
+    player.Trigger(make(n), 1000 + n);
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / count;
+}
+
+bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string_view argument = argv[i];
+    const long value = std::strtol(argv[i + 1], nullptr, 10);
+    if (argument == "--item-advancements") {
+      config.item_advancements = static_cast<int>(value);
+    } else if (argument == "--kill-advancements") {
+      config.kill_advancements = static_cast<int>(value);
+    } else if (argument == "--events") {
+      config.events = static_cast<int>(value);
+    } else {
+      return false;
+    }
+  }
+  return argc % 2 == 1 && config.item_advancements > 0 && config.kill_advancements >= 0 &&
+         config.events > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!ParseArguments(argc, argv, config)) {
+    std::fprintf(stderr, "usage: %s [--item-advancements N] [--kill-advancements N] [--events N]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  Advancement::AdvancementRegistry registry;
+  Populate(config, registry);
+  Advancement::PlayerAdvancements player(registry);
+  const size_t full_sync_bytes = player.FullSyncPacket()->bytes.size();
+
+  const std::vector<Inventory::ItemStack> inventory(36, Inventory::ItemStack{1, 1, nullptr});
+  const int32_t item_ids = config.item_advancements * 2;
+  auto inventory_event = [&](int n) {
+    return Advancement::TriggerEvent{.type = Advancement::TriggerType::INVENTORY_CHANGED,
+                                     .subject = n % item_ids,
+                                     .value = 0,
+                                     .inventory = inventory,
+                                     .x = 0.0,
+                                     .y = 0.0,
+                                     .z = 0.0};
+  };
+
+  const double pending_ns = TimeEvents(player, config.events, inventory_event);
+  const Network::SharedPacket delta = player.FlushUpdate();
+  const Advancement::AdvancementStats granted = player.GetStats();
+
+  const double exhausted_ns = TimeEvents(player, config.events, inventory_event);
+  const Advancement::AdvancementStats exhausted = player.GetStats();
+
+  const double location_ns = TimeEvents(player, config.events, [](int n) {
+    return Advancement::TriggerEvent{.type = Advancement::TriggerType::LOCATION,
+                                     .subject = -1,
+                                     .value = 0,
+                                     .inventory = {},
+                                     .x = static_cast<double>(n % 1000),
+                                     .y = 64.0,
+                                     .z = 0.0};
+  });
+
+  std::printf(
+      "advancements=%zu criteria=%zu pending_ns=%.1f exhausted_ns=%.1f location_ns=%.1f "
+      "skipped_pct=%.1f completed=%llu full_sync_bytes=%zu delta_bytes=%zu\n",
+      registry.Size(), registry.CriterionCount(), pending_ns, exhausted_ns, location_ns,
+      100.0 * static_cast<double>(exhausted.events_skipped - granted.events_skipped) /
+          config.events,
+      static_cast<unsigned long long>(granted.advancements_completed), full_sync_bytes,
+      delta != nullptr ? delta->bytes.size() : size_t{0});
+  return 0;
+}
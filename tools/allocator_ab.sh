@@ -0,0 +1,49 @@
+#!/usr/bin/env bash
+# Build allocator_bench once per global allocator and compare the results.
+#
+# Usage: tools/allocator_ab.sh [allocators...] [-- bench arguments]
+#   tools/allocator_ab.sh                          # system mimalloc jemalloc
+#   tools/allocator_ab.sh system mimalloc -- --ticks 2000 --players 128
+#
+# Each allocator gets its own build directory (build-alloc-<name>); extra
+# CMake arguments such as the vcpkg toolchain file are taken from
+# CMAKE_ARGS. RUNS (default 3) repeats every benchmark and keeps each run's
+# line so the spread is visible next to the difference.
+
+set -euo pipefail
+
+root="$(cd "$(dirname "$0")/.." && pwd)"
+allocators=()
+while [[ $# -gt 0 && "$1" != "--" ]]; do
+  allocators+=("$1")
+  shift
+done
+[[ $# -gt 0 ]] && shift
+[[ ${#allocators[@]} -eq 0 ]] && allocators=(system mimalloc jemalloc)
+runs="${RUNS:-3}"
+
+results=()
+for allocator in "${allocators[@]}"; do
+  build="$root/build-alloc-$allocator"
+  # shellcheck disable=SC2086
+  cmake -S "$root" -B "$build" -DCMAKE_BUILD_TYPE=Release -DBUILD_TESTS=OFF \
+    -DPARELLELSTONE_BENCHMARKS=ON -DPARELLELSTONE_ALLOCATOR="$allocator" ${CMAKE_ARGS:-} >/dev/null
+  cmake --build "$build" --target ParellelStone_allocator_bench -j"$(nproc 2>/dev/null || echo 4)" >/dev/null
+  for ((run = 1; run <= runs; ++run)); do
+    results+=("$("$build/bin/ParellelStone_allocator_bench" "$@")")
+    echo "${results[-1]}" >&2
+  done
+done
+
+printf '\n%-10s %10s %9s %9s %9s %9s %10s %10s\n' \
+  allocator ticks/s p50_ms p99_ms p999_ms max_ms peak_mib end_mib
+for line in "${results[@]}"; do
+  declare -A field=()
+  for pair in $line; do
+    field["${pair%%=*}"]="${pair#*=}"
+  done
+  printf '%-10s %10s %9s %9s %9s %9s %10s %10s\n' "${field[allocator]}" "${field[ticks_per_s]}" \
+    "${field[p50_ms]}" "${field[p99_ms]}" "${field[p999_ms]}" "${field[max_ms]}" \
+    "${field[rss_peak_mib]}" "${field[rss_end_mib]}"
+  unset field
+done
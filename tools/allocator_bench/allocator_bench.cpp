@@ -0,0 +1,300 @@
+/**
+ * @file allocator_bench.cpp
+ * @brief Server-shaped allocation workload for comparing global allocators
+ *
+ * Runs back-to-back "ticks" that allocate the way a busy server does: chunk
+ * columns are generated at the players' frontier and unloaded behind them,
+ * every player gets a burst of entity, chat and inventory packets, and a
+ * name table churns short strings. The work of each tick is spread over a
+ * WorkerPool so allocations cross threads like real connection and chunk
+ * work. The same binary is built once per PARELLELSTONE_ALLOCATOR value
+ * (see tools/allocator_ab.sh) and prints one key=value result line:
+ * throughput in ticks per second, tick latency percentiles and RSS.
+ *
+ * @date 2026/10/18
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "inventory/item_stack_cache.h"
+#include "network/packet_buffer.h"
+#include "platform.h"
+#include "util/global_allocator.h"
+#include "util/worker_pool.h"
+#include "world/chunk_column.h"
+
+#ifdef PLATFORM_WINDOWS
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+struct BenchConfig {
+  int ticks = 600;           ///< Measured ticks
+  int warmup = 60;           ///< Ticks run before measuring
+  size_t threads = 0;        ///< Worker threads, 0 for hardware concurrency
+  int players = 64;          ///< Simulated connections
+  int chunks_per_tick = 16;  ///< Columns loaded (and unloaded) per tick
+  int loaded_chunks = 1024;  ///< Columns kept loaded
+  uint32_t seed = 1;
+};
+
+struct Rss {
+  uint64_t current = 0;
+  uint64_t peak = 0;
+};
+
+Rss ReadRss() {
+  Rss rss;
+#if defined(PLATFORM_WINDOWS)
+  PROCESS_MEMORY_COUNTERS counters{};
+  if (::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters))) {
+    rss.current = counters.WorkingSetSize;
+    rss.peak = counters.PeakWorkingSetSize;
+  }
+#elif defined(PLATFORM_LINUX)
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  uint64_t kib = 0;
+  while (status >> key) {
+    if (key == "VmRSS:" && status >> kib) {
+      rss.current = kib * 1024;
+    } else if (key == "VmHWM:" && status >> kib) {
+      rss.peak = kib * 1024;
+    }
+  }
+#else
+  struct rusage usage{};
+  ::getrusage(RUSAGE_SELF, &usage);
+  rss.peak = static_cast<uint64_t>(usage.ru_maxrss);  // bytes on macOS
+  rss.current = rss.peak;
+#endif
+  return rss;
+}
+
+/** @brief Fill a freshly created column with layered terrain and scattered ores */
+void GenerateColumn(World::ChunkColumn& column, uint32_t seed) {
+  std::minstd_rand random(seed);
+  const World::ChunkPosition position = column.Position();
+  const int32_t base_x = position.x * World::SECTION_SIZE;
+  const int32_t base_z = position.z * World::SECTION_SIZE;
+  std::lock_guard lock(column.Mutex());
+  for (int32_t x = 0; x < World::SECTION_SIZE; ++x) {
+    for (int32_t z = 0; z < World::SECTION_SIZE; ++z) {
+      const int32_t height = 60 + static_cast<int32_t>(random() % 8);
+      for (int32_t y = column.MinY(); y < height; y += 4) {
+        const int32_t state = y < 0 ? 1 : (y + 4 >= height ? 9 : 10);
+        column.SetBlock({base_x + x, y, base_z + z}, state);
+      }
+      if (random() % 4 == 0) {
+        column.SetBlock({base_x + x, static_cast<int32_t>(random() % 64) - 60, base_z + z},
+                        100 + static_cast<int32_t>(random() % 16));
+      }
+    }
+  }
+  column.RecomputeHeightmap();
+}
+
+/** @brief One player's packets for a tick: entity moves, a chat line and an inventory */
+size_t SendPlayerPackets(int player, int tick, std::vector<Network::SharedPacket>& outbox) {
+  thread_local Inventory::ItemStackCache items(512);
+  thread_local std::minstd_rand random(static_cast<uint32_t>(player * 7919 + 1));
+
+  const int entity_moves = 8 + static_cast<int>(random() % 24);
+  for (int i = 0; i < entity_moves; ++i) {
+    Network::PacketBuffer move(0x2E, 32);
+    move.WriteVarInt(static_cast<int32_t>(random() % 4096));
+    move.WriteDouble(static_cast<double>(random() % 1000));
+    move.WriteDouble(64.0);
+    move.WriteDouble(static_cast<double>(random() % 1000));
+    move.WriteBool(true);
+    outbox.push_back(move.Finish());
+  }
+
+  if (random() % 4 == 0) {
+    std::string line = "<player" + std::to_string(player) + "> ";
+    const int words = 2 + static_cast<int>(random() % 12);
+    for (int i = 0; i < words; ++i) {
+      line += "word" + std::to_string(random() % 1000) + ' ';
+    }
+    Network::PacketBuffer chat(0x72, line.size() + 16);
+    chat.WriteString("{\"text\":\"" + line + "\"}");
+    chat.WriteBool(false);
+    outbox.push_back(chat.Finish());
+  }
+
+  if ((tick + player) % 20 == 0) {
+    Network::PacketBuffer inventory(0x12, 512);
+    inventory.WriteByte(0);
+    inventory.WriteVarInt(tick);
+    inventory.WriteVarInt(46);
+    for (int slot = 0; slot < 46; ++slot) {
+      Inventory::ItemStack stack;
+      stack.item_id = static_cast<int32_t>(random() % 64);
+      stack.count = static_cast<int32_t>(random() % 65);
+      items.Write(inventory, stack);
+    }
+    outbox.push_back(inventory.Finish());
+  }
+
+  size_t bytes = 0;
+  for (const Network::SharedPacket& packet : outbox) {
+    bytes += packet->bytes.size();
+  }
+  return bytes;
+}
+
+double Percentile(const std::vector<double>& sorted, double fraction) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  const size_t index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1));
+  return sorted[index];
+}
+
+bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view argument = argv[i];
+    if (i + 1 >= argc) {
+      std::fprintf(stderr, "missing value for %s\n", argv[i]);
+      return false;
+    }
+    const long value = std::strtol(argv[++i], nullptr, 10);
+    if (argument == "--ticks") {
+      config.ticks = static_cast<int>(value);
+    } else if (argument == "--warmup") {
+      config.warmup = static_cast<int>(value);
+    } else if (argument == "--threads") {
+      config.threads = static_cast<size_t>(value);
+    } else if (argument == "--players") {
+      config.players = static_cast<int>(value);
+    } else if (argument == "--chunks-per-tick") {
+      config.chunks_per_tick = static_cast<int>(value);
+    } else if (argument == "--loaded-chunks") {
+      config.loaded_chunks = static_cast<int>(value);
+    } else if (argument == "--seed") {
+      config.seed = static_cast<uint32_t>(value);
+    } else {
+      std::fprintf(stderr,
+                   "usage: %s [--ticks N] [--warmup N] [--threads N] [--players N] "
+                   "[--chunks-per-tick N] [--loaded-chunks N] [--seed N]\n",
+                   argv[0]);
+      return false;
+    }
+  }
+  return config.ticks > 0 && config.players > 0 && config.chunks_per_tick > 0 &&
+         config.loaded_chunks >= config.chunks_per_tick;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!ParseArguments(argc, argv, config)) {
+    return 2;
+  }
+
+  Util::WorkerPool workers(config.threads);
+  World::ChunkMap chunks;
+  std::unordered_map<uint64_t, std::string> names;
+  std::mt19937 random(config.seed);
+
+  // Players sweep a 64-column-wide strip; columns load at the head and unload at the tail
+  int64_t loaded_head = 0;
+  int64_t loaded_tail = 0;
+  auto column_position = [](int64_t index) {
+    return World::ChunkPosition{static_cast<int32_t>(index % 64),
+                                static_cast<int32_t>(index / 64)};
+  };
+
+  std::vector<double> tick_ms;
+  tick_ms.reserve(static_cast<size_t>(config.ticks));
+  uint64_t packet_bytes = 0;
+  auto measured_start = std::chrono::steady_clock::now();
+
+  for (int tick = 0; tick < config.warmup + config.ticks; ++tick) {
+    if (tick == config.warmup) {
+      measured_start = std::chrono::steady_clock::now();
+      packet_bytes = 0;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<size_t>> pending;
+
+    for (int i = 0; i < config.chunks_per_tick; ++i) {
+      const int64_t index = loaded_head++;
+      pending.push_back(workers.Submit([&chunks, position = column_position(index), seed = config.seed,
+                                        index]() -> size_t {
+        GenerateColumn(chunks.GetOrCreate(position), seed ^ static_cast<uint32_t>(index));
+        return 0;
+      }));
+    }
+
+    // One task per group of players, each with its own outbox, like per-connection send queues
+    constexpr int PLAYERS_PER_TASK = 8;
+    for (int first = 0; first < config.players; first += PLAYERS_PER_TASK) {
+      const int last = std::min(first + PLAYERS_PER_TASK, config.players);
+      pending.push_back(workers.Submit([first, last, tick] {
+        size_t bytes = 0;
+        for (int player = first; player < last; ++player) {
+          std::vector<Network::SharedPacket> outbox;
+          bytes += SendPlayerPackets(player, tick, outbox);
+        }
+        return bytes;
+      }));
+    }
+
+    // Main thread churn: entity names come and go
+    for (int i = 0; i < config.players * 4; ++i) {
+      const uint64_t id = random() % 8192;
+      if (random() % 2 == 0) {
+        names[id] = "entity-" + std::to_string(id) + "-" + std::to_string(tick);
+      } else {
+        names.erase(id);
+      }
+    }
+
+    for (std::future<size_t>& result : pending) {
+      packet_bytes += result.get();
+    }
+    while (loaded_head - loaded_tail > config.loaded_chunks) {
+      chunks.Unload(column_position(loaded_tail++));
+    }
+
+    if (tick >= config.warmup) {
+      const std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - start;
+      tick_ms.push_back(elapsed.count());
+    }
+  }
+
+  const std::chrono::duration<double> measured = std::chrono::steady_clock::now() - measured_start;
+  const Rss rss = ReadRss();
+  Util::TrimGlobalAllocator();
+  const Rss trimmed = ReadRss();
+
+  std::sort(tick_ms.begin(), tick_ms.end());
+  constexpr double MIB = 1024.0 * 1024.0;
+  std::printf(
+      "allocator=%.*s threads=%zu ticks=%d ticks_per_s=%.1f packet_mib_per_s=%.1f "
+      "p50_ms=%.3f p99_ms=%.3f p999_ms=%.3f max_ms=%.3f "
+      "rss_peak_mib=%.1f rss_end_mib=%.1f rss_trimmed_mib=%.1f\n",
+      static_cast<int>(Util::GlobalAllocatorName().size()), Util::GlobalAllocatorName().data(),
+      workers.ThreadCount(), config.ticks, config.ticks / measured.count(),
+      packet_bytes / MIB / measured.count(), Percentile(tick_ms, 0.50),
+      Percentile(tick_ms, 0.99), Percentile(tick_ms, 0.999), tick_ms.back(), rss.peak / MIB,
+      rss.current / MIB, trimmed.current / MIB);
+  return 0;
+}
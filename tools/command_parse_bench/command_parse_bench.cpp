@@ -0,0 +1,205 @@
+/**
+ * @file command_parse_bench.cpp
+ * @brief Command parse and tab completion throughput against the 100k/s target
+ *
+ * Builds a command graph of vanilla shape (tp, give, setblock, fill,
+ * gamemode, effect, msg, say, scoreboard, execute with its redirect back
+ * to the root, and a block of plugin-style literal commands) and parses a
+ * rotating mix of realistic command lines, valid and invalid, on one
+ * thread. Tab completion requests over partial lines are timed the same
+ * way. Prints parses per second, nanoseconds per parse and per
+ * completion, and the size of the cached Commands packet per permission
+ * level.
+ *
+ * @date 2026/10/18
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "command/command_graph.h"
+
+namespace {
+
+struct BenchConfig {
+  int parses = 2000000;
+  int plugin_commands = 200;  ///< Extra literal commands, as a plugin-heavy server has
+};
+
+/** @brief Lines a busy server sees; the last few do not parse */
+constexpr std::string_view COMMAND_LINES[] = {
+    "tp Steve 100 64 -200",
+    "tp Steve Alex",
+    "give Alex minecraft:diamond_sword 1",
+    "setblock ~ ~-1 ~ minecraft:stone",
+    "fill 0 60 0 15 70 15 minecraft:air",
+    "gamemode creative Steve",
+    "effect give @a minecraft:speed 30 1",
+    "msg Alex \"meet at spawn\"",
+    "say the server restarts in five minutes",
+    "scoreboard players set Steve kills 10",
+    "execute as @a at @s run tp @s ~ ~1 ~",
+    "plugin_command_42 reload",
+    "tp Steve 100 sixty-four -200",
+    "gamemode flying Steve",
+    "unknowncommand with arguments",
+};
+
+constexpr std::string_view PARTIAL_LINES[] = {
+    "g", "gamemode c", "give Alex minecraft:d", "execute as @a run s", "plugin_command_1",
+    "setblock ~ ~",
+};
+
+Command::ArgumentSpec Spec(Command::ArgumentType type) {
+  Command::ArgumentSpec spec;
+  spec.type = type;
+  return spec;
+}
+
+Command::CommandGraph BuildGraph(int plugin_commands) {
+  using Command::ArgumentType;
+  Command::CommandGraphBuilder builder;
+  auto run = [](const Command::CommandSource&, const Command::ParseResult& result) {
+    return static_cast<int32_t>(result.argument_count);
+  };
+  const Command::ArgumentSpec entity = Spec(ArgumentType::ENTITY);
+  const Command::ArgumentSpec pos = Spec(ArgumentType::BLOCK_POS);
+  Command::ArgumentSpec item = Spec(ArgumentType::WORD);
+  item.suggestions = {"minecraft:diamond", "minecraft:diamond_sword", "minecraft:dirt",
+                      "minecraft:stone"};
+  Command::ArgumentSpec count = Spec(ArgumentType::INTEGER);
+  count.has_min = true;
+  count.min = 1;
+
+  const Command::NodeId tp = builder.Literal(Command::ROOT_NODE, "tp", 2);
+  const Command::NodeId tp_target = builder.Argument(tp, "target", entity);
+  builder.Executes(builder.Argument(tp_target, "location", pos), run);
+  builder.Executes(builder.Argument(tp_target, "destination", entity), run);
+
+  const Command::NodeId give = builder.Literal(Command::ROOT_NODE, "give", 2);
+  const Command::NodeId give_item =
+      builder.Argument(builder.Argument(give, "targets", entity), "item", item);
+  builder.Executes(give_item, run);
+  builder.Executes(builder.Argument(give_item, "count", count), run);
+
+  const Command::NodeId setblock = builder.Literal(Command::ROOT_NODE, "setblock", 2);
+  builder.Executes(builder.Argument(builder.Argument(setblock, "pos", pos), "block", item), run);
+  const Command::NodeId fill = builder.Literal(Command::ROOT_NODE, "fill", 2);
+  builder.Executes(
+      builder.Argument(builder.Argument(builder.Argument(fill, "from", pos), "to", pos), "block",
+                       item),
+      run);
+
+  const Command::NodeId gamemode = builder.Literal(Command::ROOT_NODE, "gamemode", 2);
+  for (std::string_view mode : {"survival", "creative", "adventure", "spectator"}) {
+    const Command::NodeId literal = builder.Literal(gamemode, mode);
+    builder.Executes(literal, run);
+    builder.Executes(builder.Argument(literal, "target", entity), run);
+  }
+
+  const Command::NodeId effect_give =
+      builder.Literal(builder.Literal(Command::ROOT_NODE, "effect", 2), "give");
+  const Command::NodeId seconds = builder.Argument(
+      builder.Argument(builder.Argument(effect_give, "targets", entity), "effect", item),
+      "seconds", Spec(ArgumentType::INTEGER));
+  builder.Executes(seconds, run);
+  builder.Executes(builder.Argument(seconds, "amplifier", Spec(ArgumentType::INTEGER)), run);
+
+  const Command::NodeId msg = builder.Literal(Command::ROOT_NODE, "msg");
+  builder.Executes(builder.Argument(builder.Argument(msg, "targets", entity), "message",
+                                    Spec(ArgumentType::QUOTABLE_STRING)),
+                   run);
+  builder.Executes(builder.Argument(builder.Literal(Command::ROOT_NODE, "say", 2), "message",
+                                    Spec(ArgumentType::GREEDY_STRING)),
+                   run);
+
+  const Command::NodeId players_set = builder.Literal(
+      builder.Literal(builder.Literal(Command::ROOT_NODE, "scoreboard", 2), "players"), "set");
+  builder.Executes(
+      builder.Argument(builder.Argument(builder.Argument(players_set, "targets", entity),
+                                        "objective", Spec(ArgumentType::WORD)),
+                       "score", Spec(ArgumentType::INTEGER)),
+      run);
+
+  const Command::NodeId execute = builder.Literal(Command::ROOT_NODE, "execute", 2);
+  for (std::string_view modifier : {"as", "at"}) {
+    builder.Redirect(builder.Argument(builder.Literal(execute, modifier), "targets", entity),
+                     execute);
+  }
+  builder.Redirect(builder.Literal(execute, "run"), Command::ROOT_NODE);
+
+  for (int i = 0; i < plugin_commands; ++i) {
+    const Command::NodeId command =
+        builder.Literal(Command::ROOT_NODE, "plugin_command_" + std::to_string(i));
+    for (std::string_view action : {"reload", "status", "help"}) {
+      builder.Executes(builder.Literal(command, action), run);
+    }
+  }
+  return builder.Build();
+}
+
+bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string_view argument = argv[i];
+    const long value = std::strtol(argv[i + 1], nullptr, 10);
+    if (argument == "--parses") {
+      config.parses = static_cast<int>(value);
+    } else if (argument == "--plugin-commands") {
+      config.plugin_commands = static_cast<int>(value);
+    } else {
+      return false;
+    }
+  }
+  return argc % 2 == 1 && config.parses > 0 && config.plugin_commands >= 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!ParseArguments(argc, argv, config)) {
+    std::fprintf(stderr, "usage: %s [--parses N] [--plugin-commands N]\n", argv[0]);
+    return 2;
+  }
+
+  const Command::CommandGraph graph = BuildGraph(config.plugin_commands);
+  int ok = 0;
+  int64_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < config.parses; ++i) {
+    const Command::ParseResult result =
+        graph.Parse(COMMAND_LINES[i % std::size(COMMAND_LINES)], Command::MAX_PERMISSION_LEVEL);
+    ok += result.status == Command::ParseStatus::OK;
+    checksum += static_cast<int64_t>(result.argument_count + result.error_offset);
+  }
+  const std::chrono::duration<double> parse_elapsed = std::chrono::steady_clock::now() - start;
+
+  std::vector<std::string_view> completions;
+  size_t completion_start = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < config.parses; ++i) {
+    graph.Complete(PARTIAL_LINES[i % std::size(PARTIAL_LINES)], Command::MAX_PERMISSION_LEVEL,
+                   completion_start, completions);
+    checksum += static_cast<int64_t>(completions.size() + completion_start);
+  }
+  const std::chrono::duration<double> complete_elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  const double parses_per_second = config.parses / parse_elapsed.count();
+  std::printf(
+      "parses=%d ok=%d parses_per_s=%.0f parse_ns=%.1f complete_ns=%.1f target_met=%d "
+      "checksum=%lld\n",
+      config.parses, ok, parses_per_second, parse_elapsed.count() * 1e9 / config.parses,
+      complete_elapsed.count() * 1e9 / config.parses, parses_per_second >= 100000 ? 1 : 0,
+      static_cast<long long>(checksum));
+  for (uint8_t level = 0; level <= Command::MAX_PERMISSION_LEVEL; ++level) {
+    std::printf("level=%u commands_packet_bytes=%zu\n", level,
+                graph.CommandsPacket(level)->bytes.size());
+  }
+  return 0;
+}
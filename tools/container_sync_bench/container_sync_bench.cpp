@@ -0,0 +1,149 @@
+/**
+ * @file container_sync_bench.cpp
+ * @brief Container window bandwidth during heavy crafting and sorting
+ *
+ * Models a crafting table window (result, nine grid slots and the 36-slot
+ * player inventory) under a player shift-clicking crafts every tick: each
+ * craft consumes one item from every grid slot, tops the grid back up when
+ * it runs dry, moves the cursor now and then and adds the result to the
+ * inventory. Every --sort-every ticks an inventory sorter rotates all 36
+ * inventory slots. Some stacks carry a shared enchantment component patch.
+ * Two views watch the same container: one flushed with per-slot revision
+ * diffing, one forced to a full Set Container Content every tick (a naive
+ * resync). Prints packets and bytes of both and the item cache hit rate.
+ *
+ * @date 2026/10/18
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "inventory/container.h"
+#include "inventory/item_stack.h"
+#include "inventory/item_stack_cache.h"
+#include "network/encoded_packet.h"
+
+namespace {
+
+struct BenchConfig {
+  int ticks = 20000;
+  int sort_every = 40;  ///< Ticks between inventory sorts
+};
+
+constexpr size_t RESULT_SLOT = 0;
+constexpr size_t GRID_FIRST = 1;
+constexpr size_t GRID_SLOTS = 9;
+constexpr size_t INVENTORY_FIRST = GRID_FIRST + GRID_SLOTS;
+constexpr size_t INVENTORY_SLOTS = 36;
+constexpr int32_t MAX_STACK = 64;
+
+/** @brief Connection stand-in; the views count their own traffic */
+class NullSink : public Network::PacketSink {
+ public:
+  void SendPacket(const Network::SharedPacket&) override {}
+};
+
+bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string_view argument = argv[i];
+    const long value = std::strtol(argv[i + 1], nullptr, 10);
+    if (argument == "--ticks") {
+      config.ticks = static_cast<int>(value);
+    } else if (argument == "--sort-every") {
+      config.sort_every = static_cast<int>(value);
+    } else {
+      return false;
+    }
+  }
+  return argc % 2 == 1 && config.ticks > 0 && config.sort_every > 0;
+}
+
+void PrintView(const char* name, const Inventory::ContainerView& view, int ticks) {
+  const Inventory::ContainerSyncStats& stats = view.GetStats();
+  std::printf(
+      "%s slot_packets=%llu content_packets=%llu cursor_packets=%llu bytes=%llu "
+      "bytes_per_tick=%.1f\n",
+      name, static_cast<unsigned long long>(stats.slot_packets),
+      static_cast<unsigned long long>(stats.content_packets),
+      static_cast<unsigned long long>(stats.cursor_packets),
+      static_cast<unsigned long long>(stats.bytes_sent),
+      static_cast<double>(stats.bytes_sent) / ticks);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!ParseArguments(argc, argv, config)) {
+    std::fprintf(stderr, "usage: %s [--ticks N] [--sort-every N]\n", argv[0]);
+    return 2;
+  }
+
+  // Stand-in for an enchantments patch; only its size and sharing matter here
+  const auto enchanted = std::make_shared<const Inventory::ItemComponentPatch>(
+      1, 0, std::vector<uint8_t>{0x0A, 0x02, 0x0D, 0x05, 0x26, 0x03, 0x00});
+  Inventory::Container container(INVENTORY_FIRST + INVENTORY_SLOTS);
+  for (size_t i = 0; i < INVENTORY_SLOTS; ++i) {
+    container.SetSlot(INVENTORY_FIRST + i,
+                      {.item_id = static_cast<int32_t>(800 + i % 12),
+                       .count = static_cast<int32_t>(i % MAX_STACK + 1),
+                       .components = i % 5 == 0 ? enchanted : nullptr});
+  }
+
+  NullSink sink;
+  Inventory::ItemStackCache cache;
+  Inventory::ContainerView diffed(container, 1);
+  Inventory::ContainerView resynced(container, 1);
+  std::vector<Inventory::ItemStack> rotated(INVENTORY_SLOTS);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int tick = 0; tick < config.ticks; ++tick) {
+    for (size_t g = 0; g < GRID_SLOTS; ++g) {
+      Inventory::ItemStack ingredient = container.Slot(GRID_FIRST + g);
+      ingredient.item_id = 40;
+      ingredient.count = ingredient.count > 1 ? ingredient.count - 1 : MAX_STACK;
+      container.SetSlot(GRID_FIRST + g, ingredient);
+    }
+    container.SetSlot(RESULT_SLOT, {.item_id = 41, .count = 1, .components = nullptr});
+    const size_t output = INVENTORY_FIRST + static_cast<size_t>(tick / MAX_STACK) % INVENTORY_SLOTS;
+    Inventory::ItemStack crafted = container.Slot(output);
+    crafted.count = crafted.item_id == 41 ? crafted.count % MAX_STACK + 1 : 1;
+    crafted.item_id = 41;
+    crafted.components = nullptr;
+    container.SetSlot(output, crafted);
+    if (tick % 8 == 0) {
+      const Inventory::ItemStack carried{
+          .item_id = 41, .count = tick % MAX_STACK + 1, .components = nullptr};
+      diffed.SetCarried(carried);
+      resynced.SetCarried(carried);
+    }
+
+    if (tick % config.sort_every == 0) {
+      for (size_t i = 0; i < INVENTORY_SLOTS; ++i) {
+        rotated[i] = container.Slot(INVENTORY_FIRST + (i + 1) % INVENTORY_SLOTS);
+      }
+      for (size_t i = 0; i < INVENTORY_SLOTS; ++i) {
+        container.SetSlot(INVENTORY_FIRST + i, rotated[i]);
+      }
+    }
+
+    diffed.Flush(cache, sink);
+    resynced.Resync();
+    resynced.Flush(cache, sink);
+  }
+  const std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  const Inventory::ItemStackCacheStats& cache_stats = cache.GetStats();
+  std::printf("ticks=%d sort_every=%d slots=%zu tick_us=%.2f cache_hit_rate=%.3f\n",
+              config.ticks, config.sort_every, container.Size(), elapsed.count() / config.ticks,
+              static_cast<double>(cache_stats.hits) / (cache_stats.hits + cache_stats.misses));
+  PrintView("diffed", diffed, config.ticks);
+  PrintView("resynced", resynced, config.ticks);
+  return 0;
+}
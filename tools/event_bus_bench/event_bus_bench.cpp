@@ -0,0 +1,182 @@
+/**
+ * @file event_bus_bench.cpp
+ * @brief Dispatch cost of Plugin::EventBus
+ *
+ * Registers a number of block-place handlers at mixed priorities and
+ * dispatches a stream of events through EventBus::Dispatch, the path every
+ * native plugin handler takes once loaded (PluginManager only binds the
+ * host API around Subscribe). For comparison the same handlers also run
+ * through a string-keyed map of std::function vectors, the shape of a
+ * dynamic event bus that looks up the event name per dispatch. When the
+ * server is built with PARELLELSTONE_WASM_PLUGINS the same handler, as a
+ * small WebAssembly module, is loaded --wasm-plugins times into a
+ * WasmPluginHost on its own bus, which measures the cost of crossing into
+ * the sandbox. Prints nanoseconds per event and per handler for each.
+ *
+ * @date 2026/10/18
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "plugin/event_bus.h"
+#include "plugin/wasm_plugin_host.h"
+
+namespace {
+
+struct BenchConfig {
+  int handlers = 50;
+  int events = 2000000;
+  int wasm_plugins = 1;  ///< Copies of the WebAssembly handler, when the runtime is built in
+};
+
+/** @brief Typical protection-plugin handler: look at the position, rarely cancel */
+int32_t DenyBelowBedrock(void* user_data, void* event) {
+  auto* counter = static_cast<uint64_t*>(user_data);
+  const auto* block = static_cast<const ps_block_event*>(event);
+  ++*counter;
+  return block->y < -64 ? PS_EVENT_CANCEL : PS_EVENT_CONTINUE;
+}
+
+/**
+ * @brief DenyBelowBedrock as a WebAssembly plugin
+ *
+ * (module
+ *   (import "ps" "subscribe" (func $subscribe (param i32 i32) (result i32)))
+ *   (memory (export "memory") 1)
+ *   (func (export "ps_plugin_init") (result i32)
+ *     (drop (call $subscribe (i32.const 0) (i32.const 0)))  ;; BLOCK_PLACE, priority 0
+ *     (i32.const 0))
+ *   (func (export "ps_on_event") (param $type i32) (param $event i32) (param $length i32)
+ *         (result i32)
+ *     (i32.lt_s (i32.load offset=28 (local.get $event)) (i32.const -64))))  ;; y < -64
+ */
+constexpr uint8_t DENY_BELOW_BEDROCK_WASM[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x12, 0x03, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x01, 0x7f, 0x60, 0x03, 0x7f,
+    0x7f, 0x7f, 0x01, 0x7f, 0x02, 0x10, 0x01, 0x02, 0x70, 0x73, 0x09, 0x73,
+    0x75, 0x62, 0x73, 0x63, 0x72, 0x69, 0x62, 0x65, 0x00, 0x00, 0x03, 0x03,
+    0x02, 0x01, 0x02, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07, 0x29, 0x03, 0x06,
+    0x6d, 0x65, 0x6d, 0x6f, 0x72, 0x79, 0x02, 0x00, 0x0e, 0x70, 0x73, 0x5f,
+    0x70, 0x6c, 0x75, 0x67, 0x69, 0x6e, 0x5f, 0x69, 0x6e, 0x69, 0x74, 0x00,
+    0x01, 0x0b, 0x70, 0x73, 0x5f, 0x6f, 0x6e, 0x5f, 0x65, 0x76, 0x65, 0x6e,
+    0x74, 0x00, 0x02, 0x0a, 0x18, 0x02, 0x0b, 0x00, 0x41, 0x00, 0x41, 0x00,
+    0x10, 0x00, 0x1a, 0x41, 0x00, 0x0b, 0x0a, 0x00, 0x20, 0x01, 0x28, 0x02,
+    0x1c, 0x41, 0x40, 0x48, 0x0b,
+};
+
+double NanosecondsPerEvent(int events, const std::function<void(int)>& dispatch) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < events; ++i) {
+    dispatch(i);
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / events;
+}
+
+bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string_view argument = argv[i];
+    const long value = std::strtol(argv[i + 1], nullptr, 10);
+    if (argument == "--handlers") {
+      config.handlers = static_cast<int>(value);
+    } else if (argument == "--events") {
+      config.events = static_cast<int>(value);
+    } else if (argument == "--wasm-plugins") {
+      config.wasm_plugins = static_cast<int>(value);
+    } else {
+      return false;
+    }
+  }
+  return argc % 2 == 1 && config.handlers > 0 && config.events > 0 && config.wasm_plugins > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!ParseArguments(argc, argv, config)) {
+    std::fprintf(stderr, "usage: %s [--handlers N] [--events N] [--wasm-plugins N]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  uint64_t calls = 0;
+  Plugin::EventBus bus;
+  using DynamicHandler = std::function<int32_t(void*)>;
+  std::unordered_map<std::string, std::vector<DynamicHandler>> dynamic;
+  for (int h = 0; h < config.handlers; ++h) {
+    bus.Subscribe(Plugin::EventType::BLOCK_PLACE, (h * 37) % 5 * 100, DenyBelowBedrock, &calls);
+    dynamic["block_place"].push_back(
+        [&calls](void* event) { return DenyBelowBedrock(&calls, event); });
+  }
+
+  uint64_t allowed = 0;
+  const double bus_ns = NanosecondsPerEvent(config.events, [&](int i) {
+    ps_block_event event{};
+    event.x = i;
+    event.y = i % 2 == 0 ? 64 : -70;
+    allowed += bus.Dispatch<Plugin::EventType::BLOCK_PLACE>(event);
+  });
+  const double dynamic_ns = NanosecondsPerEvent(config.events, [&](int i) {
+    ps_block_event event{};
+    event.x = i;
+    event.y = i % 2 == 0 ? 64 : -70;
+    bool cancelled = false;
+    for (const DynamicHandler& handler : dynamic.find("block_place")->second) {
+      cancelled |= handler(&event) == PS_EVENT_CANCEL;
+    }
+    allowed += !cancelled;
+  });
+
+  std::printf(
+      "handlers=%d events=%d bus_ns=%.1f bus_ns_per_handler=%.2f dynamic_ns=%.1f "
+      "dynamic_ns_per_handler=%.2f allowed=%llu calls=%llu\n",
+      config.handlers, config.events, bus_ns, bus_ns / config.handlers, dynamic_ns,
+      dynamic_ns / config.handlers, static_cast<unsigned long long>(allowed),
+      static_cast<unsigned long long>(calls));
+
+  if (!Plugin::WasmPluginHost::Available()) {
+    std::printf("wasm=unavailable (build with PARELLELSTONE_WASM_PLUGINS)\n");
+    return 0;
+  }
+  const std::filesystem::path module_path =
+      std::filesystem::temp_directory_path() / "event_bus_bench_deny_below_bedrock.wasm";
+  {
+    std::ofstream file(module_path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(DENY_BELOW_BEDROCK_WASM),
+               std::size(DENY_BELOW_BEDROCK_WASM));
+  }
+  Plugin::EventBus wasm_bus;
+  Plugin::WasmLimits limits;
+  limits.tick_budget = std::chrono::hours(1);  // one "tick" covers the whole run
+  Plugin::WasmPluginHost host(wasm_bus, limits);
+  for (int p = 0; p < config.wasm_plugins; ++p) {
+    host.Load(module_path);
+  }
+  std::filesystem::remove(module_path);
+  host.BeginTick();
+
+  uint64_t wasm_allowed = 0;
+  const double wasm_ns = NanosecondsPerEvent(config.events, [&](int i) {
+    ps_block_event event{};
+    event.x = i;
+    event.y = i % 2 == 0 ? 64 : -70;
+    wasm_allowed += wasm_bus.Dispatch<Plugin::EventType::BLOCK_PLACE>(event);
+  });
+  std::printf("wasm_plugins=%d wasm_ns=%.1f wasm_ns_per_handler=%.2f allowed=%llu\n",
+              config.wasm_plugins, wasm_ns, wasm_ns / config.wasm_plugins,
+              static_cast<unsigned long long>(wasm_allowed));
+  return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file huge_page_bench.cpp
+ * @brief Random block reads over slab-backed chunk sections, with and without huge pages
+ *
+ * Fills a large number of 8-bit chunk sections, whose packed data lives in
+ * slab allocator segments, and then reads blocks at random section and
+ * index, the TLB-hostile pattern of entity AI, random ticks and lighting
+ * over a loaded world. Util::SetSlabHugePages() is set from --huge-pages
+ * before the first section allocates, so run it once per setting, each in
+ * its own process. Prints nanoseconds per read and the AnonHugePages the
+ * process ended up with; on a shared or noisy host compare several runs.
+ *
+ * @date 2026/10/18
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/slab_allocator.h"
+#include "world/chunk_section.h"
+
+namespace {
+
+struct BenchConfig {
+  bool huge_pages = false;
+  size_t sections = 200000;  ///< About 1 GiB of 8-bit sections
+  int reads = 20000000;
+};
+
+/** @brief AnonHugePages of the process in MiB, 0 where smaps_rollup is unavailable */
+uint64_t AnonHugePagesMiB() {
+  std::ifstream file("/proc/self/smaps_rollup");
+  std::string line;
+  constexpr std::string_view KEY = "AnonHugePages:";
+  while (std::getline(file, line)) {
+    if (line.rfind(KEY, 0) == 0) {
+      return std::stoull(line.substr(KEY.size())) / 1024;
+    }
+  }
+  return 0;
+}
+
+bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string_view argument = argv[i];
+    const long value = std::strtol(argv[i + 1], nullptr, 10);
+    if (argument == "--huge-pages") {
+      config.huge_pages = value != 0;
+    } else if (argument == "--sections") {
+      config.sections = static_cast<size_t>(value);
+    } else if (argument == "--reads") {
+      config.reads = static_cast<int>(value);
+    } else {
+      return false;
+    }
+  }
+  return argc % 2 == 1 && config.sections > 0 && config.reads > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!ParseArguments(argc, argv, config)) {
+    std::fprintf(stderr, "usage: %s [--huge-pages 0|1] [--sections N] [--reads N]\n", argv[0]);
+    return 2;
+  }
+
+  Util::SetSlabHugePages(config.huge_pages);
+  std::array<int32_t, World::SECTION_VOLUME> states{};
+  for (size_t i = 0; i < states.size(); ++i) {
+    states[i] = static_cast<int32_t>(i * 7 % 200 + 1);  // 200 states: 8 bits per entry
+  }
+  std::vector<World::ChunkSection> sections(config.sections);
+  for (World::ChunkSection& section : sections) {
+    section.Assign(states);
+  }
+
+  std::mt19937_64 random(42);
+  int64_t checksum = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < config.reads; ++i) {
+    const uint64_t bits = random();
+    checksum += sections[bits % config.sections].GetBlock(
+        static_cast<uint16_t>((bits >> 32) % World::SECTION_VOLUME));
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  std::printf(
+      "huge_pages=%d sections=%zu read_ns=%.1f anon_huge_pages_mib=%llu segments=%llu "
+      "checksum=%lld\n",
+      config.huge_pages ? 1 : 0, config.sections, elapsed.count() / config.reads,
+      static_cast<unsigned long long>(AnonHugePagesMiB()),
+      static_cast<unsigned long long>(Util::GetSlabStats().segments),
+      static_cast<long long>(checksum));
+  return 0;
+}
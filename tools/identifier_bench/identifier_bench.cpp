@@ -0,0 +1,128 @@
+/**
+ * @file identifier_bench.cpp
+ * @brief Registry lookup and tag membership by interned Identifier versus by string
+ *
+ * Interns a registry of namespaced item ids and a set of datapack tags over
+ * them, then times the two hot questions gameplay code asks: "what is the
+ * value registered under this id" and "is this entry in that tag". Each is
+ * answered once the string-keyed way (std::unordered_map<std::string> and
+ * per-tag std::unordered_set<std::string>) and once through the handles
+ * (IdentifierMap lookup and the resolved TagRegistry bit test). Prints
+ * nanoseconds per query for all four.
+ *
+ * @date 2026/10/18
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "util/identifier.h"
+#include "util/tag_registry.h"
+
+namespace {
+
+struct BenchConfig {
+  int ids = 1500;
+  int tags = 200;
+  int tag_members = 50;
+  int queries = 20000000;  ///< Per variant
+};
+
+double NanosecondsPerQuery(int queries, int64_t& checksum,
+                           const std::function<int64_t(int)>& query) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < queries; ++i) {
+    checksum += query(i);
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / queries;
+}
+
+bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string_view argument = argv[i];
+    const long value = std::strtol(argv[i + 1], nullptr, 10);
+    if (argument == "--ids") {
+      config.ids = static_cast<int>(value);
+    } else if (argument == "--tags") {
+      config.tags = static_cast<int>(value);
+    } else if (argument == "--tag-members") {
+      config.tag_members = static_cast<int>(value);
+    } else if (argument == "--queries") {
+      config.queries = static_cast<int>(value);
+    } else {
+      return false;
+    }
+  }
+  return argc % 2 == 1 && config.ids > 0 && config.tags > 0 && config.tag_members > 0 &&
+         config.queries > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!ParseArguments(argc, argv, config)) {
+    std::fprintf(stderr, "usage: %s [--ids N] [--tags N] [--tag-members N] [--queries N]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  std::vector<std::string> names;
+  std::vector<Util::Identifier> ids;
+  std::unordered_map<std::string, int32_t> string_registry;
+  Util::IdentifierMap<int32_t> registry;
+  for (int32_t i = 0; i < config.ids; ++i) {
+    names.push_back("minecraft:item_" + std::to_string(i));
+    ids.push_back(Util::Identifier::Intern(names.back()));
+    string_registry.emplace(names.back(), i);
+    registry.Insert(ids.back(), i);
+  }
+
+  std::vector<std::string> tag_names;
+  std::vector<Util::Identifier> tag_ids;
+  std::unordered_map<std::string, std::unordered_set<std::string>> string_tags;
+  Util::TagRegistry tags;
+  for (int t = 0; t < config.tags; ++t) {
+    tag_names.push_back("minecraft:tag_" + std::to_string(t));
+    tag_ids.push_back(Util::Identifier::Intern(tag_names.back()));
+    std::vector<int32_t> members;
+    for (int k = 0; k < config.tag_members; ++k) {
+      members.push_back((t * 37 + k * 13) % config.ids);
+      string_tags[tag_names.back()].insert(names[members.back()]);
+    }
+    tags.Define(tag_ids.back(), members);
+  }
+  tags.Resolve();
+
+  int64_t checksum = 0;
+  const double string_lookup_ns = NanosecondsPerQuery(config.queries, checksum, [&](int i) {
+    return string_registry.find(names[i * 7 % config.ids])->second;
+  });
+  const double handle_lookup_ns = NanosecondsPerQuery(config.queries, checksum, [&](int i) {
+    return *registry.Find(ids[i * 7 % config.ids]);
+  });
+  const double string_tag_ns = NanosecondsPerQuery(config.queries, checksum, [&](int i) {
+    return static_cast<int64_t>(
+        string_tags.find(tag_names[i % config.tags])->second.count(names[i * 11 % config.ids]));
+  });
+  const double handle_tag_ns = NanosecondsPerQuery(config.queries, checksum, [&](int i) {
+    return static_cast<int64_t>(tags.Contains(tag_ids[i % config.tags], i * 11 % config.ids));
+  });
+
+  std::printf(
+      "ids=%d tags=%d string_lookup_ns=%.1f handle_lookup_ns=%.1f string_tag_ns=%.1f "
+      "handle_tag_ns=%.1f checksum=%lld\n",
+      config.ids, config.tags, string_lookup_ns, handle_lookup_ns, string_tag_ns, handle_tag_ns,
+      static_cast<long long>(checksum));
+  return 0;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file numa_bench.cpp
+ * @brief Local versus remote block reads across NUMA nodes, and region relocation
+ *
+ * Creates one node-pinned WorkerPool per NUMA node and a set of filled
+ * chunk columns. For every node in turn the columns are relocated onto it
+ * with ChunkColumn::Relocate() run on that node's pool, then each pool
+ * reads random blocks from them, so the diagonal of the output is a region
+ * ticked where its memory lives and the rest is the interconnect penalty
+ * the node-local placement avoids. Prints the topology, the relocation
+ * time per node, read nanoseconds per (data node, reader node) pair and
+ * the growth of the kernel's numa_miss and other_node counters. On a
+ * single-node host only the local case exists.
+ *
+ * @date 2026/10/18
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "util/numa.h"
+#include "util/worker_pool.h"
+#include "world/chunk_column.h"
+
+namespace {
+
+struct BenchConfig {
+  int columns = 256;
+  int filled_sections = 8;  ///< Non-air sections per column, from the bottom
+  int reads = 10000000;     ///< Per (data node, reader node) pair
+  size_t threads = 1;       ///< Workers per node pool
+};
+
+uint64_t CounterSum(uint64_t Util::NumaNodeCounters::*counter) {
+  uint64_t sum = 0;
+  for (const Util::NumaNodeCounters& node : Util::ReadNumaCounters()) {
+    sum += node.*counter;
+  }
+  return sum;
+}
+
+template <typename Task>
+double Milliseconds(Util::WorkerPool& pool, Task task) {
+  const auto start = std::chrono::steady_clock::now();
+  pool.Submit(task).get();
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string_view argument = argv[i];
+    const long value = std::strtol(argv[i + 1], nullptr, 10);
+    if (argument == "--columns") {
+      config.columns = static_cast<int>(value);
+    } else if (argument == "--filled-sections") {
+      config.filled_sections = static_cast<int>(value);
+    } else if (argument == "--reads") {
+      config.reads = static_cast<int>(value);
+    } else if (argument == "--threads") {
+      config.threads = static_cast<size_t>(value);
+    } else {
+      return false;
+    }
+  }
+  return argc % 2 == 1 && config.columns > 0 && config.filled_sections > 0 &&
+         config.filled_sections <= World::OVERWORLD_SECTION_COUNT && config.reads > 0 &&
+         config.threads > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!ParseArguments(argc, argv, config)) {
+    std::fprintf(stderr,
+                 "usage: %s [--columns N] [--filled-sections N] [--reads N] [--threads N]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  const Util::NumaTopology& topology = Util::GetNumaTopology();
+  std::printf("nodes=%zu current_node=%d\n", topology.NodeCount(), Util::CurrentNumaNode());
+  std::vector<std::unique_ptr<Util::WorkerPool>> pools;
+  for (size_t node = 0; node < topology.NodeCount(); ++node) {
+    std::printf("node=%zu cpus=%zu\n", node, topology.node_cpus[node].size());
+    pools.push_back(std::make_unique<Util::WorkerPool>(config.threads, static_cast<int>(node)));
+  }
+
+  std::array<int32_t, World::SECTION_VOLUME> states{};
+  for (size_t i = 0; i < states.size(); ++i) {
+    states[i] = static_cast<int32_t>(i * 7 % 200 + 1);
+  }
+  std::vector<std::unique_ptr<World::ChunkColumn>> columns;
+  for (int c = 0; c < config.columns; ++c) {
+    auto column = std::make_unique<World::ChunkColumn>(World::ChunkPosition{c % 16, c / 16});
+    for (int s = 0; s < config.filled_sections; ++s) {
+      column->SectionAt(World::OVERWORLD_MIN_Y / World::SECTION_SIZE + s)->Assign(states);
+    }
+    column->RecomputeHeightmap();
+    columns.push_back(std::move(column));
+  }
+
+  const uint64_t miss_before = CounterSum(&Util::NumaNodeCounters::numa_miss);
+  const uint64_t other_before = CounterSum(&Util::NumaNodeCounters::other_node);
+  const int32_t filled_height = config.filled_sections * World::SECTION_SIZE;
+  for (size_t data_node = 0; data_node < pools.size(); ++data_node) {
+    const double relocate_ms = Milliseconds(*pools[data_node], [&columns] {
+      for (const std::unique_ptr<World::ChunkColumn>& column : columns) {
+        column->Relocate();
+      }
+    });
+    std::printf("data_node=%zu relocate_ms=%.1f\n", data_node, relocate_ms);
+
+    for (size_t reader_node = 0; reader_node < pools.size(); ++reader_node) {
+      int64_t checksum = 0;
+      const double read_ms = Milliseconds(*pools[reader_node], [&] {
+        std::mt19937_64 random(42);
+        for (int i = 0; i < config.reads; ++i) {
+          const uint64_t bits = random();
+          const World::ChunkColumn& column = *columns[bits % columns.size()];
+          const World::ChunkPosition chunk = column.Position();
+          checksum += column.GetBlock({chunk.x * 16 + static_cast<int32_t>(bits >> 20 & 15),
+                                       World::OVERWORLD_MIN_Y +
+                                           static_cast<int32_t>((bits >> 24) % filled_height),
+                                       chunk.z * 16 + static_cast<int32_t>(bits >> 40 & 15)});
+        }
+      });
+      std::printf("data_node=%zu reader_node=%zu read_ns=%.1f checksum=%lld\n", data_node,
+                  reader_node, read_ms * 1e6 / config.reads, static_cast<long long>(checksum));
+    }
+  }
+  std::printf("numa_miss_delta=%llu other_node_delta=%llu\n",
+              static_cast<unsigned long long>(
+                  CounterSum(&Util::NumaNodeCounters::numa_miss) - miss_before),
+              static_cast<unsigned long long>(
+                  CounterSum(&Util::NumaNodeCounters::other_node) - other_before));
+  return 0;
+}
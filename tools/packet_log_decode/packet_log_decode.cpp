@@ -0,0 +1,249 @@
+/**
+ * @file packet_log_decode.cpp
+ * @brief Offline decoder for the binary packet log written by Network::PacketLog
+ *
+ * Reads one or more .pslog files (or the directory holding the ring),
+ * orders them by sequence number and prints one line per record, or with
+ * --summary a table of counts and bytes per packet type. Filters narrow the
+ * output to a connection, a packet id or a direction.
+ *
+ * @code
+ * packet_log_decode logs/packets
+ * packet_log_decode --connection 12 --payload logs/packets/packets-2.pslog
+ * packet_log_decode --summary --direction clientbound logs/packets
+ * @endcode
+ *
+ * @date 2026/10/18
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "network/packet_log.h"
+
+namespace {
+
+struct Options {
+  std::vector<std::filesystem::path> inputs;
+  std::optional<uint32_t> connection;
+  std::optional<int32_t> packet_id;
+  std::optional<Network::PacketDirection> direction;
+  bool summary = false;
+  bool payload = false;
+};
+
+struct LogFile {
+  std::filesystem::path path;
+  Network::PacketLogFileHeader header;
+  std::vector<uint8_t> data;
+};
+
+struct TypeSummary {
+  uint64_t count = 0;
+  uint64_t bytes = 0;
+  uint32_t max_length = 0;
+};
+
+const char* DirectionName(uint8_t direction) {
+  return direction == static_cast<uint8_t>(Network::PacketDirection::CLIENTBOUND) ? "S->C" : "C->S";
+}
+
+const char* StateName(uint8_t state) {
+  switch (static_cast<Network::ConnectionState>(state)) {
+    case Network::ConnectionState::HANDSHAKING:
+      return "handshaking";
+    case Network::ConnectionState::STATUS:
+      return "status";
+    case Network::ConnectionState::LOGIN:
+      return "login";
+    case Network::ConnectionState::CONFIGURATION:
+      return "configuration";
+    case Network::ConnectionState::PLAY:
+      return "play";
+  }
+  return "unknown";
+}
+
+std::string FormatTimestamp(uint64_t nanoseconds) {
+  const std::time_t seconds = static_cast<std::time_t>(nanoseconds / 1000000000);
+  char date[32] = {};
+  if (const std::tm* utc = std::gmtime(&seconds)) {
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", utc);
+  }
+  char result[48];
+  std::snprintf(result, sizeof(result), "%s.%09lluZ", date,
+                static_cast<unsigned long long>(nanoseconds % 1000000000));
+  return result;
+}
+
+std::optional<LogFile> ReadLogFile(const std::filesystem::path& path) {
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream) {
+    std::fprintf(stderr, "%s: cannot open\n", path.string().c_str());
+    return std::nullopt;
+  }
+  LogFile file;
+  file.path = path;
+  if (!stream.read(reinterpret_cast<char*>(&file.header), sizeof(file.header)) ||
+      file.header.magic != Network::PACKET_LOG_MAGIC) {
+    std::fprintf(stderr, "%s: not a packet log\n", path.string().c_str());
+    return std::nullopt;
+  }
+  if (file.header.version != Network::PACKET_LOG_VERSION ||
+      file.header.header_bytes < sizeof(file.header)) {
+    std::fprintf(stderr, "%s: unsupported packet log version %u\n", path.string().c_str(),
+                 file.header.version);
+    return std::nullopt;
+  }
+  stream.seekg(file.header.header_bytes);
+  file.data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+  return file;
+}
+
+bool Matches(const Options& options, const Network::PacketLogRecord& record) {
+  return (!options.connection || record.connection == *options.connection) &&
+         (!options.packet_id || record.packet_id == *options.packet_id) &&
+         (!options.direction || record.direction == static_cast<uint8_t>(*options.direction));
+}
+
+bool ParseArguments(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view argument = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (argument == "--summary") {
+      options.summary = true;
+    } else if (argument == "--payload") {
+      options.payload = true;
+    } else if (argument == "--connection" && has_value) {
+      options.connection = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+    } else if (argument == "--id" && has_value) {
+      options.packet_id = static_cast<int32_t>(std::strtol(argv[++i], nullptr, 0));
+    } else if (argument == "--direction" && has_value) {
+      const std::string_view value = argv[++i];
+      if (value == "serverbound" || value == "in") {
+        options.direction = Network::PacketDirection::SERVERBOUND;
+      } else if (value == "clientbound" || value == "out") {
+        options.direction = Network::PacketDirection::CLIENTBOUND;
+      } else {
+        return false;
+      }
+    } else if (!argument.starts_with("--")) {
+      options.inputs.emplace_back(argument);
+    } else {
+      return false;
+    }
+  }
+  return !options.inputs.empty();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseArguments(argc, argv, options)) {
+    std::fprintf(stderr,
+                 "usage: %s [--summary] [--payload] [--connection N] [--id N] "
+                 "[--direction serverbound|clientbound] <file or directory>...\n",
+                 argv[0]);
+    return 2;
+  }
+
+  std::vector<std::filesystem::path> paths;
+  for (const std::filesystem::path& input : options.inputs) {
+    if (std::filesystem::is_directory(input)) {
+      for (const auto& entry : std::filesystem::directory_iterator(input)) {
+        if (entry.path().extension() == ".pslog") {
+          paths.push_back(entry.path());
+        }
+      }
+    } else {
+      paths.push_back(input);
+    }
+  }
+
+  std::vector<LogFile> files;
+  for (const std::filesystem::path& path : paths) {
+    if (std::optional<LogFile> file = ReadLogFile(path)) {
+      files.push_back(std::move(*file));
+    }
+  }
+  // The ring reuses file names; the sequence number gives the real order
+  std::sort(files.begin(), files.end(), [](const LogFile& a, const LogFile& b) {
+    return a.header.sequence < b.header.sequence;
+  });
+
+  std::map<std::tuple<uint8_t, uint8_t, int32_t>, TypeSummary> summary;
+  uint64_t records = 0;
+  uint64_t first_ns = 0;
+  uint64_t last_ns = 0;
+  for (const LogFile& file : files) {
+    size_t offset = 0;
+    while (offset + sizeof(Network::PacketLogRecord) <= file.data.size()) {
+      Network::PacketLogRecord record;
+      std::memcpy(&record, file.data.data() + offset, sizeof(record));
+      if (record.timestamp_ns == 0) {
+        break;
+      }
+      const uint8_t* payload = file.data.data() + offset + sizeof(record);
+      offset += (sizeof(record) + record.payload_bytes + Network::PACKET_LOG_ALIGNMENT - 1) &
+                ~(Network::PACKET_LOG_ALIGNMENT - 1);
+      if (offset > file.data.size()) {
+        std::fprintf(stderr, "%s: truncated record\n", file.path.string().c_str());
+        break;
+      }
+      if (!Matches(options, record)) {
+        continue;
+      }
+      ++records;
+      first_ns = first_ns == 0 ? record.timestamp_ns : std::min(first_ns, record.timestamp_ns);
+      last_ns = std::max(last_ns, record.timestamp_ns);
+
+      if (options.summary) {
+        TypeSummary& type = summary[{record.direction, record.state, record.packet_id}];
+        ++type.count;
+        type.bytes += record.length;
+        type.max_length = std::max(type.max_length, record.length);
+        continue;
+      }
+      std::printf("%s #%u %s %s 0x%02X len=%u", FormatTimestamp(record.timestamp_ns).c_str(),
+                  record.connection, DirectionName(record.direction), StateName(record.state),
+                  static_cast<unsigned>(record.packet_id), record.length);
+      if (options.payload && record.payload_bytes != 0) {
+        std::printf(" ");
+        for (uint16_t i = 0; i < record.payload_bytes; ++i) {
+          std::printf("%02x", payload[i]);
+        }
+      }
+      std::printf("\n");
+    }
+  }
+
+  if (options.summary) {
+    const double seconds = last_ns > first_ns ? (last_ns - first_ns) / 1e9 : 0.0;
+    std::printf("%llu records in %zu files over %.3f s\n",
+                static_cast<unsigned long long>(records), files.size(), seconds);
+    std::printf("%-4s %-13s %6s %12s %14s %10s %8s\n", "dir", "state", "id", "count", "bytes",
+                "avg_len", "max_len");
+    for (const auto& [key, type] : summary) {
+      const auto& [direction, state, packet_id] = key;
+      std::printf("%-4s %-13s 0x%04X %12llu %14llu %10.1f %8u\n", DirectionName(direction),
+                  StateName(state), static_cast<unsigned>(packet_id),
+                  static_cast<unsigned long long>(type.count),
+                  static_cast<unsigned long long>(type.bytes),
+                  static_cast<double>(type.bytes) / type.count, type.max_length);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file player_data_bench.cpp
+ * @brief Join stall of Player::PlayerDataStore, prefetched versus loaded at spawn
+ *
+ * Saves a set of players with a survival-sized inventory and statistics,
+ * then replays a stream of joins against the store twice. In the
+ * "prefetch" mode each join calls Prefetch() at Login Start and the tick
+ * thread collects the result when the player spawns, a login phase later
+ * (encryption and configuration in the real server). In the "spawn" mode
+ * the load starts only at spawn, which is what a synchronous read on the
+ * tick thread costs. Prints percentiles of the load time and of the time
+ * the tick thread waits at spawn, for both modes.
+ *
+ * The files are read back through the page cache; drop it between the save
+ * and the joins (or point --directory at a cold disk) to include device
+ * latency.
+ *
+ * @date 2026/10/18
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "player/player_data_store.h"
+#include "util/worker_pool.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchConfig {
+  int players = 500;
+  size_t io_threads = 4;
+  int join_interval_us = 2000;  ///< Time between two Login Starts
+  int login_ms = 30;            ///< Login Start to spawn
+  std::filesystem::path directory = "player-data-bench";
+};
+
+struct Percentiles {
+  double p50 = 0;
+  double p99 = 0;
+  double max = 0;
+};
+
+Percentiles Summarize(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  const auto at = [&values](double fraction) {
+    return values[static_cast<size_t>(fraction * static_cast<double>(values.size() - 1))];
+  };
+  return {at(0.50), at(0.99), values.back()};
+}
+
+Player::PlayerData MakePlayer(uint64_t id) {
+  Player::PlayerData data;
+  data.uuid = {id + 1, id * 7};
+  data.x = static_cast<double>(id);
+  data.y = 64;
+  auto enchanted = std::make_shared<const Inventory::ItemComponentPatch>(
+      1, 0, std::vector<uint8_t>(40, 7));
+  for (int32_t slot = 0; slot < 36; ++slot) {
+    data.inventory.push_back({slot, {slot + 1, 64, slot % 4 == 0 ? enchanted : nullptr}});
+  }
+  for (int32_t statistic = 0; statistic < 200; ++statistic) {
+    data.statistics.emplace_back(statistic, statistic * 3);
+  }
+  return data;
+}
+
+struct JoinResult {
+  std::vector<double> load_ms;
+  std::vector<double> stall_ms;
+};
+
+/** @brief Replay the joins; loads start at Login Start when @p prefetch, else at spawn */
+JoinResult Replay(const BenchConfig& config, Player::PlayerDataStore& store, bool prefetch) {
+  const auto interval = std::chrono::microseconds(config.join_interval_us);
+  const auto login = std::chrono::milliseconds(config.login_ms);
+  std::vector<std::shared_future<Player::LoadResult>> loads(static_cast<size_t>(config.players));
+  JoinResult result;
+  const Clock::time_point start = Clock::now();
+  int next_login = 0;
+  int next_spawn = 0;
+  while (next_spawn < config.players) {
+    const Clock::time_point login_at = start + next_login * interval;
+    const Clock::time_point spawn_at = start + next_spawn * interval + login;
+    if (next_login < config.players && login_at <= spawn_at) {
+      std::this_thread::sleep_until(login_at);
+      if (prefetch) {
+        loads[next_login] = store.Prefetch(MakePlayer(next_login).uuid);
+      }
+      ++next_login;
+      continue;
+    }
+    std::this_thread::sleep_until(spawn_at);
+    const Clock::time_point spawn = Clock::now();
+    if (!prefetch) {
+      loads[next_spawn] = store.Prefetch(MakePlayer(next_spawn).uuid);
+    }
+    const Player::LoadResult& loaded = loads[next_spawn].get();
+    const std::chrono::duration<double, std::milli> stall = Clock::now() - spawn;
+    if (loaded.status != Player::LoadStatus::LOADED) {
+      std::fprintf(stderr, "player %d did not load\n", next_spawn);
+    }
+    result.load_ms.push_back(static_cast<double>(loaded.load_micros) / 1000.0);
+    result.stall_ms.push_back(stall.count());
+    store.Release(loaded.data.uuid);
+    ++next_spawn;
+  }
+  return result;
+}
+
+void Print(const char* mode, const JoinResult& result) {
+  const Percentiles load = Summarize(result.load_ms);
+  const Percentiles stall = Summarize(result.stall_ms);
+  std::printf(
+      "mode=%s load_p50_ms=%.2f load_p99_ms=%.2f stall_p50_ms=%.3f stall_p99_ms=%.3f "
+      "stall_max_ms=%.3f\n",
+      mode, load.p50, load.p99, stall.p50, stall.p99, stall.max);
+}
+
+bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string_view argument = argv[i];
+    const long value = std::strtol(argv[i + 1], nullptr, 10);
+    if (argument == "--players") {
+      config.players = static_cast<int>(value);
+    } else if (argument == "--io-threads") {
+      config.io_threads = static_cast<size_t>(value);
+    } else if (argument == "--join-interval-us") {
+      config.join_interval_us = static_cast<int>(value);
+    } else if (argument == "--login-ms") {
+      config.login_ms = static_cast<int>(value);
+    } else if (argument == "--directory") {
+      config.directory = argv[i + 1];
+    } else {
+      return false;
+    }
+  }
+  return argc % 2 == 1 && config.players > 0 && config.join_interval_us >= 0 &&
+         config.login_ms >= 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!ParseArguments(argc, argv, config)) {
+    std::fprintf(stderr,
+                 "usage: %s [--players N] [--io-threads N] [--join-interval-us N] "
+                 "[--login-ms N] [--directory PATH]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  Util::WorkerPool io(config.io_threads);
+  Player::PlayerDataStore store(config.directory, io);
+  for (int i = 0; i < config.players; ++i) {
+    store.Save(MakePlayer(static_cast<uint64_t>(i)));
+  }
+  store.Flush();
+  const Player::PlayerDataStats saved = store.GetStats();
+  std::printf("players=%d io_threads=%zu bytes_per_player=%.0f\n", config.players,
+              io.ThreadCount(),
+              static_cast<double>(saved.bytes_written) / static_cast<double>(config.players));
+
+  Print("spawn", Replay(config, store, false));
+  Print("prefetch", Replay(config, store, true));
+  return 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file player_list_bench.cpp
+ * @brief Tab list traffic of Player::PlayerList in a busy lobby
+ *
+ * Fills the list with online players carrying a skin property, then runs
+ * ticks with a steady churn: a few players join and leave, some of them
+ * within the same tick, and a batch of latency updates arrives. Every tick
+ * ends with Flush(), whose packets are "sent" to every online player.
+ * Prints packets per tick, encoded bytes per second before and after
+ * fan-out, and the cost of a tick's list work.
+ *
+ * @date 2026/10/18
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "player/player_list.h"
+
+namespace {
+
+struct BenchConfig {
+  int players = 1000;        ///< Online at the start
+  int ticks = 1200;          ///< One minute at 20 TPS
+  int joins = 2;             ///< Joins per tick, matched by as many leaves
+  int latency_updates = 50;  ///< Latency changes per tick
+  uint32_t seed = 1;
+};
+
+Player::PlayerListEntry MakeEntry(uint64_t id) {
+  Player::PlayerListEntry entry;
+  entry.uuid = {id, id};
+  entry.name = "Player" + std::to_string(id);
+  // A signed skin is the bulk of a join entry
+  entry.properties.push_back({"textures", std::string(400, 'a'), std::string(684, 's')});
+  return entry;
+}
+
+bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string_view argument = argv[i];
+    const long value = std::strtol(argv[i + 1], nullptr, 10);
+    if (argument == "--players") {
+      config.players = static_cast<int>(value);
+    } else if (argument == "--ticks") {
+      config.ticks = static_cast<int>(value);
+    } else if (argument == "--joins") {
+      config.joins = static_cast<int>(value);
+    } else if (argument == "--latency-updates") {
+      config.latency_updates = static_cast<int>(value);
+    } else if (argument == "--seed") {
+      config.seed = static_cast<uint32_t>(value);
+    } else {
+      return false;
+    }
+  }
+  return argc % 2 == 1 && config.players > config.joins && config.ticks > 0 &&
+         config.joins >= 0 && config.latency_updates >= 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!ParseArguments(argc, argv, config)) {
+    std::fprintf(stderr,
+                 "usage: %s [--players N] [--ticks N] [--joins N] [--latency-updates N] "
+                 "[--seed N]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  Player::PlayerList list;
+  std::mt19937 random(config.seed);
+  uint64_t next_id = 1;
+  std::vector<Util::Uuid> online;
+  for (int i = 0; i < config.players; ++i) {
+    Player::PlayerListEntry entry = MakeEntry(next_id++);
+    online.push_back(entry.uuid);
+    list.Add(std::move(entry));
+  }
+  list.Flush([](const Network::SharedPacket&) {});
+  const Player::PlayerListStats before = list.GetStats();
+
+  uint64_t packets = 0;
+  uint64_t fanout_bytes = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int tick = 0; tick < config.ticks; ++tick) {
+    for (int i = 0; i < config.joins; ++i) {
+      const size_t leaving = random() % online.size();
+      list.Remove(online[leaving]);
+      online[leaving] = online.back();
+      online.pop_back();
+    }
+    for (int i = 0; i < config.joins; ++i) {
+      Player::PlayerListEntry entry = MakeEntry(next_id++);
+      online.push_back(entry.uuid);
+      list.Add(std::move(entry));
+    }
+    // A connection that drops during login: joins and leaves before the flush
+    if (tick % 3 == 0) {
+      Player::PlayerListEntry entry = MakeEntry(next_id++);
+      const Util::Uuid uuid = entry.uuid;
+      list.Add(std::move(entry));
+      list.Remove(uuid);
+    }
+    for (int i = 0; i < config.latency_updates; ++i) {
+      list.SetLatency(online[random() % online.size()], static_cast<int32_t>(random() % 200));
+    }
+    packets += list.Flush([&](const Network::SharedPacket& packet) {
+      fanout_bytes += packet->bytes.size() * online.size();
+    });
+  }
+  const std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  const Player::PlayerListStats& stats = list.GetStats();
+  const double seconds = config.ticks / 20.0;
+  std::printf(
+      "players=%d ticks=%d packets_per_tick=%.2f encoded_kb_per_s=%.1f fanout_mb_per_s=%.1f "
+      "cancelled_joins=%llu tick_us=%.1f snapshot_kb=%.1f\n",
+      config.players, config.ticks, static_cast<double>(packets) / config.ticks,
+      static_cast<double>(stats.bytes_encoded - before.bytes_encoded) / seconds / 1000.0,
+      static_cast<double>(fanout_bytes) / seconds / 1e6,
+      static_cast<unsigned long long>(stats.cancelled_joins), elapsed.count() / config.ticks,
+      static_cast<double>(list.SnapshotPacket()->bytes.size()) / 1000.0);
+  return 0;
+}
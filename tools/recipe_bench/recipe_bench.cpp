@@ -0,0 +1,266 @@
+/**
+ * @file recipe_bench.cpp
+ * @brief Crafting grid matching under auto-crafter spam, linear scan versus index
+ *
+ * Registers a vanilla-sized recipe book (shaped patterns of every size,
+ * mirrored and with tag-like multi-item ingredients, plus shapeless
+ * recipes) and a set of auto-crafters, each loaded with the grid of one
+ * recipe at some offset or with junk that crafts nothing. Every tick each
+ * crafter is pulsed and matches its grid; a hopper has topped it back up,
+ * so the layout is unchanged. The same stream of grids is matched three
+ * ways: the vanilla-style scan of every recipe at every grid offset, a
+ * RecipeIndex lookup, and a per-crafter CraftingMatcher. Prints
+ * nanoseconds per match for each and the matcher's cache hit rate; the
+ * scan and the index must agree on every grid.
+ *
+ * @date 2026/10/18
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "inventory/recipe_index.h"
+
+namespace {
+
+struct BenchConfig {
+  int recipes = 1200;
+  int crafters = 2000;
+  int ticks = 200;
+};
+
+constexpr int32_t ITEM_COUNT = 900;
+
+bool MatchesShapedAt(const Inventory::CraftingRecipe& recipe, const Inventory::CraftingGrid& grid,
+                     int32_t dx, int32_t dy, bool mirrored) {
+  for (int32_t row = 0; row < grid.height; ++row) {
+    for (int32_t col = 0; col < grid.width; ++col) {
+      const int32_t item = grid.items[row * grid.width + col];
+      const int32_t x = col - dx;
+      const int32_t y = row - dy;
+      if (x < 0 || y < 0 || x >= recipe.width || y >= recipe.height) {
+        if (item != Inventory::EMPTY_ITEM) {
+          return false;
+        }
+        continue;
+      }
+      const Inventory::Ingredient& ingredient =
+          recipe.ingredients[y * recipe.width + (mirrored ? recipe.width - 1 - x : x)];
+      if (ingredient.IsEmpty() ? item != Inventory::EMPTY_ITEM : !ingredient.Accepts(item)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool MatchesShapeless(const Inventory::CraftingRecipe& recipe, const std::vector<int32_t>& items,
+                      size_t next, uint16_t used) {
+  if (next == items.size()) {
+    return true;
+  }
+  for (size_t i = 0; i < recipe.ingredients.size(); ++i) {
+    if (!(used & (1u << i)) && recipe.ingredients[i].Accepts(items[next]) &&
+        MatchesShapeless(recipe, items, next + 1, static_cast<uint16_t>(used | (1u << i)))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/** @brief What a server without the index does: try every recipe at every offset */
+const Inventory::CraftingRecipe* LinearMatch(const std::vector<Inventory::CraftingRecipe>& recipes,
+                                             const Inventory::CraftingGrid& grid) {
+  std::vector<int32_t> items;
+  for (int32_t item : grid.items) {
+    if (item != Inventory::EMPTY_ITEM) {
+      items.push_back(item);
+    }
+  }
+  for (const Inventory::CraftingRecipe& recipe : recipes) {
+    if (recipe.kind == Inventory::CraftingRecipe::SHAPELESS) {
+      if (recipe.ingredients.size() == items.size() && MatchesShapeless(recipe, items, 0, 0)) {
+        return &recipe;
+      }
+      continue;
+    }
+    for (int32_t dy = 0; dy + recipe.height <= grid.height; ++dy) {
+      for (int32_t dx = 0; dx + recipe.width <= grid.width; ++dx) {
+        if (MatchesShapedAt(recipe, grid, dx, dy, false) ||
+            MatchesShapedAt(recipe, grid, dx, dy, true)) {
+          return &recipe;
+        }
+      }
+    }
+  }
+  return nullptr;
+}
+
+Inventory::Ingredient RandomIngredient(std::mt19937& random) {
+  Inventory::Ingredient ingredient;
+  // About one in six cells takes a tag (planks, logs, wool) instead of one item
+  const int32_t first = static_cast<int32_t>(random() % ITEM_COUNT) + 1;
+  const int32_t size = random() % 6 == 0 ? 4 : 1;
+  for (int32_t i = 0; i < size; ++i) {
+    ingredient.items.push_back(first + i);
+  }
+  return ingredient;
+}
+
+/** @brief Trimmed recipes, so the scan above can compare their cells directly */
+std::vector<Inventory::CraftingRecipe> MakeRecipes(int count, std::mt19937& random) {
+  std::vector<Inventory::CraftingRecipe> recipes;
+  while (static_cast<int>(recipes.size()) < count) {
+    Inventory::CraftingRecipe recipe;
+    recipe.id = "bench:recipe_" + std::to_string(recipes.size());
+    recipe.result = {.item_id = static_cast<int32_t>(random() % ITEM_COUNT) + 1,
+                     .count = 1,
+                     .components = nullptr};
+    if (random() % 4 == 0) {
+      recipe.kind = Inventory::CraftingRecipe::SHAPELESS;
+      const size_t ingredients = random() % 9 + 1;
+      for (size_t i = 0; i < ingredients; ++i) {
+        recipe.ingredients.push_back(RandomIngredient(random));
+      }
+    } else {
+      recipe.width = static_cast<int32_t>(random() % 3) + 1;
+      recipe.height = static_cast<int32_t>(random() % 3) + 1;
+      for (int32_t i = 0; i < recipe.width * recipe.height; ++i) {
+        recipe.ingredients.push_back(random() % 5 == 0 ? Inventory::Ingredient{}
+                                                       : RandomIngredient(random));
+      }
+      // Keep the pattern trimmed: its corners' rows and columns must be occupied
+      recipe.ingredients.front() = RandomIngredient(random);
+      recipe.ingredients.back() = RandomIngredient(random);
+    }
+    recipes.push_back(std::move(recipe));
+  }
+  return recipes;
+}
+
+Inventory::CraftingGrid GridFor(const Inventory::CraftingRecipe& recipe, std::mt19937& random) {
+  Inventory::CraftingGrid grid;
+  auto pick = [&random](const Inventory::Ingredient& ingredient) {
+    return ingredient.IsEmpty() ? Inventory::EMPTY_ITEM
+                                : ingredient.items[random() % ingredient.items.size()];
+  };
+  if (recipe.kind == Inventory::CraftingRecipe::SHAPELESS) {
+    std::array<int32_t, 9> cells{0, 1, 2, 3, 4, 5, 6, 7, 8};
+    std::shuffle(cells.begin(), cells.end(), random);
+    for (size_t i = 0; i < recipe.ingredients.size(); ++i) {
+      grid.items[cells[i]] = pick(recipe.ingredients[i]);
+    }
+    return grid;
+  }
+  const int32_t dx = static_cast<int32_t>(random() % (4 - recipe.width));
+  const int32_t dy = static_cast<int32_t>(random() % (4 - recipe.height));
+  const bool mirrored = random() % 2 == 0;
+  for (int32_t y = 0; y < recipe.height; ++y) {
+    for (int32_t x = 0; x < recipe.width; ++x) {
+      const int32_t source = mirrored ? recipe.width - 1 - x : x;
+      grid.items[(y + dy) * 3 + x + dx] = pick(recipe.ingredients[y * recipe.width + source]);
+    }
+  }
+  return grid;
+}
+
+bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string_view argument = argv[i];
+    const long value = std::strtol(argv[i + 1], nullptr, 10);
+    if (argument == "--recipes") {
+      config.recipes = static_cast<int>(value);
+    } else if (argument == "--crafters") {
+      config.crafters = static_cast<int>(value);
+    } else if (argument == "--ticks") {
+      config.ticks = static_cast<int>(value);
+    } else {
+      return false;
+    }
+  }
+  return argc % 2 == 1 && config.recipes > 0 && config.crafters > 0 && config.ticks > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!ParseArguments(argc, argv, config)) {
+    std::fprintf(stderr, "usage: %s [--recipes N] [--crafters N] [--ticks N]\n", argv[0]);
+    return 2;
+  }
+
+  std::mt19937 random(42);
+  const std::vector<Inventory::CraftingRecipe> recipes = MakeRecipes(config.recipes, random);
+  Inventory::RecipeIndex index;
+  for (const Inventory::CraftingRecipe& recipe : recipes) {
+    index.Add(recipe);
+  }
+
+  std::vector<Inventory::CraftingGrid> grids;
+  for (int c = 0; c < config.crafters; ++c) {
+    if (random() % 5 == 0) {
+      Inventory::CraftingGrid junk;
+      junk.items[random() % 9] = static_cast<int32_t>(random() % ITEM_COUNT) + 1;
+      junk.items[random() % 9] = static_cast<int32_t>(random() % ITEM_COUNT) + 1;
+      grids.push_back(junk);
+    } else {
+      grids.push_back(GridFor(recipes[random() % recipes.size()], random));
+    }
+  }
+
+  // The scan is slow enough that one tick is a fair sample
+  std::vector<const Inventory::CraftingRecipe*> found(grids.size());
+  auto start = std::chrono::steady_clock::now();
+  for (size_t c = 0; c < grids.size(); ++c) {
+    found[c] = LinearMatch(recipes, grids[c]);
+  }
+  const std::chrono::duration<double, std::nano> linear = std::chrono::steady_clock::now() - start;
+  int matched = 0;
+  int mismatches = 0;
+  for (size_t c = 0; c < grids.size(); ++c) {
+    const Inventory::CraftingRecipe* indexed = index.Match(grids[c]);
+    matched += found[c] != nullptr;
+    mismatches += (found[c] == nullptr) != (indexed == nullptr) ||
+                  (found[c] != nullptr && found[c]->id != indexed->id);
+  }
+
+  int64_t checksum = 0;
+  start = std::chrono::steady_clock::now();
+  for (int tick = 0; tick < config.ticks; ++tick) {
+    for (const Inventory::CraftingGrid& grid : grids) {
+      checksum += index.Match(grid) != nullptr;
+    }
+  }
+  const std::chrono::duration<double, std::nano> indexed = std::chrono::steady_clock::now() - start;
+
+  std::vector<Inventory::CraftingMatcher> matchers(grids.size(), Inventory::CraftingMatcher(index));
+  start = std::chrono::steady_clock::now();
+  for (int tick = 0; tick < config.ticks; ++tick) {
+    for (size_t c = 0; c < grids.size(); ++c) {
+      checksum += matchers[c].Match(grids[c]) != nullptr;
+    }
+  }
+  const std::chrono::duration<double, std::nano> cached = std::chrono::steady_clock::now() - start;
+  uint64_t hits = 0;
+  for (const Inventory::CraftingMatcher& matcher : matchers) {
+    hits += matcher.GetStats().cache_hits;
+  }
+
+  const double matches = static_cast<double>(config.crafters) * config.ticks;
+  std::printf(
+      "recipes=%d crafters=%d matched=%d mismatches=%d linear_ns=%.1f index_ns=%.1f "
+      "matcher_ns=%.1f matcher_hit_rate=%.3f checksum=%lld\n",
+      config.recipes, config.crafters, matched, mismatches, linear.count() / config.crafters,
+      indexed.count() / matches, cached.count() / matches, hits / matches,
+      static_cast<long long>(checksum));
+  return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file scoreboard_bench.cpp
+ * @brief Per-tick cost of per-player minigame sidebars
+ *
+ * Gives every player a board of their own with a sidebar objective and a
+ * fixed number of lines, the way minigame plugins render their HUD, and
+ * then rewrites the whole sidebar several times per tick while only a few
+ * lines actually change. Dirty tracking should drop the unchanged and
+ * overwritten sets and leave one Update Score per changed line. Prints the
+ * cost of a tick over all boards, the packets and bytes it produced and
+ * the share of sets that were dropped.
+ *
+ * @date 2026/10/18
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "scoreboard/scoreboard.h"
+
+namespace {
+
+struct BenchConfig {
+  int boards = 200;        ///< One per player
+  int lines = 15;          ///< Sidebar lines per board
+  int changing_lines = 3;  ///< Lines whose text changes every tick
+  int rewrites = 2;        ///< Times the plugin sets the whole sidebar per tick
+  int ticks = 200;
+};
+
+bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string_view argument = argv[i];
+    const long value = std::strtol(argv[i + 1], nullptr, 10);
+    if (argument == "--boards") {
+      config.boards = static_cast<int>(value);
+    } else if (argument == "--lines") {
+      config.lines = static_cast<int>(value);
+    } else if (argument == "--changing-lines") {
+      config.changing_lines = static_cast<int>(value);
+    } else if (argument == "--rewrites") {
+      config.rewrites = static_cast<int>(value);
+    } else if (argument == "--ticks") {
+      config.ticks = static_cast<int>(value);
+    } else {
+      return false;
+    }
+  }
+  return argc % 2 == 1 && config.boards > 0 && config.lines > 0 && config.changing_lines >= 0 &&
+         config.changing_lines <= config.lines && config.rewrites > 0 && config.ticks > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!ParseArguments(argc, argv, config)) {
+    std::fprintf(stderr,
+                 "usage: %s [--boards N] [--lines N] [--changing-lines N] [--rewrites N] "
+                 "[--ticks N]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  std::vector<std::string> entries;
+  for (int line = 0; line < config.lines; ++line) {
+    entries.push_back("line-" + std::to_string(line));
+  }
+  std::vector<std::unique_ptr<Scoreboard::Scoreboard>> boards;
+  for (int b = 0; b < config.boards; ++b) {
+    auto board = std::make_unique<Scoreboard::Scoreboard>();
+    board->AddObjective("sidebar", "Game");
+    board->SetDisplaySlot(Scoreboard::DisplaySlot::SIDEBAR, "sidebar");
+    for (int line = 0; line < config.lines; ++line) {
+      board->SetScore(entries[line], "sidebar", config.lines - line, "");
+    }
+    board->Flush([](const Network::SharedPacket&) {});
+    boards.push_back(std::move(board));
+  }
+
+  uint64_t packets = 0;
+  uint64_t bytes = 0;
+  std::string text;
+  const auto start = std::chrono::steady_clock::now();
+  for (int tick = 0; tick < config.ticks; ++tick) {
+    for (const std::unique_ptr<Scoreboard::Scoreboard>& board : boards) {
+      for (int rewrite = 0; rewrite < config.rewrites; ++rewrite) {
+        for (int line = 0; line < config.lines; ++line) {
+          text = "Kills: " + std::to_string(line < config.changing_lines ? tick : 7);
+          board->SetScore(entries[line], "sidebar", config.lines - line, text);
+        }
+      }
+      packets += board->Flush([&bytes](const Network::SharedPacket& packet) {
+        bytes += packet->bytes.size();
+      });
+    }
+  }
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  uint64_t sets = 0;
+  uint64_t dropped = 0;
+  for (const std::unique_ptr<Scoreboard::Scoreboard>& board : boards) {
+    const Scoreboard::ScoreboardStats& stats = board->GetStats();
+    sets += stats.score_sets;
+    dropped += stats.unchanged_sets + stats.coalesced_sets;
+  }
+  std::printf(
+      "boards=%d lines=%d tick_ms=%.3f packets_per_tick=%.1f kb_per_tick=%.1f "
+      "dropped_sets_pct=%.1f\n",
+      config.boards, config.lines, elapsed.count() / config.ticks,
+      static_cast<double>(packets) / config.ticks,
+      static_cast<double>(bytes) / config.ticks / 1000.0,
+      100.0 * static_cast<double>(dropped) / static_cast<double>(sets));
+  return 0;
+}
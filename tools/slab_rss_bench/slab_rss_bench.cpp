@@ -0,0 +1,149 @@
+/**
+ * @file slab_rss_bench.cpp
+ * @brief Resident memory of chunk-section churn, slab allocator versus malloc
+ *
+ * Stands in for an exploration session: worker-pool threads generate
+ * sections (packed data of the 4 to 8 bit and 15 bit sizes plus a palette
+ * and some short-lived scratch), the main thread keeps a sliding window of
+ * loaded sections and unloads the oldest, so most frees happen on a thread
+ * other than the allocating one. Run it once per allocator, each in its own
+ * process; it prints the final and peak resident set and, for the slab run,
+ * the slab counters.
+ *
+ * @date 2026/10/18
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "util/slab_allocator.h"
+#include "util/worker_pool.h"
+
+namespace {
+
+struct BenchConfig {
+  bool slabs = true;
+  int sections = 1000000;  ///< Generated over the whole run
+  int window = 40000;      ///< Sections kept loaded
+  size_t workers = 4;
+};
+
+/** @brief Packed data sizes in longs of 4, 5, 6, 7, 8 and 15 bits per entry */
+constexpr size_t DATA_LONGS[] = {256, 342, 410, 456, 512, 1024};
+constexpr int SECTIONS_PER_TASK = 2500;
+
+uint64_t ResidentMiB() {
+  std::ifstream file("/proc/self/statm");
+  uint64_t size = 0, resident = 0;
+  file >> size >> resident;
+  return resident * 4096 / (1024 * 1024);
+}
+
+template <template <typename> class Allocator>
+struct Section {
+  std::vector<int32_t, Allocator<int32_t>> palette;
+  std::vector<uint64_t, Allocator<uint64_t>> data;
+};
+
+template <template <typename> class Allocator>
+std::vector<std::unique_ptr<Section<Allocator>>> Generate(uint32_t seed) {
+  std::mt19937 random(seed);
+  std::vector<std::unique_ptr<Section<Allocator>>> sections;
+  for (int i = 0; i < SECTIONS_PER_TASK; ++i) {
+    auto section = std::make_unique<Section<Allocator>>();
+    const size_t size_class = random() % std::size(DATA_LONGS);
+    section->data.assign(DATA_LONGS[size_class], 1);
+    size_t palette_entries = 1;
+    while (palette_entries < (size_t{1} << (size_class + 4)) / 2 && random() % 3 != 0) {
+      palette_entries *= 2;
+    }
+    section->palette.assign(palette_entries, 0);
+    // Lighting and heightmap scratch that dies with the generation step
+    std::vector<int32_t, Allocator<int32_t>> scratch(random() % 64 + 1);
+    sections.push_back(std::move(section));
+  }
+  return sections;
+}
+
+template <template <typename> class Allocator>
+uint64_t Run(const BenchConfig& config) {
+  Util::WorkerPool pool(config.workers);
+  std::deque<std::unique_ptr<Section<Allocator>>> loaded;
+  uint64_t peak = 0;
+  const int waves = config.sections / (SECTIONS_PER_TASK * static_cast<int>(config.workers));
+  for (int wave = 0; wave < waves; ++wave) {
+    std::vector<std::future<std::vector<std::unique_ptr<Section<Allocator>>>>> generated;
+    for (size_t task = 0; task < config.workers; ++task) {
+      const auto seed = static_cast<uint32_t>(wave * config.workers + task);
+      generated.push_back(pool.Submit([seed] { return Generate<Allocator>(seed); }));
+    }
+    for (auto& batch : generated) {
+      for (auto& section : batch.get()) {
+        loaded.push_back(std::move(section));
+      }
+    }
+    while (loaded.size() > static_cast<size_t>(config.window)) {
+      loaded.pop_front();
+    }
+    peak = std::max(peak, ResidentMiB());
+  }
+  return peak;
+}
+
+bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string_view argument = argv[i];
+    const std::string_view text = argv[i + 1];
+    const long value = std::strtol(argv[i + 1], nullptr, 10);
+    if (argument == "--allocator" && (text == "slab" || text == "malloc")) {
+      config.slabs = text == "slab";
+    } else if (argument == "--sections") {
+      config.sections = static_cast<int>(value);
+    } else if (argument == "--window") {
+      config.window = static_cast<int>(value);
+    } else if (argument == "--workers") {
+      config.workers = static_cast<size_t>(value);
+    } else {
+      return false;
+    }
+  }
+  return argc % 2 == 1 && config.sections > 0 && config.window > 0 && config.workers > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!ParseArguments(argc, argv, config)) {
+    std::fprintf(stderr,
+                 "usage: %s [--allocator slab|malloc] [--sections N] [--window N] "
+                 "[--workers N]\n",
+                 argv[0]);
+    return 2;
+  }
+
+  const uint64_t peak =
+      config.slabs ? Run<Util::SlabAllocator>(config) : Run<std::allocator>(config);
+  std::printf("allocator=%s sections=%d window=%d rss_mib=%llu peak_mib=%llu\n",
+              config.slabs ? "slab" : "malloc", config.sections, config.window,
+              static_cast<unsigned long long>(ResidentMiB()),
+              static_cast<unsigned long long>(peak));
+  if (config.slabs) {
+    const Util::SlabStats stats = Util::GetSlabStats();
+    std::printf("slabs_live=%llu slabs_allocated=%llu slabs_released=%llu remote_frees=%llu\n",
+                static_cast<unsigned long long>(stats.slabs_live),
+                static_cast<unsigned long long>(stats.slabs_allocated),
+                static_cast<unsigned long long>(stats.slabs_released),
+                static_cast<unsigned long long>(stats.remote_frees));
+  }
+  return 0;
+}